@@ -97,6 +97,7 @@ foreach(
   DEVILUTIONX_DISPLAY_PIXELFORMAT # SDL2-only
   DEVILUTIONX_DISPLAY_TEXTURE_FORMAT # SDL2-only
   DEVILUTIONX_SCREENSHOT_FORMAT
+  DEVILUTIONX_SAVE_COMPRESSION
   DARWIN_MAJOR_VERSION
   DARWIN_MINOR_VERSION
 )
@@ -215,6 +215,20 @@ if(NOT NOSOUND)
   endif()
 endif()
 
+# Both are needed to load saves written with either compression, see `DEVILUTIONX_SAVE_COMPRESSION`.
+dependency_options("lz4" DEVILUTIONX_SYSTEM_LZ4 ON DEVILUTIONX_STATIC_LZ4)
+if(DEVILUTIONX_SYSTEM_LZ4)
+  find_package(lz4 REQUIRED)
+else()
+  add_subdirectory(3rdParty/lz4)
+endif()
+dependency_options("zstd" DEVILUTIONX_SYSTEM_ZSTD ON DEVILUTIONX_STATIC_ZSTD)
+if(DEVILUTIONX_SYSTEM_ZSTD)
+  find_package(zstd REQUIRED)
+else()
+  add_subdirectory(3rdParty/zstd)
+endif()
+
 if(PACKET_ENCRYPTION)
   dependency_options("libsodium" DEVILUTIONX_SYSTEM_LIBSODIUM ON DEVILUTIONX_STATIC_LIBSODIUM)
   if(DEVILUTIONX_SYSTEM_LIBSODIUM)
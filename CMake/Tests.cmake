@@ -24,19 +24,23 @@ set(tests
   drlg_l3_test
   drlg_l4_test
   effects_test
+  hero_index_test
   inv_test
   items_test
   math_test
   missiles_test
   multi_logging_test
+  net_stats_test
   pack_test
   player_test
+  protocol_sim_test
   quests_test
   scrollrt_test
   stores_test
   tile_properties_test
   timedemo_test
   townerdat_test
+  turn_delay_test
   writehero_test
   vendor_test
   panel_state_test
@@ -55,14 +59,20 @@ set(standalone_tests
   file_util_test
   format_int_test
   ini_test
+  level_delta_slots_test
   mod_identity_test
+  monster_sync_priority_test
+  packet_test
   palette_blending_test
   parse_int_test
   path_test
   vision_test
   random_test
   rectangle_test
+  save_container_test
+  save_delta_test
   sheen_bidi_test
+  spsc_queue_test
   static_vector_test
   str_cat_test
   utf8_test
@@ -70,14 +80,33 @@ set(standalone_tests
 if(NOT USE_SDL1)
   list(APPEND standalone_tests text_render_integration_test)
 endif()
+if(BUILD_RELAY_SERVER)
+  list(APPEND standalone_tests relay_server_test)
+endif()
 set(benchmarks
   clx_render_benchmark
+  codec_benchmark
   crawl_benchmark
+  data_file_benchmark
   dun_render_benchmark
+  hero_index_benchmark
   light_render_benchmark
+  loadsave_benchmark
+  monster_sync_benchmark
+  packet_benchmark
   palette_blending_benchmark
   path_benchmark
+  player_sprite_benchmark
+  save_benchmark
+  save_container_benchmark
+  save_delta_benchmark
 )
+if(NOT NONET AND NOT DISABLE_TCP)
+  list(APPEND benchmarks tcp_benchmark)
+endif()
+if(BUILD_RELAY_SERVER)
+  list(APPEND benchmarks relay_benchmark)
+endif()
 
 include(test/Fixtures.cmake)
 
@@ -133,15 +162,26 @@ target_link_dependencies(clx_render_benchmark
   libdevilutionx_surface
 )
 target_link_dependencies(crawl_test PRIVATE libdevilutionx_crawl)
+target_link_dependencies(codec_benchmark PRIVATE libdevilutionx_codec app_fatal_for_testing)
 target_link_dependencies(crawl_benchmark PRIVATE libdevilutionx_crawl)
 target_link_dependencies(data_file_test PRIVATE libdevilutionx_txtdata app_fatal_for_testing language_for_testing)
+add_custom_target(data_file_benchmark_resources DEPENDS "${DEVILUTIONX_ASSETS_OUTPUT_DIRECTORY}/txtdata/items/itemdat.tsv")
+add_dependencies(data_file_benchmark data_file_benchmark_resources)
+target_link_dependencies(data_file_benchmark PRIVATE libdevilutionx_txtdata app_fatal_for_testing language_for_testing)
 target_link_dependencies(dun_render_benchmark PRIVATE libdevilutionx_so)
+target_link_dependencies(hero_index_benchmark PRIVATE libdevilutionx_so)
 target_link_dependencies(file_util_test PRIVATE libdevilutionx_file_util app_fatal_for_testing)
 target_link_dependencies(format_int_test PRIVATE libdevilutionx_format_int language_for_testing)
 target_link_dependencies(ini_test PRIVATE libdevilutionx_ini app_fatal_for_testing)
 target_link_dependencies(mod_identity_test PRIVATE libdevilutionx_mod_identity app_fatal_for_testing)
 target_include_directories(mod_identity_test PRIVATE "${PROJECT_SOURCE_DIR}/3rdParty/PicoSHA2")
 target_link_dependencies(light_render_benchmark PRIVATE libdevilutionx_light_render DevilutionX::SDL libdevilutionx_surface libdevilutionx_paths app_fatal_for_testing)
+target_link_dependencies(loadsave_benchmark PRIVATE libdevilutionx_so)
+target_link_dependencies(monster_sync_benchmark PRIVATE libdevilutionx_monster_sync_priority)
+target_link_dependencies(monster_sync_priority_test PRIVATE libdevilutionx_monster_sync_priority)
+target_link_dependencies(net_stats_test PRIVATE libdevilutionx_protocol_sim)
+target_link_dependencies(packet_benchmark PRIVATE libdevilutionx_dvlnet_packet app_fatal_for_testing)
+target_link_dependencies(packet_test PRIVATE libdevilutionx_dvlnet_packet app_fatal_for_testing)
 target_link_dependencies(palette_blending_test PRIVATE libdevilutionx_palette_blending DevilutionX::SDL libdevilutionx_strings GTest::gmock app_fatal_for_testing)
 target_link_dependencies(palette_blending_benchmark
   PRIVATE
@@ -154,9 +194,25 @@ target_link_dependencies(parse_int_test PRIVATE libdevilutionx_parse_int)
 target_link_dependencies(path_test PRIVATE libdevilutionx_pathfinding libdevilutionx_direction app_fatal_for_testing)
 target_link_dependencies(vision_test PRIVATE libdevilutionx_vision)
 target_link_dependencies(path_benchmark PRIVATE libdevilutionx_pathfinding app_fatal_for_testing)
+target_link_dependencies(player_sprite_benchmark PRIVATE libdevilutionx_so)
+target_link_dependencies(protocol_sim_test PRIVATE libdevilutionx_protocol_sim)
 target_link_dependencies(random_test PRIVATE libdevilutionx_random)
+if(BUILD_RELAY_SERVER)
+  target_link_dependencies(relay_benchmark PRIVATE libdevilutionx_relay_server app_fatal_for_testing)
+  target_link_dependencies(relay_server_test PRIVATE libdevilutionx_relay_server app_fatal_for_testing)
+endif()
+target_link_dependencies(save_container_test PRIVATE libdevilutionx_save_container)
+target_link_dependencies(save_delta_test PRIVATE libdevilutionx_save_delta)
+target_link_dependencies(save_benchmark PRIVATE libdevilutionx_so)
+target_link_dependencies(save_container_benchmark PRIVATE libdevilutionx_so)
+target_link_dependencies(save_delta_benchmark PRIVATE libdevilutionx_so)
+target_link_dependencies(spsc_queue_test PRIVATE libdevilutionx_sdl_thread app_fatal_for_testing)
 target_link_dependencies(static_vector_test PRIVATE libdevilutionx_random app_fatal_for_testing)
 target_link_dependencies(str_cat_test PRIVATE libdevilutionx_strings)
+if(NOT NONET AND NOT DISABLE_TCP)
+  target_link_dependencies(tcp_benchmark PRIVATE libdevilutionx_so)
+endif()
+target_link_dependencies(turn_delay_test PRIVATE libdevilutionx_protocol_sim)
 if(DEVILUTIONX_SCREENSHOT_FORMAT STREQUAL DEVILUTIONX_SCREENSHOT_FORMAT_PNG AND NOT USE_SDL1)
   target_link_dependencies(text_render_integration_test
     PRIVATE
@@ -0,0 +1,24 @@
+find_package(PkgConfig QUIET)
+if(PKG_CONFIG_FOUND)
+  pkg_check_modules(PC_zstd QUIET libzstd)
+endif()
+
+find_path(zstd_INCLUDE_DIR zstd.h
+          HINTS ${PC_zstd_INCLUDEDIR} ${PC_zstd_INCLUDE_DIRS})
+
+find_library(zstd_LIBRARY zstd
+             HINTS ${PC_zstd_LIBDIR} ${PC_zstd_LIBRARY_DIRS})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(zstd
+                                  REQUIRED_VARS zstd_LIBRARY zstd_INCLUDE_DIR
+                                  VERSION_VAR PC_zstd_VERSION)
+
+if(zstd_FOUND AND NOT TARGET zstd::zstd)
+  add_library(zstd::zstd UNKNOWN IMPORTED)
+  set_target_properties(zstd::zstd PROPERTIES
+                        INTERFACE_INCLUDE_DIRECTORIES ${zstd_INCLUDE_DIR}
+                        IMPORTED_LOCATION ${zstd_LIBRARY})
+endif()
+
+mark_as_advanced(zstd_INCLUDE_DIR zstd_LIBRARY)
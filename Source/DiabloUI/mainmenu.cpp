@@ -18,7 +18,9 @@
 #include "engine/load_clx.hpp"
 #include "engine/point.hpp"
 #include "game_mode.hpp"
+#include "tables/deferred_tables.hpp"
 #include "utils/language.h"
+#include "utils/startup_trace.hpp"
 #include "utils/ui_fwd.h"
 
 namespace devilution {
@@ -117,6 +119,8 @@ bool UiMainMenuDialog(const char *name, _mainmenu_selections *pdwResult, int att
 		while (MainMenuResult == MAINMENU_NONE) {
 			UiClearScreen();
 			UiPollAndRender();
+			MarkStartupTraceMenuShown();
+			LoadNextDeferredTable();
 			if (SDL_GetTicks() >= dwAttractTicks && (HaveIntro() || gbIsHellfire)) {
 				MainMenuResult = MAINMENU_ATTRACT_MODE;
 			}
@@ -83,8 +83,12 @@ void ByteSwapBlock(uint32_t *data)
 
 void XorBlock(const uint32_t *shaResult, uint32_t *out)
 {
-	for (unsigned i = 0; i < BlockSize; ++i)
-		out[i] ^= shaResult[i % SHA1HashSize];
+	// Repeating the hash over a whole block turns this into a plain element-wise XOR that compilers vectorize.
+	uint32_t key[BlockSize];
+	for (size_t i = 0; i < BlockSize; ++i)
+		key[i] = shaResult[i % SHA1HashSize];
+	for (size_t i = 0; i < BlockSize; ++i)
+		out[i] ^= key[i];
 }
 
 } // namespace
@@ -1,18 +1,28 @@
 #include "file.hpp"
 
+#include <algorithm>
 #include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <limits>
 #include <memory>
+#include <string>
 
 #include "engine/assets.hpp"
 #include "utils/algorithm/container.hpp"
 #include "utils/format.hpp"
 #include "utils/language.h"
+#include "utils/str_cat.hpp"
 
 namespace devilution {
+
+namespace {
+
+constexpr std::string_view Utf8BOM = "\xef\xbb\xbf";
+
+} // namespace
+
 std::expected<DataFile, DataFile::Error> DataFile::load(std::string_view path)
 {
 	AssetRef ref = FindAsset(path);
@@ -20,7 +30,7 @@ std::expected<DataFile, DataFile::Error> DataFile::load(std::string_view path)
 		return std::unexpected { Error::NotFound };
 	const size_t size = ref.size();
 	// TODO: It should be possible to stream the data file contents instead of copying the whole thing into memory
-	std::unique_ptr<char[]> data { new char[size] };
+	std::unique_ptr<uint64_t[]> data { new uint64_t[(size + 7) / 8] };
 	{
 		AssetHandle handle = OpenIntegralAsset(std::move(ref));
 		if (!handle.ok())
@@ -31,6 +41,39 @@ std::expected<DataFile, DataFile::Error> DataFile::load(std::string_view path)
 	return DataFile { std::move(data), size };
 }
 
+void DataFile::stripBOM()
+{
+	if (content_.starts_with(Utf8BOM))
+		content_.remove_prefix(Utf8BOM.size());
+}
+
+void DataFile::buildSeparatorIndex()
+{
+	const size_t maskWords = SeparatorIndex::maskWords(size());
+	separators_.reset(new uint64_t[2 * maskWords]);
+	BuildSeparatorIndex(content_, separators_.get(), separators_.get() + maskWords);
+	index_ = SeparatorIndex { data(), separators_.get(), separators_.get() + maskWords };
+}
+
+void DataFile::buildRecordIndex()
+{
+	// Records start at the beginning of the file (even an empty one) and after each lf, cr, or crlf
+	// that isn't at the end of the file, the same way HandleRecordTerminator advances.
+	const char *const end = data() + size();
+	const char *recordStart = data();
+	while (true) {
+		recordOffsets_.push_back(static_cast<uint32_t>(recordStart - data()));
+		const char *terminator = index_.findRecordTerminator(recordStart, end);
+		if (terminator == end)
+			break;
+		recordStart = terminator + 1;
+		if (*terminator == '\r' && recordStart != end && *recordStart == '\n')
+			++recordStart;
+		if (recordStart == end)
+			break;
+	}
+}
+
 DataFile DataFile::loadOrDie(std::string_view path)
 {
 	std::expected<DataFile, DataFile::Error> dataFileResult = DataFile::load(path);
@@ -96,7 +139,7 @@ std::expected<void, DataFile::Error> DataFile::parseHeader(ColumnDefinition *beg
 	std::bitset<std::numeric_limits<uint8_t>::max()> seenColumns;
 	unsigned lastColumn = 0;
 
-	RecordIterator firstRecord { data(), data() + size(), false };
+	RecordIterator firstRecord { data(), data() + size(), 0, index_ };
 	for (DataFileField field : *firstRecord) {
 		if (begin == end) {
 			// All key columns have been identified
@@ -141,7 +184,7 @@ std::expected<void, DataFile::Error> DataFile::parseHeader(ColumnDefinition *beg
 
 std::expected<void, DataFile::Error> DataFile::skipHeader()
 {
-	RecordIterator it { data(), data() + size(), false };
+	RecordIterator it { data(), data() + size(), 0, index_ };
 	++it;
 	if (it == this->end()) {
 		return std::unexpected { Error::NoContent };
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <expected>
 #include <limits>
 #include <memory>
 #include <string_view>
+#include <vector>
 
 #include <function_ref.hpp>
 
@@ -33,13 +35,24 @@ struct ColumnDefinition {
 
 /**
  * @brief Container for a tab-delimited file following the TSV-like format described in txtdata/Readme.md
+ *
+ * The positions of all the separators are indexed when the file is loaded, so that reading the
+ * fields does not require scanning byte by byte.
+ *
+ * The start of every record is indexed as well, see `recordAt`.
  */
 class DataFile {
-	std::unique_ptr<const char[]> data_;
+	std::unique_ptr<const uint64_t[]> data_;
 	std::string_view content_;
 
 	const char *body_;
 
+	/** Backing storage for `index_`. */
+	std::unique_ptr<uint64_t[]> separators_;
+	SeparatorIndex index_;
+	/** Offset of the start of each record (including the header) in `content_`. */
+	std::vector<uint32_t> recordOffsets_;
+
 	DataFile() = delete;
 
 	/**
@@ -47,17 +60,20 @@ class DataFile {
 	 * @param data pointer to the raw data backing the view (this container will take ownership to ensure the lifetime of the view)
 	 * @param size total number of bytes/code units including the BOM if present
 	 */
-	DataFile(std::unique_ptr<const char[]> &&data, size_t size)
+	DataFile(std::unique_ptr<const uint64_t[]> &&data, size_t size)
 	    : data_(std::move(data))
-	    , content_(data_.get(), size)
+	    , content_(reinterpret_cast<const char *>(data_.get()), size)
 	{
-		constexpr std::string_view utf8BOM = "\xef\xbb\xbf";
-		if (this->content_.starts_with(utf8BOM))
-			this->content_.remove_prefix(utf8BOM.size());
-
+		stripBOM();
 		body_ = this->content_.data();
+		buildSeparatorIndex();
+		buildRecordIndex();
 	}
 
+	void stripBOM();
+	void buildSeparatorIndex();
+	void buildRecordIndex();
+
 public:
 	enum class Error {
 		NotFound,
@@ -117,7 +133,29 @@ public:
 
 	[[nodiscard]] RecordIterator begin() const
 	{
-		return { body_, data() + size(), body_ != data() };
+		return { body_, data() + size(), body_ != data() ? 1U : 0U, index_ };
+	}
+
+	/**
+	 * @brief Returns an iterator starting at the given record without parsing the records before it
+	 *
+	 * Iterators are independent of each other, so disjoint ranges of records can be processed in parallel.
+	 * @param row index of the record, the header (if any) is record 0
+	 * @return an iterator to the record or end() if there are only `row` or fewer records
+	 */
+	[[nodiscard]] RecordIterator recordAt(size_t row) const
+	{
+		if (row >= recordOffsets_.size())
+			return end();
+		return { data() + recordOffsets_[row], data() + size(), static_cast<unsigned>(row), index_ };
+	}
+
+	/**
+	 * @brief Returns the number of records including the header, as visited by the record iterator
+	 */
+	[[nodiscard]] size_t numRows() const
+	{
+		return recordOffsets_.size();
 	}
 
 	[[nodiscard]] RecordIterator end() const
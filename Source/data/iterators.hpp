@@ -17,6 +17,7 @@ class DataFileField {
 	const char *end_;
 	unsigned row_;
 	unsigned column_;
+	SeparatorIndex index_;
 
 public:
 	enum class Error {
@@ -51,11 +52,12 @@ public:
 		}
 	}
 
-	DataFileField(GetFieldResult *state, const char *end, unsigned row, unsigned column)
+	DataFileField(GetFieldResult *state, const char *end, unsigned row, unsigned column, const SeparatorIndex &index = {})
 	    : state_(state)
 	    , end_(end)
 	    , row_(row)
 	    , column_(column)
+	    , index_(index)
 	{
 	}
 
@@ -70,7 +72,7 @@ public:
 	[[nodiscard]] std::string_view value()
 	{
 		if (state_->status == GetFieldResult::Status::ReadyToRead) {
-			*state_ = GetNextField(state_->next, end_);
+			*state_ = GetNextField(state_->next, end_, index_);
 		}
 		return state_->value;
 	}
@@ -102,7 +104,7 @@ public:
 			result = std::from_chars(begin, end_, destination);
 			if (result.ec != std::errc::invalid_argument) {
 				// from_chars was able to consume at least one character, consume the rest of the field
-				*state_ = GetNextField(result.ptr, end_);
+				*state_ = GetNextField(result.ptr, end_, index_);
 				// and prepend what was already parsed
 				state_->value = { begin, (state_->value.data() - begin) + state_->value.size() };
 			}
@@ -238,7 +240,7 @@ public:
 			// first read, consume digits
 			parseResult = ParseFixed6<T>({ begin, static_cast<size_t>(end_ - begin) }, &state_->next);
 			// then read the remainder of the field
-			*state_ = GetNextField(state_->next, end_);
+			*state_ = GetNextField(state_->next, end_, index_);
 			// and prepend what was already parsed
 			state_->value = { begin, (state_->value.data() - begin) + state_->value.size() };
 		} else {
@@ -304,6 +306,7 @@ class FieldIterator {
 	const char *const end_;
 	const unsigned row_;
 	unsigned column_ = 0;
+	SeparatorIndex index_;
 
 public:
 	using iterator_category = std::input_iterator_tag;
@@ -316,10 +319,11 @@ public:
 	{
 	}
 
-	FieldIterator(GetFieldResult *state, const char *end, unsigned row)
+	FieldIterator(GetFieldResult *state, const char *end, unsigned row, const SeparatorIndex &index = {})
 	    : state_(state)
 	    , end_(end)
 	    , row_(row)
+	    , index_(index)
 	{
 		state_->status = GetFieldResult::Status::ReadyToRead;
 	}
@@ -362,7 +366,7 @@ public:
 		if (state_->status == GetFieldResult::Status::ReadyToRead) {
 			// We never read the value and no longer need it, discard it so that we end up
 			//  advancing past the field delimiter (as if a value access had happened)
-			*state_ = DiscardField(state_->next, end_);
+			*state_ = DiscardField(state_->next, end_, index_);
 		}
 
 		if (state_->endOfRecord()) {
@@ -373,7 +377,7 @@ public:
 			//  last value access found the end of the field by necessity or we discarded it a few
 			//  lines up), so we only need to advance further if an increment greater than 1 was
 			//  provided.
-			*state_ = DiscardMultipleFields(state_->next, end_, increment - 1, &fieldsSkipped);
+			*state_ = DiscardMultipleFields(state_->next, end_, increment - 1, &fieldsSkipped, index_);
 			// As we've consumed the current field by this point we need to increment the internal
 			//  column counter one extra time so we have an accurate value.
 			column_ += fieldsSkipped + 1;
@@ -393,7 +397,7 @@ public:
 	 */
 	[[nodiscard]] value_type operator*()
 	{
-		return { state_, end_, row_, column_ };
+		return { state_, end_, row_, column_, index_ };
 	}
 
 	/**
@@ -416,18 +420,20 @@ class DataFileRecord {
 	GetFieldResult *state_;
 	const char *const end_;
 	const unsigned row_;
+	SeparatorIndex index_;
 
 public:
-	DataFileRecord(GetFieldResult *state, const char *end, unsigned row)
+	DataFileRecord(GetFieldResult *state, const char *end, unsigned row, const SeparatorIndex &index = {})
 	    : state_(state)
 	    , end_(end)
 	    , row_(row)
+	    , index_(index)
 	{
 	}
 
 	[[nodiscard]] FieldIterator begin()
 	{
-		return { state_, end_, row_ };
+		return { state_, end_, row_, index_ };
 	}
 
 	[[nodiscard]] FieldIterator end() const
@@ -445,6 +451,7 @@ class RecordIterator {
 	GetFieldResult state_;
 	const char *const end_;
 	unsigned row_ = 0;
+	SeparatorIndex index_;
 
 public:
 	using iterator_category = std::forward_iterator_tag;
@@ -456,10 +463,17 @@ public:
 	{
 	}
 
-	RecordIterator(const char *begin, const char *end, bool skippedHeader)
+	/**
+	 * @param begin start of the first record to visit
+	 * @param end one past the last character of the stream
+	 * @param row index of the first record in the file, 1 if the header has been skipped
+	 * @param index positions of the separators in the stream, if known
+	 */
+	RecordIterator(const char *begin, const char *end, unsigned row, const SeparatorIndex &index = {})
 	    : state_(begin)
 	    , end_(end)
-	    , row_(skippedHeader ? 1 : 0)
+	    , row_(row)
+	    , index_(index)
 	{
 	}
 
@@ -485,7 +499,7 @@ public:
 
 		if (!state_.endOfRecord()) {
 			// The field iterator either hasn't been used or hasn't consumed the entire record
-			state_ = DiscardRemainingFields(state_.next, end_);
+			state_ = DiscardRemainingFields(state_.next, end_, index_);
 		}
 
 		if (state_.endOfFile()) {
@@ -496,7 +510,7 @@ public:
 			//  last value access found the end of the record by necessity or we discarded any
 			//  leftovers a few lines up), so we only need to advance further if an increment
 			//  greater than 1 was provided.
-			state_ = DiscardMultipleRecords(state_.next, end_, increment - 1, &recordsSkipped);
+			state_ = DiscardMultipleRecords(state_.next, end_, increment - 1, &recordsSkipped, index_);
 			// As we've consumed the current record by this point we need to increment the internal
 			//  row counter one extra time so we have an accurate value.
 			row_ += recordsSkipped + 1;
@@ -509,7 +523,7 @@ public:
 
 	[[nodiscard]] DataFileRecord operator*()
 	{
-		return { &state_, end_, row_ };
+		return { &state_, end_, row_, index_ };
 	}
 
 	/**
@@ -1,6 +1,129 @@
 #include "parser.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define DVL_DATA_PARSER_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define DVL_DATA_PARSER_NEON
+#endif
+
 namespace devilution {
+
+namespace {
+
+struct SeparatorBits {
+	uint64_t tabs = 0;
+	uint64_t terminators = 0;
+};
+
+#if defined(__AVX2__)
+SeparatorBits FindSeparators64(const char *src)
+{
+	const __m256i tab = _mm256_set1_epi8('\t');
+	const __m256i cr = _mm256_set1_epi8('\r');
+	const __m256i lf = _mm256_set1_epi8('\n');
+	SeparatorBits result;
+	for (unsigned i = 0; i < 2; ++i) {
+		const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 32));
+		const auto tabs = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, tab)));
+		const auto terminators = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, cr), _mm256_cmpeq_epi8(chunk, lf))));
+		result.tabs |= static_cast<uint64_t>(tabs) << (i * 32);
+		result.terminators |= static_cast<uint64_t>(terminators) << (i * 32);
+	}
+	return result;
+}
+#elif defined(DVL_DATA_PARSER_SSE2)
+SeparatorBits FindSeparators64(const char *src)
+{
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+	SeparatorBits result;
+	for (unsigned i = 0; i < 4; ++i) {
+		const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 16));
+		const auto tabs = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, tab)));
+		const auto terminators = static_cast<uint16_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf))));
+		result.tabs |= static_cast<uint64_t>(tabs) << (i * 16);
+		result.terminators |= static_cast<uint64_t>(terminators) << (i * 16);
+	}
+	return result;
+}
+#elif defined(DVL_DATA_PARSER_NEON)
+/** NEON has no movemask, so weight each lane by its bit and add the halves up. */
+uint16_t MoveMask(uint8x16_t matches)
+{
+	constexpr uint8_t Weights[16] { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	const uint8x16_t bits = vandq_u8(matches, vld1q_u8(Weights));
+	return static_cast<uint16_t>(vaddv_u8(vget_low_u8(bits)) | (vaddv_u8(vget_high_u8(bits)) << 8));
+}
+
+SeparatorBits FindSeparators64(const char *src)
+{
+	const uint8x16_t tab = vdupq_n_u8('\t');
+	const uint8x16_t cr = vdupq_n_u8('\r');
+	const uint8x16_t lf = vdupq_n_u8('\n');
+	SeparatorBits result;
+	for (unsigned i = 0; i < 4; ++i) {
+		const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(src + i * 16));
+		const uint16_t tabs = MoveMask(vceqq_u8(chunk, tab));
+		const uint16_t terminators = MoveMask(vorrq_u8(vceqq_u8(chunk, cr), vceqq_u8(chunk, lf)));
+		result.tabs |= static_cast<uint64_t>(tabs) << (i * 16);
+		result.terminators |= static_cast<uint64_t>(terminators) << (i * 16);
+	}
+	return result;
+}
+#endif
+
+SeparatorBits FindSeparatorsScalar(const char *src, size_t size)
+{
+	SeparatorBits result;
+	for (size_t i = 0; i < size; ++i) {
+		if (src[i] == '\t')
+			result.tabs |= uint64_t { 1 } << i;
+		else if (IsRecordTerminator(src[i]))
+			result.terminators |= uint64_t { 1 } << i;
+	}
+	return result;
+}
+
+} // namespace
+
+void BuildSeparatorIndex(std::string_view content, uint64_t *fieldSeparators, uint64_t *recordTerminators)
+{
+#if defined(DVL_DATA_PARSER_SSE2) || defined(DVL_DATA_PARSER_NEON)
+	const char *src = content.data();
+	const size_t size = content.size();
+	size_t word = 0;
+	for (; (word + 1) * 64 <= size; ++word) {
+		const SeparatorBits bits = FindSeparators64(src + word * 64);
+		fieldSeparators[word] = bits.tabs | bits.terminators;
+		recordTerminators[word] = bits.terminators;
+	}
+	if (word * 64 < size) {
+		const SeparatorBits bits = FindSeparatorsScalar(src + word * 64, size - word * 64);
+		fieldSeparators[word] = bits.tabs | bits.terminators;
+		recordTerminators[word] = bits.terminators;
+	}
+#else
+	BuildSeparatorIndexScalar(content, fieldSeparators, recordTerminators);
+#endif
+}
+
+void BuildSeparatorIndexScalar(std::string_view content, uint64_t *fieldSeparators, uint64_t *recordTerminators)
+{
+	for (size_t word = 0; word * 64 < content.size(); ++word) {
+		const SeparatorBits bits = FindSeparatorsScalar(content.data() + word * 64, std::min<size_t>(64, content.size() - word * 64));
+		fieldSeparators[word] = bits.tabs | bits.terminators;
+		recordTerminators[word] = bits.terminators;
+	}
+}
+
 GetFieldResult HandleRecordTerminator(const char *begin, const char *end)
 {
 	if (begin == end) {
@@ -26,13 +149,13 @@ GetFieldResult HandleRecordTerminator(const char *begin, const char *end)
 	return { begin, GetFieldResult::Status::BadRecordTerminator };
 }
 
-GetFieldResult DiscardMultipleFields(const char *begin, const char *end, unsigned skipLength, unsigned *fieldsSkipped)
+GetFieldResult DiscardMultipleFields(const char *begin, const char *end, unsigned skipLength, unsigned *fieldsSkipped, const SeparatorIndex &index)
 {
 	GetFieldResult result { begin };
 	unsigned skipCount = 0;
 	while (skipCount < skipLength) {
 		++skipCount;
-		result = DiscardField(result.next, end);
+		result = DiscardField(result.next, end, index);
 		if (result.endOfRecord()) {
 			// Found the end of record early
 			break;
@@ -44,13 +167,13 @@ GetFieldResult DiscardMultipleFields(const char *begin, const char *end, unsigne
 	return result;
 }
 
-GetFieldResult DiscardMultipleRecords(const char *begin, const char *end, unsigned skipLength, unsigned *recordsSkipped)
+GetFieldResult DiscardMultipleRecords(const char *begin, const char *end, unsigned skipLength, unsigned *recordsSkipped, const SeparatorIndex &index)
 {
 	GetFieldResult result { begin };
 	unsigned skipCount = 0;
 	while (skipCount < skipLength) {
 		++skipCount;
-		result = DiscardRemainingFields(result.next, end);
+		result = DiscardRemainingFields(result.next, end, index);
 		if (result.endOfFile()) {
 			// Found the end of file early
 			break;
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 #include "utils/is_of.hpp"
@@ -88,6 +91,88 @@ constexpr bool IsFieldSeparator(char c)
 	return c == '\t' || IsRecordTerminator(c);
 }
 
+/**
+ * @brief Precomputed positions of the separators in a data file, used to find the end of a field without scanning.
+ *
+ * Bit `i` of `fieldSeparators` is set if `base[i]` is a field separator (tab, cr or lf),
+ * bit `i` of `recordTerminators` is set if `base[i]` is part of a record terminator (cr or lf).
+ * A default constructed index is empty, in which case the find functions scan the stream instead.
+ */
+struct SeparatorIndex {
+	const char *base = nullptr;
+	const uint64_t *fieldSeparators = nullptr;
+	const uint64_t *recordTerminators = nullptr;
+
+	/**
+	 * @brief Returns the number of 64-bit words in each mask for a file of the given size
+	 */
+	static constexpr size_t maskWords(size_t size)
+	{
+		return (size + 63) / 64;
+	}
+
+	[[nodiscard]] bool empty() const
+	{
+		return base == nullptr;
+	}
+
+	/**
+	 * @brief Returns a pointer to the first field separator in [begin, end) or end if there is none
+	 */
+	[[nodiscard]] const char *findFieldSeparator(const char *begin, const char *end) const
+	{
+		if (empty())
+			return std::find_if(begin, end, IsFieldSeparator);
+		return findNextSetBit(fieldSeparators, begin, end);
+	}
+
+	/**
+	 * @brief Returns a pointer to the first record terminator character in [begin, end) or end if there is none
+	 */
+	[[nodiscard]] const char *findRecordTerminator(const char *begin, const char *end) const
+	{
+		if (empty())
+			return std::find_if(begin, end, IsRecordTerminator);
+		return findNextSetBit(recordTerminators, begin, end);
+	}
+
+private:
+	[[nodiscard]] const char *findNextSetBit(const uint64_t *mask, const char *begin, const char *end) const
+	{
+		if (begin >= end)
+			return end;
+		const size_t endPos = static_cast<size_t>(end - base);
+		const size_t lastWord = (endPos - 1) / 64;
+		size_t pos = static_cast<size_t>(begin - base);
+		size_t word = pos / 64;
+		uint64_t bits = mask[word] & (~uint64_t { 0 } << (pos % 64));
+		while (bits == 0) {
+			if (++word > lastWord)
+				return end;
+			bits = mask[word];
+		}
+		pos = word * 64 + static_cast<size_t>(std::countr_zero(bits));
+		return pos < endPos ? base + pos : end;
+	}
+};
+
+/**
+ * @brief Fills in the separator masks for the given content
+ *
+ * Scans 64 bytes per step, using SSE2/AVX2 or NEON compares where available.
+ * @param content the data file contents
+ * @param fieldSeparators destination for the field separator mask, `SeparatorIndex::maskWords(content.size())` words
+ * @param recordTerminators destination for the record terminator mask, `SeparatorIndex::maskWords(content.size())` words
+ */
+void BuildSeparatorIndex(std::string_view content, uint64_t *fieldSeparators, uint64_t *recordTerminators);
+
+/**
+ * @brief Same as `BuildSeparatorIndex`, one byte at a time
+ *
+ * Used where no vector instructions are available, and as the reference for the vectorized scan in tests.
+ */
+void BuildSeparatorIndexScalar(std::string_view content, uint64_t *fieldSeparators, uint64_t *recordTerminators);
+
 /**
  * @brief Consumes the current record terminator sequence and returns a result describing whether at least one more record is available.
  *
@@ -136,9 +221,9 @@ inline GetFieldResult HandleFieldSeparator(const char *begin, const char *end)
  * @return a GetFieldResult struct containing an empty value, a pointer to the start of the next
  *          field/record, and a status code describing what type of separator was found
  */
-inline GetFieldResult DiscardField(const char *begin, const char *end)
+inline GetFieldResult DiscardField(const char *begin, const char *end, const SeparatorIndex &index = {})
 {
-	const char *nextSeparator = std::find_if(begin, end, IsFieldSeparator);
+	const char *nextSeparator = index.findFieldSeparator(begin, end);
 
 	return HandleFieldSeparator(nextSeparator, end);
 }
@@ -153,7 +238,7 @@ inline GetFieldResult DiscardField(const char *begin, const char *end)
  * @return a GetFieldResult struct containing an empty value, a pointer to the start of the next
  *          field/record, and a status code describing what type of separator was found
  */
-GetFieldResult DiscardMultipleFields(const char *begin, const char *end, unsigned skipLength, unsigned *fieldsSkipped = nullptr);
+GetFieldResult DiscardMultipleFields(const char *begin, const char *end, unsigned skipLength, unsigned *fieldsSkipped = nullptr, const SeparatorIndex &index = {});
 
 /**
  * @brief Advances by the specified number of records or until the end of the file, whichever occurs first
@@ -165,7 +250,7 @@ GetFieldResult DiscardMultipleFields(const char *begin, const char *end, unsigne
  * @return a GetFieldResult struct containing an empty value, a pointer to the start of the next
  *          record, and a status code describing what type of separator was found
  */
-GetFieldResult DiscardMultipleRecords(const char *begin, const char *end, unsigned skipLength, unsigned *recordsSkipped = nullptr);
+GetFieldResult DiscardMultipleRecords(const char *begin, const char *end, unsigned skipLength, unsigned *recordsSkipped = nullptr, const SeparatorIndex &index = {});
 
 /**
  * @brief Discard any remaining fields in the current record
@@ -174,9 +259,9 @@ GetFieldResult DiscardMultipleRecords(const char *begin, const char *end, unsign
  * @return a GetFieldResult struct containing an empty value, the start of the next record (or
  *          `end`), and a status describing whether more records are available
  */
-inline GetFieldResult DiscardRemainingFields(const char *begin, const char *end)
+inline GetFieldResult DiscardRemainingFields(const char *begin, const char *end, const SeparatorIndex &index = {})
 {
-	const char *nextSeparator = std::find_if(begin, end, IsRecordTerminator);
+	const char *nextSeparator = index.findRecordTerminator(begin, end);
 
 	return HandleRecordTerminator(nextSeparator, end);
 }
@@ -196,9 +281,9 @@ inline GetFieldResult DiscardRemainingFields(const char *begin, const char *end)
  * @return a GetFieldResult struct containing a string_view of the field, the start of the next
  *          field/record, and a status code describing what type of separator was found
  */
-inline GetFieldResult GetNextField(const char *begin, const char *end)
+inline GetFieldResult GetNextField(const char *begin, const char *end, const SeparatorIndex &index = {})
 {
-	const char *nextSeparator = std::find_if(begin, end, IsFieldSeparator);
+	const char *nextSeparator = index.findFieldSeparator(begin, end);
 
 	// Can't use the string_view(It, It) constructor since that was only added in C++20...
 	return { { begin, static_cast<size_t>(nextSeparator - begin) }, HandleFieldSeparator(nextSeparator, end) };
@@ -41,6 +41,7 @@
 #include "discord/discord.h"
 #include "doom.h"
 #include "encrypt.h"
+#include "engine/asset_cache.hpp"
 #include "engine/backbuffer_state.hpp"
 #include "engine/clx_sprite.hpp"
 #include "engine/demomode.h"
@@ -97,9 +98,11 @@
 #include "qol/xpbar.h"
 #include "quick_messages.hpp"
 #include "restrict.h"
+#include "save_queue.hpp"
 #include "stores.h"
 #include "storm/storm_net.hpp"
 #include "storm/storm_svid.h"
+#include "tables/deferred_tables.hpp"
 #include "tables/monstdat.h"
 #include "tables/playerdat.hpp"
 #include "towners.h"
@@ -114,6 +117,7 @@
 #include "utils/screen_reader.hpp"
 #include "utils/sdl_compat.h"
 #include "utils/sdl_thread.h"
+#include "utils/startup_trace.hpp"
 #include "utils/status_macros.hpp"
 #include "utils/str_cat.hpp"
 #include "utils/utf8.hpp"
@@ -966,6 +970,7 @@ void RunGameLoop(interface_mode uMsg)
 	scrollrt_draw_game_screen();
 	previousHandler = SetEventHandler(previousHandler);
 	assert(HeadlessMode || previousHandler == GameEventHandler);
+	LogItemRecreationCacheStats("game");
 	FreeGame();
 
 	if (cineflag) {
@@ -1021,9 +1026,14 @@ extern "C" void SdlLogToFile(void *userdata, int /*category*/, SDL_LogPriority p
 	PrintHelpOption("--save-dir", _(/* TRANSLATORS: Commandline Option */ "Specify the folder of save files"));
 	PrintHelpOption("--config-dir", _(/* TRANSLATORS: Commandline Option */ "Specify the location of diablo.ini"));
 	PrintHelpOption("--lang", _(/* TRANSLATORS: Commandline Option */ "Specify the language code (e.g. en or pt_BR)"));
+#ifndef UNPACKED_MPQS
+	PrintHelpOption("--asset-cache-dir", _(/* TRANSLATORS: Commandline Option */ "Cache converted graphics in the given folder"));
+#endif
+	PrintHelpOption("--startup-trace <path>", _(/* TRANSLATORS: Commandline Option */ "Write the duration of each startup phase to a JSON file"));
 	PrintHelpOption("-n", _(/* TRANSLATORS: Commandline Option */ "Skip startup videos"));
 	PrintHelpOption("-f", _(/* TRANSLATORS: Commandline Option */ "Display frames per second"));
 	PrintHelpOption("--verbose", _(/* TRANSLATORS: Commandline Option */ "Enable verbose logging"));
+	PrintHelpOption("--net-stats <path>", _(/* TRANSLATORS: Commandline Option */ "Write the network statistics of each multiplayer game to a CSV file"));
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	PrintHelpOption("--log-to-file <path>", _(/* TRANSLATORS: Commandline Option */ "Log to a file instead of stderr"));
 #endif
@@ -1111,6 +1121,20 @@ void DiabloParseFlags(int argc, char **argv)
 				diablo_quit(64);
 			}
 			forceLocale = argv[++i];
+#ifndef UNPACKED_MPQS
+		} else if (arg == "--asset-cache-dir") {
+			if (i + 1 == argc) {
+				PrintFlagRequiresArgument("--asset-cache-dir");
+				diablo_quit(64);
+			}
+			SetAssetCacheDirectory(argv[++i]);
+#endif
+		} else if (arg == "--startup-trace") {
+			if (i + 1 == argc) {
+				PrintFlagRequiresArgument("--startup-trace");
+				diablo_quit(64);
+			}
+			InitStartupTrace(argv[++i]);
 #ifndef DISABLE_DEMOMODE
 		} else if (arg == "--demo") {
 			if (i + 1 == argc) {
@@ -1159,6 +1183,12 @@ void DiabloParseFlags(int argc, char **argv)
 			gbVanilla = true;
 		} else if (arg == "--verbose") {
 			SDL_SetLogPriorities(SDL_LOG_PRIORITY_VERBOSE);
+		} else if (arg == "--net-stats") {
+			if (i + 1 == argc) {
+				PrintFlagRequiresArgument("--net-stats");
+				diablo_quit(64);
+			}
+			SetNetStatsPath(argv[++i]);
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 		} else if (arg == "--log-to-file") {
 			if (i + 1 == argc) {
@@ -1284,7 +1314,7 @@ void DiabloInit()
 	InitializeVirtualGamepad();
 #endif
 
-	UiInitialize();
+	TraceStartupPhase("UiInitialize", UiInitialize);
 	was_ui_init = true;
 
 	if (wasHellfireDiscovered) {
@@ -1300,17 +1330,19 @@ void DiabloInit()
 
 	DiabloInitScreen();
 
-	snd_init();
+	TraceStartupPhase("snd_init", snd_init);
 
-	ui_sound_init();
+	TraceStartupPhase("ui_sound_init", ui_sound_init);
 
 	// Item graphics are loaded early, they already get touched during hero selection.
-	InitItemGFX();
+	TraceStartupPhase("InitItemGFX", InitItemGFX);
 
 	// Always available.
 	LoadSmallSelectionSpinner();
 
 	CheckArchivesUpToDate();
+
+	SetBackgroundSavesEnabled(true);
 }
 
 void DiabloSplash()
@@ -1340,6 +1372,7 @@ void DiabloSplash()
 
 void DiabloDeinit()
 {
+	FinishStartupTrace();
 	FreeItemGFX();
 
 	LuaShutdown();
@@ -1352,6 +1385,8 @@ void DiabloDeinit()
 		UiDestroy();
 	if (was_archives_init)
 		init_cleanup();
+	// Flush barrier: the hero written by init_cleanup has to reach the disk before exiting.
+	SetBackgroundSavesEnabled(false);
 	if (was_window_init)
 		dx_cleanup(); // Cleanup SDL surfaces stuff, so we have to do it before SDL_Quit().
 	UnloadFonts();
@@ -1579,6 +1614,7 @@ void TimeoutCursor(bool bTimeout)
 			InfoString = StringOrView {};
 			AddInfoBoxString(_("-- Network timeout --"));
 			AddInfoBoxString(_("-- Waiting for players --"));
+			AddInfoBoxString(FormatRuntime(_(/* TRANSLATORS: Network connectivity statistics */ "Turn delay: {:d} ms"), nthread_turn_delay_ms()));
 			for (uint8_t i = 0; i < Players.size(); i++) {
 				bool isConnected = (player_state[i] & PS_CONNECTED) != 0;
 				bool isActive = (player_state[i] & PS_ACTIVE) != 0;
@@ -2687,6 +2723,8 @@ void FreeGameMem()
 
 bool StartGame(bool bNewGame, bool bSinglePlayer)
 {
+	EnsureDeferredTablesLoaded();
+
 	gbSelectProvider = true;
 	ReturnToMainMenu = false;
 
@@ -2765,37 +2803,33 @@ int DiabloMain(int argc, char **argv)
 	InitPadmapActions();
 
 	// Need to ensure devilutionx.mpq (and fonts.mpq if available) are loaded before attempting to read translation settings
-	LoadCoreArchives();
+	TraceStartupPhase("LoadCoreArchives", LoadCoreArchives);
 	was_archives_init = true;
 
 	// Read settings including translation next. This will use the presence of fonts.mpq and look for assets in devilutionx.mpq
-	LoadOptions();
+	TraceStartupPhase("LoadOptions", LoadOptions);
 	if (demo::IsRunning()) demo::OverrideOptions();
 
 	// Then look for a voice pack file based on the selected translation
-	LoadLanguageArchive();
+	TraceStartupPhase("LoadLanguageArchive", LoadLanguageArchive);
 
-	ApplicationInit();
-	LuaInitialize();
+	TraceStartupPhase("ApplicationInit", ApplicationInit);
+	// Mods are initialized before the main menu because their archives can override its assets.
+	TraceStartupPhase("LuaInitialize", LuaInitialize);
 	if (!demo::IsRunning()) SaveOptions();
 
 	// Finally load game data
-	LoadGameArchives();
+	TraceStartupPhase("LoadGameArchives", LoadGameArchives);
 
-	LoadTextData();
+	TraceStartupPhase("LoadTextData", LoadTextData);
 
 	// Load dynamic data before we go into the menu as we need to initialise player characters in memory pretty early.
-	LoadPlayerDataFiles();
+	TraceStartupPhase("LoadPlayerDataFiles", LoadPlayerDataFiles);
 
-	// TODO: We can probably load this much later (when the game is starting).
-	LoadSpellData();
-	LoadMissileData();
-	LoadMonsterData();
-	LoadItemData();
-	LoadObjectData();
-	LoadQuestData();
+	// The remaining tables (spells, missiles, monsters, items, objects and quests) are
+	// loaded while the main menu is idle, see `EnsureDeferredTablesLoaded`.
 
-	DiabloInit();
+	TraceStartupPhase("DiabloInit", DiabloInit);
 #ifdef __UWP__
 	onInitialized();
 #endif
@@ -3494,6 +3528,7 @@ bool game_loop(bool bStartup)
 		}
 		TimeoutCursor(false);
 		GameLogic();
+		multi_flush_packets();
 		ClearLastSentPlayerCmd();
 
 		if (!gbRunGame || !gbIsMultiplayer || demo::IsRunning() || demo::IsRecording() || !nthread_has_500ms_passed())
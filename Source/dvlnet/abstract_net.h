@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "dvlnet/net_stats.hpp"
 #include "multi.h"
 #include "storm/storm_net.hpp"
 
@@ -65,6 +66,23 @@ public:
 		return {};
 	}
 
+	/**
+	 * @brief Counts a game command in the statistics of the connection it was sent over.
+	 * @param playerid The player the command was sent to or received from, `SNPLAYER_OTHERS` for all other players.
+	 */
+	virtual void record_command(uint8_t playerid, bool sent, uint8_t cmd, size_t size)
+	{
+	}
+
+	virtual void record_wait_for_turns(uint32_t ms)
+	{
+	}
+
+	virtual NetStats get_stats()
+	{
+		return {};
+	}
+
 	static std::unique_ptr<abstract_net> MakeNet(provider_t provider);
 };
 
@@ -5,6 +5,7 @@
 #include <cstring>
 #include <expected>
 #include <memory>
+#include <span>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_timer.h>
@@ -48,6 +49,54 @@ DvlNetLatencies base::get_latencies(uint8_t playerid)
 	return latencies;
 }
 
+template <typename F>
+void base::ForEachDestination(uint8_t playerId, F &&fn)
+{
+	if (playerId != SNPLAYER_OTHERS) {
+		if (playerId < MAX_PLRS && playerId != plr_self)
+			fn(stats_.peers[playerId]);
+		return;
+	}
+	for (plr_t i = 0; i < MAX_PLRS; i++) {
+		if (i != plr_self && IsConnected(i))
+			fn(stats_.peers[i]);
+	}
+}
+
+void base::record_command(uint8_t playerid, bool sent, uint8_t cmd, size_t size)
+{
+	if (sent) {
+		ForEachDestination(playerid, [&](PeerNetStats &peer) { peer.commands[cmd].sent.Add(size); });
+	} else if (playerid < MAX_PLRS && playerid != plr_self) {
+		stats_.peers[playerid].commands[cmd].received.Add(size);
+	}
+}
+
+void base::record_wait_for_turns(uint32_t ms)
+{
+	stats_.waitForTurns.Add(ms * UINT64_C(1000000));
+}
+
+NetStats base::get_stats()
+{
+	NetStats stats = stats_;
+	for (plr_t i = 0; i < MAX_PLRS; i++) {
+		PeerNetStats &peer = stats.peers[i];
+		peer.isConnected = i != plr_self && IsConnected(i);
+		peer.turnQueueDepth = static_cast<uint32_t>(playerStateTable_[i].turnQueue.size());
+	}
+	stats.messageQueueDepth = static_cast<uint32_t>(message_queue.size());
+	if (pktfty != nullptr)
+		stats.crypto = pktfty->crypto();
+	return stats;
+}
+
+void base::QueueMessage(plr_t sender, std::span<const unsigned char> message)
+{
+	message_queue.emplace_back(sender, buffer_t(message.begin(), message.end()));
+	stats_.maxMessageQueueDepth = std::max(stats_.maxMessageQueueDepth, static_cast<uint32_t>(message_queue.size()));
+}
+
 void base::RunEventHandler(_SNETEVENT &ev)
 {
 	auto f = registered_handlers[static_cast<event_type>(ev.eventid)];
@@ -122,6 +171,11 @@ std::expected<void, PacketError> base::HandleTurn(packet &pkt)
 	std::deque<turn_t> &turnQueue = playerState.turnQueue;
 	return pkt.Turn().transform([&](turn_t &&turn) {
 		turnQueue.push_back(turn);
+		if (src < MAX_PLRS) {
+			PeerNetStats &peer = stats_.peers[src];
+			peer.AddTurnArrival(SDL_GetTicks());
+			peer.maxTurnQueueDepth = std::max(peer.maxTurnQueueDepth, static_cast<uint32_t>(turnQueue.size()));
+		}
 		MakeReady(turn.SequenceNumber);
 	});
 }
@@ -215,8 +269,10 @@ std::expected<void, PacketError> base::RecvLocal(packet &pkt)
 	}
 	switch (pkt.Type()) {
 	case PT_MESSAGE:
-		return pkt.Message().transform([&](const buffer_t *message) {
-			message_queue.emplace_back(pkt.Source(), *message);
+		return pkt.Message().transform([&](std::span<const unsigned char> message) {
+			if (pkt.Source() < MAX_PLRS)
+				stats_.peers[pkt.Source()].messagesReceived.Add(message.size());
+			QueueMessage(pkt.Source(), message);
 		});
 	case PT_TURN:
 		return HandleTurn(pkt);
@@ -260,10 +316,10 @@ bool base::SNetSendMessage(uint8_t playerId, void *data, size_t size)
 {
 	if (playerId != SNPLAYER_OTHERS && playerId >= MAX_PLRS)
 		abort();
-	auto *rawMessage = reinterpret_cast<unsigned char *>(data);
-	const buffer_t message(rawMessage, rawMessage + size);
+	const std::span<const unsigned char> message(reinterpret_cast<const unsigned char *>(data), size);
 	if (playerId == plr_self)
-		message_queue.emplace_back(plr_self, message);
+		QueueMessage(plr_self, message);
+	ForEachDestination(playerId, [size](PeerNetStats &peer) { peer.messagesSent.Add(size); });
 	plr_t dest;
 	if (playerId == SNPLAYER_OTHERS)
 		dest = PLR_BROADCAST;
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <deque>
 #include <memory>
+#include <span>
 #include <string>
 
 #include <ankerl/unordered_dense.h>
@@ -42,6 +43,9 @@ public:
 	void clear_password() override;
 
 	DvlNetLatencies get_latencies(uint8_t playerid) override;
+	void record_command(uint8_t playerid, bool sent, uint8_t cmd, size_t size) override;
+	void record_wait_for_turns(uint32_t ms) override;
+	NetStats get_stats() override;
 
 	~base() override = default;
 
@@ -93,8 +97,13 @@ private:
 	std::array<PlayerState, MAX_PLRS> playerStateTable_;
 	bool awaitingSequenceNumber_ = true;
 	uint32_t lastEchoTime = 0;
+	NetStats stats_;
 
 	plr_t GetOwner();
+	void QueueMessage(plr_t sender, std::span<const unsigned char> message);
+	/** @brief Calls `fn` with the stats of each player that a message to `playerId` goes to. */
+	template <typename F>
+	void ForEachDestination(uint8_t playerId, F &&fn);
 	bool AllTurnsArrived();
 	std::expected<void, PacketError> MakeReady(seq_t sequenceNumber);
 	std::expected<void, PacketError> SendTurnIfReady(turn_t turn);
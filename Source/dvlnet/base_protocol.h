@@ -4,6 +4,7 @@
 #include <set>
 #include <string>
 #include <string_view>
+#include <utility>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_timer.h>
@@ -25,6 +26,12 @@ namespace devilution::net {
 template <class P>
 class base_protocol : public base {
 public:
+	template <typename... Args>
+	explicit base_protocol(Args &&...args)
+	    : proto(std::forward<Args>(args)...)
+	{
+	}
+
 	int create(std::string_view addrstr) override;
 	int join(std::string_view addrstr) override;
 	std::expected<void, PacketError> poll() override;
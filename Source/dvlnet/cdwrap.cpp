@@ -140,4 +140,19 @@ DvlNetLatencies cdwrap::get_latencies(uint8_t playerid)
 	return dvlnet_wrap->get_latencies(playerid);
 }
 
+void cdwrap::record_command(uint8_t playerid, bool sent, uint8_t cmd, size_t size)
+{
+	dvlnet_wrap->record_command(playerid, sent, cmd, size);
+}
+
+void cdwrap::record_wait_for_turns(uint32_t ms)
+{
+	dvlnet_wrap->record_wait_for_turns(ms);
+}
+
+NetStats cdwrap::get_stats()
+{
+	return dvlnet_wrap->get_stats();
+}
+
 } // namespace devilution::net
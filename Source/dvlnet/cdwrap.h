@@ -54,6 +54,9 @@ public:
 	void setup_password(std::string pw) override;
 	void clear_password() override;
 	DvlNetLatencies get_latencies(uint8_t playerid) override;
+	void record_command(uint8_t playerid, bool sent, uint8_t cmd, size_t size) override;
+	void record_wait_for_turns(uint32_t ms) override;
+	NetStats get_stats() override;
 
 	virtual ~cdwrap() = default;
 };
@@ -1,5 +1,7 @@
 #include "dvlnet/frame_queue.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cstring>
 
 #include "appfat.h"
@@ -20,40 +22,67 @@ PacketError FrameQueueError()
 
 } // namespace
 
-framesize_t frame_queue::Size() const
+size_t frame_queue::Size() const
 {
-	return current_size;
+	return write_pos - read_pos;
 }
 
-std::expected<buffer_t, PacketError> frame_queue::Read(framesize_t s)
+void frame_queue::Grow(size_t minFree)
 {
-	if (current_size < s)
-		return std::unexpected(FrameQueueError());
-	buffer_t ret;
-	while (s > 0 && s >= buffer_deque.front().size()) {
-		const auto bufferSize = static_cast<framesize_t>(buffer_deque.front().size());
-		s -= bufferSize;
-		current_size -= bufferSize;
-		ret.insert(ret.end(),
-		    buffer_deque.front().begin(),
-		    buffer_deque.front().end());
-		buffer_deque.pop_front();
-	}
-	if (s > 0) {
-		ret.insert(ret.end(),
-		    buffer_deque.front().begin(),
-		    buffer_deque.front().begin() + s);
-		buffer_deque.front().erase(buffer_deque.front().begin(),
-		    buffer_deque.front().begin() + s);
-		current_size -= s;
+	size_t capacity = ring.size();
+	const size_t size = Size();
+	while (capacity - size < minFree)
+		capacity *= 2;
+	if (capacity == ring.size())
+		return;
+
+	buffer_t grown(capacity);
+	Read(grown.data(), size);
+	ring = std::move(grown);
+	read_pos = 0;
+	write_pos = size;
+}
+
+void frame_queue::Read(unsigned char *out, size_t size)
+{
+	assert(size <= Size());
+	const size_t mask = ring.size() - 1;
+	const size_t start = read_pos & mask;
+	const size_t first = std::min(size, ring.size() - start);
+	std::memcpy(out, &ring[start], first);
+	std::memcpy(out + first, ring.data(), size - first);
+	read_pos += size;
+}
+
+void frame_queue::Write(std::span<const unsigned char> buf)
+{
+	Grow(buf.size());
+	const size_t mask = ring.size() - 1;
+	const size_t start = write_pos & mask;
+	const size_t first = std::min(buf.size(), ring.size() - start);
+	std::memcpy(&ring[start], buf.data(), first);
+	std::memcpy(ring.data(), buf.data() + first, buf.size() - first);
+	write_pos += buf.size();
+}
+
+std::span<unsigned char> frame_queue::WriteSpan()
+{
+	if (Size() == 0) {
+		// Start over at the beginning, so that all of the space is in one piece.
+		read_pos = 0;
+		write_pos = 0;
 	}
-	return ret;
+	Grow(1);
+	const size_t mask = ring.size() - 1;
+	const size_t start = write_pos & mask;
+	const size_t free = ring.size() - Size();
+	return { &ring[start], std::min(free, ring.size() - start) };
 }
 
-void frame_queue::Write(buffer_t buf)
+void frame_queue::CommitWrite(size_t size)
 {
-	current_size += static_cast<framesize_t>(buf.size());
-	buffer_deque.push_back(std::move(buf));
+	assert(size <= ring.size() - Size());
+	write_pos += size;
 }
 
 std::expected<bool, PacketError> frame_queue::PacketReady()
@@ -61,10 +90,9 @@ std::expected<bool, PacketError> frame_queue::PacketReady()
 	if (nextsize == 0) {
 		if (Size() < sizeof(framesize_t))
 			return false;
-		std::expected<buffer_t, PacketError> szbuf = Read(sizeof(framesize_t));
-		if (!szbuf.has_value())
-			return std::unexpected(szbuf.error());
-		nextsize = LoadLE32(szbuf->data());
+		unsigned char szbuf[sizeof(framesize_t)];
+		Read(szbuf, sizeof(szbuf));
+		nextsize = LoadLE32(szbuf);
 		if (nextsize == 0)
 			return std::unexpected(FrameQueueError());
 	}
@@ -77,27 +105,40 @@ uint16_t frame_queue::ReadPacketFlags()
 	return static_cast<uint16_t>(nextsize >> 16);
 }
 
-std::expected<buffer_t, PacketError> frame_queue::ReadPacket()
+std::expected<std::span<const unsigned char>, PacketError> frame_queue::ReadPacket()
 {
 	const framesize_t packetSize = nextsize & frame_size_mask;
 	if (nextsize == 0 || Size() < packetSize)
 		return std::unexpected(FrameQueueError());
-	std::expected<buffer_t, PacketError> ret = Read(packetSize);
 	nextsize = 0;
-	return ret;
+
+	const size_t start = read_pos & (ring.size() - 1);
+	if (start + packetSize <= ring.size()) {
+		read_pos += packetSize;
+		return std::span<const unsigned char> { &ring[start], packetSize };
+	}
+	wrapped_packet.resize(packetSize);
+	Read(wrapped_packet.data(), packetSize);
+	return std::span<const unsigned char> { wrapped_packet };
 }
 
-std::expected<buffer_t, PacketError> frame_queue::MakeFrame(buffer_t packetbuf, uint16_t flags)
+std::expected<void, PacketError> frame_queue::MakeFrame(std::span<const unsigned char> packetbuf, uint16_t flags, buffer_t &frame)
 {
-	buffer_t ret;
 	const auto size = static_cast<framesize_t>(packetbuf.size());
-	if (size > max_frame_size)
+	if (packetbuf.size() > max_frame_size)
 		return std::unexpected("Buffer exceeds maximum frame size");
 	static_assert(sizeof(size) == 4, "framesize_t is not 4 bytes");
-	unsigned char sizeBuf[4];
-	WriteLE32(sizeBuf, size | (static_cast<framesize_t>(flags) << 16));
-	ret.insert(ret.end(), sizeBuf, sizeBuf + 4);
-	ret.insert(ret.end(), packetbuf.begin(), packetbuf.end());
+	frame.resize(sizeof(size) + packetbuf.size());
+	WriteLE32(frame.data(), size | (static_cast<framesize_t>(flags) << 16));
+	std::copy(packetbuf.begin(), packetbuf.end(), frame.begin() + sizeof(size));
+	return {};
+}
+
+std::expected<buffer_t, PacketError> frame_queue::MakeFrame(std::span<const unsigned char> packetbuf, uint16_t flags)
+{
+	buffer_t ret;
+	if (std::expected<void, PacketError> result = MakeFrame(packetbuf, flags, ret); !result.has_value())
+		return std::unexpected(result.error());
 	return ret;
 }
 
@@ -1,9 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <exception>
 #include <expected>
+#include <span>
 #include <vector>
 
 #include "dvlnet/packet.h"
@@ -14,26 +15,58 @@ namespace net {
 typedef std::vector<unsigned char> buffer_t;
 typedef uint32_t framesize_t;
 
+/**
+ * @brief Splits a stream of bytes into the frames sent by `MakeFrame`.
+ *
+ * The bytes are kept in a ring buffer that only grows when more data is written than was read
+ * before, so that receiving a packet doesn't allocate.
+ */
 class frame_queue {
 public:
 	constexpr static framesize_t frame_size_mask = 0xFFFF;
 	constexpr static framesize_t max_frame_size = 0xFFFF;
 
+	/**
+	 * Room for two full frames. TCP reads at most `max_frame_size` bytes at a time and takes out all
+	 * complete packets after each read, so it never needs more than that.
+	 */
+	constexpr static size_t initial_capacity = 1 << 17;
+
 private:
-	framesize_t current_size = 0;
-	std::deque<buffer_t> buffer_deque;
+	/** The size is always a power of two. */
+	buffer_t ring = buffer_t(initial_capacity);
+	/** Positions of the next byte to read and write, wrapped around the end of the ring buffer by masking. */
+	size_t read_pos = 0;
+	size_t write_pos = 0;
 	framesize_t nextsize = 0;
+	/** Packets that wrap around the end of the ring buffer are copied here. */
+	buffer_t wrapped_packet;
 
-	framesize_t Size() const;
-	std::expected<buffer_t, PacketError> Read(framesize_t s);
+	size_t Size() const;
+	void Grow(size_t minFree);
+	void Read(unsigned char *out, size_t size);
 
 public:
 	std::expected<bool, PacketError> PacketReady();
 	uint16_t ReadPacketFlags();
-	std::expected<buffer_t, PacketError> ReadPacket();
-	void Write(buffer_t buf);
+	/**
+	 * @brief Takes the next packet out of the queue.
+	 *
+	 * The returned view is only valid until the queue is used again.
+	 */
+	std::expected<std::span<const unsigned char>, PacketError> ReadPacket();
+	void Write(std::span<const unsigned char> buf);
+
+	/**
+	 * @brief Returns free space at the end of the queue that can be written to directly.
+	 *
+	 * Call `CommitWrite` with the number of bytes actually written.
+	 */
+	std::span<unsigned char> WriteSpan();
+	void CommitWrite(size_t size);
 
-	static std::expected<buffer_t, PacketError> MakeFrame(buffer_t packetbuf, uint16_t flags = 0);
+	static std::expected<void, PacketError> MakeFrame(std::span<const unsigned char> packetbuf, uint16_t flags, buffer_t &frame);
+	static std::expected<buffer_t, PacketError> MakeFrame(std::span<const unsigned char> packetbuf, uint16_t flags = 0);
 };
 
 } // namespace net
@@ -0,0 +1,68 @@
+#include "dvlnet/net_stats.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <string>
+#include <string_view>
+
+namespace devilution::net {
+
+void PeerNetStats::AddTurnArrival(uint32_t nowMs)
+{
+	if (turnsReceived.count != 0) {
+		const uint32_t interval = nowMs - lastTurnArrival;
+		if (turnsReceived.count > 1) {
+			const auto deviation = static_cast<float>(std::abs(static_cast<int64_t>(interval) - static_cast<int64_t>(lastTurnInterval)));
+			turnJitterMs += (deviation - turnJitterMs) / 16;
+		}
+		lastTurnInterval = interval;
+	}
+	lastTurnArrival = nowMs;
+	turnsReceived.Add(sizeof(int32_t));
+}
+
+std::string FormatNetStatsCsv(const NetStats &stats, tl::function_ref<std::string_view(uint8_t)> commandName)
+{
+	std::string csv = "player,metric,command,value\n";
+	const auto appendRow = [&csv](std::string_view player, std::string_view metric, std::string_view command, auto value) {
+		csv += std::format("{},{},{},{}\n", player, metric, command, value);
+	};
+
+	appendRow("", "message_queue_max", "", stats.maxMessageQueueDepth);
+	appendRow("", "wait_for_turns_count", "", stats.waitForTurns.count);
+	appendRow("", "wait_for_turns_us", "", stats.waitForTurns.nanoseconds / 1000);
+	appendRow("", "crypto_count", "", stats.crypto.count);
+	appendRow("", "crypto_us", "", stats.crypto.nanoseconds / 1000);
+
+	for (size_t i = 0; i < stats.peers.size(); i++) {
+		const PeerNetStats &peer = stats.peers[i];
+		if (peer.messagesSent.count == 0 && peer.messagesReceived.count == 0 && peer.turnsReceived.count == 0)
+			continue;
+		const std::string player = std::to_string(i);
+		appendRow(player, "messages_sent", "", peer.messagesSent.count);
+		appendRow(player, "message_bytes_sent", "", peer.messagesSent.bytes);
+		appendRow(player, "messages_received", "", peer.messagesReceived.count);
+		appendRow(player, "message_bytes_received", "", peer.messagesReceived.bytes);
+		appendRow(player, "turns_received", "", peer.turnsReceived.count);
+		appendRow(player, "turn_jitter_ms", "", std::format("{:.1f}", peer.turnJitterMs));
+		appendRow(player, "turn_queue_max", "", peer.maxTurnQueueDepth);
+		for (size_t cmd = 0; cmd < peer.commands.size(); cmd++) {
+			const CommandTraffic &traffic = peer.commands[cmd];
+			if (traffic.sent.count == 0 && traffic.received.count == 0)
+				continue;
+			std::string_view name = commandName(static_cast<uint8_t>(cmd));
+			const std::string number = name.empty() ? std::to_string(cmd) : std::string();
+			if (name.empty())
+				name = number;
+			appendRow(player, "commands_sent", name, traffic.sent.count);
+			appendRow(player, "command_bytes_sent", name, traffic.sent.bytes);
+			appendRow(player, "commands_received", name, traffic.received.count);
+			appendRow(player, "command_bytes_received", name, traffic.received.bytes);
+		}
+	}
+	return csv;
+}
+
+} // namespace devilution::net
@@ -0,0 +1,99 @@
+/**
+ * @file net_stats.hpp
+ *
+ * Statistics of the network traffic of a game, for the FPS overlay and `--net-stats`.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <function_ref.hpp>
+
+#include "multi.h"
+
+namespace devilution::net {
+
+/** @brief Number and total size of packets or commands. */
+struct TrafficCount {
+	uint32_t count = 0;
+	uint64_t bytes = 0;
+
+	void Add(size_t size)
+	{
+		count++;
+		bytes += size;
+	}
+};
+
+/** @brief Number and total duration of operations. */
+struct TimeCount {
+	uint32_t count = 0;
+	uint64_t nanoseconds = 0;
+
+	void Add(uint64_t ns)
+	{
+		count++;
+		nanoseconds += ns;
+	}
+};
+
+/** @brief Traffic of one kind of game command (`_cmd_id`). */
+struct CommandTraffic {
+	TrafficCount sent;
+	TrafficCount received;
+};
+
+/** @brief Statistics of the connection to one other player. */
+struct PeerNetStats {
+	bool isConnected = false;
+	/** Messages as they are handed to and received from the network provider, including the packet header. */
+	TrafficCount messagesSent;
+	TrafficCount messagesReceived;
+	/** The game commands in these messages, by `_cmd_id`. */
+	std::array<CommandTraffic, 256> commands {};
+
+	TrafficCount turnsReceived;
+	/**
+	 * Mean deviation of the time between two turns from the time between the two turns before, in ms.
+	 * Uses the estimator of RFC 3550, so a single late turn fades out over about 16 turns.
+	 */
+	float turnJitterMs = 0;
+	uint32_t lastTurnArrival = 0;
+	uint32_t lastTurnInterval = 0;
+
+	/** Turns received from the player that the game didn't use yet. */
+	uint32_t turnQueueDepth = 0;
+	uint32_t maxTurnQueueDepth = 0;
+
+	void AddTurnArrival(uint32_t nowMs);
+};
+
+/** @brief Statistics of the network traffic of a game, per player where they apply to a connection. */
+struct NetStats {
+	std::array<PeerNetStats, MAX_PLRS> peers {};
+
+	/** Messages received that the game didn't process yet. */
+	uint32_t messageQueueDepth = 0;
+	uint32_t maxMessageQueueDepth = 0;
+
+	/** Time the game waited in `WaitForTurns` for the turns and level data of the other players. */
+	TimeCount waitForTurns;
+	/** Time spent encrypting and decrypting packets. */
+	TimeCount crypto;
+};
+
+/**
+ * @brief Formats the statistics as CSV with the columns `player,metric,command,value`.
+ *
+ * `player` is empty for metrics of the whole game and `command` is empty for metrics that aren't
+ * counted per command.
+ *
+ * @param commandName The name of a `_cmd_id`.
+ */
+std::string FormatNetStatsCsv(const NetStats &stats, tl::function_ref<std::string_view(uint8_t)> commandName);
+
+} // namespace devilution::net
@@ -1,13 +1,13 @@
 #include "dvlnet/packet.h"
 
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <expected>
 
 #ifdef PACKET_ENCRYPTION
 #include <sodium.h>
 #else
-#include <chrono>
 #include <random>
 #endif
 
@@ -123,12 +123,109 @@ std::expected<void, PacketError> CheckPacketTypeOneOf(std::initializer_list<pack
 
 } // namespace
 
-const buffer_t &packet::Data()
+buffer_t buffer_pool::acquire()
+{
+	if (free_buffers.empty())
+		return {};
+	buffer_t buf = std::move(free_buffers.back());
+	free_buffers.pop_back();
+	return buf;
+}
+
+void buffer_pool::release(buffer_t &&buf)
+{
+	if (buf.capacity() == 0 || free_buffers.size() >= max_buffers)
+		return;
+	buf.clear();
+	free_buffers.push_back(std::move(buf));
+}
+
+packet::~packet()
+{
+	pool.release(std::move(buffer));
+	pool.release(std::move(m_info));
+}
+
+#ifdef PACKET_ENCRYPTION
+namespace {
+
+/** @brief Adds the lifetime of the object to a `TimeCount`. */
+class CryptoTimer {
+public:
+	explicit CryptoTimer(TimeCount &time)
+	    : time_(time)
+	    , start_(std::chrono::steady_clock::now())
+	{
+	}
+
+	~CryptoTimer()
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - start_;
+		time_.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}
+
+private:
+	TimeCount &time_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace
+
+std::expected<void, PacketError> packet::EncryptPayload()
+{
+	assert(!have_encrypted && header_size == encrypted_header_size);
+	const CryptoTimer timer(crypto_time);
+	unsigned char *nonce = buffer.data();
+	unsigned char *mac = nonce + crypto_secretbox_NONCEBYTES;
+	unsigned char *payload = buffer.data() + header_size;
+	const int status = crypto_secretbox_detached(
+	    payload, mac, payload, buffer.size() - header_size, nonce, key.data());
+	if (status != 0) {
+		auto code = PacketError::ErrorCode::EncryptionFailed;
+		std::string_view message = "Failed to encrypt packet data";
+		return std::unexpected(PacketError(code, message));
+	}
+	have_encrypted = true;
+	return {};
+}
+
+std::expected<void, PacketError> packet::DecryptPayload()
 {
-	assert(have_encrypted || have_decrypted);
+	assert(have_encrypted && header_size == encrypted_header_size);
+	const CryptoTimer timer(crypto_time);
+	const unsigned char *nonce = buffer.data();
+	const unsigned char *mac = nonce + crypto_secretbox_NONCEBYTES;
+	unsigned char *payload = buffer.data() + header_size;
+	const int status = crypto_secretbox_open_detached(
+	    payload, payload, mac, buffer.size() - header_size, nonce, key.data());
+	if (status != 0) {
+		auto code = PacketError::ErrorCode::DecryptionFailed;
+		std::string_view message = "Failed to decrypt packet data";
+		return std::unexpected(PacketError(code, message));
+	}
+	have_encrypted = false;
+	return {};
+}
+#endif
+
+std::expected<void, PacketError> packet::EnsureDecrypted()
+{
+#ifdef PACKET_ENCRYPTION
 	if (have_encrypted)
-		return encrypted_buffer;
-	return decrypted_buffer;
+		return DecryptPayload();
+#endif
+	return {};
+}
+
+const buffer_t &packet::Data()
+{
+	assert(have_decrypted);
+#ifdef PACKET_ENCRYPTION
+	// Encrypting the payload again with the same nonce gives back the data that was received.
+	if (header_size != 0 && !have_encrypted && !EncryptPayload().has_value())
+		ABORT();
+#endif
+	return buffer;
 }
 
 packet_type packet::Type()
@@ -149,11 +246,12 @@ plr_t packet::Destination() const
 	return m_dest;
 }
 
-std::expected<const buffer_t *, PacketError> packet::Message()
+std::expected<std::span<const unsigned char>, PacketError> packet::Message()
 {
 	assert(have_decrypted);
 	return CheckPacketTypeOneOf({ PT_MESSAGE }, m_type)
-	    .transform([this]() { return &m_message; });
+	    .and_then([this]() { return EnsureDecrypted(); })
+	    .transform([this]() { return std::span<const unsigned char>(buffer).subspan(m_message.offset, m_message.size); });
 }
 
 std::expected<turn_t, PacketError> packet::Turn()
@@ -204,14 +302,11 @@ std::expected<void, PacketError> packet_in::Create(buffer_t buf)
 	if (buf.size() < sizeof(packet_type) + 2 * sizeof(plr_t))
 		return std::unexpected(PacketError());
 
-	decrypted_buffer = std::move(buf);
+	pool.release(std::move(buffer));
+	buffer = std::move(buf);
+	header_size = 0;
+	read_pos = 0;
 	have_decrypted = true;
-
-	// TCP server implementation forwards the original data to clients
-	// so although we are not decrypting anything,
-	// we save a copy in encrypted_buffer anyway
-	encrypted_buffer = decrypted_buffer;
-	have_encrypted = true;
 	return {};
 }
 
@@ -219,29 +314,17 @@ std::expected<void, PacketError> packet_in::Create(buffer_t buf)
 std::expected<void, PacketError> packet_in::Decrypt(buffer_t buf)
 {
 	assert(!have_encrypted && !have_decrypted);
-	encrypted_buffer = std::move(buf);
+	pool.release(std::move(buffer));
+	buffer = std::move(buf);
+	header_size = encrypted_header_size;
 	have_encrypted = true;
 
-	if (encrypted_buffer.size() < crypto_secretbox_NONCEBYTES
-	        + crypto_secretbox_MACBYTES
-	        + sizeof(packet_type) + 2 * sizeof(plr_t))
+	if (buffer.size() < encrypted_header_size + sizeof(packet_type) + 2 * sizeof(plr_t))
 		return std::unexpected(PacketError());
-	auto pktlen = (encrypted_buffer.size()
-	    - crypto_secretbox_NONCEBYTES
-	    - crypto_secretbox_MACBYTES);
-	decrypted_buffer.resize(pktlen);
-	const int status = crypto_secretbox_open_easy(
-	    decrypted_buffer.data(),
-	    encrypted_buffer.data() + crypto_secretbox_NONCEBYTES,
-	    encrypted_buffer.size() - crypto_secretbox_NONCEBYTES,
-	    encrypted_buffer.data(),
-	    key.data());
-	if (status != 0) {
-		auto code = PacketError::ErrorCode::DecryptionFailed;
-		std::string_view message = "Failed to decrypt packet data";
-		return std::unexpected(PacketError(code, message));
-	}
+	if (std::expected<void, PacketError> result = DecryptPayload(); !result.has_value())
+		return result;
 
+	read_pos = header_size;
 	have_decrypted = true;
 	return {};
 }
@@ -250,31 +333,13 @@ std::expected<void, PacketError> packet_in::Decrypt(buffer_t buf)
 #ifdef PACKET_ENCRYPTION
 std::expected<void, PacketError> packet_out::Encrypt()
 {
-	assert(have_decrypted);
+	assert(have_decrypted && header_size == encrypted_header_size);
 
 	if (have_encrypted)
 		return {};
 
-	auto lenCleartext = decrypted_buffer.size();
-	encrypted_buffer.insert(encrypted_buffer.begin(),
-	    crypto_secretbox_NONCEBYTES, 0);
-	encrypted_buffer.insert(encrypted_buffer.end(),
-	    crypto_secretbox_MACBYTES + lenCleartext, 0);
-	randombytes_buf(encrypted_buffer.data(), crypto_secretbox_NONCEBYTES);
-	const int status = crypto_secretbox_easy(
-	    encrypted_buffer.data() + crypto_secretbox_NONCEBYTES,
-	    decrypted_buffer.data(),
-	    lenCleartext,
-	    encrypted_buffer.data(),
-	    key.data());
-	if (status != 0) {
-		auto code = PacketError::ErrorCode::EncryptionFailed;
-		std::string_view message = "Failed to encrypt packet data";
-		return std::unexpected(PacketError(code, message));
-	}
-
-	have_encrypted = true;
-	return {};
+	randombytes_buf(buffer.data(), crypto_secretbox_NONCEBYTES);
+	return EncryptPayload();
 }
 #endif
 
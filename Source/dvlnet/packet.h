@@ -5,8 +5,10 @@
 #include <cstring>
 #include <expected>
 #include <memory>
+#include <span>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #ifdef PACKET_ENCRYPTION
 #include <sodium.h>
@@ -15,6 +17,7 @@
 #include "appfat.h"
 #include "dvlnet/abstract_net.h"
 #include "dvlnet/leaveinfo.hpp"
+#include "dvlnet/net_stats.hpp"
 #include "utils/attributes.h"
 #include "utils/endian_read.hpp"
 #include "utils/endian_write.hpp"
@@ -146,12 +149,42 @@ inline PacketError IoHandlerError(std::string message)
 PacketError PacketTypeError(std::uint8_t unknownPacketType);
 PacketError PacketTypeError(std::initializer_list<packet_type> expectedTypes, std::uint8_t actual);
 
+/** @brief Keeps the storage of buffers that are no longer needed, so that it can be used for the next packets. */
+class buffer_pool {
+public:
+	/** @brief Returns an empty buffer, reusing the storage of a released buffer if there is one. */
+	buffer_t acquire();
+	void release(buffer_t &&buf);
+
+private:
+	static constexpr size_t max_buffers = 64;
+
+	std::vector<buffer_t> free_buffers;
+};
+
+/** @brief A part of the buffer of a packet. */
+struct buffer_range {
+	size_t offset = 0;
+	size_t size = 0;
+};
+
+#ifdef PACKET_ENCRYPTION
+/** Encrypted packets start with the nonce and the MAC, followed by the encrypted payload. */
+constexpr size_t encrypted_header_size = crypto_secretbox_NONCEBYTES + crypto_secretbox_MACBYTES;
+#endif
+
+/**
+ * @brief A packet together with its data as it is sent.
+ *
+ * The data is kept in a single pooled buffer. Encrypted packets are encrypted and decrypted in
+ * place, the buffer holds either the encrypted or the decrypted payload at any time.
+ */
 class packet {
 protected:
 	packet_type m_type;
 	plr_t m_src;
 	plr_t m_dest;
-	buffer_t m_message;
+	buffer_range m_message;
 	turn_t m_turn;
 	cookie_t m_cookie;
 	plr_t m_newplr;
@@ -160,21 +193,47 @@ protected:
 	leaveinfo_t m_leaveinfo;
 
 	const key_t &key;
-	bool have_encrypted = false;
+	buffer_pool &pool;
+	/** Time spent encrypting and decrypting, shared by the packets of a factory. */
+	TimeCount &crypto_time;
+	/** Whether the fields above are set. */
 	bool have_decrypted = false;
-	buffer_t encrypted_buffer;
-	buffer_t decrypted_buffer;
+	/** Whether the payload in `buffer` is currently encrypted. */
+	bool have_encrypted = false;
+	/** Size of the nonce and MAC in front of the payload, 0 for packets that are not encrypted. */
+	size_t header_size = 0;
+	buffer_t buffer;
+
+#ifdef PACKET_ENCRYPTION
+	std::expected<void, PacketError> EncryptPayload();
+	std::expected<void, PacketError> DecryptPayload();
+#endif
+	std::expected<void, PacketError> EnsureDecrypted();
 
 public:
-	packet(const key_t &k)
-	    : key(k) {};
+	packet(const key_t &k, buffer_pool &p, TimeCount &t)
+	    : key(k)
+	    , pool(p)
+	    , crypto_time(t)
+	    , buffer(p.acquire())
+	{
+	}
 
+	virtual ~packet();
+
+	/**
+	 * @brief The packet as it is sent.
+	 *
+	 * A received packet that was decrypted is encrypted again for this, which gives back the
+	 * received data. This invalidates the views returned by `Message`.
+	 */
 	const buffer_t &Data();
 
 	packet_type Type();
 	plr_t Source() const;
 	plr_t Destination() const;
-	std::expected<const buffer_t *, PacketError> Message();
+	/** @brief The message, a view into the packet's buffer that is valid until `Data` is called. */
+	std::expected<std::span<const unsigned char>, PacketError> Message();
 	std::expected<turn_t, PacketError> Turn();
 	std::expected<cookie_t, PacketError> Cookie();
 	std::expected<plr_t, PacketError> NewPlayer();
@@ -191,23 +250,42 @@ public:
 };
 
 class packet_in : public packet_proc<packet_in> {
+	/** Position of the next field in `buffer`. */
+	size_t read_pos = 0;
+
 public:
 	using packet_proc<packet_in>::packet_proc;
 	std::expected<void, PacketError> Create(buffer_t buf);
 	std::expected<void, PacketError> process_element(buffer_t &x);
+	std::expected<void, PacketError> process_element(buffer_range &x);
 	template <class T>
 	std::expected<void, PacketError> process_element(T &x);
 	std::expected<void, PacketError> Decrypt(buffer_t buf);
 };
 
 class packet_out : public packet_proc<packet_out> {
+	/** The message of a `PT_MESSAGE` packet, only valid until the packet is created. */
+	std::span<const unsigned char> message_data;
+
+	void Append(std::span<const unsigned char> data)
+	{
+		buffer.insert(buffer.end(), data.begin(), data.end());
+	}
+
 public:
-	using packet_proc<packet_out>::packet_proc;
+	/** @param headerSize Room to leave in front of the payload for encryption. */
+	packet_out(const key_t &k, buffer_pool &p, TimeCount &t, size_t headerSize)
+	    : packet_proc<packet_out>(k, p, t)
+	{
+		header_size = headerSize;
+		buffer.resize(header_size);
+	}
 
 	template <packet_type t, typename... Args>
 	void create(Args... args);
 
 	std::expected<void, PacketError> process_element(buffer_t &x);
+	std::expected<void, PacketError> process_element(buffer_range &x);
 	template <class T>
 	std::expected<void, PacketError> process_element(const T &x);
 	static cookie_t GenerateCookie();
@@ -262,8 +340,17 @@ std::expected<void, PacketError> packet_proc<P>::process_data()
 
 inline std::expected<void, PacketError> packet_in::process_element(buffer_t &x)
 {
-	x.insert(x.begin(), decrypted_buffer.begin(), decrypted_buffer.end());
-	decrypted_buffer.resize(0);
+	if (x.capacity() == 0)
+		x = pool.acquire();
+	x.insert(x.begin(), buffer.begin() + read_pos, buffer.end());
+	read_pos = buffer.size();
+	return {};
+}
+
+inline std::expected<void, PacketError> packet_in::process_element(buffer_range &x)
+{
+	x = { read_pos, buffer.size() - read_pos };
+	read_pos = buffer.size();
 	return {};
 }
 
@@ -272,18 +359,18 @@ std::expected<void, PacketError> packet_in::process_element(T &x)
 {
 	static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "Unsupported T");
 	static_assert(sizeof(T) == 4 || sizeof(T) == 2 || sizeof(T) == 1, "Unsupported T");
-	if (decrypted_buffer.size() < sizeof(T)) {
+	if (buffer.size() - read_pos < sizeof(T)) {
 		return std::unexpected(PacketError());
 	}
+	const unsigned char *data = buffer.data() + read_pos;
 	if (sizeof(T) == 4) {
-		x = static_cast<T>(LoadLE32(decrypted_buffer.data()));
+		x = static_cast<T>(LoadLE32(data));
 	} else if (sizeof(T) == 2) {
-		x = static_cast<T>(LoadLE16(decrypted_buffer.data()));
+		x = static_cast<T>(LoadLE16(data));
 	} else if (sizeof(T) == 1) {
-		std::memcpy(&x, decrypted_buffer.data(), sizeof(T));
+		std::memcpy(&x, data, sizeof(T));
 	}
-	decrypted_buffer.erase(decrypted_buffer.begin(),
-	    decrypted_buffer.begin() + sizeof(T));
+	read_pos += sizeof(T);
 	return {};
 }
 
@@ -311,7 +398,7 @@ inline void packet_out::create<PT_INFO_REPLY>(plr_t s, plr_t d, buffer_t i)
 }
 
 template <>
-inline void packet_out::create<PT_MESSAGE>(plr_t s, plr_t d, buffer_t m)
+inline void packet_out::create<PT_MESSAGE>(plr_t s, plr_t d, std::span<const unsigned char> m)
 {
 	if (have_encrypted || have_decrypted)
 		ABORT();
@@ -319,7 +406,7 @@ inline void packet_out::create<PT_MESSAGE>(plr_t s, plr_t d, buffer_t m)
 	m_type = PT_MESSAGE;
 	m_src = s;
 	m_dest = d;
-	m_message = std::move(m);
+	message_data = m;
 }
 
 template <>
@@ -428,7 +515,15 @@ inline void packet_out::create<PT_ECHO_REPLY>(plr_t s, plr_t d, timestamp_t t)
 
 inline std::expected<void, PacketError> packet_out::process_element(buffer_t &x)
 {
-	decrypted_buffer.insert(decrypted_buffer.end(), x.begin(), x.end());
+	Append(x);
+	return {};
+}
+
+inline std::expected<void, PacketError> packet_out::process_element(buffer_range &x)
+{
+	x = { buffer.size(), message_data.size() };
+	Append(message_data);
+	message_data = {};
 	return {};
 }
 
@@ -444,7 +539,7 @@ std::expected<void, PacketError> packet_out::process_element(const T &x)
 		} else {
 			WriteLE32(buf, x);
 		}
-		decrypted_buffer.insert(decrypted_buffer.end(), buf, buf + 4);
+		Append(buf);
 	} else if (sizeof(T) == 2) {
 		unsigned char buf[2];
 		if constexpr (std::is_enum<T>::value) {
@@ -452,9 +547,9 @@ std::expected<void, PacketError> packet_out::process_element(const T &x)
 		} else {
 			WriteLE16(buf, x);
 		}
-		decrypted_buffer.insert(decrypted_buffer.end(), buf, buf + 2);
+		Append(buf);
 	} else if (sizeof(T) == 1) {
-		decrypted_buffer.push_back(static_cast<unsigned char>(x));
+		buffer.push_back(static_cast<unsigned char>(x));
 	}
 	return {};
 }
@@ -462,20 +557,37 @@ std::expected<void, PacketError> packet_out::process_element(const T &x)
 class packet_factory {
 	key_t key = {};
 	bool secure;
+	buffer_pool pool;
+	TimeCount crypto_time;
 
 public:
 	static constexpr unsigned short max_packet_size = 0xFFFF;
 
 	packet_factory();
 	packet_factory(std::string pw);
-	std::expected<std::unique_ptr<packet>, PacketError> make_packet(buffer_t buf);
+	/** @brief Creates a packet from received data, the packet takes over the buffer and decrypts it in place. */
+	std::expected<std::unique_ptr<packet>, PacketError> make_packet(buffer_t &&buf);
+	/** @brief Creates a packet from received data, the data is copied into a pooled buffer. */
+	std::expected<std::unique_ptr<packet>, PacketError> make_packet(std::span<const unsigned char> buf);
 	template <packet_type t, typename... Args>
 	std::expected<std::unique_ptr<packet>, PacketError> make_packet(Args... args);
+
+	/** @brief Buffers of packets created by this factory are returned here once the packets are destroyed. */
+	buffer_pool &buffers()
+	{
+		return pool;
+	}
+
+	/** @brief Time spent encrypting and decrypting the packets of this factory. */
+	const TimeCount &crypto() const
+	{
+		return crypto_time;
+	}
 };
 
-inline std::expected<std::unique_ptr<packet>, PacketError> packet_factory::make_packet(buffer_t buf)
+inline std::expected<std::unique_ptr<packet>, PacketError> packet_factory::make_packet(buffer_t &&buf)
 {
-	auto ret = std::make_unique<packet_in>(key);
+	auto ret = std::make_unique<packet_in>(key, pool, crypto_time);
 #ifndef PACKET_ENCRYPTION
 	std::expected<void, PacketError> isCreated = ret->Create(std::move(buf));
 #else
@@ -492,10 +604,21 @@ inline std::expected<std::unique_ptr<packet>, PacketError> packet_factory::make_
 	return ret;
 }
 
+inline std::expected<std::unique_ptr<packet>, PacketError> packet_factory::make_packet(std::span<const unsigned char> buf)
+{
+	buffer_t pooled = pool.acquire();
+	pooled.assign(buf.begin(), buf.end());
+	return make_packet(std::move(pooled));
+}
+
 template <packet_type t, typename... Args>
 std::expected<std::unique_ptr<packet>, PacketError> packet_factory::make_packet(Args... args)
 {
-	auto ret = std::make_unique<packet_out>(key);
+#ifdef PACKET_ENCRYPTION
+	auto ret = std::make_unique<packet_out>(key, pool, crypto_time, secure ? encrypted_header_size : 0);
+#else
+	auto ret = std::make_unique<packet_out>(key, pool, crypto_time, 0);
+#endif
 	ret->create<t>(args...);
 	if (const std::expected<void, PacketError> result = ret->process_data(); !result.has_value()) {
 		return std::unexpected(result.error());
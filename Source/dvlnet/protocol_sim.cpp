@@ -0,0 +1,257 @@
+#include "dvlnet/protocol_sim.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <expected>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "dvlnet/base_protocol.h"
+#include "utils/stubs.h"
+
+namespace devilution::net {
+
+namespace {
+
+/** After this many losses in a row a game packet gets through, so a loss rate of 1 can't stall a test forever. */
+constexpr int MaxRetransmissions = 8;
+
+std::pair<uint8_t, uint8_t> ConnectionKey(uint8_t a, uint8_t b)
+{
+	return std::minmax(a, b);
+}
+
+} // namespace
+
+protocol_sim::protocol_sim(sim_network &network)
+    : network_(network)
+{
+	self_.id = network_.Attach();
+}
+
+void protocol_sim::disconnect(const endpoint &peer)
+{
+	if (peer)
+		network_.Disconnect(self_.id, peer.id);
+}
+
+std::expected<void, PacketError> protocol_sim::send(const endpoint &peer, const buffer_t &data)
+{
+	if (!peer)
+		return std::unexpected("Invalid simulated endpoint");
+	network_.Send(self_.id, peer.id, data, /*reliable=*/true);
+	return {};
+}
+
+bool protocol_sim::send_oob(const endpoint &peer, const buffer_t &data) const
+{
+	if (!peer)
+		return false;
+	network_.Send(self_.id, peer.id, data, /*reliable=*/false);
+	return true;
+}
+
+bool protocol_sim::send_oob_mc(const buffer_t &data) const
+{
+	for (size_t i = 1; i <= network_.nodes_.size(); ++i) {
+		const auto id = static_cast<uint8_t>(i);
+		if (id != self_.id)
+			network_.Send(self_.id, id, data, /*reliable=*/false);
+	}
+	return true;
+}
+
+bool protocol_sim::recv(endpoint &peer, buffer_t &data)
+{
+	return network_.Receive(self_.id, peer.id, data);
+}
+
+bool protocol_sim::get_disconnected(endpoint &peer)
+{
+	std::deque<uint8_t> &disconnected = network_.GetNode(self_.id).disconnected;
+	if (disconnected.empty())
+		return false;
+	peer.id = disconnected.front();
+	disconnected.pop_front();
+	return true;
+}
+
+std::expected<bool, PacketError> protocol_sim::network_online()
+{
+	return true;
+}
+
+std::expected<bool, PacketError> protocol_sim::peers_ready()
+{
+	return true;
+}
+
+bool protocol_sim::is_peer_connected(endpoint & /*peer*/)
+{
+	// There is no handshake to get wrong, so either side may start it.
+	return true;
+}
+
+std::optional<bool> protocol_sim::is_peer_relayed(const endpoint & /*peer*/) const
+{
+	return false;
+}
+
+std::optional<int> protocol_sim::get_latency_to(const endpoint &peer) const
+{
+	if (!peer)
+		return std::nullopt;
+	return static_cast<int>(network_.GetNode(self_.id).conditions.latencyMs + network_.GetNode(peer.id).conditions.latencyMs);
+}
+
+std::string protocol_sim::make_default_gamename()
+{
+	return "sim";
+}
+
+sim_network::sim_network(uint64_t seed)
+    : rng_(seed)
+{
+}
+
+sim_network::~sim_network() = default;
+
+abstract_net &sim_network::AddPeer()
+{
+	std::unique_ptr<abstract_net> peer = std::make_unique<base_protocol<protocol_sim>>(*this);
+	peer->clear_password();
+	Node &node = nodes_.back();
+	node.net = std::move(peer);
+	return *node.net;
+}
+
+void sim_network::SetConditions(const LinkConditions &conditions)
+{
+	for (Node &node : nodes_)
+		node.conditions = conditions;
+}
+
+void sim_network::SetConditions(size_t peer, const LinkConditions &conditions)
+{
+	nodes_[peer].conditions = conditions;
+}
+
+void sim_network::Advance(uint32_t ms)
+{
+	now_ += ms;
+}
+
+uint8_t sim_network::Attach()
+{
+	if (nodes_.size() == UINT8_MAX)
+		ABORT();
+	nodes_.emplace_back();
+	return static_cast<uint8_t>(nodes_.size());
+}
+
+sim_network::Node &sim_network::GetNode(uint8_t id)
+{
+	return nodes_[id - 1];
+}
+
+const sim_network::Node &sim_network::GetNode(uint8_t id) const
+{
+	return nodes_[id - 1];
+}
+
+bool sim_network::Chance(float rate)
+{
+	// Rates of 0 don't use up random numbers, so turning one condition on doesn't change the others.
+	if (rate <= 0)
+		return false;
+	if (rate >= 1)
+		return true;
+	return rng_.next() < static_cast<double>(rate) * 4294967296.0;
+}
+
+void sim_network::Send(uint8_t from, uint8_t to, const buffer_t &data, bool reliable)
+{
+	Node &sender = GetNode(from);
+	const LinkConditions &conditions = sender.conditions;
+	stats_.packetsSent++;
+	stats_.bytesSent += data.size();
+
+	uint32_t uploaded = now_;
+	if (conditions.bytesPerSecond != 0) {
+		const uint32_t uploadTime = static_cast<uint32_t>(data.size() * 1000 / conditions.bytesPerSecond);
+		sender.uploadFreeAt = std::max(now_, sender.uploadFreeAt) + uploadTime;
+		uploaded = sender.uploadFreeAt;
+	}
+	uint32_t arrival = uploaded + conditions.latencyMs;
+	if (conditions.jitterMs != 0)
+		arrival += rng_.next() % (conditions.jitterMs + 1);
+
+	if (reliable) {
+		connections_.insert(ConnectionKey(from, to));
+		uint32_t timeout = conditions.retransmitTimeoutMs;
+		for (int i = 0; i < MaxRetransmissions && Chance(conditions.lossRate); ++i) {
+			arrival += timeout;
+			timeout *= 2;
+			stats_.retransmissions++;
+		}
+		// Like TCP, a packet that arrives early waits for the ones sent before it.
+		if (!Chance(conditions.reorderRate)) {
+			uint32_t &lastArrival = lastArrival_[{ from, to }];
+			arrival = std::max(arrival, lastArrival);
+			lastArrival = arrival;
+		}
+	} else if (Chance(conditions.lossRate)) {
+		stats_.packetsDropped++;
+		return;
+	}
+
+	GetNode(to).inbox.emplace(arrival, InFlight { from, now_, data });
+}
+
+bool sim_network::Receive(uint8_t self, uint8_t &sender, buffer_t &data)
+{
+	Node &node = GetNode(self);
+	if (node.inbox.empty() || node.inbox.begin()->first > now_)
+		PollOthers(self);
+	if (node.inbox.empty() || node.inbox.begin()->first > now_)
+		return false;
+
+	auto it = node.inbox.begin();
+	stats_.packetsDelivered++;
+	stats_.maxDelayMs = std::max(stats_.maxDelayMs, it->first - it->second.sentAt);
+	sender = it->second.sender;
+	data = std::move(it->second.data);
+	node.inbox.erase(it);
+	return true;
+}
+
+void sim_network::Disconnect(uint8_t self, uint8_t peer)
+{
+	if (connections_.erase(ConnectionKey(self, peer)) == 0)
+		return;
+
+	// Whatever was still in flight is lost with the connection.
+	std::erase_if(GetNode(peer).inbox, [self](const auto &entry) { return entry.second.sender == self; });
+	std::erase_if(GetNode(self).inbox, [peer](const auto &entry) { return entry.second.sender == peer; });
+	lastArrival_.erase({ self, peer });
+	lastArrival_.erase({ peer, self });
+	GetNode(peer).disconnected.push_back(self);
+}
+
+void sim_network::PollOthers(uint8_t self)
+{
+	if (polling_)
+		return;
+	polling_ = true;
+	for (size_t i = 0; i < nodes_.size(); ++i) {
+		Node &node = nodes_[i];
+		if (i + 1 != self && node.net != nullptr)
+			node.net->process_network_packets();
+	}
+	polling_ = false;
+}
+
+} // namespace devilution::net
@@ -0,0 +1,200 @@
+/**
+ * @file protocol_sim.h
+ *
+ * In-process network with configurable link conditions, for testing multiplayer without sockets.
+ *
+ * Each peer is a `base_protocol<protocol_sim>`, so peers talk to each other through the same
+ * peer-to-peer logic as ZeroTier games. Time only moves when `sim_network::Advance` is called and
+ * all random choices come from the seed, so a run can be repeated exactly.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dvlnet/abstract_net.h"
+#include "dvlnet/packet.h"
+#include "engine/random.hpp"
+
+namespace devilution::net {
+
+/** @brief Conditions of the packets sent by a peer. */
+struct LinkConditions {
+	/** One-way delay of every packet. */
+	uint32_t latencyMs = 0;
+	/** Up to this much delay is added at random to each packet. */
+	uint32_t jitterMs = 0;
+	/** Upload rate of the peer, 0 means unlimited. */
+	uint32_t bytesPerSecond = 0;
+	/**
+	 * Chance that a packet is lost, from 0 to 1.
+	 *
+	 * Game packets go over a reliable connection, so a lost one is sent again after `retransmitTimeoutMs`,
+	 * which doubles with each further loss. Out of band packets are dropped.
+	 */
+	float lossRate = 0;
+	uint32_t retransmitTimeoutMs = 200;
+	/** Chance that a packet isn't held back behind the packets sent before it, from 0 to 1. */
+	float reorderRate = 0;
+};
+
+struct SimNetworkStats {
+	size_t packetsSent = 0;
+	size_t bytesSent = 0;
+	size_t packetsDelivered = 0;
+	/** Game packets that had to be sent again. */
+	size_t retransmissions = 0;
+	/** Out of band packets that were lost. */
+	size_t packetsDropped = 0;
+	/** The longest a packet took from being sent to being delivered. */
+	uint32_t maxDelayMs = 0;
+};
+
+class sim_network;
+
+/** @brief The transport of a peer on a `sim_network`, this is the protocol of `base_protocol`. */
+class protocol_sim {
+public:
+	class endpoint {
+	public:
+		/** The index of the peer plus one, 0 is no peer. */
+		uint8_t id = 0;
+
+		explicit operator bool() const
+		{
+			return id != 0;
+		}
+
+		bool operator==(const endpoint &rhs) const
+		{
+			return id == rhs.id;
+		}
+
+		bool operator!=(const endpoint &rhs) const
+		{
+			return !(*this == rhs);
+		}
+
+		bool operator<(const endpoint &rhs) const
+		{
+			return id < rhs.id;
+		}
+
+		buffer_t serialize() const
+		{
+			return buffer_t { id };
+		}
+
+		std::expected<void, PacketError> unserialize(const buffer_t &buf)
+		{
+			if (buf.size() != 1 || buf[0] == 0)
+				return std::unexpected("Invalid simulated endpoint");
+			id = buf[0];
+			return {};
+		}
+	};
+
+	explicit protocol_sim(sim_network &network);
+
+	void disconnect(const endpoint &peer);
+	std::expected<void, PacketError> send(const endpoint &peer, const buffer_t &data);
+	bool send_oob(const endpoint &peer, const buffer_t &data) const;
+	bool send_oob_mc(const buffer_t &data) const;
+	bool recv(endpoint &peer, buffer_t &data);
+	bool get_disconnected(endpoint &peer);
+	std::expected<bool, PacketError> network_online();
+	std::expected<bool, PacketError> peers_ready();
+	bool is_peer_connected(endpoint &peer);
+	std::optional<bool> is_peer_relayed(const endpoint &peer) const;
+	std::optional<int> get_latency_to(const endpoint &peer) const;
+	static std::string make_default_gamename();
+
+private:
+	sim_network &network_;
+	endpoint self_;
+};
+
+/**
+ * @brief Peers that are connected by simulated links.
+ *
+ * Peers join through `base_protocol`, which waits for replies in a loop, so peers are polled
+ * whenever another peer has nothing to receive. Since the clock doesn't move on its own, joining
+ * only completes over links without delay: set the link conditions once all peers have joined.
+ */
+class sim_network {
+public:
+	explicit sim_network(uint64_t seed);
+	~sim_network();
+
+	sim_network(const sim_network &) = delete;
+	sim_network &operator=(const sim_network &) = delete;
+
+	/** @brief Adds a peer that can create or join a game. The peer lives as long as the network. */
+	abstract_net &AddPeer();
+
+	/** @brief Sets the conditions of the packets sent by all peers. */
+	void SetConditions(const LinkConditions &conditions);
+
+	/** @brief Sets the conditions of the packets sent by the peer that was added `peer`th. */
+	void SetConditions(size_t peer, const LinkConditions &conditions);
+
+	void Advance(uint32_t ms);
+
+	[[nodiscard]] uint32_t Now() const
+	{
+		return now_;
+	}
+
+	[[nodiscard]] const SimNetworkStats &Stats() const
+	{
+		return stats_;
+	}
+
+private:
+	friend class protocol_sim;
+
+	struct InFlight {
+		uint8_t sender;
+		uint32_t sentAt;
+		buffer_t data;
+	};
+
+	struct Node {
+		std::unique_ptr<abstract_net> net;
+		LinkConditions conditions;
+		/** When the upload of the packets sent so far is done. */
+		uint32_t uploadFreeAt = 0;
+		/** Packets by delivery time, packets with the same time stay in the order they were sent. */
+		std::multimap<uint32_t, InFlight> inbox;
+		std::deque<uint8_t> disconnected;
+	};
+
+	uint8_t Attach();
+	Node &GetNode(uint8_t id);
+	const Node &GetNode(uint8_t id) const;
+	bool Chance(float rate);
+	void Send(uint8_t from, uint8_t to, const buffer_t &data, bool reliable);
+	bool Receive(uint8_t self, uint8_t &sender, buffer_t &data);
+	void Disconnect(uint8_t self, uint8_t peer);
+	void PollOthers(uint8_t self);
+
+	xoshiro128plusplus rng_;
+	uint32_t now_ = 0;
+	bool polling_ = false;
+	SimNetworkStats stats_;
+	std::vector<Node> nodes_;
+	/** Connections as (smaller id, larger id), a connection is opened by the first game packet. */
+	std::set<std::pair<uint8_t, uint8_t>> connections_;
+	/** When the last packet that was kept in order arrives on each link, by (sender, receiver). */
+	std::map<std::pair<uint8_t, uint8_t>, uint32_t> lastArrival_;
+};
+
+} // namespace devilution::net
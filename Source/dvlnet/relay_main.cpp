@@ -0,0 +1,218 @@
+/**
+ * @file relay_main.cpp
+ *
+ * Entry point of `devilutionx-relay`, a headless server for TCP games.
+ *
+ * The relay only forwards packets between players, it doesn't load any game data or run the game.
+ */
+#define SDL_MAIN_HANDLED
+
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <asio/signal_set.hpp>
+#include <asio/ts/io_context.hpp>
+
+#include <config.h>
+
+#include "appfat.h"
+#include "dvlnet/relay_server.hpp"
+#include "utils/console.h"
+#include "utils/log.hpp"
+#include "utils/parse_int.hpp"
+#include "utils/sdl_compat.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+// The relay has no UI, so fatal errors are only logged.
+
+[[noreturn]] void DisplayFatalErrorAndExit(std::string_view title, std::string_view body)
+{
+	LogCritical("{}: {}", title, body);
+	std::exit(1);
+}
+
+[[noreturn]] void app_fatal(std::string_view str)
+{
+	LogCritical("{}", str);
+	std::exit(1);
+}
+
+#ifdef _DEBUG
+[[noreturn]] void assert_fail(int nLineNo, const char *pszFile, const char *pszFail)
+{
+	LogCritical("Assertion failed in {}:{}: {}", pszFile, nLineNo, pszFail);
+	std::exit(1);
+}
+#endif
+
+[[noreturn]] void ErrDlg(const char *title, std::string_view error, std::string_view logFilePath, int logLineNr)
+{
+	LogCritical("{}: {} @ {}:{}", title, error, logFilePath, logLineNr);
+	std::exit(1);
+}
+
+namespace {
+
+void PrintHelpOption(std::string_view flags, std::string_view description)
+{
+	printInConsole(StrCat("    ", flags, std::string(flags.size() < 24 ? 24 - flags.size() : 1, ' '), description));
+	printNewlineInConsole();
+}
+
+[[noreturn]] void PrintHelpAndExit()
+{
+	printInConsole("Usage: devilutionx-relay [options]");
+	printNewlineInConsole();
+	PrintHelpOption("-h, --help", "Print this message and exit");
+	PrintHelpOption("--version", "Print the version and exit");
+	PrintHelpOption("--bind <address>", "Address to listen on (default 0.0.0.0)");
+	PrintHelpOption("--port <port>", "Port of the first game (default 6112)");
+	PrintHelpOption("--games <n>", "Number of games, each one on the next port (default 1)");
+	PrintHelpOption("--threads <n>", "Number of threads (default one per CPU core)");
+	PrintHelpOption("--password <password>", "Password of the games (default none, as public games)");
+	PrintHelpOption("--verbose", "Enable verbose logging");
+	printNewlineInConsole();
+	printInConsole("Game settings:");
+	printNewlineInConsole();
+	PrintHelpOption("--spawn", "Host Shareware games");
+	PrintHelpOption("--difficulty <n>", "0 = Normal, 1 = Nightmare, 2 = Hell");
+	PrintHelpOption("--tick-rate <n>", "Gameplay ticks per second (default 20)");
+	PrintHelpOption("--run-in-town", "Enable running in town");
+	PrintHelpOption("--theo-quest", "Enable the Little Girl quest");
+	PrintHelpOption("--cow-quest", "Enable Jersey's quest");
+	PrintHelpOption("--no-friendly-fire", "Disable damage between players");
+	PrintHelpOption("--full-quests", "Enable the full singleplayer version of quests");
+	std::exit(0);
+}
+
+template <typename IntT>
+IntT ParseFlagValue(int argc, char **argv, int &i, IntT min, IntT max)
+{
+	const std::string_view flag = argv[i];
+	if (i + 1 == argc) {
+		printInConsole(StrCat(flag, " requires an argument"));
+		printNewlineInConsole();
+		std::exit(64);
+	}
+	const std::string_view value = argv[++i];
+	const ParseIntResult<IntT> result = ParseInt<IntT>(value, min, max);
+	if (!result.has_value()) {
+		printInConsole(StrCat("Invalid value for ", flag, ": ", value));
+		printNewlineInConsole();
+		std::exit(64);
+	}
+	return *result;
+}
+
+std::string_view FlagArgument(int argc, char **argv, int &i)
+{
+	if (i + 1 == argc) {
+		printInConsole(StrCat(argv[i], " requires an argument"));
+		printNewlineInConsole();
+		std::exit(64);
+	}
+	return argv[++i];
+}
+
+net::RelayOptions ParseFlags(int argc, char **argv)
+{
+	net::RelayOptions options;
+	bool spawn = false;
+	bool runInTown = false;
+	bool theoQuest = false;
+	bool cowQuest = false;
+	bool friendlyFire = true;
+	bool fullQuests = false;
+	uint8_t difficulty = DIFF_NORMAL;
+	uint8_t tickRate = 20;
+	for (int i = 1; i < argc; i++) {
+		const std::string_view arg = argv[i];
+		if (arg == "-h" || arg == "--help") {
+			PrintHelpAndExit();
+		} else if (arg == "--version") {
+			printInConsole(StrCat(PROJECT_NAME, " relay v", PROJECT_VERSION));
+			printNewlineInConsole();
+			std::exit(0);
+		} else if (arg == "--bind") {
+			options.bindAddress = FlagArgument(argc, argv, i);
+		} else if (arg == "--port") {
+			options.firstPort = ParseFlagValue<unsigned short>(argc, argv, i, 1, 65535);
+		} else if (arg == "--games") {
+			options.numGames = ParseFlagValue<size_t>(argc, argv, i, 1, 4096);
+		} else if (arg == "--threads") {
+			options.numThreads = ParseFlagValue<size_t>(argc, argv, i, 0, 256);
+		} else if (arg == "--password") {
+			options.password.emplace(FlagArgument(argc, argv, i));
+		} else if (arg == "--verbose") {
+			SDL_SetLogPriorities(SDL_LOG_PRIORITY_VERBOSE);
+		} else if (arg == "--spawn") {
+			spawn = true;
+		} else if (arg == "--difficulty") {
+			difficulty = ParseFlagValue<uint8_t>(argc, argv, i, DIFF_NORMAL, DIFF_LAST);
+		} else if (arg == "--tick-rate") {
+			tickRate = ParseFlagValue<uint8_t>(argc, argv, i, 1, 255);
+		} else if (arg == "--run-in-town") {
+			runInTown = true;
+		} else if (arg == "--theo-quest") {
+			theoQuest = true;
+		} else if (arg == "--cow-quest") {
+			cowQuest = true;
+		} else if (arg == "--no-friendly-fire") {
+			friendlyFire = false;
+		} else if (arg == "--full-quests") {
+			fullQuests = true;
+		} else {
+			printInConsole(StrCat("unrecognized option '", arg, "'"));
+			printNewlineInConsole();
+			PrintHelpAndExit();
+		}
+	}
+	if (static_cast<size_t>(options.firstPort) + options.numGames > 65536) {
+		printInConsole("Not enough ports for all games");
+		printNewlineInConsole();
+		std::exit(64);
+	}
+
+	GameData &settings = options.gameSettings;
+	settings = net::DefaultRelayGameSettings(spawn);
+	settings.nDifficulty = static_cast<_difficulty>(difficulty);
+	settings.nTickRate = tickRate;
+	settings.bRunInTown = runInTown ? 1 : 0;
+	settings.bTheoQuest = theoQuest ? 1 : 0;
+	settings.bCowQuest = cowQuest ? 1 : 0;
+	settings.bFriendlyFire = friendlyFire ? 1 : 0;
+	settings.fullQuests = fullQuests ? 1 : 0;
+	return options;
+}
+
+} // namespace
+
+} // namespace devilution
+
+int main(int argc, char **argv)
+{
+	using namespace devilution;
+
+	const net::RelayOptions options = ParseFlags(argc, argv);
+	net::RelayServer relay(options);
+	const std::vector<unsigned short> ports = relay.Ports();
+	LogInfo("Listening on {} ports {}-{}", options.bindAddress, ports.front(), ports.back());
+	relay.Start();
+
+	asio::io_context signalContext;
+	asio::signal_set signals(signalContext, SIGINT, SIGTERM);
+	signals.async_wait([](const asio::error_code & /*ec*/, int signal) {
+		LogInfo("Received signal {}, shutting down", signal);
+	});
+	signalContext.run();
+
+	relay.Stop();
+	return 0;
+}
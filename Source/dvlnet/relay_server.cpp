@@ -0,0 +1,150 @@
+#include "dvlnet/relay_server.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <expected>
+#include <random>
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_cpuinfo.h>
+#else
+#include <SDL.h>
+#endif
+
+#include <config.h>
+
+#include "diablo.h"
+#include "utils/endian_swap.hpp"
+#include "utils/log.hpp"
+
+namespace devilution::net {
+
+namespace {
+
+size_t GetCpuCount()
+{
+#if defined(USE_SDL1)
+	return 1;
+#elif defined(USE_SDL3)
+	return static_cast<size_t>(std::max(SDL_GetNumLogicalCPUCores(), 1));
+#else
+	return static_cast<size_t>(std::max(SDL_GetCPUCount(), 1));
+#endif
+}
+
+} // namespace
+
+GameData DefaultRelayGameSettings(bool spawn)
+{
+	GameData settings {};
+	settings.size = sizeof(GameData);
+	settings.isSpawn = spawn ? 1 : 0;
+	settings.programid = spawn ? GameIdDiabloSpawn : GameIdDiabloFull;
+	settings.versionMajor = PROJECT_VERSION_MAJOR;
+	settings.versionMinor = PROJECT_VERSION_MINOR;
+	settings.versionPatch = PROJECT_VERSION_PATCH;
+	settings.nDifficulty = DIFF_NORMAL;
+	settings.nTickRate = 20;
+	settings.bRunInTown = 0;
+	settings.bTheoQuest = 0;
+	settings.bCowQuest = 0;
+	settings.bFriendlyFire = 1;
+	settings.fullQuests = 0;
+	return settings;
+}
+
+RelayServer::Worker::Worker(const std::optional<std::string> &password)
+    : work(asio::make_work_guard(ioc))
+    , pktfty(password ? packet_factory(*password) : packet_factory())
+    , errorCheckTimer(ioc)
+{
+}
+
+RelayServer::RelayServer(const RelayOptions &options)
+    : gameSettings_(options.gameSettings)
+{
+	const size_t numThreads = std::min(options.numThreads != 0 ? options.numThreads : GetCpuCount(), std::max<size_t>(options.numGames, 1));
+	for (size_t i = 0; i < numThreads; ++i)
+		workers_.push_back(std::make_unique<Worker>(options.password));
+
+	for (size_t i = 0; i < options.numGames; ++i) {
+		Worker &worker = *workers_[i % workers_.size()];
+		const auto port = static_cast<unsigned short>(options.firstPort != 0 ? options.firstPort + i : 0);
+		auto game = std::make_unique<tcp_server>(worker.ioc, options.bindAddress, port, worker.pktfty);
+		game->SetGameInfoFactory([this]() { return MakeGameInfo(); });
+		game->KeepAcceptingOnError();
+		games_.push_back(game.get());
+		worker.games.push_back(std::move(game));
+	}
+	LogInfo("Relaying {} games on {} threads", games_.size(), workers_.size());
+}
+
+RelayServer::~RelayServer()
+{
+	Stop();
+}
+
+void RelayServer::Start()
+{
+	for (const std::unique_ptr<Worker> &worker : workers_) {
+		StartErrorCheck(*worker);
+		worker->thread = SdlThread(RunWorker, worker.get());
+	}
+}
+
+void RelayServer::Stop()
+{
+	for (const std::unique_ptr<Worker> &worker : workers_)
+		worker->ioc.stop();
+	for (const std::unique_ptr<Worker> &worker : workers_)
+		worker->thread.join();
+}
+
+std::vector<unsigned short> RelayServer::Ports() const
+{
+	std::vector<unsigned short> ports;
+	ports.reserve(games_.size());
+	for (const tcp_server *game : games_)
+		ports.push_back(game->Port());
+	return ports;
+}
+
+int SDLCALL RelayServer::RunWorker(void *data)
+{
+	static_cast<Worker *>(data)->ioc.run();
+	return 0;
+}
+
+void RelayServer::StartErrorCheck(Worker &worker)
+{
+	worker.errorCheckTimer.expires_after(std::chrono::seconds(1));
+	worker.errorCheckTimer.async_wait([&worker](const asio::error_code &ec) {
+		if (ec)
+			return;
+		for (const std::unique_ptr<tcp_server> &game : worker.games) {
+			if (std::expected<void, PacketError> result = game->CheckIoHandlerError(); !result.has_value())
+				LogError("Game on port {}: {}", game->Port(), result.error().what());
+		}
+		StartErrorCheck(worker);
+	});
+}
+
+buffer_t RelayServer::MakeGameInfo() const
+{
+	GameData gameData = gameSettings_;
+	std::random_device randomDevice;
+	for (uint32_t &seed : gameData.gameSeed)
+		seed = randomDevice();
+	// Same as `GameData::swapLE`, the game info is sent in little-endian.
+	gameData.size = SwapSigned32LE(static_cast<int32_t>(sizeof(GameData)));
+	gameData.programid = Swap32LE(gameData.programid);
+	for (uint32_t &seed : gameData.gameSeed)
+		seed = Swap32LE(seed);
+
+	buffer_t info(sizeof(GameData));
+	std::memcpy(info.data(), &gameData, sizeof(GameData));
+	return info;
+}
+
+} // namespace devilution::net
@@ -0,0 +1,87 @@
+/**
+ * @file relay_server.hpp
+ *
+ * Headless server that hosts TCP games without taking part in them.
+ *
+ * Each game is a `tcp_server` on its own port, since the protocol has no way for a client to pick
+ * a game on a shared port. The games are spread over one `asio::io_context` per worker thread.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <asio/executor_work_guard.hpp>
+#include <asio/ts/io_context.hpp>
+
+#include "dvlnet/packet.h"
+#include "dvlnet/tcp_server.h"
+#include "multi.h"
+#include "utils/sdl_thread.h"
+
+namespace devilution::net {
+
+struct RelayOptions {
+	std::string bindAddress = "0.0.0.0";
+	/** The games listen on consecutive ports starting at this one, 0 lets the system pick a free port for each game. */
+	unsigned short firstPort = 6112;
+	size_t numGames = 1;
+	/** 0 means one thread per logical CPU core. */
+	size_t numThreads = 0;
+	std::optional<std::string> password;
+	/** Settings of every game, the seed is chosen anew whenever a game starts. */
+	GameData gameSettings;
+};
+
+/** @brief Settings for games that players of this version can join. */
+GameData DefaultRelayGameSettings(bool spawn);
+
+class RelayServer {
+public:
+	explicit RelayServer(const RelayOptions &options);
+	~RelayServer();
+
+	RelayServer(const RelayServer &) = delete;
+	RelayServer &operator=(const RelayServer &) = delete;
+
+	/** @brief Starts a thread for each worker and returns right away. */
+	void Start();
+
+	/** @brief Stops the workers and waits for their threads to finish. Safe to call from any thread. */
+	void Stop();
+
+	/** @brief The ports of the games, in the order of the games. */
+	[[nodiscard]] std::vector<unsigned short> Ports() const;
+
+	[[nodiscard]] size_t NumWorkers() const
+	{
+		return workers_.size();
+	}
+
+private:
+	struct Worker {
+		asio::io_context ioc;
+		asio::executor_work_guard<asio::io_context::executor_type> work;
+		packet_factory pktfty;
+		asio::steady_timer errorCheckTimer;
+		std::vector<std::unique_ptr<tcp_server>> games;
+		SdlThread thread;
+
+		explicit Worker(const std::optional<std::string> &password);
+	};
+
+	static int SDLCALL RunWorker(void *data);
+	static void StartErrorCheck(Worker &worker);
+
+	buffer_t MakeGameInfo() const;
+
+	GameData gameSettings_;
+	std::vector<std::unique_ptr<Worker>> workers_;
+	/** Game `i` is run by worker `i % workers_.size()`, these are the games in that order. */
+	std::vector<tcp_server *> games_;
+};
+
+} // namespace devilution::net
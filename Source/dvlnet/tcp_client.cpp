@@ -1,12 +1,17 @@
 #include "dvlnet/tcp_client.h"
 
+#include <chrono>
+#include <cstdint>
 #include <exception>
 #include <expected>
 #include <format>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <stdexcept>
 #include <system_error>
+#include <utility>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_error.h>
@@ -16,6 +21,8 @@
 #endif
 
 #include <asio/connect.hpp>
+#include <asio/post.hpp>
+#include <asio/write.hpp>
 
 #include "options.h"
 #include "utils/language.h"
@@ -27,7 +34,8 @@ namespace devilution::net {
 int tcp_client::create(std::string_view addrstr)
 {
 	auto port = *GetOptions().Network.port;
-	local_server = std::make_unique<tcp_server>(ioc, std::string(addrstr), port, *pktfty);
+	server_pktfty = std::make_unique<packet_factory>(*pktfty);
+	local_server = std::make_unique<tcp_server>(ioc, std::string(addrstr), port, *server_pktfty);
 	return join(local_server->LocalhostSelf());
 }
 
@@ -87,6 +95,7 @@ int tcp_client::join(std::string_view addrstr)
 		LogError("Client error setting socket option: {}", errorCode.message());
 
 	StartReceive();
+	io_thread = SdlThread(RunIoThread, this);
 	{
 		cookie_self = packet_out::GenerateCookie();
 		std::expected<std::unique_ptr<packet>, PacketError> pkt
@@ -131,19 +140,41 @@ bool tcp_client::IsGameHost()
 
 std::expected<void, PacketError> tcp_client::poll()
 {
-	while (ioc.poll_one() > 0) {
-		if (IsGameHost()) {
-			std::expected<void, PacketError> serverResult = local_server->CheckIoHandlerError();
-			if (!serverResult.has_value())
-				return serverResult;
-		}
-		if (ioHandlerResult == std::nullopt)
-			continue;
-		std::expected<void, PacketError> packetError = std::unexpected(*ioHandlerResult);
-		ioHandlerResult = std::nullopt;
-		return packetError;
+	while (buffer_t *frame = received_frames.Front()) {
+		// Swapping in a pooled buffer hands the data to the packet without copying it.
+		buffer_t data = pktfty->buffers().acquire();
+		std::swap(data, *frame);
+		received_frames.Pop();
+		std::expected<void, PacketError> result
+		    = pktfty->make_packet(std::move(data))
+		          .and_then([this](std::unique_ptr<packet> &&pkt) { return RecvLocal(*pkt); });
+		if (!result.has_value())
+			return result;
 	}
-	return {};
+	if (IsGameHost()) {
+		std::expected<void, PacketError> serverResult = local_server->CheckIoHandlerError();
+		if (!serverResult.has_value())
+			return serverResult;
+	}
+	const std::lock_guard<SdlMutex> lock(ioHandlerMutex);
+	if (ioHandlerResult == std::nullopt)
+		return {};
+	std::expected<void, PacketError> packetError = std::unexpected(*ioHandlerResult);
+	ioHandlerResult = std::nullopt;
+	return packetError;
+}
+
+int SDLCALL tcp_client::RunIoThread(void *data)
+{
+	static_cast<tcp_client *>(data)->ioc.run();
+	return 0;
+}
+
+void tcp_client::StopIoThread()
+{
+	work.reset();
+	ioc.stop();
+	io_thread.join();
 }
 
 void tcp_client::HandleReceive(const asio::error_code &error, size_t bytesRead)
@@ -158,9 +189,12 @@ void tcp_client::HandleReceive(const asio::error_code &error, size_t bytesRead)
 		RaiseIoHandlerError(packetError);
 		return;
 	}
-	recv_buffer.resize(bytesRead);
-	recv_queue.Write(std::move(recv_buffer));
-	recv_buffer.resize(frame_queue::max_frame_size);
+	recv_queue.CommitWrite(bytesRead);
+	DeliverFrames();
+}
+
+void tcp_client::DeliverFrames()
+{
 	while (true) {
 		std::expected<bool, PacketError> ready = recv_queue.PacketReady();
 		if (!ready.has_value()) {
@@ -173,40 +207,70 @@ void tcp_client::HandleReceive(const asio::error_code &error, size_t bytesRead)
 			HandleTcpErrorCode();
 			return;
 		}
-		std::expected<void, PacketError> result
-		    = recv_queue.ReadPacket()
-		          .and_then([this](buffer_t &&pktData) { return pktfty->make_packet(pktData); })
-		          .and_then([this](std::unique_ptr<packet> &&pkt) { return RecvLocal(*pkt); });
-		if (!result.has_value()) {
-			RaiseIoHandlerError(result.error());
+		buffer_t *frame = received_frames.BackSlot();
+		if (frame == nullptr) {
+			// The game is busy with a long frame. Reading stops until it catches up, TCP slows down the server meanwhile.
+			receive_retry_timer.expires_after(std::chrono::milliseconds(1));
+			receive_retry_timer.async_wait([this](const asio::error_code &error) {
+				if (!error)
+					DeliverFrames();
+			});
+			return;
+		}
+		std::expected<std::span<const unsigned char>, PacketError> pktData = recv_queue.ReadPacket();
+		if (!pktData.has_value()) {
+			RaiseIoHandlerError(pktData.error());
 			return;
 		}
+		frame->assign(pktData->begin(), pktData->end());
+		received_frames.Push();
 	}
 	StartReceive();
 }
 
 void tcp_client::StartReceive()
 {
+	const std::span<unsigned char> recvSpan = recv_queue.WriteSpan();
 	sock.async_receive(
-	    asio::buffer(recv_buffer),
+	    asio::buffer(recvSpan.data(), recvSpan.size()),
 	    std::bind(&tcp_client::HandleReceive, this, std::placeholders::_1, std::placeholders::_2));
 }
 
+void tcp_client::StartSend()
+{
+	if (sending)
+		return;
+	buffer_t *frame = send_frames.Front();
+	if (frame == nullptr)
+		return;
+	// One write at a time, so that the frames can't interleave on the socket.
+	sending = true;
+	asio::async_write(sock, asio::buffer(*frame),
+	    std::bind(&tcp_client::HandleSend, this, std::placeholders::_1, std::placeholders::_2));
+}
+
 void tcp_client::HandleSend(const asio::error_code &error, size_t /*bytesSent*/)
 {
+	sending = false;
+	{
+		const std::lock_guard<SdlMutex> lock(sendMutex);
+		send_frames.Pop();
+	}
+	frameSent.signal();
 	if (error)
 		RaiseIoHandlerError(error.message());
+	StartSend();
 }
 
 void tcp_client::HandleTcpErrorCode()
 {
-	std::expected<buffer_t, PacketError> packet = recv_queue.ReadPacket();
+	std::expected<std::span<const unsigned char>, PacketError> packet = recv_queue.ReadPacket();
 	if (!packet.has_value()) {
 		RaiseIoHandlerError(packet.error());
 		return;
 	}
 
-	buffer_t pktData = *packet;
+	const std::span<const unsigned char> pktData = *packet;
 	if (pktData.size() != 1) {
 		RaiseIoHandlerError(PacketError());
 		return;
@@ -221,17 +285,32 @@ void tcp_client::HandleTcpErrorCode()
 
 std::expected<void, PacketError> tcp_client::send(packet &pkt)
 {
-	std::expected<buffer_t, PacketError> frame = frame_queue::MakeFrame(pkt.Data());
-	if (!frame.has_value())
-		return std::unexpected(frame.error());
-	std::unique_ptr<buffer_t> framePtr = std::make_unique<buffer_t>(*frame);
-	const asio::mutable_buffer buf = asio::buffer(*framePtr);
-	asio::async_write(sock, buf, [this, frame = std::move(framePtr)](const asio::error_code &error, size_t bytesSent) {
-		HandleSend(error, bytesSent);
-	});
+	buffer_t *frame = send_frames.BackSlot();
+	if (frame == nullptr) {
+		// The network thread writes as fast as the socket takes the frames, this only waits for TCP.
+		const std::lock_guard<SdlMutex> lock(sendMutex);
+		const uint32_t deadline = SDL_GetTicks() + send_timeout_ms;
+		while ((frame = send_frames.BackSlot()) == nullptr) {
+			if (!WaitForSentFrame(deadline))
+				return std::unexpected("The send queue is full");
+		}
+	}
+	if (std::expected<void, PacketError> result = frame_queue::MakeFrame(pkt.Data(), 0, *frame); !result.has_value())
+		return result;
+	send_frames.Push();
+	asio::post(ioc, [this]() { StartSend(); });
 	return {};
 }
 
+bool tcp_client::WaitForSentFrame(uint32_t deadline)
+{
+	const uint32_t now = SDL_GetTicks();
+	if (now >= deadline)
+		return false;
+	frameSent.waitFor(sendMutex, deadline - now);
+	return true;
+}
+
 void tcp_client::DisconnectNet(plr_t plr)
 {
 	if (local_server != nullptr)
@@ -240,11 +319,19 @@ void tcp_client::DisconnectNet(plr_t plr)
 
 bool tcp_client::SNetLeaveGame(net::leaveinfo_t type)
 {
+	constexpr uint32_t MaxWaitMs = 100;
+
 	auto ret = base::SNetLeaveGame(type);
+	// Gives the network thread the time to send the goodbye, the game may be torn down right after.
+	if (io_thread.joinable()) {
+		const std::lock_guard<SdlMutex> lock(sendMutex);
+		const uint32_t deadline = SDL_GetTicks() + MaxWaitMs;
+		while (!send_frames.Empty() && WaitForSentFrame(deadline)) { }
+	}
 	process_network_packets();
 	if (local_server != nullptr)
 		local_server->Close();
-	sock.close();
+	asio::post(ioc, [this]() { sock.close(); });
 	return ret;
 }
 
@@ -255,10 +342,13 @@ std::string tcp_client::make_default_gamename()
 
 void tcp_client::RaiseIoHandlerError(const PacketError &error)
 {
+	const std::lock_guard<SdlMutex> lock(ioHandlerMutex);
 	ioHandlerResult.emplace(error);
 }
 
 tcp_client::~tcp_client()
-    = default;
+{
+	StopIoThread();
+}
 
 } // namespace devilution::net
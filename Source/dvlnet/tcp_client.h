@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
+#include <asio/executor_work_guard.hpp>
 #include <asio/ts/buffer.hpp>
 #include <asio/ts/internet.hpp>
 #include <asio/ts/io_context.hpp>
@@ -13,9 +17,20 @@
 #include "dvlnet/frame_queue.h"
 #include "dvlnet/packet.h"
 #include "dvlnet/tcp_server.h"
+#include "utils/sdl_cond.h"
+#include "utils/sdl_mutex.h"
+#include "utils/sdl_thread.h"
+#include "utils/spsc_queue.hpp"
 
 namespace devilution::net {
 
+/**
+ * @brief Connects to a TCP game, and hosts it when it is created here.
+ *
+ * The socket and the hosted server are run by a network thread, so the server relays the packets
+ * of the other players no matter how long the game takes for a frame. Frames are handed between
+ * the game thread and the network thread through lock-free queues.
+ */
 class tcp_client : public base {
 public:
 	int create(std::string_view addrstr) override;
@@ -35,19 +50,51 @@ protected:
 	bool IsGameHost() override;
 
 private:
+	/** Enough for the packets of a few turns, the producer waits for the consumer when it is full. */
+	static constexpr size_t frame_queue_capacity = 256;
+	/** How long `send` waits for a full `send_frames` before it gives up on the frame. */
+	static constexpr uint32_t send_timeout_ms = 1000;
+
+	/** Only used on the network thread. */
 	frame_queue recv_queue;
-	buffer_t recv_buffer = buffer_t(frame_queue::max_frame_size);
+	/** Frames from the server, from the network thread to `poll`. */
+	SpscQueue<buffer_t, frame_queue_capacity> received_frames;
+	/** Frames from `send`, from the game thread to the network thread. */
+	SpscQueue<buffer_t, frame_queue_capacity> send_frames;
+	/** Whether the network thread is writing the first frame of `send_frames`. */
+	bool sending = false;
+	/** Guards popping `send_frames`, so that the game thread can sleep until a frame was sent. */
+	SdlMutex sendMutex;
+	/** Signalled by the network thread after each frame of `send_frames` it wrote. */
+	SdlCondition frameSent;
 
 	asio::io_context ioc;
+	asio::executor_work_guard<asio::io_context::executor_type> work = asio::make_work_guard(ioc);
 	asio::ip::tcp::resolver resolver = asio::ip::tcp::resolver(ioc);
 	asio::ip::tcp::socket sock = asio::ip::tcp::socket(ioc);
+	asio::steady_timer receive_retry_timer = asio::steady_timer(ioc);
+	/** The server has its own packet factory, since the one of the game isn't thread-safe. */
+	std::unique_ptr<packet_factory> server_pktfty;
 	std::unique_ptr<tcp_server> local_server; // must be declared *after* ioc
+	SdlThread io_thread;
 
+	/** Raised on the network thread and checked in `poll`. */
+	SdlMutex ioHandlerMutex;
 	std::optional<PacketError> ioHandlerResult;
 
+	static int SDLCALL RunIoThread(void *data);
+	void StopIoThread();
+
 	void HandleReceive(const asio::error_code &error, size_t bytesRead);
 	void StartReceive();
+	void DeliverFrames();
+	void StartSend();
 	void HandleSend(const asio::error_code &error, size_t bytesSent);
+	/**
+	 * @brief Sleeps until the network thread sent a frame, `sendMutex` must be locked.
+	 * @return false once `deadline` (in `SDL_GetTicks` time) has passed.
+	 */
+	bool WaitForSentFrame(uint32_t deadline);
 	void HandleTcpErrorCode();
 
 	void RaiseIoHandlerError(const PacketError &error);
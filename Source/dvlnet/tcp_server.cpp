@@ -4,28 +4,33 @@
 #include <expected>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <utility>
 
-#include "dvlnet/base.h"
-#include "player.h"
+#include <asio/post.hpp>
+
 #include "utils/log.hpp"
 
 namespace devilution::net {
 
 tcp_server::tcp_server(asio::io_context &ioc, const std::string &bindaddr,
     unsigned short port, packet_factory &pktfty)
-    : ioc(ioc)
+    : strand(asio::make_strand(ioc))
     , pktfty(pktfty)
+    , acceptRetryTimer(strand)
 {
 	auto addr = asio::ip::make_address(bindaddr);
 	auto ep = asio::ip::tcp::endpoint(addr, port);
-	acceptor = std::make_unique<asio::ip::tcp::acceptor>(ioc, ep, true);
+	acceptor = std::make_unique<asio::ip::tcp::acceptor>(strand, ep, true);
+	// Kept, so that it can be read while the strand uses the acceptor.
+	local_endpoint = acceptor->local_endpoint();
 	StartAccept();
 }
 
-std::string tcp_server::LocalhostSelf()
+std::string tcp_server::LocalhostSelf() const
 {
-	auto addr = acceptor->local_endpoint().address();
+	auto addr = local_endpoint.address();
 	if (addr.is_unspecified()) {
 		if (addr.is_v4()) {
 			return asio::ip::address_v4::loopback().to_string();
@@ -38,14 +43,29 @@ std::string tcp_server::LocalhostSelf()
 	return addr.to_string();
 }
 
+unsigned short tcp_server::Port() const
+{
+	return local_endpoint.port();
+}
+
+void tcp_server::SetGameInfoFactory(std::function<buffer_t()> factory)
+{
+	game_init_info_factory = std::move(factory);
+}
+
+void tcp_server::KeepAcceptingOnError()
+{
+	keepAcceptingOnError = true;
+}
+
 tcp_server::scc tcp_server::MakeConnection()
 {
-	return std::make_shared<client_connection>(ioc);
+	return std::make_shared<client_connection>(strand);
 }
 
 plr_t tcp_server::NextFree()
 {
-	for (plr_t i = 0; i < Players.size(); ++i)
+	for (plr_t i = 0; i < MAX_PLRS; ++i)
 		if (!connections[i])
 			return i;
 	return PLR_BROADCAST;
@@ -53,7 +73,7 @@ plr_t tcp_server::NextFree()
 
 bool tcp_server::Empty()
 {
-	for (plr_t i = 0; i < Players.size(); ++i)
+	for (plr_t i = 0; i < MAX_PLRS; ++i)
 		if (connections[i])
 			return false;
 	return true;
@@ -61,8 +81,9 @@ bool tcp_server::Empty()
 
 void tcp_server::StartReceive(const scc &con)
 {
+	const std::span<unsigned char> recvSpan = con->recv_queue.WriteSpan();
 	con->socket.async_receive(
-	    asio::buffer(con->recv_buffer),
+	    asio::buffer(recvSpan.data(), recvSpan.size()),
 	    std::bind(&tcp_server::HandleReceive, this, con, std::placeholders::_1, std::placeholders::_2));
 }
 
@@ -73,9 +94,7 @@ void tcp_server::HandleReceive(const scc &con, const asio::error_code &ec,
 		DropConnection(con);
 		return;
 	}
-	con->recv_buffer.resize(bytesRead);
-	con->recv_queue.Write(std::move(con->recv_buffer));
-	con->recv_buffer.resize(frame_queue::max_frame_size);
+	con->recv_queue.CommitWrite(bytesRead);
 	while (true) {
 		std::expected<bool, PacketError> ready = con->recv_queue.PacketReady();
 		if (!ready.has_value()) {
@@ -85,7 +104,7 @@ void tcp_server::HandleReceive(const scc &con, const asio::error_code &ec,
 		}
 		if (!*ready)
 			break;
-		std::expected<buffer_t, PacketError> pktData = con->recv_queue.ReadPacket();
+		std::expected<std::span<const unsigned char>, PacketError> pktData = con->recv_queue.ReadPacket();
 		if (!pktData.has_value()) {
 			Log("ReadPacket: {}", pktData.error().what());
 			DropConnection(con);
@@ -108,7 +127,7 @@ void tcp_server::HandleReceive(const scc &con, const asio::error_code &ec,
 			}
 		} else {
 			con->timeout = timeout_active;
-			std::expected<void, PacketError> result = HandleReceivePacket(**pkt);
+			std::expected<void, PacketError> result = HandleReceivePacket(con, **pkt, *pktData);
 			if (!result.has_value()) {
 				Log("Network error: {}", result.error().what());
 				DropConnection(con);
@@ -125,14 +144,16 @@ std::expected<void, PacketError> tcp_server::HandleReceiveNewPlayer(const scc &c
 	if (newplr == PLR_BROADCAST)
 		return std::unexpected(ServerError());
 
-	if (Empty()) {
+	if (Empty() && game_init_info_factory) {
+		game_init_info = game_init_info_factory();
+	} else if (Empty()) {
 		std::expected<const buffer_t *, PacketError> pktInfo = inPkt.Info();
 		if (!pktInfo.has_value())
 			return std::unexpected(pktInfo.error());
 		game_init_info = **pktInfo;
 	}
 
-	for (plr_t player = 0; player < Players.size(); player++) {
+	for (plr_t player = 0; player < MAX_PLRS; player++) {
 		if (connections[player]) {
 			std::expected<void, PacketError> result
 			    = pktfty.make_packet<PT_CONNECT>(PLR_MASTER, PLR_BROADCAST, newplr)
@@ -156,18 +177,34 @@ std::expected<void, PacketError> tcp_server::HandleReceiveNewPlayer(const scc &c
 	return {};
 }
 
-std::expected<void, PacketError> tcp_server::HandleReceivePacket(packet &pkt)
+std::expected<void, PacketError> tcp_server::HandleReceivePacket(const scc &con, packet &pkt, std::span<const unsigned char> pktData)
 {
-	return SendPacket(pkt);
+	if (pkt.Type() == PT_ECHO_REQUEST && pkt.Destination() == PLR_MASTER)
+		return HandleEchoRequest(con, pkt);
+	// Forward the data as it was received, so that it doesn't have to be encrypted again.
+	return SendPacket(pkt, pktData);
+}
+
+std::expected<void, PacketError> tcp_server::HandleEchoRequest(const scc &con, packet &pkt)
+{
+	// Lets a client measure its latency to the server itself.
+	return pkt.Time()
+	    .and_then([&](timestamp_t &&pktTime) { return pktfty.make_packet<PT_ECHO_REPLY>(PLR_MASTER, con->plr, pktTime); })
+	    .and_then([&](std::unique_ptr<packet> &&reply) { return StartSend(con, *reply); });
 }
 
 std::expected<void, PacketError> tcp_server::SendPacket(packet &pkt)
+{
+	return SendPacket(pkt, pkt.Data());
+}
+
+std::expected<void, PacketError> tcp_server::SendPacket(packet &pkt, std::span<const unsigned char> pktData)
 {
 	if (pkt.Destination() == PLR_BROADCAST) {
-		for (size_t i = 0; i < Players.size(); ++i) {
+		for (size_t i = 0; i < MAX_PLRS; ++i) {
 			if (i == pkt.Source() || !connections[i])
 				continue;
-			std::expected<void, PacketError> result = StartSend(connections[i], pkt);
+			std::expected<void, PacketError> result = StartSend(connections[i], pktData, 0);
 			if (!result.has_value())
 				LogError("Failed to send packet {} to player {}: {}", static_cast<uint8_t>(pkt.Type()), i, result.error().what());
 		}
@@ -177,7 +214,7 @@ std::expected<void, PacketError> tcp_server::SendPacket(packet &pkt)
 		return std::unexpected(ServerError());
 	if (pkt.Destination() == pkt.Source() || !connections[pkt.Destination()])
 		return {};
-	return StartSend(connections[pkt.Destination()], pkt);
+	return StartSend(connections[pkt.Destination()], pktData, 0);
 }
 
 std::expected<void, PacketError> tcp_server::StartSend(const scc &con, packet &pkt)
@@ -187,20 +224,20 @@ std::expected<void, PacketError> tcp_server::StartSend(const scc &con, packet &p
 
 std::expected<void, PacketError> tcp_server::StartSend(const scc &con, PacketError::ErrorCode errorCode)
 {
-	buffer_t pktData;
-	pktData.push_back(static_cast<unsigned char>(errorCode));
+	const unsigned char pktData[] = { static_cast<unsigned char>(errorCode) };
 	return StartSend(con, pktData, TcpErrorCodeFlags);
 }
 
-std::expected<void, PacketError> tcp_server::StartSend(const scc &con, buffer_t pktData, uint16_t flags)
+std::expected<void, PacketError> tcp_server::StartSend(const scc &con, std::span<const unsigned char> pktData, uint16_t flags)
 {
-	std::expected<buffer_t, PacketError> frame = frame_queue::MakeFrame(pktData, flags);
-	if (!frame.has_value())
-		return std::unexpected(frame.error());
-	std::unique_ptr<buffer_t> framePtr = std::make_unique<buffer_t>(*frame);
-	const asio::mutable_buffer buf = asio::buffer(*framePtr);
+	buffer_t frame = pktfty.buffers().acquire();
+	if (std::expected<void, PacketError> result = frame_queue::MakeFrame(pktData, flags, frame); !result.has_value())
+		return result;
+	// Moving the frame into the handler keeps its storage, so the buffer stays valid.
+	const asio::const_buffer buf = asio::buffer(frame);
 	asio::async_write(con->socket, buf,
-	    [this, con, frame = std::move(framePtr)](const asio::error_code &ec, size_t bytesSent) {
+	    [this, con, frame = std::move(frame)](const asio::error_code &ec, size_t bytesSent) mutable {
+		    pktfty.buffers().release(std::move(frame));
 		    HandleSend(con, ec, bytesSent);
 	    });
 	return {};
@@ -226,6 +263,16 @@ void tcp_server::StartAccept()
 void tcp_server::HandleAccept(const scc &con, const asio::error_code &ec)
 {
 	if (ec) {
+		if (keepAcceptingOnError && acceptor->is_open()) {
+			// E.g. running out of file descriptors, which passes once other connections are closed.
+			LogError("Server error accepting a connection: {}", ec.message());
+			acceptRetryTimer.expires_after(std::chrono::milliseconds(accept_retry_delay_ms));
+			acceptRetryTimer.async_wait([this](const asio::error_code &timerError) {
+				if (!timerError && acceptor->is_open())
+					StartAccept();
+			});
+			return;
+		}
 		const PacketError packetError = IoHandlerError(ec.message());
 		RaiseIoHandlerError(packetError);
 		return;
@@ -290,11 +337,13 @@ void tcp_server::DropConnection(const scc &con)
 
 void tcp_server::RaiseIoHandlerError(const PacketError &error)
 {
+	const std::lock_guard<SdlMutex> lock(ioHandlerMutex);
 	ioHandlerResult.emplace(error);
 }
 
 std::expected<void, PacketError> tcp_server::CheckIoHandlerError()
 {
+	const std::lock_guard<SdlMutex> lock(ioHandlerMutex);
 	if (ioHandlerResult == std::nullopt)
 		return {};
 	std::expected<void, PacketError> packetError = std::unexpected(*ioHandlerResult);
@@ -304,17 +353,22 @@ std::expected<void, PacketError> tcp_server::CheckIoHandlerError()
 
 void tcp_server::DisconnectNet(plr_t plr)
 {
-	scc &con = connections[plr];
-	if (con == nullptr)
-		return;
-	con->timer.cancel();
-	con->socket.close();
-	con = nullptr;
+	asio::post(strand, [this, plr]() {
+		scc &con = connections[plr];
+		if (con == nullptr)
+			return;
+		con->timer.cancel();
+		con->socket.close();
+		con = nullptr;
+	});
 }
 
 void tcp_server::Close()
 {
-	acceptor->close();
+	asio::post(strand, [this]() {
+		acceptRetryTimer.cancel();
+		acceptor->close();
+	});
 }
 
 tcp_server::~tcp_server()
@@ -2,9 +2,13 @@
 
 #include <array>
 #include <expected>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 
+#include <asio/strand.hpp>
 #include <asio/ts/buffer.hpp>
 #include <asio/ts/internet.hpp>
 #include <asio/ts/io_context.hpp>
@@ -15,6 +19,7 @@
 #include "dvlnet/frame_queue.h"
 #include "dvlnet/packet.h"
 #include "multi.h"
+#include "utils/sdl_mutex.h"
 
 namespace devilution::net {
 
@@ -25,42 +30,74 @@ inline PacketError ServerError()
 	return PacketError("Invalid player ID");
 }
 
+/**
+ * @brief Relays the packets of a game between the players connected to it.
+ *
+ * All handlers of the server run on one strand, so the `io_context` may be run by any number of
+ * threads. The public member functions may be called from any thread.
+ */
 class tcp_server {
 public:
 	tcp_server(asio::io_context &ioc, const std::string &bindaddr,
 	    unsigned short port, packet_factory &pktfty);
-	std::string LocalhostSelf();
+	std::string LocalhostSelf() const;
+	/** @brief The port the server accepts connections on, needed when it was created with port 0. */
+	unsigned short Port() const;
 	std::expected<void, PacketError> CheckIoHandlerError();
+	/**
+	 * @brief Makes the server choose the settings of each new game instead of taking them from the first player who joins.
+	 *
+	 * Used when no player hosts the game, since joining players don't send any settings.
+	 */
+	void SetGameInfoFactory(std::function<buffer_t()> factory);
+	/**
+	 * @brief Makes the server log errors accepting a connection and try again shortly, instead of raising them.
+	 *
+	 * Used when no player hosts the game, since nobody would end it on such an error and it would never
+	 * accept a player again. Call before the `io_context` runs.
+	 */
+	void KeepAcceptingOnError();
+	/** @brief Drops the connection of the player, once the handlers that are already queued have run. */
 	void DisconnectNet(plr_t plr);
+	/** @brief Stops accepting new players, once the handlers that are already queued have run. */
 	void Close();
 	virtual ~tcp_server();
 
 private:
 	static constexpr int timeout_connect = 30;
 	static constexpr int timeout_active = 60;
+	static constexpr int accept_retry_delay_ms = 100;
 
+	typedef asio::strand<asio::io_context::executor_type> strand_t;
+
+	/** Sockets and timers complete on the strand they are created with. */
 	struct client_connection {
 		frame_queue recv_queue;
-		buffer_t recv_buffer = buffer_t(frame_queue::max_frame_size);
 		plr_t plr = PLR_BROADCAST;
 		asio::ip::tcp::socket socket;
 		asio::steady_timer timer;
 		int timeout;
-		client_connection(asio::io_context &ioc)
-		    : socket(ioc)
-		    , timer(ioc)
+		client_connection(const strand_t &strand)
+		    : socket(strand)
+		    , timer(strand)
 		{
 		}
 	};
 
 	typedef std::shared_ptr<client_connection> scc;
 
-	asio::io_context &ioc;
+	strand_t strand;
 	packet_factory &pktfty;
 	std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
+	asio::steady_timer acceptRetryTimer;
+	bool keepAcceptingOnError = false;
+	asio::ip::tcp::endpoint local_endpoint;
 	std::array<scc, MAX_PLRS> connections;
 	buffer_t game_init_info;
+	std::function<buffer_t()> game_init_info_factory;
 
+	/** Raised on the strand and checked from other threads. */
+	SdlMutex ioHandlerMutex;
 	std::optional<PacketError> ioHandlerResult;
 
 	scc MakeConnection();
@@ -71,11 +108,13 @@ private:
 	void StartReceive(const scc &con);
 	void HandleReceive(const scc &con, const asio::error_code &ec, size_t bytesRead);
 	std::expected<void, PacketError> HandleReceiveNewPlayer(const scc &con, packet &pkt);
-	std::expected<void, PacketError> HandleReceivePacket(packet &pkt);
+	std::expected<void, PacketError> HandleReceivePacket(const scc &con, packet &pkt, std::span<const unsigned char> pktData);
+	std::expected<void, PacketError> HandleEchoRequest(const scc &con, packet &pkt);
 	std::expected<void, PacketError> SendPacket(packet &pkt);
+	std::expected<void, PacketError> SendPacket(packet &pkt, std::span<const unsigned char> pktData);
 	std::expected<void, PacketError> StartSend(const scc &con, packet &pkt);
 	std::expected<void, PacketError> StartSend(const scc &con, PacketError::ErrorCode errorCode);
-	std::expected<void, PacketError> StartSend(const scc &con, buffer_t pktData, uint16_t flags);
+	std::expected<void, PacketError> StartSend(const scc &con, std::span<const unsigned char> pktData, uint16_t flags);
 	void HandleSend(const scc &con, const asio::error_code &ec, size_t bytesSent);
 	void StartTimeout(const scc &con);
 	void HandleTimeout(const scc &con, const asio::error_code &ec);
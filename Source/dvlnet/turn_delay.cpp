@@ -0,0 +1,69 @@
+#include "dvlnet/turn_delay.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace devilution::net {
+
+void TurnDelayController::Reset(uint32_t initialTurns)
+{
+	hasSample_ = false;
+	smoothedRoundTripMs_ = 0;
+	roundTripJitterMs_ = 0;
+	desiredTurns_ = std::clamp(initialTurns, MinTurns, MaxTurns);
+	calmTurns_ = 0;
+	playerTurns_.fill(0);
+}
+
+void TurnDelayController::AddRoundTripSample(uint32_t roundTripMs)
+{
+	// The same smoothing that TCP uses for its retransmit timeout (RFC 6298).
+	if (!hasSample_) {
+		smoothedRoundTripMs_ = roundTripMs;
+		roundTripJitterMs_ = roundTripMs / 2;
+		hasSample_ = true;
+		return;
+	}
+	const uint32_t deviation = smoothedRoundTripMs_ > roundTripMs ? smoothedRoundTripMs_ - roundTripMs : roundTripMs - smoothedRoundTripMs_;
+	roundTripJitterMs_ = (3 * roundTripJitterMs_ + deviation) / 4;
+	smoothedRoundTripMs_ = (7 * smoothedRoundTripMs_ + roundTripMs) / 8;
+}
+
+void TurnDelayController::AddStall()
+{
+	desiredTurns_ = std::min(desiredTurns_ + 1, MaxTurns);
+	calmTurns_ = 0;
+}
+
+void TurnDelayController::Update(uint32_t turnPeriodMs)
+{
+	if (!hasSample_)
+		return;
+
+	// One turn more than the turns that pass while a turn is on its way, since the players don't start their turns at the same time.
+	const uint32_t transitMs = smoothedRoundTripMs_ / 2 + 2 * roundTripJitterMs_;
+	const uint32_t targetTurns = std::clamp(transitMs / std::max<uint32_t>(turnPeriodMs, 1) + 1, MinTurns, MaxTurns);
+	if (targetTurns > desiredTurns_) {
+		desiredTurns_ = targetTurns;
+		calmTurns_ = 0;
+	} else if (targetTurns == desiredTurns_) {
+		calmTurns_ = 0;
+	} else if (++calmTurns_ >= CalmTurnsBeforeLowering) {
+		desiredTurns_--;
+		calmTurns_ = 0;
+	}
+}
+
+void TurnDelayController::SetPlayerTurns(size_t playerId, uint32_t turns)
+{
+	if (playerId >= playerTurns_.size())
+		return;
+	playerTurns_[playerId] = turns == 0 ? 0 : std::clamp(turns, MinTurns, MaxTurns);
+}
+
+uint32_t TurnDelayController::AgreedTurns() const
+{
+	return std::max(desiredTurns_, *std::max_element(playerTurns_.begin(), playerTurns_.end()));
+}
+
+} // namespace devilution::net
@@ -0,0 +1,80 @@
+/**
+ * @file turn_delay.hpp
+ *
+ * Picks how many turns are sent ahead, from the measured latency to the other players.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "multi.h"
+
+namespace devilution::net {
+
+/**
+ * @brief Adapts the number of turns in transit to the network conditions.
+ *
+ * A turn has to reach the other players before they need it, so the turns sent ahead have to cover
+ * the one-way latency and its jitter. More turns in transit make the game wait less for late turns but
+ * let the players drift further apart, so the number is raised as soon as it is too low and only lowered
+ * after the link has been calm for a while.
+ *
+ * Every player runs its own controller and tells the others the number it wants. All players use the
+ * highest number that any of them wants, so they agree once the last announcement arrived.
+ */
+class TurnDelayController {
+public:
+	static constexpr uint32_t MinTurns = 1;
+	static constexpr uint32_t MaxTurns = 10;
+	/** Turns in a row in which fewer turns in transit would have done before one turn is taken away. */
+	static constexpr uint32_t CalmTurnsBeforeLowering = 50;
+
+	/** @brief Forgets all measurements, such as when a new game starts. */
+	void Reset(uint32_t initialTurns);
+
+	/** @brief Adds a measured round-trip time to the slowest player. */
+	void AddRoundTripSample(uint32_t roundTripMs);
+
+	/** @brief Records that the turns of the other players didn't arrive in time. */
+	void AddStall();
+
+	/**
+	 * @brief Reevaluates the number of turns this player wants, once per turn.
+	 * @param turnPeriodMs The time between two turns.
+	 */
+	void Update(uint32_t turnPeriodMs);
+
+	/** @brief The number of turns in transit that this player wants. */
+	[[nodiscard]] uint32_t DesiredTurns() const
+	{
+		return desiredTurns_;
+	}
+
+	/** @brief Records the number of turns another player wants, 0 if the player isn't in the game. */
+	void SetPlayerTurns(size_t playerId, uint32_t turns);
+
+	/** @brief The number of turns in transit that all players agree on. */
+	[[nodiscard]] uint32_t AgreedTurns() const;
+
+	[[nodiscard]] uint32_t SmoothedRoundTripMs() const
+	{
+		return smoothedRoundTripMs_;
+	}
+
+	[[nodiscard]] uint32_t RoundTripJitterMs() const
+	{
+		return roundTripJitterMs_;
+	}
+
+private:
+	bool hasSample_ = false;
+	uint32_t smoothedRoundTripMs_ = 0;
+	uint32_t roundTripJitterMs_ = 0;
+	uint32_t desiredTurns_ = MinTurns;
+	uint32_t calmTurns_ = 0;
+	std::array<uint32_t, MAX_PLRS> playerTurns_ {};
+};
+
+} // namespace devilution::net
@@ -0,0 +1,189 @@
+#include "engine/asset_cache.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <ankerl/unordered_dense.h>
+
+#include "utils/endian_swap.hpp"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+
+namespace devilution {
+
+namespace {
+
+/** Bump this whenever the on-disk entry layout changes. */
+constexpr uint16_t AssetCacheFormatVersion = 1;
+
+constexpr std::array<char, 4> AssetCacheMagic { 'D', 'X', 'A', 'C' };
+
+struct AssetCacheHeader {
+	std::array<char, 4> magic;
+	uint16_t formatVersion;
+	uint8_t kind;
+	uint8_t reserved;
+	uint32_t meta;
+	uint32_t reserved2;
+	uint64_t payloadSize;
+	uint64_t payloadChecksum;
+};
+static_assert(sizeof(AssetCacheHeader) == 32);
+
+std::string CacheDirectory;
+uint64_t ArchiveFingerprint;
+
+std::string GetEntryPath(const AssetCacheKey &key)
+{
+	return std::format("{}{:02x}-{:016x}.dxac", CacheDirectory, static_cast<uint8_t>(key.kind), key.hash);
+}
+
+struct FileCloser {
+	void operator()(FILE *file) const { std::fclose(file); }
+};
+using FileUniquePtr = std::unique_ptr<FILE, FileCloser>;
+
+} // namespace
+
+void SetAssetCacheDirectory(std::string_view path)
+{
+	CacheDirectory = path;
+	if (CacheDirectory.empty())
+		return;
+	if (CacheDirectory.back() != DirectorySeparator)
+		CacheDirectory += DirectorySeparator;
+	RecursivelyCreateDir(CacheDirectory.c_str());
+	LogVerbose("Asset cache: {}", CacheDirectory);
+}
+
+bool IsAssetCacheEnabled()
+{
+	return !CacheDirectory.empty();
+}
+
+void SetAssetCacheArchiveFingerprint(uint64_t fingerprint)
+{
+	ArchiveFingerprint = fingerprint;
+}
+
+uint64_t AssetCacheHash(std::span<const uint8_t> data)
+{
+	return ankerl::unordered_dense::hash<std::string_view> {}(
+	    std::string_view { reinterpret_cast<const char *>(data.data()), data.size() });
+}
+
+AssetCacheKey MakeAssetCacheKey(AssetCacheKind kind, std::span<const uint8_t> source, uint32_t converterVersion, std::span<const uint8_t> params)
+{
+	const std::array<uint64_t, 5> parts {
+		ArchiveFingerprint,
+		AssetCacheHash(source),
+		source.size(),
+		(static_cast<uint64_t>(kind) << 32) | converterVersion,
+		AssetCacheHash(params),
+	};
+	return AssetCacheKey {
+		kind,
+		AssetCacheHash({ reinterpret_cast<const uint8_t *>(parts.data()), sizeof(parts) }),
+	};
+}
+
+std::optional<AssetCacheEntry> LookupAssetCache(const AssetCacheKey &key)
+{
+	if (!IsAssetCacheEnabled())
+		return std::nullopt;
+
+	const std::string path = GetEntryPath(key);
+	std::uintmax_t fileSize;
+	if (!GetFileSize(path.c_str(), &fileSize))
+		return std::nullopt;
+	const FileUniquePtr file { OpenFile(path.c_str(), "rb") };
+	if (file == nullptr)
+		return std::nullopt;
+
+	AssetCacheHeader header;
+	if (std::fread(&header, sizeof(header), 1, file.get()) != 1
+	    || header.magic != AssetCacheMagic
+	    || Swap16LE(header.formatVersion) != AssetCacheFormatVersion
+	    || header.kind != static_cast<uint8_t>(key.kind)) {
+		LogVerbose("Asset cache: ignoring invalid entry {}", path);
+		return std::nullopt;
+	}
+
+	// Never trust the size in the header for the allocation, a truncated or corrupted entry is a miss.
+	const uint64_t payloadSize = Swap64LE(header.payloadSize);
+	if (fileSize < sizeof(header) || payloadSize != fileSize - sizeof(header)) {
+		LogVerbose("Asset cache: size mismatch in {}", path);
+		return std::nullopt;
+	}
+	const size_t size = static_cast<size_t>(payloadSize);
+	std::unique_ptr<uint8_t[]> data { new uint8_t[size] };
+	if ((size != 0 && std::fread(data.get(), size, 1, file.get()) != 1)
+	    || AssetCacheHash({ data.get(), size }) != Swap64LE(header.payloadChecksum)) {
+		LogVerbose("Asset cache: checksum mismatch in {}", path);
+		return std::nullopt;
+	}
+
+	return AssetCacheEntry { std::move(data), size, Swap32LE(header.meta) };
+}
+
+void StoreAssetCache(const AssetCacheKey &key, std::span<const uint8_t> data, uint32_t meta)
+{
+	if (!IsAssetCacheEnabled())
+		return;
+
+	AssetCacheHeader header {};
+	header.magic = AssetCacheMagic;
+	header.formatVersion = Swap16LE(AssetCacheFormatVersion);
+	header.kind = static_cast<uint8_t>(key.kind);
+	header.meta = Swap32LE(meta);
+	header.payloadSize = Swap64LE(data.size());
+	header.payloadChecksum = Swap64LE(AssetCacheHash(data));
+
+	// Write to a temporary file first so that a concurrently running instance
+	// (or a crash mid-write) never observes a partially written entry.
+	const std::string path = GetEntryPath(key);
+	const std::string tempPath = path + ".tmp";
+	FILE *file = OpenFile(tempPath.c_str(), "wb");
+	if (file == nullptr) {
+		LogWarn("Asset cache: failed to open {} for writing", tempPath);
+		return;
+	}
+	const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+	    && (data.empty() || std::fwrite(data.data(), data.size(), 1, file) == 1);
+	if (std::fclose(file) != 0 || !written) {
+		LogWarn("Asset cache: failed to write {}", tempPath);
+		RemoveFile(tempPath.c_str());
+		return;
+	}
+	if (!RenameFileOverwrite(tempPath.c_str(), path.c_str())) {
+		LogWarn("Asset cache: failed to replace {}", path);
+		RemoveFile(tempPath.c_str());
+	}
+}
+
+std::optional<OwnedClxSpriteListOrSheet> LookupClxAssetCache(const AssetCacheKey &key)
+{
+	std::optional<AssetCacheEntry> entry = LookupAssetCache(key);
+	if (!entry.has_value())
+		return std::nullopt;
+	return OwnedClxSpriteListOrSheet { std::move(entry->data), static_cast<uint16_t>(entry->meta) };
+}
+
+void StoreClxAssetCache(const AssetCacheKey &key, const OwnedClxSpriteListOrSheet &clx)
+{
+	if (!IsAssetCacheEnabled())
+		return;
+	const ClxSpriteListOrSheet listOrSheet { clx };
+	const uint8_t *data = listOrSheet.isSheet() ? listOrSheet.sheet().data() : listOrSheet.list().data();
+	StoreAssetCache(key, { data, listOrSheet.dataSize() }, clx.numLists());
+}
+
+} // namespace devilution
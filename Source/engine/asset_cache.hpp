@@ -0,0 +1,82 @@
+/**
+ * @file asset_cache.hpp
+ *
+ * Optional on-disk cache of converted assets (CEL/CL2/PCX -> CLX, re-encoded dungeon cels).
+ *
+ * Entries are content-addressed: the key combines the fingerprint of the loaded archives,
+ * a hash of the source file, the converter version and any conversion parameters.
+ * Each entry carries a checksum of its payload that is verified on load.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "engine/clx_sprite.hpp"
+
+namespace devilution {
+
+enum class AssetCacheKind : uint8_t {
+	CelToClx,
+	Cl2ToClx,
+	PcxToClx,
+	DungeonCels,
+};
+
+struct AssetCacheKey {
+	AssetCacheKind kind;
+	uint64_t hash;
+};
+
+struct AssetCacheEntry {
+	std::unique_ptr<uint8_t[]> data;
+	size_t size;
+	/** @brief Converter-specific metadata, e.g. the number of lists in a CLX sheet. */
+	uint32_t meta;
+};
+
+/**
+ * @brief Enables the cache, storing entries under the given directory.
+ *
+ * An empty path disables the cache (the default).
+ */
+void SetAssetCacheDirectory(std::string_view path);
+
+[[nodiscard]] bool IsAssetCacheEnabled();
+
+/**
+ * @brief Sets the fingerprint of the currently loaded archives.
+ *
+ * The fingerprint is part of every key, so loading a different set of archives
+ * does not reuse the entries converted for another set.
+ */
+void SetAssetCacheArchiveFingerprint(uint64_t fingerprint);
+
+[[nodiscard]] uint64_t AssetCacheHash(std::span<const uint8_t> data);
+
+/**
+ * @param source Source file contents (or any unique identifier of the source when hashing the contents is not possible).
+ * @param converterVersion Bumped whenever the converter output changes.
+ * @param params Any additional conversion parameters, e.g. frame widths.
+ */
+[[nodiscard]] AssetCacheKey MakeAssetCacheKey(AssetCacheKind kind, std::span<const uint8_t> source, uint32_t converterVersion, std::span<const uint8_t> params = {});
+
+/**
+ * @brief Returns the cached entry for the given key, if present and valid.
+ */
+[[nodiscard]] std::optional<AssetCacheEntry> LookupAssetCache(const AssetCacheKey &key);
+
+/**
+ * @brief Stores an entry in the cache. Failures are logged and otherwise ignored.
+ */
+void StoreAssetCache(const AssetCacheKey &key, std::span<const uint8_t> data, uint32_t meta = 0);
+
+[[nodiscard]] std::optional<OwnedClxSpriteListOrSheet> LookupClxAssetCache(const AssetCacheKey &key);
+void StoreClxAssetCache(const AssetCacheKey &key, const OwnedClxSpriteListOrSheet &clx);
+
+} // namespace devilution
@@ -18,6 +18,7 @@
 #endif
 
 #include "appfat.h"
+#include "engine/asset_cache.hpp"
 #include "game_mode.hpp"
 #include "mods/mod_identity.h"
 #include "utils/file_util.h"
@@ -393,6 +394,20 @@ bool LoadMPQ(std::span<const std::string> paths, std::string_view mpqName, int p
 	return true;
 }
 #else
+/**
+ * @brief Identifies the set of loaded archives for the asset cache by their priorities, paths and sizes.
+ */
+void RefreshAssetCacheFingerprint()
+{
+	std::string identity;
+	for (const auto &[priority, archive] : MpqArchives) {
+		std::uintmax_t size = 0;
+		GetFileSize(archive.path().c_str(), &size);
+		StrAppend(identity, priority, ":", archive.path(), ":", size, "\n");
+	}
+	SetAssetCacheArchiveFingerprint(AssetCacheHash({ reinterpret_cast<const uint8_t *>(identity.data()), identity.size() }));
+}
+
 bool FindMPQ(std::span<const std::string> paths, std::string_view mpqName)
 {
 	std::string mpqAbsPath;
@@ -426,6 +441,7 @@ bool LoadMPQ(std::span<const std::string> paths, std::string_view mpqName, int p
 		if (!inserted) {
 			LogError("MPQ with priority {} is already registered, skipping {}", priority, mpqName);
 		}
+		RefreshAssetCacheFingerprint();
 		if (loadedPath != nullptr)
 			*loadedPath = mpqAbsPath;
 		return true;
@@ -521,6 +537,9 @@ void LoadCoreArchives()
 void LoadLanguageArchive()
 {
 	MpqArchives.erase(LangMpqPriority);
+#ifndef UNPACKED_MPQS
+	RefreshAssetCacheFingerprint();
+#endif
 	const std::string_view code = GetLanguageCode();
 	if (code != "en") {
 		LoadMPQ(GetMPQSearchPaths(), code, LangMpqPriority);
@@ -601,6 +620,7 @@ void UnloadModArchives()
 			++it;
 		}
 	}
+	RefreshAssetCacheFingerprint();
 #endif
 }
 
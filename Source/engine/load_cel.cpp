@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <expected>
 #include <memory>
+#include <optional>
 #include <string>
 
 #ifdef DEBUG_CEL_TO_CL2_SIZE
@@ -18,12 +19,36 @@
 #ifdef UNPACKED_MPQS
 #include "engine/load_clx.hpp"
 #else
+#include "engine/asset_cache.hpp"
 #include "engine/load_file.hpp"
 #include "utils/cel_to_clx.hpp"
 #endif
 
 namespace devilution {
 
+#ifndef UNPACKED_MPQS
+namespace {
+
+OwnedClxSpriteListOrSheet CelToClxCached(const uint8_t *data, size_t size, PointerOrValue<uint16_t> widthOrWidths)
+{
+	// The length of the widths array is not known here, so only uniform widths are cached.
+	if (!IsAssetCacheEnabled() || widthOrWidths.HoldsPointer())
+		return CelToClx(data, size, widthOrWidths);
+
+	const uint16_t width = widthOrWidths.AsValue();
+	const AssetCacheKey key = MakeAssetCacheKey(AssetCacheKind::CelToClx, { data, size }, CelToClxVersion,
+	    { reinterpret_cast<const uint8_t *>(&width), sizeof(width) });
+	if (std::optional<OwnedClxSpriteListOrSheet> cached = LookupClxAssetCache(key); cached.has_value())
+		return *std::move(cached);
+
+	OwnedClxSpriteListOrSheet result = CelToClx(data, size, widthOrWidths);
+	StoreClxAssetCache(key, result);
+	return result;
+}
+
+} // namespace
+#endif
+
 std::expected<OwnedClxSpriteListOrSheet, std::string> LoadCelListOrSheetWithStatus(const char *pszName, PointerOrValue<uint16_t> widthOrWidths)
 {
 	char path[MaxMpqPathSize];
@@ -36,7 +61,7 @@ std::expected<OwnedClxSpriteListOrSheet, std::string> LoadCelListOrSheetWithStat
 #ifdef DEBUG_CEL_TO_CL2_SIZE
 	std::cout << path;
 #endif
-	return CelToClx(data.get(), size, widthOrWidths);
+	return CelToClxCached(data.get(), size, widthOrWidths);
 #endif
 }
 
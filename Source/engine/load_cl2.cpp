@@ -1,8 +1,11 @@
 #include "engine/load_cl2.hpp"
 
+#include <array>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "mpq/mpq_common.hpp"
@@ -11,29 +14,66 @@
 
 #ifdef UNPACKED_MPQS
 #include "engine/load_clx.hpp"
+#include "engine/render/clx_render.hpp"
 #else
+#include "engine/asset_cache.hpp"
 #include "engine/load_file.hpp"
 #include "utils/cl2_to_clx.hpp"
 #endif
 
 namespace devilution {
 
-std::expected<OwnedClxSpriteListOrSheet, std::string> LoadCl2ListOrSheetWithStatus(const char *pszName, PointerOrValue<uint16_t> widthOrWidths)
+#ifndef UNPACKED_MPQS
+namespace {
+
+OwnedClxSpriteListOrSheet Cl2ToClxCached(std::unique_ptr<uint8_t[]> &&data, size_t size, PointerOrValue<uint16_t> widthOrWidths, const uint8_t *trn)
+{
+	// The length of the widths array is not known here, so only uniform widths are cached.
+	if (!IsAssetCacheEnabled() || widthOrWidths.HoldsPointer())
+		return Cl2ToClxParallel(std::move(data), size, widthOrWidths, trn);
+
+	std::array<uint8_t, 2 + 256> params;
+	const uint16_t width = widthOrWidths.AsValue();
+	std::memcpy(params.data(), &width, sizeof(width));
+	if (trn != nullptr)
+		std::memcpy(&params[2], trn, 256);
+	const AssetCacheKey key = MakeAssetCacheKey(AssetCacheKind::Cl2ToClx, { data.get(), size }, Cl2ToClxVersion,
+	    { params.data(), trn != nullptr ? params.size() : sizeof(width) });
+	if (std::optional<OwnedClxSpriteListOrSheet> cached = LookupClxAssetCache(key); cached.has_value())
+		return *std::move(cached);
+
+	OwnedClxSpriteListOrSheet result = Cl2ToClxParallel(std::move(data), size, widthOrWidths, trn);
+	StoreClxAssetCache(key, result);
+	return result;
+}
+
+} // namespace
+#endif
+
+std::expected<OwnedClxSpriteListOrSheet, std::string> LoadCl2ListOrSheetWithStatus(const char *pszName, PointerOrValue<uint16_t> widthOrWidths, const uint8_t *trn)
 {
 	char path[MaxMpqPathSize];
 	*BufCopy(path, pszName, DEVILUTIONX_CL2_EXT) = '\0';
 #ifdef UNPACKED_MPQS
-	return LoadClxListOrSheetWithStatus(path);
+	ASSIGN_OR_RETURN(OwnedClxSpriteListOrSheet result, LoadClxListOrSheetWithStatus(path));
+	if (trn != nullptr) {
+		if (result.isSheet()) {
+			ClxApplyTrans(ClxSpriteSheet { result.sheet() }, trn);
+		} else {
+			ClxApplyTrans(ClxSpriteList { result.list() }, trn);
+		}
+	}
+	return result;
 #else
 	size_t size;
 	ASSIGN_OR_RETURN(std::unique_ptr<uint8_t[]> data, LoadFileInMemWithStatus<uint8_t>(path, &size));
-	return Cl2ToClx(std::move(data), size, widthOrWidths);
+	return Cl2ToClxCached(std::move(data), size, widthOrWidths, trn);
 #endif
 }
 
-OwnedClxSpriteListOrSheet LoadCl2ListOrSheet(const char *pszName, PointerOrValue<uint16_t> widthOrWidths)
+OwnedClxSpriteListOrSheet LoadCl2ListOrSheet(const char *pszName, PointerOrValue<uint16_t> widthOrWidths, const uint8_t *trn)
 {
-	std::expected<OwnedClxSpriteListOrSheet, std::string> result = LoadCl2ListOrSheetWithStatus(pszName, widthOrWidths);
+	std::expected<OwnedClxSpriteListOrSheet, std::string> result = LoadCl2ListOrSheetWithStatus(pszName, widthOrWidths, trn);
 	if (!result.has_value()) app_fatal(result.error());
 	return std::move(result).value();
 }
@@ -29,8 +29,11 @@
 
 namespace devilution {
 
-std::expected<OwnedClxSpriteListOrSheet, std::string> LoadCl2ListOrSheetWithStatus(const char *pszName, PointerOrValue<uint16_t> widthOrWidths);
-OwnedClxSpriteListOrSheet LoadCl2ListOrSheet(const char *pszName, PointerOrValue<uint16_t> widthOrWidths);
+/**
+ * @param trn If not null, a color translation applied to every pixel while loading.
+ */
+std::expected<OwnedClxSpriteListOrSheet, std::string> LoadCl2ListOrSheetWithStatus(const char *pszName, PointerOrValue<uint16_t> widthOrWidths, const uint8_t *trn = nullptr);
+OwnedClxSpriteListOrSheet LoadCl2ListOrSheet(const char *pszName, PointerOrValue<uint16_t> widthOrWidths, const uint8_t *trn = nullptr);
 
 template <size_t MaxCount>
 std::expected<OwnedClxSpriteSheet, std::string> LoadMultipleCl2Sheet(tl::function_ref<const char *(size_t)> filenames, size_t count, uint16_t width)
@@ -97,4 +100,12 @@ inline OwnedClxSpriteSheet LoadCl2Sheet(const char *pszName, uint16_t width)
 	return LoadCl2ListOrSheet(pszName, PointerOrValue<uint16_t> { width }).sheet();
 }
 
+/**
+ * @brief Loads a CL2 sprite sheet, applying the given color translation (see `ClxApplyTrans`).
+ */
+inline OwnedClxSpriteSheet LoadCl2Sheet(const char *pszName, uint16_t width, const uint8_t *trn)
+{
+	return LoadCl2ListOrSheet(pszName, PointerOrValue<uint16_t> { width }, trn).sheet();
+}
+
 } // namespace devilution
@@ -1,9 +1,11 @@
 #include "engine/load_pcx.hpp"
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #ifdef DEBUG_PCX_TO_CL2_SIZE
@@ -24,6 +26,7 @@
 #include "engine/load_clx.hpp"
 #include "engine/load_file.hpp"
 #else
+#include "engine/asset_cache.hpp"
 #include "engine/assets.hpp"
 #include "utils/pcx.hpp"
 #include "utils/pcx_to_clx.hpp"
@@ -35,6 +38,37 @@
 
 namespace devilution {
 
+#ifndef UNPACKED_MPQS
+namespace {
+
+OptionalOwnedClxSpriteList PcxToClxCached(AssetHandle &handle, size_t fileSize, int numFramesOrFrameHeight, std::optional<uint8_t> transparentColor, SDL_Color *outPalette)
+{
+	// The palette is not stored in the cache, so only palette-less loads are cached.
+	if (!IsAssetCacheEnabled() || outPalette != nullptr)
+		return PcxToClx(handle, fileSize, numFramesOrFrameHeight, transparentColor, outPalette);
+
+	std::unique_ptr<uint8_t[]> source { new uint8_t[fileSize] };
+	if (!handle.read(source.get(), fileSize) || !handle.seek(0))
+		return std::nullopt;
+
+	const std::array<int32_t, 2> params { numFramesOrFrameHeight, transparentColor.has_value() ? *transparentColor : -1 };
+	const AssetCacheKey key = MakeAssetCacheKey(AssetCacheKind::PcxToClx, { source.get(), fileSize }, PcxToClxVersion,
+	    { reinterpret_cast<const uint8_t *>(params.data()), sizeof(params) });
+	source = nullptr;
+	if (std::optional<OwnedClxSpriteListOrSheet> cached = LookupClxAssetCache(key); cached.has_value())
+		return std::move(*cached).list();
+
+	OptionalOwnedClxSpriteList result = PcxToClx(handle, fileSize, numFramesOrFrameHeight, transparentColor, outPalette);
+	if (result) {
+		const ClxSpriteList list { *result };
+		StoreAssetCache(key, { list.data(), list.dataSize() });
+	}
+	return result;
+}
+
+} // namespace
+#endif
+
 OptionalOwnedClxSpriteList LoadPcxSpriteList(const char *filename, int numFramesOrFrameHeight, std::optional<uint8_t> transparentColor, SDL_Color *outPalette, bool logError)
 {
 	char path[MaxMpqPathSize];
@@ -72,7 +106,7 @@ OptionalOwnedClxSpriteList LoadPcxSpriteList(const char *filename, int numFrames
 #ifdef DEBUG_PCX_TO_CL2_SIZE
 	std::cout << filename;
 #endif
-	OptionalOwnedClxSpriteList result = PcxToClx(handle, fileSize, numFramesOrFrameHeight, transparentColor, outPalette);
+	OptionalOwnedClxSpriteList result = PcxToClxCached(handle, fileSize, numFramesOrFrameHeight, transparentColor, outPalette);
 	if (!result)
 		return std::nullopt;
 	return result;
@@ -5,9 +5,15 @@
  */
 #include "engine/render/scrollrt.h"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_keyboard.h>
@@ -51,6 +57,7 @@
 #include "lua/lua_event.hpp"
 #include "minitext.h"
 #include "missiles.h"
+#include "multi.h"
 #include "nthread.h"
 #include "options.h"
 #include "panels/charpanel.hpp"
@@ -65,6 +72,7 @@
 #include "qol/stash.h"
 #include "qol/visual_store.h"
 #include "qol/xpbar.h"
+#include "storm/storm_net.hpp"
 #include "stores.h"
 #include "towners.h"
 #include "utils/attributes.h"
@@ -1482,6 +1490,95 @@ void DrawFPS(const Surface &out)
 	DrawString(out, formatted, Point { 8, 8 }, { .flags = UiFlags::ColorRed });
 }
 
+/** @brief The growth of a counter, counters that went down started over with a new game. */
+uint64_t CounterDelta(uint64_t current, uint64_t last)
+{
+	return current >= last ? current - last : current;
+}
+
+/**
+ * @brief Formats the network statistics for the overlay: the commands that took the most bandwidth and the
+ * state of the connection to each other player.
+ */
+void FormatNetStats(const net::NetStats &stats, const net::NetStats &lastStats, uint32_t msSinceLastUpdate, std::vector<std::string> &lines)
+{
+	constexpr size_t NumTopCommands = 3;
+	std::array<uint64_t, 256> commandBytes {};
+	for (size_t i = 0; i < stats.peers.size(); i++) {
+		const net::PeerNetStats &peer = stats.peers[i];
+		const net::PeerNetStats &lastPeer = lastStats.peers[i];
+		for (size_t cmd = 0; cmd < commandBytes.size(); cmd++) {
+			commandBytes[cmd] += CounterDelta(peer.commands[cmd].sent.bytes, lastPeer.commands[cmd].sent.bytes);
+			commandBytes[cmd] += CounterDelta(peer.commands[cmd].received.bytes, lastPeer.commands[cmd].received.bytes);
+		}
+	}
+	std::array<uint8_t, 256> commands;
+	std::iota(commands.begin(), commands.end(), 0);
+	std::partial_sort(commands.begin(), commands.begin() + NumTopCommands, commands.end(), [&commandBytes](uint8_t a, uint8_t b) {
+		return commandBytes[a] > commandBytes[b];
+	});
+	if (commandBytes[commands[0]] != 0) {
+		std::string line = "Top:";
+		for (size_t i = 0; i < NumTopCommands && commandBytes[commands[i]] != 0; i++) {
+			const uint8_t cmd = commands[i];
+			std::string_view name = CmdIdString(static_cast<_cmd_id>(cmd));
+			if (name.starts_with("CMD_"))
+				name.remove_prefix(4);
+			StrAppend(line, i == 0 ? " " : ", ", name, " ", 1000 * commandBytes[cmd] / msSinceLastUpdate, " B/s");
+		}
+		lines.push_back(std::move(line));
+	}
+
+	for (size_t i = 0; i < stats.peers.size(); i++) {
+		const net::PeerNetStats &peer = stats.peers[i];
+		if (!peer.isConnected)
+			continue;
+		const uint64_t bytesPerSecond = 1000 * CounterDelta(peer.messagesReceived.bytes, lastStats.peers[i].messagesReceived.bytes) / msSinceLastUpdate;
+		lines.push_back(StrCat(Players[i]._pName, ": ", bytesPerSecond, " B/s in, jitter ", static_cast<int>(std::lround(peer.turnJitterMs)),
+		    " ms, ", peer.turnQueueDepth, " turns queued"));
+	}
+
+	const uint64_t cryptoUsPerSecond = CounterDelta(stats.crypto.nanoseconds, lastStats.crypto.nanoseconds) / msSinceLastUpdate;
+	lines.push_back(StrCat(stats.messageQueueDepth, " messages queued, crypto ", cryptoUsPerSecond, " us/s, waited ",
+	    stats.waitForTurns.nanoseconds / 1000000, " ms for turns"));
+}
+
+/**
+ * @brief Display the network traffic per second below the FPS
+ */
+void DrawNetTraffic(const Surface &out)
+{
+	static uint32_t lastUpdateInMs = 0;
+	static NetTrafficCounters lastCounters {};
+	static net::NetStats lastStats {};
+	static std::vector<std::string> lines;
+
+	if (!frameflag || !gbActive || !gbIsMultiplayer) {
+		return;
+	}
+
+	const uint32_t runtimeInMs = SDL_GetTicks();
+	const uint32_t msSinceLastUpdate = runtimeInMs - lastUpdateInMs;
+	if (msSinceLastUpdate >= 1000) {
+		lastUpdateInMs = runtimeInMs;
+		const NetTrafficCounters &counters = multi_get_traffic_counters();
+		// The counters start over with each game.
+		if (counters.packetsSent < lastCounters.packetsSent)
+			lastCounters = {};
+		const uint64_t packetsPerSecond = 1000ULL * (counters.packetsSent - lastCounters.packetsSent) / msSinceLastUpdate;
+		const uint64_t bytesPerSecond = 1000ULL * (counters.bytesSent - lastCounters.bytesSent) / msSinceLastUpdate;
+		lastCounters = counters;
+
+		lines.clear();
+		lines.push_back(StrCat(packetsPerSecond, " pkt/s, ", bytesPerSecond, " B/s"));
+		const net::NetStats stats = DvlNet_GetStats();
+		FormatNetStats(stats, lastStats, msSinceLastUpdate, lines);
+		lastStats = stats;
+	}
+	for (size_t i = 0; i < lines.size(); i++)
+		DrawString(out, lines[i], Point { 8, 24 + 16 * static_cast<int>(i) }, { .flags = UiFlags::ColorRed });
+}
+
 /**
  * @brief Update part of the screen from the back buffer
  */
@@ -1902,6 +1999,7 @@ void DrawAndBlit()
 	DrawCursor(out);
 
 	DrawFPS(out);
+	DrawNetTraffic(out);
 
 	lua::GameDrawComplete();
 
@@ -57,4 +57,18 @@ std::optional<std::array<uint8_t, 256>> GetPlayerGraphicTRN(const char *pszName)
 	return std::nullopt;
 }
 
+std::optional<std::array<uint8_t, 256>> GetPlayerSpriteTRN(Player &player, const char *pszName)
+{
+	std::optional<std::array<uint8_t, 256>> trn = GetPlayerGraphicTRN(pszName);
+	const std::optional<std::array<uint8_t, 256>> classTRN = GetClassTRN(player);
+	if (!classTRN)
+		return trn;
+	if (!trn)
+		return classTRN;
+	for (uint8_t &color : *trn) {
+		color = (*classTRN)[color];
+	}
+	return trn;
+}
+
 } // namespace devilution
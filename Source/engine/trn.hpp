@@ -18,4 +18,9 @@ uint8_t *GetPauseTRN();
 std::optional<std::array<uint8_t, 256>> GetClassTRN(Player &player);
 std::optional<std::array<uint8_t, 256>> GetPlayerGraphicTRN(const char *pszName);
 
+/**
+ * @brief The graphic TRN followed by the class TRN, composed into a single table.
+ */
+std::optional<std::array<uint8_t, 256>> GetPlayerSpriteTRN(Player &player, const char *pszName);
+
 } // namespace devilution
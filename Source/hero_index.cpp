@@ -0,0 +1,240 @@
+#include "hero_index.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "game_mode.hpp"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+
+namespace devilution {
+
+namespace {
+
+/*
+ * Layout (all integers are little-endian):
+ *
+ *   offset  size
+ *   0       4     magic "DXHI"
+ *   4       2     format version
+ *   6       2     number of entries
+ *   8             entries:
+ *                   2     length of the save path
+ *                         save path
+ *                   8     size of the save
+ *                   8     modification time of the save
+ *                   1     indexed by Hellfire
+ *                   16    name
+ *                   1     level
+ *                   1     class
+ *                   1     rank
+ *                   2     strength
+ *                   2     magic
+ *                   2     dexterity
+ *                   2     vitality
+ *                   1     has a saved game
+ *                   1     spawn
+ */
+constexpr std::array<char, 4> HeroIndexMagic { 'D', 'X', 'H', 'I' };
+/** Bump this whenever the on-disk entry layout changes. */
+constexpr uint16_t HeroIndexFormatVersion = 1;
+constexpr size_t HeaderSize = 8;
+
+struct FileCloser {
+	void operator()(FILE *file) const { std::fclose(file); }
+};
+using FileUniquePtr = std::unique_ptr<FILE, FileCloser>;
+
+void AppendLE(std::vector<std::byte> &out, uint64_t value, size_t size)
+{
+	for (size_t i = 0; i < size; ++i)
+		out.push_back(static_cast<std::byte>(value >> (8 * i)));
+}
+
+/** @brief Reads the serialized index, each read fails once the end of the data has been reached. */
+class IndexReader {
+public:
+	explicit IndexReader(std::span<const std::byte> data)
+	    : data_(data)
+	{
+	}
+
+	[[nodiscard]] bool ok() const
+	{
+		return ok_;
+	}
+
+	uint64_t nextLE(size_t size)
+	{
+		if (!ok_ || data_.size() - pos_ < size) {
+			ok_ = false;
+			return 0;
+		}
+		uint64_t value = 0;
+		for (size_t i = 0; i < size; ++i)
+			value |= static_cast<uint64_t>(data_[pos_ + i]) << (8 * i);
+		pos_ += size;
+		return value;
+	}
+
+	std::string_view nextString(size_t size)
+	{
+		if (!ok_ || data_.size() - pos_ < size) {
+			ok_ = false;
+			return {};
+		}
+		const std::string_view result { reinterpret_cast<const char *>(&data_[pos_]), size };
+		pos_ += size;
+		return result;
+	}
+
+private:
+	std::span<const std::byte> data_;
+	size_t pos_ = 0;
+	bool ok_ = true;
+};
+
+} // namespace
+
+std::optional<SaveFileStamp> GetSaveFileStamp(const std::string &path)
+{
+	std::uintmax_t size;
+	int64_t modificationTime;
+	if (!GetFileSize(path.c_str(), &size) || !GetFileModificationTime(path.c_str(), &modificationTime))
+		return std::nullopt;
+	return SaveFileStamp { size, modificationTime };
+}
+
+HeroIndex HeroIndex::Load(const std::string &path)
+{
+	HeroIndex index;
+	std::uintmax_t size;
+	if (!GetFileSize(path.c_str(), &size) || size < HeaderSize)
+		return index;
+
+	std::vector<std::byte> data(static_cast<size_t>(size));
+	{
+		const FileUniquePtr file { OpenFile(path.c_str(), "rb") };
+		if (file == nullptr || std::fread(data.data(), data.size(), 1, file.get()) != 1)
+			return index;
+	}
+
+	IndexReader reader { data };
+	if (reader.nextString(HeroIndexMagic.size()) != std::string_view { HeroIndexMagic.data(), HeroIndexMagic.size() }
+	    || reader.nextLE(2) != HeroIndexFormatVersion) {
+		LogVerbose("Hero index: ignoring invalid index {}", path);
+		return index;
+	}
+
+	const size_t numEntries = static_cast<size_t>(reader.nextLE(2));
+	index.entries_.reserve(numEntries);
+	for (size_t i = 0; i < numEntries; ++i) {
+		const std::string_view savePath = reader.nextString(static_cast<size_t>(reader.nextLE(2)));
+		Entry entry {};
+		entry.stamp.size = reader.nextLE(8);
+		entry.stamp.modificationTime = static_cast<int64_t>(reader.nextLE(8));
+		entry.hellfire = reader.nextLE(1) != 0;
+		const std::string_view name = reader.nextString(sizeof(entry.hero.name));
+		memcpy(entry.hero.name, name.data(), name.size());
+		entry.hero.name[sizeof(entry.hero.name) - 1] = '\0';
+		entry.hero.level = static_cast<uint8_t>(reader.nextLE(1));
+		entry.hero.heroclass = static_cast<HeroClass>(reader.nextLE(1));
+		entry.hero.herorank = static_cast<uint8_t>(reader.nextLE(1));
+		entry.hero.strength = static_cast<uint16_t>(reader.nextLE(2));
+		entry.hero.magic = static_cast<uint16_t>(reader.nextLE(2));
+		entry.hero.dexterity = static_cast<uint16_t>(reader.nextLE(2));
+		entry.hero.vitality = static_cast<uint16_t>(reader.nextLE(2));
+		entry.hero.hassaved = reader.nextLE(1) != 0;
+		entry.hero.spawned = reader.nextLE(1) != 0;
+		if (!reader.ok()) {
+			LogVerbose("Hero index: ignoring truncated index {}", path);
+			index.entries_.clear();
+			return index;
+		}
+		index.entries_.emplace(std::string(savePath), entry);
+	}
+	return index;
+}
+
+void HeroIndex::save(const std::string &path)
+{
+	if (!dirty_)
+		return;
+
+	std::vector<std::byte> data;
+	for (const char c : HeroIndexMagic)
+		data.push_back(static_cast<std::byte>(c));
+	AppendLE(data, HeroIndexFormatVersion, 2);
+	AppendLE(data, entries_.size(), 2);
+	for (const auto &[savePath, entry] : entries_) {
+		AppendLE(data, savePath.size(), 2);
+		for (const char c : savePath)
+			data.push_back(static_cast<std::byte>(c));
+		AppendLE(data, entry.stamp.size, 8);
+		AppendLE(data, static_cast<uint64_t>(entry.stamp.modificationTime), 8);
+		AppendLE(data, entry.hellfire ? 1 : 0, 1);
+		for (const char c : entry.hero.name)
+			data.push_back(static_cast<std::byte>(c));
+		AppendLE(data, entry.hero.level, 1);
+		AppendLE(data, static_cast<uint8_t>(entry.hero.heroclass), 1);
+		AppendLE(data, entry.hero.herorank, 1);
+		AppendLE(data, entry.hero.strength, 2);
+		AppendLE(data, entry.hero.magic, 2);
+		AppendLE(data, entry.hero.dexterity, 2);
+		AppendLE(data, entry.hero.vitality, 2);
+		AppendLE(data, entry.hero.hassaved ? 1 : 0, 1);
+		AppendLE(data, entry.hero.spawned ? 1 : 0, 1);
+	}
+
+	// Write to a temporary file first, so that a crash mid-write leaves the previous index in place.
+	const std::string tempPath = path + ".tmp";
+	{
+		const FileUniquePtr file { OpenFile(tempPath.c_str(), "wb") };
+		if (file == nullptr) {
+			LogWarn("Hero index: failed to open {} for writing", tempPath);
+			return;
+		}
+		if (std::fwrite(data.data(), data.size(), 1, file.get()) != 1) {
+			LogWarn("Hero index: failed to write {}", tempPath);
+			return;
+		}
+	}
+	if (RenameFileOverwrite(tempPath.c_str(), path.c_str()))
+		dirty_ = false;
+}
+
+const _uiheroinfo *HeroIndex::find(std::string_view savePath, const SaveFileStamp &stamp) const
+{
+	const auto it = entries_.find(savePath);
+	if (it == entries_.end() || it->second.stamp != stamp || it->second.hellfire != gbIsHellfire)
+		return nullptr;
+	return &it->second.hero;
+}
+
+void HeroIndex::insert(std::string_view savePath, const SaveFileStamp &stamp, const _uiheroinfo &hero)
+{
+	if (savePath.size() > UINT16_MAX)
+		return;
+	entries_.insert_or_assign(std::string(savePath), Entry { stamp, gbIsHellfire, hero });
+	dirty_ = true;
+}
+
+void HeroIndex::erase(std::string_view savePath)
+{
+	const auto it = entries_.find(savePath);
+	if (it == entries_.end())
+		return;
+	entries_.erase(it);
+	dirty_ = true;
+}
+
+} // namespace devilution
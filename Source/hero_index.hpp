@@ -0,0 +1,64 @@
+/**
+ * @file hero_index.hpp
+ *
+ * Index of the heroes shown on the character selection screen.
+ *
+ * Showing a hero otherwise means decoding and unpacking its whole save. The index stores what the
+ * screen shows for each save, together with the size and modification time of the save at the time,
+ * so that only saves that changed since have to be read again.
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <ankerl/unordered_dense.h>
+
+#include "DiabloUI/diabloui.h"
+#include "utils/string_view_hash.hpp"
+
+namespace devilution {
+
+/** @brief Identifies a version of a save file on disk. */
+struct SaveFileStamp {
+	uint64_t size;
+	int64_t modificationTime;
+
+	bool operator==(const SaveFileStamp &) const = default;
+};
+
+/** @brief Returns the stamp of the file at `path`, or nullopt if it does not exist. */
+std::optional<SaveFileStamp> GetSaveFileStamp(const std::string &path);
+
+class HeroIndex {
+public:
+	/** @brief Reads the index at `path`, a missing or invalid file results in an empty index. */
+	static HeroIndex Load(const std::string &path);
+
+	/** @brief Writes the index to `path` if it was changed since it was loaded. */
+	void save(const std::string &path);
+
+	/**
+	 * @brief Returns the hero indexed for the save.
+	 * @return nullptr if the save is not indexed, has changed since, or was indexed by the other game (Diablo/Hellfire).
+	 */
+	[[nodiscard]] const _uiheroinfo *find(std::string_view savePath, const SaveFileStamp &stamp) const;
+
+	void insert(std::string_view savePath, const SaveFileStamp &stamp, const _uiheroinfo &hero);
+
+	void erase(std::string_view savePath);
+
+private:
+	struct Entry {
+		SaveFileStamp stamp;
+		bool hellfire;
+		_uiheroinfo hero;
+	};
+
+	ankerl::unordered_dense::map<std::string, Entry, StringViewHash, StringViewEquals> entries_;
+	bool dirty_ = false;
+};
+
+} // namespace devilution
@@ -19,6 +19,8 @@
 #include <utility>
 #include <vector>
 
+#include <ankerl/unordered_dense.h>
+
 #ifdef USE_SDL3
 #include <SDL3/SDL_timer.h>
 #else
@@ -2164,6 +2166,199 @@ void RecreateTownItem(const Player &player, Item &item, _item_indexes idx, uint1
 		RecreateHealerItem(player, item, idx, icreateinfo & CF_LEVEL, iseed);
 }
 
+/**
+ * @brief Whether recreating the item only depends on its seed.
+ *
+ * The potions and scrolls that Adria and Pepin always have in stock are generated from the current
+ * state of the random number generator instead, these are never cached.
+ */
+bool IsRecreatedFromSeed(_item_indexes idx, uint16_t icreateinfo)
+{
+	if ((icreateinfo & CF_UNIQUE) != 0 || (icreateinfo & CF_TOWN) == 0)
+		return true;
+	if ((icreateinfo & (CF_SMITH | CF_SMITHPREMIUM | CF_BOY)) != 0)
+		return true;
+	if ((icreateinfo & CF_WITCH) != 0)
+		return !IsAnyOf(idx, IDI_MANA, IDI_FULLMANA, IDI_PORTAL);
+	return !IsAnyOf(idx, IDI_HEAL, IDI_FULLHEAL, IDI_RESURRECT);
+}
+
+/** @brief Generates an item that is recreated from its seed, see `IsRecreatedFromSeed`. */
+void GenerateRecreatedItem(const Player &player, Item &item, _item_indexes idx, uint16_t icreateinfo, uint32_t iseed)
+{
+	if ((icreateinfo & CF_UNIQUE) == 0) {
+		if ((icreateinfo & CF_TOWN) != 0) {
+			RecreateTownItem(player, item, idx, icreateinfo, iseed);
+			return;
+		}
+
+		if ((icreateinfo & CF_USEFUL) == CF_USEFUL) {
+			SetupAllUseful(item, iseed, icreateinfo & CF_LEVEL);
+			return;
+		}
+	}
+
+	const int level = icreateinfo & CF_LEVEL;
+
+	int uper = 0;
+	if ((icreateinfo & CF_UPER1) != 0)
+		uper = 1;
+	if ((icreateinfo & CF_UPER15) != 0)
+		uper = 15;
+
+	const bool onlygood = (icreateinfo & CF_ONLYGOOD) != 0;
+	const bool forceNotUnique = (icreateinfo & CF_UNIQUE) == 0;
+	const bool pregen = (icreateinfo & CF_PREGEN) != 0;
+	auto uidOffset = static_cast<int>((item.dwBuff & CF_UIDOFFSET) >> 1);
+
+	SetupAllItems(player, item, idx, iseed, level, uper, onlygood, pregen, uidOffset, forceNotUnique);
+	SetupItem(item);
+}
+
+/**
+ * @brief Everything besides the item data tables that a recreated item depends on.
+ *
+ * Only made of 32-bit fields, so that it has no padding and can be hashed as bytes.
+ */
+struct RecreatedItemKey {
+	uint32_t seed;
+	uint32_t dwBuff;
+	uint32_t createInfo;
+	int32_t idx;
+	/** Hero class, difficulty, spawn, multiplayer and the bard test option. */
+	uint32_t gameFlags;
+	int32_t maxHPBase;
+	int32_t maxManaBase;
+	int32_t baseStr;
+	int32_t baseMag;
+	int32_t baseDex;
+	int32_t baseVit;
+
+	bool operator==(const RecreatedItemKey &) const = default;
+};
+static_assert(std::has_unique_object_representations_v<RecreatedItemKey>);
+
+struct RecreatedItemKeyHash {
+	using is_avalanching = void;
+
+	[[nodiscard]] uint64_t operator()(const RecreatedItemKey &key) const noexcept
+	{
+		return ankerl::unordered_dense::hash<std::string_view> {}(
+		    std::string_view { reinterpret_cast<const char *>(&key), sizeof(key) });
+	}
+};
+
+struct RecreatedItem {
+	Item item;
+	/** State of the random number generator after the item was generated. */
+	uint32_t rngState;
+};
+
+/** Number of items in each of the two generations of the cache, so at most twice as many are kept. */
+constexpr size_t RecreatedItemCacheGenerationSize = 4096;
+
+/**
+ * @brief Items recreated from their seed.
+ *
+ * Items are looked up in the current generation first, then in the previous one. Once the current
+ * generation is full it replaces the previous one, so items that are not used again are dropped.
+ */
+struct RecreatedItemCache {
+	using Generation = ankerl::unordered_dense::map<RecreatedItemKey, RecreatedItem, RecreatedItemKeyHash>;
+
+	Generation current;
+	Generation previous;
+	ItemRecreationCacheStats stats;
+	bool enabled = true;
+
+	const RecreatedItem *find(const RecreatedItemKey &key)
+	{
+		if (const auto it = current.find(key); it != current.end())
+			return &it->second;
+		const auto it = previous.find(key);
+		if (it == previous.end())
+			return nullptr;
+		// Copied first, starting a new generation drops the previous one.
+		RecreatedItem promoted;
+		std::memcpy(&promoted, &it->second, sizeof(promoted));
+		return &insert(key, promoted);
+	}
+
+	const RecreatedItem &insert(const RecreatedItemKey &key, const RecreatedItem &recreated)
+	{
+		if (current.size() >= RecreatedItemCacheGenerationSize) {
+			previous = std::move(current);
+			current.clear();
+		}
+		RecreatedItem &entry = current[key];
+		// Copy the padding too, so that cached items are identical to the ones they were copied from.
+		std::memcpy(&entry, &recreated, sizeof(entry));
+		return entry;
+	}
+
+	void clear()
+	{
+		current.clear();
+		previous.clear();
+	}
+};
+
+RecreatedItemCache RecreatedItems;
+
+RecreatedItemKey GetRecreatedItemKey(const Player &player, _item_indexes idx, uint16_t icreateinfo, uint32_t iseed, uint32_t dwBuff)
+{
+	const uint32_t gameFlags = static_cast<uint32_t>(player._pClass)
+	    | static_cast<uint32_t>(sgGameInitInfo.nDifficulty) << 8
+	    | (gbIsSpawn ? 1U << 16 : 0)
+	    | (gbIsMultiplayer ? 1U << 17 : 0)
+	    | (*GetOptions().Gameplay.testBard ? 1U << 18 : 0);
+	return RecreatedItemKey {
+		.seed = iseed,
+		.dwBuff = dwBuff,
+		.createInfo = icreateinfo,
+		.idx = static_cast<int32_t>(idx),
+		.gameFlags = gameFlags,
+		.maxHPBase = player._pMaxHPBase,
+		.maxManaBase = player._pMaxManaBase,
+		.baseStr = player._pBaseStr,
+		.baseMag = player._pBaseMag,
+		.baseDex = player._pBaseDex,
+		.baseVit = player._pBaseVit,
+	};
+}
+
+/**
+ * @brief Recreates an item from its seed, reusing the item from the cache if it was recreated before.
+ *
+ * The item is always generated into an empty item, and the random number generator is left in the
+ * same state as if the item had been generated, so that a cached item can't be told apart from a
+ * freshly generated one.
+ */
+void RecreateItemFromSeed(const Player &player, Item &item, _item_indexes idx, uint16_t icreateinfo, uint32_t iseed, uint32_t dwBuff)
+{
+	RecreatedItemCache &cache = RecreatedItems;
+	const RecreatedItemKey key = GetRecreatedItemKey(player, idx, icreateinfo, iseed, dwBuff);
+	if (const RecreatedItem *cached = cache.enabled ? cache.find(key) : nullptr; cached != nullptr) {
+		++cache.stats.hits;
+		std::memcpy(&item, &cached->item, sizeof(item));
+		SetRndSeed(cached->rngState);
+		// The animation refers to the loaded item graphics and depends on whether a level is being loaded.
+		if ((icreateinfo & CF_UNIQUE) != 0 || (icreateinfo & CF_TOWN) == 0)
+			SetupItem(item);
+		return;
+	}
+
+	RecreatedItem recreated { .item = {}, .rngState = 0 };
+	recreated.item.dwBuff = dwBuff;
+	GenerateRecreatedItem(player, recreated.item, idx, icreateinfo, iseed);
+	recreated.rngState = GetLCGEngineState();
+	std::memcpy(&item, &recreated.item, sizeof(item));
+	if (cache.enabled) {
+		++cache.stats.misses;
+		cache.insert(key, recreated);
+	}
+}
+
 void CreateMagicItem(Point position, int lvl, ItemType itemType, int imid, int icurs, bool sendmsg, bool delta, bool spawn = false)
 {
 	if (ActiveItemCount >= MAXITEMS)
@@ -3537,36 +3732,47 @@ void RecreateItem(const Player &player, Item &item, _item_indexes idx, uint16_t
 		return;
 	}
 
-	if ((icreateinfo & CF_UNIQUE) == 0) {
-		if ((icreateinfo & CF_TOWN) != 0) {
-			RecreateTownItem(player, item, idx, icreateinfo, iseed);
-			gbIsHellfire = tmpIsHellfire;
-			return;
-		}
-
-		if ((icreateinfo & CF_USEFUL) == CF_USEFUL) {
-			SetupAllUseful(item, iseed, icreateinfo & CF_LEVEL);
-			gbIsHellfire = tmpIsHellfire;
-			return;
-		}
+	if (!IsRecreatedFromSeed(idx, icreateinfo)) {
+		RecreateTownItem(player, item, idx, icreateinfo, iseed);
+		gbIsHellfire = tmpIsHellfire;
+		return;
 	}
 
-	const int level = icreateinfo & CF_LEVEL;
+	RecreateItemFromSeed(player, item, idx, icreateinfo, iseed, dwBuff);
+	gbIsHellfire = tmpIsHellfire;
+}
 
-	int uper = 0;
-	if ((icreateinfo & CF_UPER1) != 0)
-		uper = 1;
-	if ((icreateinfo & CF_UPER15) != 0)
-		uper = 15;
+ItemRecreationCacheStats GetItemRecreationCacheStats()
+{
+	return RecreatedItems.stats;
+}
 
-	const bool onlygood = (icreateinfo & CF_ONLYGOOD) != 0;
-	const bool forceNotUnique = (icreateinfo & CF_UNIQUE) == 0;
-	const bool pregen = (icreateinfo & CF_PREGEN) != 0;
-	auto uidOffset = static_cast<int>((item.dwBuff & CF_UIDOFFSET) >> 1);
+void ResetItemRecreationCacheStats()
+{
+	RecreatedItems.stats = {};
+}
 
-	SetupAllItems(player, item, idx, iseed, level, uper, onlygood, pregen, uidOffset, forceNotUnique);
-	SetupItem(item);
-	gbIsHellfire = tmpIsHellfire;
+void LogItemRecreationCacheStats(std::string_view context)
+{
+	const ItemRecreationCacheStats &stats = RecreatedItems.stats;
+	const uint32_t total = stats.hits + stats.misses;
+	if (total == 0)
+		return;
+	LogVerbose("Item recreation cache ({}): {} of {} items cached ({}%), {} items kept", context, stats.hits, total, stats.hits * 100 / total,
+	    RecreatedItems.current.size() + RecreatedItems.previous.size());
+	ResetItemRecreationCacheStats();
+}
+
+void ClearItemRecreationCache()
+{
+	RecreatedItems.clear();
+}
+
+void SetItemRecreationCacheEnabled(bool enabled)
+{
+	RecreatedItems.enabled = enabled;
+	if (!enabled)
+		RecreatedItems.clear();
 }
 
 void RecreateEar(Item &item, uint16_t ic, uint32_t iseed, uint8_t bCursval, std::string_view heroName)
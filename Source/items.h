@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <string_view>
 
 #include "DiabloUI/ui_flags.hpp"
 #include "cursor.h"
@@ -531,6 +532,23 @@ void CreateRndItem(Point position, bool onlygood, bool sendmsg, bool delta);
 void CreateRndUseful(Point position, bool sendmsg);
 void CreateTypeItem(Point position, bool onlygood, ItemType itemType, int imisc, bool sendmsg, bool delta, bool spawn = false);
 void RecreateItem(const Player &player, Item &item, _item_indexes idx, uint16_t icreateinfo, uint32_t iseed, int ivalue, uint32_t dwBuff);
+
+struct ItemRecreationCacheStats {
+	/** Items that `RecreateItem` copied from the cache. */
+	uint32_t hits;
+	/** Items that `RecreateItem` had to generate and added to the cache. */
+	uint32_t misses;
+};
+
+/** @brief Returns how often `RecreateItem` used the cache since the counters were last reset. */
+ItemRecreationCacheStats GetItemRecreationCacheStats();
+void ResetItemRecreationCacheStats();
+/** @brief Logs the hit rate of the item recreation cache and resets the counters, `context` names what the numbers cover. */
+void LogItemRecreationCacheStats(std::string_view context);
+/** @brief Drops all cached items, needs to be called whenever the item data changes. */
+void ClearItemRecreationCache();
+/** @brief Turns the item recreation cache on or off, turning it off also clears it. */
+void SetItemRecreationCacheEnabled(bool enabled);
 void RecreateEar(Item &item, uint16_t ic, uint32_t iseed, uint8_t bCursval, std::string_view heroName);
 void CornerstoneSave();
 void CornerstoneLoad(Point position);
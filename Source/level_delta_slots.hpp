@@ -0,0 +1,83 @@
+/**
+ * @file level_delta_slots.hpp
+ *
+ * Encoding of the item and monster tables in the level deltas sent to joining players.
+ *
+ * Only the used slots of a table are sent, as a count followed by index/record pairs. Most slots are
+ * unchanged since dungeon generation, so the deltas of a level that was only passed through take a
+ * few bytes.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace devilution {
+
+/** @brief Maximum number of bytes written by `ExportDeltaSlots` for a table of `NumSlots` records of type `T`. */
+template <typename T, size_t NumSlots>
+constexpr size_t MaxDeltaSlotsSize = sizeof(uint8_t) + (sizeof(uint8_t) + sizeof(T)) * NumSlots;
+
+/**
+ * @brief Writes the slots of `slots` for which `isUsed` returns true.
+ * @return the end of the written data
+ */
+template <size_t NumSlots, typename T, typename IsUsed>
+std::byte *ExportDeltaSlots(std::byte *dst, const T *slots, IsUsed isUsed)
+{
+	static_assert(NumSlots <= UINT8_MAX, "Delta slot indices must fit in one byte");
+
+	std::byte *count = dst++;
+	uint8_t numSlots = 0;
+	for (size_t i = 0; i < NumSlots; i++) {
+		if (!isUsed(slots[i]))
+			continue;
+		*dst++ = static_cast<std::byte>(i);
+		memcpy(dst, &slots[i], sizeof(T));
+		dst += sizeof(T);
+		numSlots++;
+	}
+	*count = static_cast<std::byte>(numSlots);
+
+	return dst;
+}
+
+/**
+ * @brief Reads the slots written by `ExportDeltaSlots`, the other slots are filled with 0xFF bytes.
+ *
+ * The slots must come in increasing order, as `ExportDeltaSlots` writes them, so that each slot is
+ * written at most once.
+ * @return the end of the read data, or nullptr if the data is malformed, in which case all slots are
+ * filled with 0xFF bytes
+ */
+template <size_t NumSlots, typename T>
+const std::byte *ImportDeltaSlots(const std::byte *src, const std::byte *end, T *slots)
+{
+	static_assert(NumSlots <= UINT8_MAX, "Delta slot indices must fit in one byte");
+
+	memset(slots, 0xFF, sizeof(T) * NumSlots);
+
+	if (src == nullptr || src == end)
+		return nullptr;
+
+	const auto numSlots = static_cast<uint8_t>(*src++);
+	if (numSlots > NumSlots || static_cast<size_t>(end - src) < (sizeof(uint8_t) + sizeof(T)) * numSlots)
+		return nullptr;
+
+	int previousIndex = -1;
+	for (unsigned i = 0; i < numSlots; i++) {
+		const auto index = static_cast<uint8_t>(*src++);
+		if (index >= NumSlots || index <= previousIndex) {
+			memset(slots, 0xFF, sizeof(T) * NumSlots);
+			return nullptr;
+		}
+		previousIndex = index;
+		memcpy(&slots[index], src, sizeof(T));
+		src += sizeof(T);
+	}
+
+	return src;
+}
+
+} // namespace devilution
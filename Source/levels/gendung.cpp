@@ -2,8 +2,11 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <memory>
+#include <optional>
+#include <span>
 #include <stack>
 #include <string>
 #include <utility>
@@ -12,6 +15,7 @@
 #include <ankerl/unordered_dense.h>
 #include <magic_enum/magic_enum.hpp>
 
+#include "engine/asset_cache.hpp"
 #include "engine/clx_sprite.hpp"
 #include "engine/load_file.hpp"
 #include "engine/random.hpp"
@@ -29,6 +33,7 @@
 #include "objects.h"
 #include "utils/algorithm/container.hpp"
 #include "utils/bitset2d.hpp"
+#include "utils/endian_read.hpp"
 #include "utils/endian_swap.hpp"
 #include "utils/is_of.hpp"
 #include "utils/log.hpp"
@@ -101,6 +106,38 @@ std::unique_ptr<uint16_t[]> LoadMinData(size_t &tileCount)
 	}
 }
 
+void ReencodeDungeonCelsCached(std::unique_ptr<std::byte[]> &dungeonCels, std::span<std::pair<uint16_t, DunFrameInfo>> frames)
+{
+	if (!IsAssetCacheEnabled()) {
+		ReencodeDungeonCels(dungeonCels, frames);
+		return;
+	}
+
+	// The last frame offset of a CEL file is equal to the file size.
+	const auto *celData = reinterpret_cast<const uint8_t *>(dungeonCels.get());
+	const size_t celSize = LoadLE32(&celData[4 * (static_cast<size_t>(LoadLE32(celData)) + 1)]);
+
+	std::vector<uint8_t> params;
+	params.reserve(frames.size() * 5);
+	for (const auto &[frame, info] : frames) {
+		params.push_back(static_cast<uint8_t>(frame & 0xFF));
+		params.push_back(static_cast<uint8_t>(frame >> 8));
+		params.push_back(info.microTileIndex);
+		params.push_back(static_cast<uint8_t>(info.type));
+		params.push_back(static_cast<uint8_t>(info.properties));
+	}
+	const AssetCacheKey key = MakeAssetCacheKey(AssetCacheKind::DungeonCels, { celData, celSize }, ReencodeDungeonCelsVersion, params);
+	if (std::optional<AssetCacheEntry> cached = LookupAssetCache(key); cached.has_value()) {
+		dungeonCels = std::unique_ptr<std::byte[]> { new std::byte[cached->size] };
+		std::memcpy(dungeonCels.get(), cached->data.get(), cached->size);
+		return;
+	}
+
+	ReencodeDungeonCels(dungeonCels, frames);
+	const auto *result = reinterpret_cast<const uint8_t *>(dungeonCels.get());
+	StoreAssetCache(key, { result, LoadLE32(&result[4 * (frames.size() + 1)]) });
+}
+
 /**
  * @brief Starting from the origin point determine how much floor space is available with the given bounds
  *
@@ -541,7 +578,7 @@ void SetDungeonMicros(std::unique_ptr<std::byte[]> &dungeonCels, uint_fast8_t &m
 	c_sort(frameToTypeList, [](const std::pair<uint16_t, DunFrameInfo> &a, const std::pair<uint16_t, DunFrameInfo> &b) {
 		return a.first < b.first;
 	});
-	ReencodeDungeonCels(dungeonCels, frameToTypeList);
+	ReencodeDungeonCelsCached(dungeonCels, frameToTypeList);
 
 	std::vector<std::pair<uint16_t, uint16_t>> celBlockAdjustments = ComputeCelBlockAdjustments(frameToTypeList);
 	if (celBlockAdjustments.size() == 0) return;
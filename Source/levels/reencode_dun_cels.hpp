@@ -11,6 +11,9 @@
 
 namespace devilution {
 
+/** @brief Version of the `ReencodeDungeonCels` output, bump when the output changes (see `engine/asset_cache.hpp`). */
+constexpr uint32_t ReencodeDungeonCelsVersion = 1;
+
 struct DunFrameInfo {
 	// Only floor tiles have this.
 	uint8_t microTileIndex;
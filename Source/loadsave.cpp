@@ -5,13 +5,17 @@
  */
 #include "loadsave.h"
 
+#include <algorithm>
 #include <climits>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <expected>
 #include <numeric>
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
 
 #include <ankerl/unordered_dense.h>
 
@@ -35,6 +39,8 @@
 #include "pfile.h"
 #include "plrmsg.h"
 #include "qol/stash.h"
+#include "save_delta.hpp"
+#include "save_profile.hpp"
 #include "stores.h"
 #include "tables/playerdat.hpp"
 #include "utils/algorithm/container.hpp"
@@ -42,7 +48,10 @@
 #include "utils/endian_swap.hpp"
 #include "utils/is_of.hpp"
 #include "utils/language.h"
+#include "utils/log.hpp"
+#include "utils/parallel_for.hpp"
 #include "utils/status_macros.hpp"
+#include "utils/str_cat.hpp"
 
 namespace devilution {
 
@@ -54,6 +63,15 @@ namespace {
 constexpr size_t MaxMissilesForSaveGame = 125;
 constexpr size_t PlayerWalkPathSizeForSaveGame = 25;
 
+/** Number of deltas that are written against a level file before the level is written in full again. */
+constexpr uint16_t MaxLevelDeltas = 8;
+
+const int DiabloItemSaveSize = 368;
+const int HellfireItemSaveSize = 372;
+constexpr size_t MonsterSaveSize = 216;
+constexpr size_t MissileSaveSize = 176;
+constexpr size_t ObjectSaveSize = 120;
+
 uint8_t giNumberQuests;
 uint8_t giNumberOfSmithPremiumItems;
 
@@ -95,10 +113,83 @@ void TerminateUtf8(char *str, size_t maxLength)
 	str[utf8Length] = '\0';
 }
 
+/**
+ * @brief Reads the values of a record whose size has already been checked by LoadHelper::NextRecord.
+ *
+ * Has the same interface as LoadHelper, but each value is a plain copy without a bounds check.
+ */
+class RecordReader {
+	const std::byte *m_cur_;
+
+	template <class T>
+	T Next()
+	{
+		T value;
+		memcpy(&value, m_cur_, sizeof(T));
+		m_cur_ += sizeof(T);
+		return value;
+	}
+
+public:
+	explicit RecordReader(const std::byte *data)
+	    : m_cur_(data)
+	{
+	}
+
+	template <typename T>
+	constexpr void Skip(size_t count = 1)
+	{
+		Skip(sizeof(T) * count);
+	}
+
+	void Skip(size_t size)
+	{
+		m_cur_ += size;
+	}
+
+	void NextBytes(void *bytes, size_t size)
+	{
+		memcpy(bytes, m_cur_, size);
+		m_cur_ += size;
+	}
+
+	template <class T>
+	T NextLE()
+	{
+		return SwapLE(Next<T>());
+	}
+
+	template <class T>
+	T NextBE()
+	{
+		return SwapBE(Next<T>());
+	}
+
+	template <class TSource, class TDesired>
+	TDesired NextLENarrow(TSource modifier = 0)
+	{
+		static_assert(sizeof(TSource) > sizeof(TDesired), "Can only narrow to a smaller type");
+		TSource value = SwapLE(Next<TSource>()) + modifier;
+		return static_cast<TDesired>(std::clamp<TSource>(value, std::numeric_limits<TDesired>::min(), std::numeric_limits<TDesired>::max()));
+	}
+
+	bool NextBool8()
+	{
+		return Next<uint8_t>() != 0;
+	}
+
+	bool NextBool32()
+	{
+		return Next<uint32_t>() != 0;
+	}
+};
+
 class LoadHelper {
 	std::unique_ptr<std::byte[]> m_buffer_;
 	size_t m_cur_ = 0;
 	size_t m_size_;
+	/** Holds records that run past the end of the file, padded with zeros. */
+	std::vector<std::byte> m_truncatedRecord_;
 
 	template <class T>
 	T Next()
@@ -123,6 +214,12 @@ public:
 			m_buffer_ = nullptr;
 	}
 
+	LoadHelper(std::unique_ptr<std::byte[]> buffer, size_t size)
+	    : m_buffer_(std::move(buffer))
+	    , m_size_(size)
+	{
+	}
+
 	bool IsValid(size_t size = 1)
 	{
 		return m_buffer_ != nullptr
@@ -183,6 +280,27 @@ public:
 	{
 		return Next<uint32_t>() != 0;
 	}
+
+	/**
+	 * @brief Checks the size of a fixed-size record once and skips over it.
+	 *
+	 * If the file ends before the record does, the missing part reads as zeros like it does through the other functions.
+	 * @return A reader over the record, valid until the next call.
+	 */
+	RecordReader NextRecord(size_t size)
+	{
+		if (IsValid(size)) {
+			const RecordReader record { &m_buffer_[m_cur_] };
+			m_cur_ += size;
+			return record;
+		}
+
+		m_truncatedRecord_.assign(size, std::byte { 0 });
+		if (m_buffer_ != nullptr && m_cur_ < m_size_)
+			memcpy(m_truncatedRecord_.data(), &m_buffer_[m_cur_], m_size_ - m_cur_);
+		m_cur_ += size;
+		return RecordReader { m_truncatedRecord_.data() };
+	}
 };
 
 class SaveHelper {
@@ -231,6 +349,18 @@ public:
 		m_cur_ += len;
 	}
 
+	/** @brief The contents written so far. */
+	[[nodiscard]] std::span<const std::byte> Data() const
+	{
+		return { m_buffer_.get(), m_cur_ };
+	}
+
+	/** @brief Drops the contents instead of writing them to the archive. */
+	void Discard()
+	{
+		m_buffer_ = nullptr;
+	}
+
 	template <class T>
 	void WriteLE(T value)
 	{
@@ -247,10 +377,10 @@ public:
 
 	~SaveHelper()
 	{
-		const auto encodedLen = codec_get_encoded_len(m_cur_);
-		const char *const password = pfile_get_password();
-		codec_encode(m_buffer_.get(), m_cur_, encodedLen, password);
-		m_mpqWriter.WriteFile(m_szFileName_, m_buffer_.get(), encodedLen);
+		if (m_buffer_ == nullptr)
+			return;
+		// The buffer was allocated with room for encoding, which happens on the save worker.
+		m_mpqWriter.WriteFile(m_szFileName_, std::move(m_buffer_), m_cur_, pfile_get_password());
 	}
 };
 
@@ -265,7 +395,28 @@ struct LevelConversionData {
 	MonsterConversionData monsterConversionData[MaxMonsters];
 };
 
-[[nodiscard]] bool LoadItemData(LoadHelper &file, Item &item)
+/**
+ * @brief The full level file that the current level was last read from or written to.
+ *
+ * Level saves only write the changes against it, see `SaveLevelDelta`.
+ */
+struct LevelSnapshot {
+	uint32_t saveNumber;
+	std::string fileName;
+	std::vector<std::byte> data;
+	uint64_t hash;
+	/** Number of deltas written against the snapshot so far. */
+	uint16_t numDeltas;
+};
+
+std::optional<LevelSnapshot> CurrentLevelSnapshot;
+
+size_t GetItemSaveSize()
+{
+	return gbIsHellfireSaveGame ? HellfireItemSaveSize : DiabloItemSaveSize;
+}
+
+[[nodiscard]] bool LoadItemData(RecordReader file, Item &item)
 {
 	item._iSeed = file.NextLE<uint32_t>();
 	item._iCreateInfo = file.NextLE<uint16_t>();
@@ -381,7 +532,7 @@ struct LevelConversionData {
 
 void LoadAndValidateItemData(LoadHelper &file, Item &item)
 {
-	const bool success = LoadItemData(file, item);
+	const bool success = LoadItemData(file.NextRecord(GetItemSaveSize()), item);
 	if (!success) {
 		item.clear();
 		return;
@@ -392,6 +543,8 @@ void LoadAndValidateItemData(LoadHelper &file, Item &item)
 
 void LoadPlayer(LoadHelper &file, Player &player)
 {
+	const SaveProfileScope profileScope(SaveProfileSection::LoadPlayer);
+
 	player._pmode = static_cast<PLR_MODE>(file.NextLE<int32_t>());
 
 	for (size_t i = 0; i < PlayerWalkPathSizeForSaveGame; ++i) {
@@ -660,106 +813,106 @@ void LoadPlayer(LoadHelper &file, Player &player)
 
 bool gbSkipSync = false;
 
-[[nodiscard]] bool LoadMonster(LoadHelper *file, Monster &monster, MonsterConversionData *monsterConversionData = nullptr)
+[[nodiscard]] bool LoadMonster(RecordReader file, Monster &monster, MonsterConversionData *monsterConversionData = nullptr)
 {
-	monster.levelType = file->NextLE<int32_t>();
-	monster.mode = static_cast<MonsterMode>(file->NextLE<int32_t>());
-	monster.goal = static_cast<MonsterGoal>(file->NextLE<uint8_t>());
-	file->Skip(3); // Alignment
-	monster.goalVar1 = file->NextLENarrow<int32_t, int16_t>();
-	monster.goalVar2 = file->NextLENarrow<int32_t, int8_t>();
-	monster.goalVar3 = file->NextLENarrow<int32_t, int8_t>();
-	file->Skip(4); // Unused
-	monster.pathCount = file->NextLE<uint8_t>();
-	file->Skip(3); // Alignment
-	monster.position.tile.x = file->NextLE<int32_t>();
-	monster.position.tile.y = file->NextLE<int32_t>();
-	monster.position.future.x = file->NextLE<int32_t>();
-	monster.position.future.y = file->NextLE<int32_t>();
-	monster.position.old.x = file->NextLE<int32_t>();
-	monster.position.old.y = file->NextLE<int32_t>();
-	file->Skip<int32_t>(4); // Skip offset and velocity
-	monster.direction = static_cast<Direction>(file->NextLE<int32_t>());
-	monster.enemy = file->NextLE<int32_t>();
-	monster.enemyPosition.x = file->NextLE<uint8_t>();
-	monster.enemyPosition.y = file->NextLE<uint8_t>();
-	file->Skip(2); // Unused
+	monster.levelType = file.NextLE<int32_t>();
+	monster.mode = static_cast<MonsterMode>(file.NextLE<int32_t>());
+	monster.goal = static_cast<MonsterGoal>(file.NextLE<uint8_t>());
+	file.Skip(3); // Alignment
+	monster.goalVar1 = file.NextLENarrow<int32_t, int16_t>();
+	monster.goalVar2 = file.NextLENarrow<int32_t, int8_t>();
+	monster.goalVar3 = file.NextLENarrow<int32_t, int8_t>();
+	file.Skip(4); // Unused
+	monster.pathCount = file.NextLE<uint8_t>();
+	file.Skip(3); // Alignment
+	monster.position.tile.x = file.NextLE<int32_t>();
+	monster.position.tile.y = file.NextLE<int32_t>();
+	monster.position.future.x = file.NextLE<int32_t>();
+	monster.position.future.y = file.NextLE<int32_t>();
+	monster.position.old.x = file.NextLE<int32_t>();
+	monster.position.old.y = file.NextLE<int32_t>();
+	file.Skip<int32_t>(4); // Skip offset and velocity
+	monster.direction = static_cast<Direction>(file.NextLE<int32_t>());
+	monster.enemy = file.NextLE<int32_t>();
+	monster.enemyPosition.x = file.NextLE<uint8_t>();
+	monster.enemyPosition.y = file.NextLE<uint8_t>();
+	file.Skip(2); // Unused
 
-	file->Skip(4); // Skip pointer _mAnimData
+	file.Skip(4); // Skip pointer _mAnimData
 	monster.animInfo = {};
-	monster.animInfo.ticksPerFrame = file->NextLENarrow<int32_t, int8_t>();
+	monster.animInfo.ticksPerFrame = file.NextLENarrow<int32_t, int8_t>();
 	// Ensure that we can increase the tickCounterOfCurrentFrame at least once without overflow (needed for backwards compatibility for sitting gargoyles)
-	monster.animInfo.tickCounterOfCurrentFrame = file->NextLENarrow<int32_t, int8_t>(1) - 1;
-	monster.animInfo.numberOfFrames = file->NextLENarrow<int32_t, int8_t>();
-	monster.animInfo.currentFrame = file->NextLENarrow<int32_t, int8_t>(-1);
-	file->Skip(4); // Skip _meflag
-	monster.isInvalid = file->NextBool32();
-	monster.var1 = file->NextLENarrow<int32_t, int16_t>();
-	monster.var2 = file->NextLENarrow<int32_t, int16_t>();
-	monster.var3 = file->NextLENarrow<int32_t, int8_t>();
-	monster.position.temp.x = file->NextLENarrow<int32_t, WorldTileCoord>();
-	monster.position.temp.y = file->NextLENarrow<int32_t, WorldTileCoord>();
-	file->Skip<int32_t>(2); // skip offset2;
-	file->Skip(4);          // Skip actionFrame
-	monster.maxHitPoints = file->NextLE<int32_t>();
-	monster.hitPoints = file->NextLE<int32_t>();
-
-	monster.ai = static_cast<MonsterAIID>(file->NextLE<uint8_t>());
-	monster.intelligence = file->NextLE<uint8_t>();
-	file->Skip(2); // Alignment
-	monster.flags = file->NextLE<uint32_t>();
-	monster.activeForTicks = file->NextLE<uint8_t>();
-	file->Skip(3); // Alignment
-	file->Skip(4); // Unused
-	monster.position.last.x = file->NextLE<int32_t>();
-	monster.position.last.y = file->NextLE<int32_t>();
-	monster.rndItemSeed = file->NextLE<uint32_t>();
-	monster.aiSeed = file->NextLE<uint32_t>();
-	file->Skip(4); // Unused
+	monster.animInfo.tickCounterOfCurrentFrame = file.NextLENarrow<int32_t, int8_t>(1) - 1;
+	monster.animInfo.numberOfFrames = file.NextLENarrow<int32_t, int8_t>();
+	monster.animInfo.currentFrame = file.NextLENarrow<int32_t, int8_t>(-1);
+	file.Skip(4); // Skip _meflag
+	monster.isInvalid = file.NextBool32();
+	monster.var1 = file.NextLENarrow<int32_t, int16_t>();
+	monster.var2 = file.NextLENarrow<int32_t, int16_t>();
+	monster.var3 = file.NextLENarrow<int32_t, int8_t>();
+	monster.position.temp.x = file.NextLENarrow<int32_t, WorldTileCoord>();
+	monster.position.temp.y = file.NextLENarrow<int32_t, WorldTileCoord>();
+	file.Skip<int32_t>(2); // skip offset2;
+	file.Skip(4);          // Skip actionFrame
+	monster.maxHitPoints = file.NextLE<int32_t>();
+	monster.hitPoints = file.NextLE<int32_t>();
+
+	monster.ai = static_cast<MonsterAIID>(file.NextLE<uint8_t>());
+	monster.intelligence = file.NextLE<uint8_t>();
+	file.Skip(2); // Alignment
+	monster.flags = file.NextLE<uint32_t>();
+	monster.activeForTicks = file.NextLE<uint8_t>();
+	file.Skip(3); // Alignment
+	file.Skip(4); // Unused
+	monster.position.last.x = file.NextLE<int32_t>();
+	monster.position.last.y = file.NextLE<int32_t>();
+	monster.rndItemSeed = file.NextLE<uint32_t>();
+	monster.aiSeed = file.NextLE<uint32_t>();
+	file.Skip(4); // Unused
 
-	monster.uniqueType = static_cast<UniqueMonsterType>(file->NextLE<uint8_t>() - 1);
-	monster.uniqTrans = file->NextLE<uint8_t>();
-	monster.corpseId = file->NextLE<int8_t>();
+	monster.uniqueType = static_cast<UniqueMonsterType>(file.NextLE<uint8_t>() - 1);
+	monster.uniqTrans = file.NextLE<uint8_t>();
+	monster.corpseId = file.NextLE<int8_t>();
 
-	monster.whoHit = file->NextLE<int8_t>();
+	monster.whoHit = file.NextLE<int8_t>();
 	if (monsterConversionData != nullptr)
-		monsterConversionData->monsterLevel = file->NextLE<int8_t>();
+		monsterConversionData->monsterLevel = file.NextLE<int8_t>();
 	else
-		file->Skip(1); // Skip level - now calculated on the fly
-	file->Skip(1);     // Alignment
+		file.Skip(1); // Skip level - now calculated on the fly
+	file.Skip(1);     // Alignment
 	if (monsterConversionData != nullptr)
-		monsterConversionData->experience = file->NextLE<uint16_t>();
+		monsterConversionData->experience = file.NextLE<uint16_t>();
 	else
-		file->Skip(2); // Skip exp - now calculated from monstdat when the monster dies
+		file.Skip(2); // Skip exp - now calculated from monstdat when the monster dies
 
 	if (monsterConversionData != nullptr)
-		monsterConversionData->toHit = file->NextLE<uint8_t>();
+		monsterConversionData->toHit = file.NextLE<uint8_t>();
 	else if (monster.isPlayerMinion()) // Don't skip for golems
-		monster.golemToHit = file->NextLE<uint8_t>();
+		monster.golemToHit = file.NextLE<uint8_t>();
 	else
-		file->Skip(1); // Skip toHit - now calculated on the fly
-	monster.minDamage = file->NextLE<uint8_t>();
-	monster.maxDamage = file->NextLE<uint8_t>();
+		file.Skip(1); // Skip toHit - now calculated on the fly
+	monster.minDamage = file.NextLE<uint8_t>();
+	monster.maxDamage = file.NextLE<uint8_t>();
 	if (monsterConversionData != nullptr)
-		monsterConversionData->toHitSpecial = file->NextLE<uint8_t>();
+		monsterConversionData->toHitSpecial = file.NextLE<uint8_t>();
 	else
-		file->Skip(1); // Skip toHitSpecial - now calculated on the fly
-	monster.minDamageSpecial = file->NextLE<uint8_t>();
-	monster.maxDamageSpecial = file->NextLE<uint8_t>();
-	monster.armorClass = file->NextLE<uint8_t>();
-	file->Skip(1); // Alignment
-	monster.resistance = file->NextLE<uint16_t>();
-	file->Skip(2); // Alignment
+		file.Skip(1); // Skip toHitSpecial - now calculated on the fly
+	monster.minDamageSpecial = file.NextLE<uint8_t>();
+	monster.maxDamageSpecial = file.NextLE<uint8_t>();
+	monster.armorClass = file.NextLE<uint8_t>();
+	file.Skip(1); // Alignment
+	monster.resistance = file.NextLE<uint16_t>();
+	file.Skip(2); // Alignment
 
-	monster.talkMsg = static_cast<_speech_id>(file->NextLE<int32_t>());
+	monster.talkMsg = static_cast<_speech_id>(file.NextLE<int32_t>());
 	if (monster.talkMsg == TEXT_KING1) // Fix original bad mapping of NONE for monsters
 		monster.talkMsg = TEXT_NONE;
-	monster.leader = file->NextLE<uint8_t>();
+	monster.leader = file.NextLE<uint8_t>();
 	if (monster.leader == 0)
 		monster.leader = Monster::NoLeader; // Golems shouldn't be leaders of other monsters
-	monster.leaderRelation = static_cast<LeaderRelation>(file->NextLE<uint8_t>());
-	monster.packSize = file->NextLE<uint8_t>();
-	monster.lightId = file->NextLE<int8_t>();
+	monster.leaderRelation = static_cast<LeaderRelation>(file.NextLE<uint8_t>());
+	monster.packSize = file.NextLE<uint8_t>();
+	monster.lightId = file.NextLE<int8_t>();
 	if (monster.lightId == 0)
 		monster.lightId = NO_LIGHT; // Correct incorrect values in old saves
 
@@ -782,15 +935,18 @@ bool gbSkipSync = false;
 
 void LoadMonsters(LoadHelper &file, ankerl::unordered_dense::set<unsigned> &removedMonsterIds, const bool applyLight, LevelConversionData *levelConversionData)
 {
+	const SaveProfileScope profileScope(SaveProfileSection::LoadMonsters);
+
+	RecordReader activeMonsters = file.NextRecord(sizeof(uint32_t) * MaxMonsters);
 	for (unsigned &monsterId : ActiveMonsters)
-		monsterId = file.NextBE<uint32_t>();
+		monsterId = activeMonsters.NextBE<uint32_t>();
 
 	for (size_t i = 0; i < ActiveMonsterCount;) {
 		Monster &monster = Monsters[ActiveMonsters[i]];
 		MonsterConversionData *monsterConversionData = nullptr;
 		if (levelConversionData != nullptr)
 			monsterConversionData = &levelConversionData->monsterConversionData[ActiveMonsters[i]];
-		const bool valid = LoadMonster(&file, monster, monsterConversionData);
+		const bool valid = LoadMonster(file.NextRecord(MonsterSaveSize), monster, monsterConversionData);
 		if (!valid) {
 			Monsters[ActiveMonsters[i]] = {};
 			removedMonsterIds.insert(ActiveMonsters[i]);
@@ -836,54 +992,54 @@ void SyncPackSize(Monster &leader)
 	}
 }
 
-void LoadMissile(LoadHelper *file)
+void LoadMissile(RecordReader file)
 {
 	Missile missile = {};
-	missile._mitype = static_cast<MissileID>(file->NextLE<int32_t>());
-	missile.position.tile.x = file->NextLE<int32_t>();
-	missile.position.tile.y = file->NextLE<int32_t>();
-	missile.position.offset.deltaX = file->NextLE<int32_t>();
-	missile.position.offset.deltaY = file->NextLE<int32_t>();
-	missile.position.velocity.deltaX = file->NextLE<int32_t>();
-	missile.position.velocity.deltaY = file->NextLE<int32_t>();
-	missile.position.start.x = file->NextLE<int32_t>();
-	missile.position.start.y = file->NextLE<int32_t>();
-	missile.position.traveled.deltaX = file->NextLE<int32_t>();
-	missile.position.traveled.deltaY = file->NextLE<int32_t>();
-	missile.setFrameGroupRaw(file->NextLE<int32_t>());
-	missile._mispllvl = file->NextLE<int32_t>();
-	missile._miDelFlag = file->NextBool32();
-	missile._miAnimType = static_cast<MissileGraphicID>(file->NextLE<uint8_t>());
-	file->Skip(3); // Alignment
-	missile._miAnimFlags = static_cast<MissileGraphicsFlags>(file->NextLE<int32_t>());
-	file->Skip(4); // Skip pointer _miAnimData
-	missile._miAnimDelay = file->NextLE<int32_t>();
-	missile._miAnimLen = file->NextLE<int32_t>();
-	missile._miAnimWidth = file->NextLE<int32_t>();
-	missile._miAnimWidth2 = file->NextLE<int32_t>();
-	missile._miAnimCnt = file->NextLE<int32_t>();
-	missile._miAnimAdd = file->NextLE<int32_t>();
-	missile._miAnimFrame = file->NextLE<int32_t>();
-	missile._miDrawFlag = file->NextBool32();
-	missile._miLightFlag = file->NextBool32();
-	missile._miPreFlag = file->NextBool32();
-	missile._miUniqTrans = file->NextLE<uint32_t>();
-	missile.duration = file->NextLE<int32_t>();
-	missile._misource = file->NextLE<int32_t>();
-	missile._micaster = static_cast<mienemy_type>(file->NextLE<int32_t>());
-	missile._midam = file->NextLE<int32_t>();
-	missile._miHitFlag = file->NextBool32();
-	missile._midist = file->NextLE<int32_t>();
-	missile._mlid = file->NextLE<int32_t>();
-	missile._mirnd = file->NextLE<int32_t>();
-	missile.var1 = file->NextLE<int32_t>();
-	missile.var2 = file->NextLE<int32_t>();
-	missile.var3 = file->NextLE<int32_t>();
-	missile.var4 = file->NextLE<int32_t>();
-	missile.var5 = file->NextLE<int32_t>();
-	missile.var6 = file->NextLE<int32_t>();
-	missile.var7 = file->NextLE<int32_t>();
-	missile.limitReached = file->NextBool32();
+	missile._mitype = static_cast<MissileID>(file.NextLE<int32_t>());
+	missile.position.tile.x = file.NextLE<int32_t>();
+	missile.position.tile.y = file.NextLE<int32_t>();
+	missile.position.offset.deltaX = file.NextLE<int32_t>();
+	missile.position.offset.deltaY = file.NextLE<int32_t>();
+	missile.position.velocity.deltaX = file.NextLE<int32_t>();
+	missile.position.velocity.deltaY = file.NextLE<int32_t>();
+	missile.position.start.x = file.NextLE<int32_t>();
+	missile.position.start.y = file.NextLE<int32_t>();
+	missile.position.traveled.deltaX = file.NextLE<int32_t>();
+	missile.position.traveled.deltaY = file.NextLE<int32_t>();
+	missile.setFrameGroupRaw(file.NextLE<int32_t>());
+	missile._mispllvl = file.NextLE<int32_t>();
+	missile._miDelFlag = file.NextBool32();
+	missile._miAnimType = static_cast<MissileGraphicID>(file.NextLE<uint8_t>());
+	file.Skip(3); // Alignment
+	missile._miAnimFlags = static_cast<MissileGraphicsFlags>(file.NextLE<int32_t>());
+	file.Skip(4); // Skip pointer _miAnimData
+	missile._miAnimDelay = file.NextLE<int32_t>();
+	missile._miAnimLen = file.NextLE<int32_t>();
+	missile._miAnimWidth = file.NextLE<int32_t>();
+	missile._miAnimWidth2 = file.NextLE<int32_t>();
+	missile._miAnimCnt = file.NextLE<int32_t>();
+	missile._miAnimAdd = file.NextLE<int32_t>();
+	missile._miAnimFrame = file.NextLE<int32_t>();
+	missile._miDrawFlag = file.NextBool32();
+	missile._miLightFlag = file.NextBool32();
+	missile._miPreFlag = file.NextBool32();
+	missile._miUniqTrans = file.NextLE<uint32_t>();
+	missile.duration = file.NextLE<int32_t>();
+	missile._misource = file.NextLE<int32_t>();
+	missile._micaster = static_cast<mienemy_type>(file.NextLE<int32_t>());
+	missile._midam = file.NextLE<int32_t>();
+	missile._miHitFlag = file.NextBool32();
+	missile._midist = file.NextLE<int32_t>();
+	missile._mlid = file.NextLE<int32_t>();
+	missile._mirnd = file.NextLE<int32_t>();
+	missile.var1 = file.NextLE<int32_t>();
+	missile.var2 = file.NextLE<int32_t>();
+	missile.var3 = file.NextLE<int32_t>();
+	missile.var4 = file.NextLE<int32_t>();
+	missile.var5 = file.NextLE<int32_t>();
+	missile.var6 = file.NextLE<int32_t>();
+	missile.var7 = file.NextLE<int32_t>();
+	missile.limitReached = file.NextBool32();
 	missile.lastCollisionTargetHash = 0;
 	if (Missiles.size() < Missiles.max_size()) {
 		Missiles.push_back(missile);
@@ -929,7 +1085,7 @@ _object_id ConvertFromHellfireObject(_object_id type)
 	return type;
 }
 
-void LoadObject(LoadHelper &file, Object &object)
+void LoadObject(RecordReader file, Object &object)
 {
 	object._otype = ConvertFromHellfireObject(static_cast<_object_id>(file.NextLE<int32_t>()));
 	object.position.x = file.NextLE<int32_t>();
@@ -1064,10 +1220,98 @@ void GetPermLevelNames(char *szPerm)
 	return GetLevelNames("perm", szPerm);
 }
 
-bool LevelFileExists(SaveWriter &archive)
+void GetLevelDeltaName(const char *szName, char *out)
 {
-	char szName[MaxMpqPathSize];
+	*BufCopy(out, szName, LevelDeltaSuffix) = '\0';
+}
+
+/**
+ * @brief Reads a level file and applies the changes from its delta file.
+ * @param snapshot if not null, receives the full level file that the delta applies to
+ */
+std::unique_ptr<std::byte[]> ReadLevelFile(SaveReader &archive, const char *szName, size_t &size, LevelSnapshot *snapshot)
+{
+	size_t baseSize;
+	std::unique_ptr<std::byte[]> base = ReadArchive(archive, szName, &baseSize);
+	if (base == nullptr)
+		return nullptr;
+	const std::span<const std::byte> baseData { base.get(), baseSize };
+
+	char szDeltaName[MaxMpqPathSize];
+	GetLevelDeltaName(szName, szDeltaName);
+	std::unique_ptr<std::byte[]> result;
+	uint16_t numDeltas = 0;
+	if (archive.HasFile(szDeltaName)) {
+		size_t deltaSize;
+		const std::unique_ptr<std::byte[]> delta = ReadArchive(archive, szDeltaName, &deltaSize);
+		if (delta != nullptr) {
+			const std::span<const std::byte> deltaData { delta.get(), deltaSize };
+			result = ApplySaveDelta(baseData, deltaData, size);
+			if (result != nullptr)
+				numDeltas = GetSaveDeltaGeneration(deltaData);
+		}
+		if (result == nullptr)
+			LogError("Ignoring {}, it does not apply to {}", szDeltaName, szName);
+	}
+
+	if (snapshot != nullptr) {
+		snapshot->data.assign(baseData.begin(), baseData.end());
+		snapshot->hash = GetSaveDeltaBaseHash(baseData);
+		snapshot->numDeltas = numDeltas;
+	}
+	if (result != nullptr)
+		return result;
+	size = baseSize;
+	return base;
+}
+
+/**
+ * @brief Writes the changes to the current level since its snapshot rather than the whole level.
+ * @return false if the level has to be written in full instead
+ */
+bool SaveLevelDelta(SaveWriter &saveWriter, const char *szName, std::span<const std::byte> level)
+{
+	if (!CurrentLevelSnapshot || CurrentLevelSnapshot->saveNumber != gSaveNumber || CurrentLevelSnapshot->fileName != szName)
+		return false;
+	LevelSnapshot &snapshot = *CurrentLevelSnapshot;
+	if (snapshot.numDeltas >= MaxLevelDeltas)
+		return false;
+
+	const std::vector<std::byte> delta = CreateSaveDelta(snapshot.data, snapshot.hash, level, snapshot.numDeltas + 1);
+	// The delta is against the snapshot, so it only grows. Past this point, starting over is cheaper.
+	if (delta.size() > level.size() / 4)
+		return false;
+
+	char szDeltaName[MaxMpqPathSize];
+	GetLevelDeltaName(szName, szDeltaName);
+	SaveHelper file(saveWriter, szDeltaName, delta.size());
+	file.WriteBytes(delta.data(), delta.size());
+	snapshot.numDeltas++;
+	return true;
+}
+
+/**
+ * @brief Makes a level that is written in full the snapshot that the following deltas are created against.
+ */
+void SetLevelSnapshot(SaveWriter &saveWriter, const char *szName, std::span<const std::byte> level)
+{
+	char szDeltaName[MaxMpqPathSize];
+	GetLevelDeltaName(szName, szDeltaName);
+	saveWriter.RemoveHashEntry(szDeltaName);
+	CurrentLevelSnapshot = LevelSnapshot {
+		.saveNumber = gSaveNumber,
+		.fileName = szName,
+		.data = { level.begin(), level.end() },
+		.hash = GetSaveDeltaBaseHash(level),
+		.numDeltas = 0,
+	};
+}
 
+/**
+ * @brief Finds the file of the current level, the temporary one if there is one.
+ */
+bool FindLevelFile(SaveReader &archive, char *szName)
+{
 	GetTempLevelNames(szName);
 	if (archive.HasFile(szName))
 		return true;
@@ -1082,7 +1326,7 @@ void LoadMatchingItems(LoadHelper &file, const Player &player, const int n, Item
 
 	for (int i = 0; i < n; i++) {
 		Item &unpackedItem = pItem[i];
-		const bool success = LoadItemData(file, heroItem);
+		const bool success = LoadItemData(file.NextRecord(GetItemSaveSize()), heroItem);
 		if (!success) {
 			heroItem.clear();
 			unpackedItem = Item();
@@ -1122,6 +1366,8 @@ void LoadMatchingItems(LoadHelper &file, const Player &player, const int n, Item
  */
 void LoadDroppedItems(LoadHelper &file, size_t savedItemCount)
 {
+	const SaveProfileScope profileScope(SaveProfileSection::LoadDroppedItems);
+
 	// Skip loading ActiveItems and AvailableItems, the indices are initialised below based on the number of valid items
 	file.Skip<uint8_t>(MAXITEMS * 2);
 
@@ -1887,6 +2133,8 @@ void LoadAdditionalMissiles()
 		return;
 	}
 
+	// Reading the file is already counted as decoding and unpacking, this covers parsing the missiles like `LoadGame` does.
+	const SaveProfileScope profileScope(SaveProfileSection::LoadMissiles);
 	auto loadedVersion = file.NextLE<uint32_t>();
 	if (loadedVersion > VersionAdditionalMissiles) {
 		// unknown version
@@ -1894,7 +2142,7 @@ void LoadAdditionalMissiles()
 	}
 	auto missileCountAdditional = file.NextLE<uint32_t>();
 	for (uint32_t i = 0U; i < missileCountAdditional; i++) {
-		LoadMissile(&file);
+		LoadMissile(file.NextRecord(MissileSaveSize));
 	}
 }
 
@@ -1998,27 +2246,25 @@ void SaveLevel(SaveWriter &saveWriter, LevelConversionData *levelConversionData)
 		}
 	}
 
+	// Converted levels are always written in full, the snapshot still has the old format.
+	if (levelConversionData == nullptr && SaveLevelDelta(saveWriter, szName, file.Data()))
+		file.Discard();
+	else
+		SetLevelSnapshot(saveWriter, szName, file.Data());
+
 	if (!setlevel)
 		myPlayer._pLvlVisited[currlevel] = true;
 	else
 		myPlayer._pSLvlVisited[setlvlnum] = true;
 }
 
-std::expected<void, std::string> LoadLevel(LevelConversionData *levelConversionData)
+std::expected<void, std::string> LoadLevel(LoadHelper &file, LevelConversionData *levelConversionData)
 {
-	char szName[MaxMpqPathSize];
-	std::optional<SaveReader> archive = OpenSaveArchive(gSaveNumber);
-	GetTempLevelNames(szName);
-	if (!archive || !archive->HasFile(szName))
-		GetPermLevelNames(szName);
-	LoadHelper file(std::move(archive), szName);
-	if (!file.IsValid())
-		return std::unexpected(std::string(_("Unable to open save file archive")));
-
 	if (leveltype != DTYPE_TOWN) {
+		RecordReader corpseGrid = file.NextRecord(MAXDUNX * MAXDUNY);
 		for (int j = 0; j < MAXDUNY; j++) {
 			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dCorpse[i][j] = file.NextLE<int8_t>();
+				dCorpse[i][j] = corpseGrid.NextLE<int8_t>();
 		}
 		MoveLightsToCorpses();
 	}
@@ -2040,8 +2286,11 @@ std::expected<void, std::string> LoadLevel(LevelConversionData *levelConversionD
 			objectId = file.NextLE<int8_t>();
 		for (int &objectId : AvailableObjects)
 			objectId = file.NextLE<int8_t>();
-		for (int i = 0; i < ActiveObjectCount; i++)
-			LoadObject(file, Objects[ActiveObjects[i]]);
+		{
+			const SaveProfileScope profileScope(SaveProfileSection::LoadObjects);
+			for (int i = 0; i < ActiveObjectCount; i++)
+				LoadObject(file.NextRecord(ObjectSaveSize), Objects[ActiveObjects[i]]);
+		}
 		if (!gbSkipSync) {
 			for (int i = 0; i < ActiveObjectCount; i++)
 				SyncObjectAnim(Objects[ActiveObjects[i]]);
@@ -2050,36 +2299,41 @@ std::expected<void, std::string> LoadLevel(LevelConversionData *levelConversionD
 
 	LoadDroppedItems(file, savedItemCount);
 
+	RecordReader flagGrid = file.NextRecord(MAXDUNX * MAXDUNY);
 	for (int j = 0; j < MAXDUNY; j++) {
 		for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			dFlags[i][j] = static_cast<DungeonFlag>(file.NextLE<uint8_t>()) & DungeonFlag::LoadedFlags;
+			dFlags[i][j] = static_cast<DungeonFlag>(flagGrid.NextLE<uint8_t>()) & DungeonFlag::LoadedFlags;
 	}
 
 	// skip dItem indexes, this gets populated in LoadDroppedItems
 	file.Skip<uint8_t>(MAXDUNX * MAXDUNY);
 
 	if (leveltype != DTYPE_TOWN) {
+		RecordReader monsterGrid = file.NextRecord(sizeof(int32_t) * MAXDUNX * MAXDUNY);
 		for (int j = 0; j < MAXDUNY; j++) {
 			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
 			{
-				dMonster[i][j] = file.NextBE<int32_t>();
+				dMonster[i][j] = monsterGrid.NextBE<int32_t>();
 				if (dMonster[i][j] > 0 && removedMonsterIds.contains(std::abs(dMonster[i][j]) - 1)) {
 					dMonster[i][j] = 0;
 				}
 			}
 		}
+		RecordReader objectGrid = file.NextRecord(MAXDUNX * MAXDUNY);
 		for (int j = 0; j < MAXDUNY; j++) {
 			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dObject[i][j] = file.NextLE<int8_t>();
+				dObject[i][j] = objectGrid.NextLE<int8_t>();
 		}
 		file.Skip<uint8_t>(MAXDUNY * MAXDUNX); // dLight
+		RecordReader preLightGrid = file.NextRecord(MAXDUNX * MAXDUNY);
 		for (int j = 0; j < MAXDUNY; j++) {
 			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dPreLight[i][j] = file.NextLE<uint8_t>();
+				dPreLight[i][j] = preLightGrid.NextLE<uint8_t>();
 		}
+		RecordReader automapGrid = file.NextRecord(DMAXX * DMAXY);
 		for (int j = 0; j < DMAXY; j++) {
 			for (int i = 0; i < DMAXX; i++) { // NOLINT(modernize-loop-convert)
-				const auto automapView = static_cast<MapExplorationType>(file.NextLE<uint8_t>());
+				const auto automapView = static_cast<MapExplorationType>(automapGrid.NextLE<uint8_t>());
 				AutomapView[i][j] = automapView == MAP_EXP_OLD ? MAP_EXP_SELF : automapView;
 			}
 		}
@@ -2105,8 +2359,58 @@ std::expected<void, std::string> LoadLevel(LevelConversionData *levelConversionD
 	return {};
 }
 
-const int DiabloItemSaveSize = 368;
-const int HellfireItemSaveSize = 372;
+std::expected<void, std::string> LoadLevel(LevelConversionData *levelConversionData)
+{
+	char szName[MaxMpqPathSize];
+	std::optional<SaveReader> archive = OpenSaveArchive(gSaveNumber);
+	GetTempLevelNames(szName);
+	// Only the temporary level files are written to, so deltas are only created against those.
+	const bool isTempLevel = archive && archive->HasFile(szName);
+	if (!isTempLevel)
+		GetPermLevelNames(szName);
+	CurrentLevelSnapshot = std::nullopt;
+	LevelSnapshot snapshot { .saveNumber = gSaveNumber, .fileName = szName };
+	size_t size = 0;
+	std::unique_ptr<std::byte[]> data;
+	if (archive)
+		data = ReadLevelFile(*archive, szName, size, isTempLevel ? &snapshot : nullptr);
+	LoadHelper file(std::move(data), size);
+	if (!file.IsValid())
+		return std::unexpected(std::string(_("Unable to open save file archive")));
+	if (isTempLevel)
+		CurrentLevelSnapshot = std::move(snapshot);
+
+	return LoadLevel(file, levelConversionData);
+}
+
+/** @brief A level that is converted, see `ConvertLevels`. */
+struct LevelToConvert {
+	bool setlevel;
+	/** `setlvlnum` for quest levels, `currlevel` otherwise. */
+	uint8_t levelNum;
+	dungeon_type leveltype;
+	char fileName[MaxMpqPathSize];
+	std::unique_ptr<std::byte[]> data;
+	size_t size;
+};
+
+/**
+ * @brief Reads the files of the given levels in parallel, `levels[i]` is read from `archives[i]`.
+ *
+ * Archives can not be shared between threads, so each level needs its own.
+ */
+std::expected<void, std::string> ReadLevelsToConvert(std::span<SaveReader *const> archives, std::span<LevelToConvert> levels)
+{
+	ParallelFor(levels.size(), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			levels[i].data = ReadLevelFile(*archives[i], levels[i].fileName, &levels[i].size);
+	});
+	for (const LevelToConvert &level : levels) {
+		if (level.data == nullptr)
+			return std::unexpected(StrCat(_("Unable to read the level file "), level.fileName, _(" from the save file archive")));
+	}
+	return {};
+}
 
 bool IsStashSizeValid(size_t stashSize, uint32_t pages, uint32_t itemCount)
 {
@@ -2125,7 +2429,7 @@ bool IsStashSizeValid(size_t stashSize, uint32_t pages, uint32_t itemCount)
 
 } // namespace
 
-std::expected<void, std::string> ConvertLevels(SaveWriter &saveWriter)
+std::expected<void, std::string> ConvertLevels(SaveReader &archive, SaveWriter &saveWriter)
 {
 	// Backup current level state
 	const bool tmpSetlevel = setlevel;
@@ -2135,17 +2439,14 @@ std::expected<void, std::string> ConvertLevels(SaveWriter &saveWriter)
 
 	gbSkipSync = true;
 
+	std::vector<LevelToConvert> levels;
+
 	setlevel = false; // Convert regular levels
 	for (int i = 0; i < giNumberOfLevels; i++) {
 		currlevel = i;
-		if (!LevelFileExists(saveWriter))
-			continue;
-
-		leveltype = GetLevelType(currlevel);
-
-		LevelConversionData levelConversionData;
-		RETURN_IF_ERROR(LoadLevel(&levelConversionData));
-		SaveLevel(saveWriter, &levelConversionData);
+		LevelToConvert level { .setlevel = false, .levelNum = static_cast<uint8_t>(i), .leveltype = GetLevelType(currlevel) };
+		if (FindLevelFile(archive, level.fileName))
+			levels.push_back(std::move(level));
 	}
 
 	setlevel = true; // Convert quest levels
@@ -2154,18 +2455,52 @@ std::expected<void, std::string> ConvertLevels(SaveWriter &saveWriter)
 			continue;
 		}
 
-		leveltype = quest._qlvltype;
-		if (leveltype == DTYPE_NONE) {
+		if (quest._qlvltype == DTYPE_NONE) {
 			continue;
 		}
 
 		setlvlnum = quest._qslvl;
-		if (!LevelFileExists(saveWriter))
-			continue;
+		LevelToConvert level { .setlevel = true, .levelNum = static_cast<uint8_t>(quest._qslvl), .leveltype = quest._qlvltype };
+		if (FindLevelFile(archive, level.fileName))
+			levels.push_back(std::move(level));
+	}
+
+	// Reading and decoding the level files doesn't touch the game state, so the levels of a batch are read in parallel.
+	// Converting a level goes through the global level state, so the levels are converted one at a time.
+	// Levels are read in batches to limit how many of them are held in memory.
+	const size_t batchSize = std::min(GetParallelWorkerCount(), levels.size());
+
+	// Each level of a batch is read from its own archive. The archives are opened once, up front, the
+	// pending saves were already waited for when `archive` was opened.
+	std::vector<SaveReader> ownArchives;
+	ownArchives.reserve(batchSize);
+	std::vector<SaveReader *> archives { &archive };
+	for (size_t i = 1; i < batchSize; ++i) {
+		std::expected<SaveReader, std::string> opened = OpenSaveArchiveWithoutWaiting(gSaveNumber);
+		if (!opened.has_value())
+			return std::unexpected(StrCat(_("Unable to open the save file archive to read "), levels[i].fileName, ": ", opened.error()));
+		archives.push_back(&ownArchives.emplace_back(std::move(*opened)));
+	}
+
+	for (size_t batchBegin = 0; batchBegin < levels.size(); batchBegin += batchSize) {
+		const std::span<LevelToConvert> batch { &levels[batchBegin], std::min(batchSize, levels.size() - batchBegin) };
+		RETURN_IF_ERROR(ReadLevelsToConvert(archives, batch));
 
-		LevelConversionData levelConversionData;
-		RETURN_IF_ERROR(LoadLevel(&levelConversionData));
-		SaveLevel(saveWriter, &levelConversionData);
+		for (LevelToConvert &level : batch) {
+			setlevel = level.setlevel;
+			if (setlevel)
+				setlvlnum = static_cast<_setlevels>(level.levelNum);
+			else
+				currlevel = level.levelNum;
+			leveltype = level.leveltype;
+
+			LoadHelper file(std::move(level.data), level.size);
+			if (!file.IsValid())
+				return std::unexpected(std::string(_("Unable to open save file archive")));
+			LevelConversionData levelConversionData;
+			RETURN_IF_ERROR(LoadLevel(file, &levelConversionData));
+			SaveLevel(saveWriter, &levelConversionData);
+		}
 	}
 
 	gbSkipSync = false;
@@ -2410,6 +2745,8 @@ constexpr uint8_t StashVersion = 0;
 
 void LoadStash()
 {
+	const SaveProfileScope profileScope(SaveProfileSection::LoadStash);
+
 	const char *filename;
 	if (!gbIsMultiplayer)
 		filename = "spstashitems";
@@ -2431,9 +2768,11 @@ void LoadStash()
 	Stash.gold = file.NextLE<uint32_t>();
 
 	auto pages = file.NextLE<uint32_t>();
+	std::vector<std::pair<unsigned, StashStruct::StashGrid>> grids;
 	for (unsigned i = 0; i < pages; i++) {
-		auto page = file.NextLE<uint32_t>();
-		for (auto &row : Stash.stashGrids[page]) {
+		auto &[page, grid] = grids.emplace_back();
+		page = file.NextLE<uint32_t>();
+		for (auto &row : grid) {
 			for (uint16_t &cell : row) {
 				cell = file.NextLE<uint16_t>();
 			}
@@ -2446,14 +2785,57 @@ void LoadStash()
 		EventPlrMsg(_("Stash size invalid. If you attempt to access your stash, data will be overwritten!!"), UiFlags::ColorRed);
 		return;
 	}
-	Stash.stashList.resize(itemCount);
-	for (unsigned i = 0; i < itemCount; i++) {
-		LoadAndValidateItemData(file, Stash.stashList[i]);
+
+	// Reading an item means recreating it, so each page keeps its items as they were saved until the page is used.
+	// Items that are on none of the pages can't be reached and are dropped.
+	const size_t itemSize = GetItemSaveSize();
+	std::vector<std::byte> itemData(itemSize * itemCount);
+	file.NextBytes(itemData.data(), itemData.size());
+	Stash.packedHellfire = gbIsHellfireSaveGame;
+	std::vector<StashStruct::StashCell> pageIds(itemCount + 1, 0);
+	for (const auto &[page, grid] : grids) {
+		StashStruct::PackedPage packedPage {};
+		for (size_t x = 0; x < grid.size(); x++) {
+			for (size_t y = 0; y < grid[x].size(); y++) {
+				const StashStruct::StashCell cell = grid[x][y];
+				if (cell == 0 || cell > itemCount)
+					continue;
+				if (pageIds[cell] == 0) {
+					pageIds[cell] = ++packedPage.itemCount;
+					const auto item = itemData.begin() + static_cast<ptrdiff_t>((cell - 1) * itemSize);
+					packedPage.items.insert(packedPage.items.end(), item, item + static_cast<ptrdiff_t>(itemSize));
+				}
+				packedPage.grid[x][y] = pageIds[cell];
+			}
+		}
+		for (const auto &row : grid) {
+			for (const StashStruct::StashCell cell : row) {
+				if (cell != 0 && cell <= itemCount)
+					pageIds[cell] = 0;
+			}
+		}
+		if (packedPage.itemCount != 0)
+			Stash.packedPages.insert_or_assign(page, std::move(packedPage));
 	}
 
 	Stash.SetPage(file.NextLE<uint32_t>());
 }
 
+void LoadPackedStashItems(std::span<const std::byte> items, bool hellfire, std::vector<Item> &stashList)
+{
+	const bool isHellfireSaveGame = gbIsHellfireSaveGame;
+	gbIsHellfireSaveGame = hellfire;
+	const size_t itemSize = GetItemSaveSize();
+	for (size_t offset = 0; offset + itemSize <= items.size(); offset += itemSize) {
+		Item &item = stashList.emplace_back();
+		if (LoadItemData(RecordReader { &items[offset] }, item))
+			RemoveInvalidItem(item);
+		else
+			item.clear();
+	}
+	gbIsHellfireSaveGame = isHellfireSaveGame;
+}
+
 void RemoveEmptyInventory(Player &player)
 {
 	for (int i = InventoryGridCells; i > 0; i--) {
@@ -2559,8 +2941,11 @@ std::expected<void, std::string> LoadGame(bool firstflag)
 		file.Skip<int8_t>(MaxMissilesForSaveGame);
 		// Skip AvailableMissiles
 		file.Skip<int8_t>(MaxMissilesForSaveGame);
-		for (int i = 0; i < tmpNummissiles; i++)
-			LoadMissile(&file);
+		{
+			const SaveProfileScope profileScope(SaveProfileSection::LoadMissiles);
+			for (int i = 0; i < tmpNummissiles; i++)
+				LoadMissile(file.NextRecord(MissileSaveSize));
+		}
 		// For petrified monsters, the data in missile.var1 must be used to
 		// load the appropriate animation data for the monster in missile.var2
 		for (size_t i = 0; i < ActiveMonsterCount; i++)
@@ -2569,8 +2954,11 @@ std::expected<void, std::string> LoadGame(bool firstflag)
 			objectId = file.NextLE<int8_t>();
 		for (int &objectId : AvailableObjects)
 			objectId = file.NextLE<int8_t>();
-		for (int i = 0; i < ActiveObjectCount; i++)
-			LoadObject(file, Objects[ActiveObjects[i]]);
+		{
+			const SaveProfileScope profileScope(SaveProfileSection::LoadObjects);
+			for (int i = 0; i < ActiveObjectCount; i++)
+				LoadObject(file.NextRecord(ObjectSaveSize), Objects[ActiveObjects[i]]);
+		}
 		for (int i = 0; i < ActiveObjectCount; i++)
 			SyncObjectAnim(Objects[ActiveObjects[i]]);
 
@@ -2598,44 +2986,51 @@ std::expected<void, std::string> LoadGame(bool firstflag)
 		uniqueItemFlag = file.NextBool8();
 
 	file.Skip<uint8_t>(MAXDUNY * MAXDUNX); // dLight
+	RecordReader flagGrid = file.NextRecord(MAXDUNX * MAXDUNY);
 	for (int j = 0; j < MAXDUNY; j++) {
 		for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			dFlags[i][j] = static_cast<DungeonFlag>(file.NextLE<uint8_t>()) & DungeonFlag::LoadedFlags;
+			dFlags[i][j] = static_cast<DungeonFlag>(flagGrid.NextLE<uint8_t>()) & DungeonFlag::LoadedFlags;
 	}
+	RecordReader playerGrid = file.NextRecord(MAXDUNX * MAXDUNY);
 	for (int j = 0; j < MAXDUNY; j++) {
 		for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			dPlayer[i][j] = file.NextLE<int8_t>();
+			dPlayer[i][j] = playerGrid.NextLE<int8_t>();
 	}
 
 	// skip dItem indexes, this gets populated in LoadDroppedItems
 	file.Skip<uint8_t>(MAXDUNX * MAXDUNY);
 
 	if (leveltype != DTYPE_TOWN) {
+		RecordReader monsterGrid = file.NextRecord(sizeof(int32_t) * MAXDUNX * MAXDUNY);
 		for (int j = 0; j < MAXDUNY; j++) {
 			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
 			{
-				dMonster[i][j] = file.NextBE<int32_t>();
+				dMonster[i][j] = monsterGrid.NextBE<int32_t>();
 				if (dMonster[i][j] > 0 && removedMonsterIds.contains(std::abs(dMonster[i][j]) - 1)) {
 					dMonster[i][j] = 0;
 				}
 			}
 		}
+		RecordReader corpseGrid = file.NextRecord(MAXDUNX * MAXDUNY);
 		for (int j = 0; j < MAXDUNY; j++) {
 			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dCorpse[i][j] = file.NextLE<int8_t>();
+				dCorpse[i][j] = corpseGrid.NextLE<int8_t>();
 		}
+		RecordReader objectGrid = file.NextRecord(MAXDUNX * MAXDUNY);
 		for (int j = 0; j < MAXDUNY; j++) {
 			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dObject[i][j] = file.NextLE<int8_t>();
+				dObject[i][j] = objectGrid.NextLE<int8_t>();
 		}
 		file.Skip<uint8_t>(MAXDUNY * MAXDUNX); // dLight
+		RecordReader preLightGrid = file.NextRecord(MAXDUNX * MAXDUNY);
 		for (int j = 0; j < MAXDUNY; j++) {
 			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dPreLight[i][j] = file.NextLE<uint8_t>();
+				dPreLight[i][j] = preLightGrid.NextLE<uint8_t>();
 		}
+		RecordReader automapGrid = file.NextRecord(DMAXX * DMAXY);
 		for (int j = 0; j < DMAXY; j++) {
 			for (int i = 0; i < DMAXX; i++) { // NOLINT(modernize-loop-convert)
-				const auto automapView = static_cast<MapExplorationType>(file.NextLE<uint8_t>());
+				const auto automapView = static_cast<MapExplorationType>(automapGrid.NextLE<uint8_t>());
 				AutomapView[i][j] = automapView == MAP_EXP_OLD ? MAP_EXP_SELF : automapView;
 			}
 		}
@@ -2684,6 +3079,7 @@ std::expected<void, std::string> LoadGame(bool firstflag)
 	}
 
 	gbIsHellfireSaveGame = gbIsHellfire;
+	LogItemRecreationCacheStats("load game");
 	return {};
 }
 
@@ -2712,15 +3108,19 @@ void SaveStash(SaveWriter &stashWriter)
 
 	const int itemSize = (gbIsHellfire ? HellfireItemSaveSize : DiabloItemSaveSize);
 
+	// Packed pages are written as they were loaded, unless the items have to be converted to the other game's format.
+	if (Stash.packedHellfire != gbIsHellfire)
+		Stash.UnpackAllPages();
+
 	SaveHelper file(
 	    stashWriter,
 	    filename,
 	    sizeof(uint8_t)
 	        + sizeof(uint32_t)
 	        + sizeof(uint32_t)
-	        + ((sizeof(uint32_t) + 10 * 10 * sizeof(uint16_t)) * Stash.stashGrids.size())
+	        + ((sizeof(uint32_t) + 10 * 10 * sizeof(uint16_t)) * (Stash.stashGrids.size() + Stash.packedPages.size()))
 	        + sizeof(uint32_t)
-	        + (itemSize * Stash.stashList.size())
+	        + (itemSize * Stash.ItemCount())
 	        + sizeof(uint32_t));
 
 	file.WriteLE<uint8_t>(StashVersion);
@@ -2740,7 +3140,7 @@ void SaveStash(SaveWriter &stashWriter)
 	};
 
 	// Current stash size is 100 pages. Will definitely fit in a 32 bit value.
-	file.WriteLE<uint32_t>(static_cast<uint32_t>(pagesToSave.size()));
+	file.WriteLE<uint32_t>(static_cast<uint32_t>(pagesToSave.size() + Stash.packedPages.size()));
 	for (const auto &page : pagesToSave) {
 		file.WriteLE<uint32_t>(page);
 		for (const auto &row : Stash.stashGrids[page]) {
@@ -2749,12 +3149,26 @@ void SaveStash(SaveWriter &stashWriter)
 			}
 		}
 	}
+	// The items of packed pages follow the items of stashList, in the same order as the pages.
+	size_t firstPackedItem = Stash.stashList.size();
+	for (const auto &[page, packedPage] : Stash.packedPages) {
+		file.WriteLE<uint32_t>(page);
+		for (const auto &row : packedPage.grid) {
+			for (const uint16_t cell : row) {
+				file.WriteLE<uint16_t>(cell == 0 ? 0 : static_cast<uint16_t>(firstPackedItem + cell));
+			}
+		}
+		firstPackedItem += packedPage.itemCount;
+	}
 
 	// 100 pages of 100 items is still only 10 000, as with the page count will definitely fit in 32 bits even in the worst case.
-	file.WriteLE<uint32_t>(static_cast<uint32_t>(Stash.stashList.size()));
+	file.WriteLE<uint32_t>(static_cast<uint32_t>(Stash.ItemCount()));
 	for (const Item &item : Stash.stashList) {
 		SaveItem(file, item);
 	}
+	for (const auto &[page, packedPage] : Stash.packedPages) {
+		file.WriteBytes(packedPage.items.data(), packedPage.items.size());
+	}
 
 	file.WriteLE<uint32_t>(static_cast<uint32_t>(Stash.GetPage()));
 }
@@ -2943,4 +3357,18 @@ std::expected<void, std::string> LoadLevel()
 	return LoadLevel(nullptr);
 }
 
+std::unique_ptr<std::byte[]> ReadLevelFile(SaveReader &archive, const char *szName, size_t *pdwLen)
+{
+	size_t size;
+	std::unique_ptr<std::byte[]> result = ReadLevelFile(archive, szName, size, nullptr);
+	if (result != nullptr && pdwLen != nullptr)
+		*pdwLen = size;
+	return result;
+}
+
+void ClearLevelSnapshot()
+{
+	CurrentLevelSnapshot = std::nullopt;
+}
+
 } // namespace devilution
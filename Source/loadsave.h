@@ -5,8 +5,13 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
 
 #include "pfile.h"
 #include "player.h"
@@ -40,10 +45,42 @@ void SaveHotkeys(SaveWriter &saveWriter, const Player &player);
 void SaveHeroItems(SaveWriter &saveWriter, Player &player);
 void SaveGameData(SaveWriter &saveWriter);
 void SaveGame();
+/**
+ * @brief Saves the current level
+ *
+ * When the level was last read from or written to the same file, only the changes are written to a delta file
+ * (see `LevelDeltaSuffix`). Every few saves, the level is written in full again.
+ */
 void SaveLevel(SaveWriter &saveWriter);
 std::expected<void, std::string> LoadLevel();
-std::expected<void, std::string> ConvertLevels(SaveWriter &saveWriter);
+/** @brief Suffix of the file holding the changes to a level file since it was last written in full. */
+constexpr std::string_view LevelDeltaSuffix = ".dlt";
+/**
+ * @brief Reads a level file, including the changes from its delta file.
+ */
+std::unique_ptr<std::byte[]> ReadLevelFile(SaveReader &archive, const char *szName, size_t *pdwLen = nullptr);
+/**
+ * @brief Forgets the level that deltas are created against, needed when the level files were removed or renamed.
+ */
+void ClearLevelSnapshot();
+/**
+ * @brief Rewrites the level files of the save in the current format.
+ *
+ * Only reading and decoding the level files is spread over several threads. Loading and saving a level
+ * go through the global dungeon state, so the levels themselves are converted one at a time.
+ */
+std::expected<void, std::string> ConvertLevels(SaveReader &archive, SaveWriter &saveWriter);
+/**
+ * @brief Loads the stash, only the items of the current page are read.
+ *
+ * The other pages are kept in `StashStruct::packedPages` until they are used.
+ */
 void LoadStash();
+/**
+ * @brief Reads the items of a packed stash page and appends them to `stashList`.
+ * @param hellfire Whether the items were saved by Hellfire.
+ */
+void LoadPackedStashItems(std::span<const std::byte> items, bool hellfire, std::vector<Item> &stashList);
 void SaveStash(SaveWriter &stashWriter);
 
 } // namespace devilution
@@ -40,6 +40,7 @@
 #include "options.h"
 #include "plrmsg.h"
 #include "stores.h"
+#include "tables/deferred_tables.hpp"
 #include "utils/console.h"
 #include "utils/log.hpp"
 #include "utils/str_cat.hpp"
@@ -267,17 +268,13 @@ void LuaReloadActiveMods()
 	else
 		ui_sound_init();
 
-	// Reload game data (this can probably be done later in the process to avoid having to reload it)
+	// Reload game data. Only the tables needed by the menus are loaded right away,
+	// `LoadModsComplete` fires once the remaining ones have been loaded as well.
 	LoadTextData();
 	LoadPlayerDataFiles();
-	LoadSpellData();
-	LoadMissileData();
-	LoadMonsterData();
-	LoadItemData();
-	LoadObjectData();
-	LoadQuestData();
-
-	lua::LoadModsComplete();
+	InvalidateDeferredTables(/*notifyMods=*/true);
+	if (gbRunGame)
+		EnsureDeferredTablesLoaded();
 }
 
 void LuaInitialize()
@@ -456,12 +456,14 @@ void AddItemDataFromTsv(const std::string_view path, const int32_t baseMappingId
 {
 	DataFile dataFile = DataFile::loadOrDie(path);
 	LoadItemDatFromFile(dataFile, path, baseMappingId);
+	ClearItemRecreationCache();
 }
 
 void AddUniqueItemDataFromTsv(const std::string_view path, const int32_t baseMappingId)
 {
 	DataFile dataFile = DataFile::loadOrDie(path);
 	LoadUniqueItemDatFromFile(dataFile, path, baseMappingId);
+	ClearItemRecreationCache();
 }
 
 } // namespace
@@ -0,0 +1,82 @@
+#include "monsters/sync_priority.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace devilution {
+
+void MonsterSyncScheduler::Reset()
+{
+	syncs_ = 0;
+	sentStates_.fill({});
+}
+
+uint32_t MonsterSyncScheduler::Score(const MonsterSyncState &monster) const
+{
+	const SentState &sentState = sentStates_[monster.monsterId];
+	const uint32_t age = syncs_ - sentState.sentAt;
+	if (!sentState.known)
+		return age * UnchangedAgeWeight;
+	const bool hitPointsChanged = sentState.hitPoints != monster.hitPoints;
+	const bool modeChanged = sentState.mode != monster.mode;
+	const bool moved = sentState.x != monster.x || sentState.y != monster.y;
+	// The other players already have the last sent state, so resending it only guards against them drifting apart.
+	if (!hitPointsChanged && !modeChanged && !moved)
+		return age * UnchangedAgeWeight;
+
+	uint32_t score = age * AgeWeight;
+	if (hitPointsChanged)
+		score += HitPointsChangedBonus;
+	if (modeChanged)
+		score += ModeChangedBonus;
+	if (moved)
+		score += MovedBonus;
+	// An idle monster looks the same to everyone, so being close to a player only matters once it moves.
+	if (monster.active && monster.viewerDistance < ViewDistance)
+		score += (ViewDistance - monster.viewerDistance) * ViewerBonusPerTile;
+	return score;
+}
+
+size_t MonsterSyncScheduler::Schedule(std::span<const MonsterSyncState> monsters, std::span<uint8_t> selected)
+{
+	scores_.clear();
+	for (size_t i = 0; i < monsters.size(); i++) {
+		const MonsterSyncState &monster = monsters[i];
+		SentState &sentState = sentStates_[monster.monsterId];
+		if (!sentState.known) {
+			// The other players generated the same level, so they start out with the state it has when first seen here.
+			sentState.hitPoints = monster.hitPoints;
+			sentState.x = monster.x;
+			sentState.y = monster.y;
+			sentState.mode = monster.mode;
+			sentState.known = true;
+		}
+		scores_.emplace_back(Score(monster), i);
+	}
+
+	const size_t count = std::min(selected.size(), scores_.size());
+	// Highest score first, ties go to the lower id so that the order doesn't depend on the input order.
+	std::partial_sort(scores_.begin(), scores_.begin() + count, scores_.end(), [&monsters](const auto &a, const auto &b) {
+		return a.first != b.first ? a.first > b.first : monsters[a.second].monsterId < monsters[b.second].monsterId;
+	});
+
+	for (size_t i = 0; i < count; i++) {
+		const MonsterSyncState &monster = monsters[scores_[i].second];
+		selected[i] = monster.monsterId;
+		sentStates_[monster.monsterId] = SentState {
+			.sentAt = syncs_,
+			.hitPoints = monster.hitPoints,
+			.x = monster.x,
+			.y = monster.y,
+			.mode = monster.mode,
+			.known = true,
+		};
+	}
+	syncs_++;
+
+	return count;
+}
+
+} // namespace devilution
@@ -0,0 +1,89 @@
+/**
+ * @file monsters/sync_priority.hpp
+ *
+ * Picks which monsters go into the monster sync part of a network packet.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace devilution {
+
+/** @brief The state of a monster that is sent in a `TSyncMonster`, plus how much the other players care about it. */
+struct MonsterSyncState {
+	uint8_t monsterId;
+	uint8_t x;
+	uint8_t y;
+	uint8_t mode;
+	int32_t hitPoints;
+	/** False if the monster hasn't noticed any player, its state then rarely changes. */
+	bool active;
+	/**
+	 * Distance to the closest other player on the level that takes this player's word for the monster,
+	 * i.e. that isn't closer to it than this player. `NoViewer` if there is no such player.
+	 */
+	uint32_t viewerDistance;
+
+	static constexpr uint32_t NoViewer = UINT32_MAX;
+};
+
+/**
+ * @brief Fills the monster sync part of packets with the monsters the other players need most.
+ *
+ * Every monster gets a score from the time since it was last sent, whether its hit points, mode or
+ * position changed since then and how close it is to another player. The highest scores are sent.
+ * Monsters that didn't change score slowly. Since every score grows with the time since the last
+ * sync, every monster is sent eventually.
+ */
+class MonsterSyncScheduler {
+public:
+	static constexpr size_t MaxMonsterId = UINT8_MAX + 1;
+
+	/** Score per sync that a changed monster wasn't sent. */
+	static constexpr uint32_t AgeWeight = 8;
+	/** Score per sync that a monster that didn't change since it was last sent wasn't sent. */
+	static constexpr uint32_t UnchangedAgeWeight = 1;
+	static constexpr uint32_t HitPointsChangedBonus = 192;
+	static constexpr uint32_t ModeChangedBonus = 96;
+	static constexpr uint32_t MovedBonus = 32;
+	/** Monsters closer than this to another player score more the closer they are. */
+	static constexpr uint32_t ViewDistance = 32;
+	static constexpr uint32_t ViewerBonusPerTile = 8;
+
+	/** @brief Forgets what was sent, such as when entering a level. Monsters count as unchanged until they change after that. */
+	void Reset();
+
+	/**
+	 * @brief Picks the monsters for one packet and remembers them as sent.
+	 * @param monsters The monsters that could be sent.
+	 * @param selected Receives the ids of the picked monsters, most important first.
+	 * @return The number of monsters picked, at most `selected.size()`.
+	 */
+	size_t Schedule(std::span<const MonsterSyncState> monsters, std::span<uint8_t> selected);
+
+	/** @brief The score that a monster has in the next call to `Schedule`. */
+	[[nodiscard]] uint32_t Score(const MonsterSyncState &monster) const;
+
+private:
+	struct SentState {
+		uint32_t sentAt = 0;
+		int32_t hitPoints = 0;
+		uint8_t x = 0;
+		uint8_t y = 0;
+		uint8_t mode = 0;
+		/** False until the monster is first passed to `Schedule`. */
+		bool known = false;
+	};
+
+	uint32_t syncs_ = 0;
+	std::array<SentState, MaxMonsterId> sentStates_ {};
+	/** Scores and indices of the monsters passed to `Schedule`, kept to reuse the allocation. */
+	std::vector<std::pair<uint32_t, size_t>> scores_;
+};
+
+} // namespace devilution
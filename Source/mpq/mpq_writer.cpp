@@ -3,6 +3,7 @@
 #include <cerrno>
 #include <cstring>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include <mpqfs/mpqfs.h>
@@ -27,10 +28,24 @@ std::string FormatMpqfsError(mpqfs_error_code code)
 	return mpqfs_error_message(code);
 }
 
+/** Replaces the extension with .tmp rather than appending it to stay 8.3 compliant. */
+std::string GetTempPath(std::string_view path)
+{
+	std::string tmpPath { path };
+	const size_t sep = tmpPath.find_last_of("/\\");
+	const size_t dot = tmpPath.find_last_of('.');
+	if (dot != std::string::npos && (sep == std::string::npos || dot > sep)) {
+		tmpPath.resize(dot);
+	}
+	tmpPath += ".tmp";
+	return tmpPath;
+}
+
 } // namespace
 
 MpqWriter::MpqWriter(const char *path, bool carryForward)
     : path_(path)
+    , tmpPath_(GetTempPath(path))
 {
 	const std::string dir = std::string(Dirname(path));
 	if (!dir.empty()) {
@@ -38,35 +53,21 @@ MpqWriter::MpqWriter(const char *path, bool carryForward)
 	}
 	LogVerbose("Opening {}", path);
 
-	// If the file already exists and we need to preserve its contents,
-	// rename it to a temp path so we can read from it after the writer
-	// truncates the original path.
-	std::string tmpPath;
+	// The new archive is written to a temp path and only replaces the original once it is complete,
+	// so the original can be read from while carrying its files forward.
+	::devilution::RemoveFile(tmpPath_.c_str());
 	mpqfs_archive_t *oldArchive = nullptr;
 	if (carryForward && FileExists(path)) {
-		// Replace the extension with .tmp rather than appending it to stay 8.3 compliant.
-		tmpPath = std::string(path);
-		const size_t sep = tmpPath.find_last_of("/\\");
-		const size_t dot = tmpPath.find_last_of('.');
-		if (dot != std::string::npos && (sep == std::string::npos || dot > sep)) {
-			tmpPath.resize(dot);
-		}
-		tmpPath += ".tmp";
-		// Remove any stale temp file, then rename old → tmp.
-		::devilution::RemoveFile(tmpPath.c_str());
-		::devilution::RenameFile(path, tmpPath.c_str());
 		// If it fails to open (e.g. corrupt), we proceed without
 		// carry-forward — the file will be recreated from scratch.
-		(void)mpqfs_open(tmpPath.c_str(), &oldArchive);
+		(void)mpqfs_open(path, &oldArchive);
 	}
 
-	const mpqfs_error_code code = mpqfs_writer_create(path, MpqWriterHashTableSize, &writer_);
+	const mpqfs_error_code code = mpqfs_writer_create(tmpPath_.c_str(), MpqWriterHashTableSize, &writer_);
 	if (code != MPQFS_OK) {
-		LogError("Failed to write MPQ archive to {}: {}", path, FormatMpqfsError(code));
+		LogError("Failed to write MPQ archive to {}: {}", tmpPath_, FormatMpqfsError(code));
 		if (oldArchive != nullptr)
 			mpqfs_close(oldArchive);
-		if (!tmpPath.empty())
-			::devilution::RemoveFile(tmpPath.c_str());
 		return;
 	}
 
@@ -77,13 +78,11 @@ MpqWriter::MpqWriter(const char *path, bool carryForward)
 		}
 		mpqfs_close(oldArchive);
 	}
-
-	if (!tmpPath.empty())
-		::devilution::RemoveFile(tmpPath.c_str());
 }
 
 MpqWriter::MpqWriter(MpqWriter &&other) noexcept
     : path_(std::move(other.path_))
+    , tmpPath_(std::move(other.tmpPath_))
     , writer_(other.writer_)
 {
 	other.writer_ = nullptr;
@@ -92,9 +91,12 @@ MpqWriter::MpqWriter(MpqWriter &&other) noexcept
 MpqWriter &MpqWriter::operator=(MpqWriter &&other) noexcept
 {
 	if (this != &other) {
-		if (writer_ != nullptr)
+		if (writer_ != nullptr) {
 			mpqfs_writer_discard(writer_);
+			::devilution::RemoveFile(tmpPath_.c_str());
+		}
 		path_ = std::move(other.path_);
+		tmpPath_ = std::move(other.tmpPath_);
 		writer_ = other.writer_;
 		other.writer_ = nullptr;
 	}
@@ -110,8 +112,12 @@ MpqWriter::~MpqWriter()
 
 	const mpqfs_error_code code = mpqfs_writer_close(writer_);
 	if (code != MPQFS_OK) {
+		// Keep the previous archive rather than replacing it with a broken one.
 		LogError("Failed to close MPQ archive {}: {}", path_, FormatMpqfsError(code));
+		::devilution::RemoveFile(tmpPath_.c_str());
+		return;
 	}
+	RenameFileOverwrite(tmpPath_.c_str(), path_.c_str());
 }
 
 bool MpqWriter::HasFile(std::string_view name) const
@@ -18,8 +18,18 @@ namespace devilution {
 
 constexpr uint32_t MpqWriterHashTableSize = 2048;
 
+/**
+ * @brief Writes an MPQ archive.
+ *
+ * The archive is written to a temporary file next to `path` that replaces `path` once the writer
+ * is destroyed, so the archive at `path` stays intact if the game crashes while writing.
+ */
 class MpqWriter {
 public:
+	/**
+	 * @param path the archive to write
+	 * @param carryForward keep the files of the existing archive at `path`
+	 */
 	explicit MpqWriter(const char *path, bool carryForward = true);
 	explicit MpqWriter(const std::string &path, bool carryForward = true)
 	    : MpqWriter(path.c_str(), carryForward)
@@ -40,6 +50,7 @@ public:
 
 private:
 	std::string path_;
+	std::string tmpPath_;
 	mpqfs_writer_t *writer_ = nullptr;
 };
 
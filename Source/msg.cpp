@@ -35,6 +35,7 @@
 #include "engine/world_tile.hpp"
 #include "gamemenu.h"
 #include "items/validation.h"
+#include "level_delta_slots.hpp"
 #include "levels/crypt.h"
 #include "levels/town.h"
 #include "levels/trigs.h"
@@ -108,9 +109,6 @@ void LogFailedPacket(const char *condition, const char *name1, T1 value1, const
 uint8_t gbBufferMsgs;
 int dwRecCount;
 
-namespace {
-
-#ifdef LOG_RECEIVED_MESSAGES
 std::string_view CmdIdString(_cmd_id cmd)
 {
 	// clang-format off
@@ -195,6 +193,7 @@ std::string_view CmdIdString(_cmd_id cmd)
 	case CMD_OPENHIVE: return "CMD_OPENHIVE";
 	case CMD_OPENGRAVE: return "CMD_OPENGRAVE";
 	case CMD_SPAWNMONSTER: return "CMD_SPAWNMONSTER";
+	case CMD_TURNDELAY: return "CMD_TURNDELAY";
 	case FAKE_CMD_SETID: return "FAKE_CMD_SETID";
 	case FAKE_CMD_DROPID: return "FAKE_CMD_DROPID";
 	case CMD_INVALID: return "CMD_INVALID";
@@ -202,7 +201,8 @@ std::string_view CmdIdString(_cmd_id cmd)
 	}
 	// clang-format on
 }
-#endif // LOG_RECEIVED_MESSAGES
+
+namespace {
 
 struct TMegaPkt {
 	size_t spaceLeft;
@@ -285,14 +285,14 @@ uint8_t sbLastCmd;
 /**
  * @brief buffer used to receive level deltas, size is the worst expected case assuming every object on a level was touched
  */
-std::byte sgRecvBuf[1U                                               /* marker byte, always 0 */
-    + sizeof(uint8_t)                                                /* level id */
-    + sizeof(DLevel::item)                                           /* items spawned during dungeon generation which have been picked up, and items dropped by a player during a game */
-    + sizeof(uint8_t)                                                /* count of object interactions which caused a state change since dungeon generation */
-    + ((sizeof(WorldTilePosition) + sizeof(_cmd_id)) * MAXOBJECTS)   /* location/action pairs for the object interactions */
-    + sizeof(DLevel::monster)                                        /* latest monster state */
-    + sizeof(uint16_t)                                               /* spawned monster count */
-    + ((sizeof(uint16_t) + sizeof(DSpawnedMonster)) * MaxMonsters)]; /* spawned monsters */
+std::byte sgRecvBuf[1U                                                          /* marker byte, always 0 */
+    + sizeof(uint8_t)                                                           /* level id */
+    + sizeof(uint8_t) + ((sizeof(uint8_t) + sizeof(TCmdPItem)) * MAXITEMS)      /* items spawned during dungeon generation which have been picked up, and items dropped by a player during a game */
+    + sizeof(uint8_t)                                                           /* count of object interactions which caused a state change since dungeon generation */
+    + ((sizeof(WorldTilePosition) + sizeof(_cmd_id)) * MAXOBJECTS)              /* location/action pairs for the object interactions */
+    + sizeof(uint8_t) + ((sizeof(uint8_t) + sizeof(DMonsterStr)) * MaxMonsters) /* latest state of the monsters that changed */
+    + sizeof(uint16_t)                                                          /* spawned monster count */
+    + ((sizeof(uint16_t) + sizeof(DSpawnedMonster)) * MaxMonsters)];            /* spawned monsters */
 
 _cmd_id sgbRecvCmd;
 ankerl::unordered_dense::map<uint8_t, LocalLevel> LocalLevels;
@@ -540,38 +540,21 @@ int WaitForTurns()
 
 std::byte *DeltaExportItem(std::byte *dst, const TCmdPItem *src)
 {
-	for (int i = 0; i < MAXITEMS; i++, src++) {
-		if (src->bCmd == CMD_INVALID) {
-			*dst++ = std::byte { 0xFF };
-		} else {
-			memcpy(dst, src, sizeof(TCmdPItem));
-			dst += sizeof(TCmdPItem);
-		}
-	}
-
-	return dst;
+	return ExportDeltaSlots<MAXITEMS>(dst, src, [](const TCmdPItem &item) { return item.bCmd != CMD_INVALID; });
 }
 
 const std::byte *DeltaImportItem(const std::byte *src, const std::byte *end, TCmdPItem *dst)
 {
-	size_t size = 0;
-	for (int i = 0; i < MAXITEMS; i++, dst++) {
-		if (&src[size] >= end)
-			return nullptr;
-		if (src[size] == std::byte { 0xFF }) {
-			memset(dst, 0xFF, sizeof(TCmdPItem));
-			size++;
-		} else {
-			if (&src[size] + sizeof(TCmdPItem) > end)
-				return nullptr;
-			memcpy(dst, &src[size], sizeof(TCmdPItem));
-			if (!IsItemDeltaValid(*dst))
-				memset(dst, 0xFF, sizeof(TCmdPItem));
-			size += sizeof(TCmdPItem);
-		}
+	src = ImportDeltaSlots<MAXITEMS>(src, end, dst);
+	if (src == nullptr)
+		return nullptr;
+
+	for (int i = 0; i < MAXITEMS; i++) {
+		if (!IsItemDeltaValid(dst[i]))
+			memset(&dst[i], 0xFF, sizeof(TCmdPItem));
 	}
 
-	return src + size;
+	return src;
 }
 
 std::byte *DeltaExportObject(std::byte *dst, const ankerl::unordered_dense::map<WorldTilePosition, DObjectStr> &src)
@@ -614,39 +597,12 @@ const std::byte *DeltaImportObjects(const std::byte *src, const std::byte *end,
 
 std::byte *DeltaExportMonster(std::byte *dst, const DMonsterStr *src)
 {
-	for (size_t i = 0; i < MaxMonsters; i++, src++) {
-		if (src->position.x == 0xFF) {
-			*dst++ = std::byte { 0xFF };
-		} else {
-			memcpy(dst, src, sizeof(DMonsterStr));
-			dst += sizeof(DMonsterStr);
-		}
-	}
-
-	return dst;
+	return ExportDeltaSlots<MaxMonsters>(dst, src, [](const DMonsterStr &monster) { return monster.position.x != 0xFF; });
 }
 
 const std::byte *DeltaImportMonster(const std::byte *src, const std::byte *end, DMonsterStr *dst)
 {
-	if (src == nullptr)
-		return nullptr;
-
-	size_t size = 0;
-	for (size_t i = 0; i < MaxMonsters; i++, dst++) {
-		if (&src[size] >= end)
-			return nullptr;
-		if (src[size] == std::byte { 0xFF }) {
-			memset(dst, 0xFF, sizeof(DMonsterStr));
-			size++;
-		} else {
-			if (&src[size] + sizeof(DMonsterStr) > end)
-				return nullptr;
-			memcpy(dst, &src[size], sizeof(DMonsterStr));
-			size += sizeof(DMonsterStr);
-		}
-	}
-
-	return src + size;
+	return ImportDeltaSlots<MaxMonsters>(src, end, dst);
 }
 
 std::byte *DeltaExportSpawnedMonsters(std::byte *dst, const ankerl::unordered_dense::map<size_t, DSpawnedMonster> &spawnedMonsters)
@@ -2566,6 +2522,14 @@ size_t OnSetReflect(const TCmdParam1 &message, Player &player)
 	return sizeof(message);
 }
 
+size_t OnTurnDelay(const TCmdParam1 &message, Player &player)
+{
+	if (&player != MyPlayer)
+		nthread_set_player_turn_delay(player.getId(), Swap16LE(message.wParam1));
+
+	return sizeof(message);
+}
+
 size_t OnNakrul(const TCmd &cmd)
 {
 	if (gbBufferMsgs != 1) {
@@ -2739,6 +2703,7 @@ bool msg_wait_resync()
 	gbBufferMsgs = 1;
 	sgdwOwnerWait = SDL_GetTicks();
 	success = UiProgressDialog(WaitForTurns);
+	DvlNet_RecordWaitForTurns(SDL_GetTicks() - sgdwOwnerWait);
 	gbBufferMsgs = 0;
 	if (!success) {
 		FreePackets();
@@ -2773,13 +2738,17 @@ void run_delta_info()
 
 void DeltaExportData(uint8_t pnum)
 {
+	const uint32_t startTicks = SDL_GetTicks();
+	size_t encodedBytes = 0;
+	size_t sentBytes = 0;
+
 	for (const auto &[levelNum, deltaLevel] : DeltaLevels) {
 		const size_t bufferSize = 1U                                                              /* marker byte, always 0 */
 		    + sizeof(uint8_t)                                                                     /* level id */
-		    + sizeof(deltaLevel.item)                                                             /* items spawned during dungeon generation which have been picked up, and items dropped by a player during a game */
+		    + MaxDeltaSlotsSize<TCmdPItem, MAXITEMS>                                              /* items spawned during dungeon generation which have been picked up, and items dropped by a player during a game */
 		    + sizeof(uint8_t)                                                                     /* count of object interactions which caused a state change since dungeon generation */
 		    + ((sizeof(WorldTilePosition) + sizeof(DObjectStr)) * deltaLevel.object.size())       /* location/action pairs for the object interactions */
-		    + sizeof(deltaLevel.monster)                                                          /* latest monster state */
+		    + MaxDeltaSlotsSize<DMonsterStr, MaxMonsters>                                         /* latest state of the monsters that changed */
 		    + sizeof(uint16_t)                                                                    /* spawned monster count */
 		    + ((sizeof(uint16_t) + sizeof(DSpawnedMonster)) * deltaLevel.spawnedMonsters.size()); /* spawned monsters */
 		const std::unique_ptr<std::byte[]> dst { new std::byte[bufferSize] };
@@ -2791,18 +2760,24 @@ void DeltaExportData(uint8_t pnum)
 		dstEnd = DeltaExportObject(dstEnd, deltaLevel.object);
 		dstEnd = DeltaExportMonster(dstEnd, deltaLevel.monster);
 		dstEnd = DeltaExportSpawnedMonsters(dstEnd, deltaLevel.spawnedMonsters);
+		encodedBytes += dstEnd - dst.get();
 		const uint32_t size = CompressData(dst.get(), dstEnd);
+		sentBytes += size;
 		multi_send_zero_packet(pnum, CMD_DLEVEL, dst.get(), size);
 	}
 
 	std::byte dst[sizeof(DJunk) + 1];
 	std::byte *dstEnd = &dst[1];
 	dstEnd = DeltaExportJunk(dstEnd);
+	encodedBytes += dstEnd - dst;
 	const uint32_t size = CompressData(dst, dstEnd);
+	sentBytes += size;
 	multi_send_zero_packet(pnum, CMD_DLEVEL_JUNK, dst, size);
 
 	std::byte src[1] = { static_cast<std::byte>(0) };
 	multi_send_zero_packet(pnum, CMD_DLEVEL_END, src, 1);
+
+	LogVerbose("Sent deltas of {} levels to player {}: {} bytes, {} compressed, in {} ms", DeltaLevels.size(), pnum, encodedBytes, sentBytes, SDL_GetTicks() - startTicks);
 }
 
 void delta_init()
@@ -3498,6 +3473,8 @@ size_t ParseCmd(uint8_t pnum, const TCmd *pCmd, size_t maxCmdSize)
 		return OnOpenGrave(*pCmd);
 	case CMD_SPAWNMONSTER:
 		return HandleCmd(OnSpawnMonster, player, pCmd, maxCmdSize);
+	case CMD_TURNDELAY:
+		return HandleCmd(OnTurnDelay, player, pCmd, maxCmdSize);
 	default:
 		break;
 	}
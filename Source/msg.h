@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string_view>
 
 #include "dvlnet/leaveinfo.hpp"
 #include "engine/point.hpp"
@@ -416,6 +417,10 @@ enum _cmd_id : uint8_t {
 	//
 	// body (TCmdSpawnMonster)
 	CMD_SPAWNMONSTER,
+	// Number of turns in transit that the player wants.
+	//
+	// body (TCmdParam1)
+	CMD_TURNDELAY,
 	// Fake command; set current player for succeeding mega pkt buffer messages.
 	//
 	// body (TFakeCmdPlr)
@@ -762,5 +767,7 @@ void NetSendCmdString(uint32_t pmask, const char *pszStr);
 void delta_close_portal(const Player &player);
 bool ValidateCmdSize(size_t requiredCmdSize, size_t maxCmdSize, size_t playerId);
 size_t ParseCmd(uint8_t pnum, const TCmd *pCmd, size_t maxCmdSize);
+/** @brief The name of a command for logs and network statistics, empty for unknown commands. */
+std::string_view CmdIdString(_cmd_id cmd);
 
 } // namespace devilution
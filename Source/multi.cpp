@@ -5,8 +5,11 @@
  */
 #include "multi.h"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <format>
 #include <string_view>
@@ -43,6 +46,7 @@
 #include "tmsg.h"
 #include "utils/endian_read.hpp"
 #include "utils/endian_swap.hpp"
+#include "utils/file_util.h"
 #include "utils/format.hpp"
 #include "utils/is_of.hpp"
 #include "utils/language.h"
@@ -109,6 +113,19 @@ struct TBuffer {
 TBuffer highPriorityBuffer;
 TBuffer lowPriorityBuffer;
 
+/** Messages for one player that are sent together in a single packet by `multi_flush_packets`. */
+struct CoalescedPacket {
+	size_t size;
+	std::byte body[sizeof(TPkt::body)];
+};
+
+std::array<CoalescedPacket, MAX_PLRS> CoalescedPackets;
+/** The buffered messages and monster sync data are shared with the other players by the next `multi_flush_packets`. */
+bool sgbShareBufferedPackets;
+NetTrafficCounters TrafficCounters;
+/** Where the network statistics of a game are written when it ends, see `SetNetStatsPath`. */
+std::string NetStatsPath;
+
 constexpr uint16_t HeaderCheckVal =
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
     LoadBE16("ip");
@@ -118,6 +135,18 @@ constexpr uint16_t HeaderCheckVal =
 
 uint32_t sgbSentThisCycle;
 
+/**
+ * @brief Counts a command in the network statistics.
+ *
+ * Commands to and from this player never go over the network, so they are left out.
+ */
+void RecordCommand(uint8_t playerId, bool sent, const std::byte *command, size_t size)
+{
+	if (!gbIsMultiplayer || playerId == MyPlayerId || size == 0)
+		return;
+	DvlNet_RecordCommand(playerId, sent, static_cast<uint8_t>(command[0]), size);
+}
+
 void BufferInit(TBuffer *pBuf)
 {
 	pBuf->dwNextWriteOffset = 0;
@@ -149,6 +178,7 @@ std::byte *CopyBufferedPackets(std::byte *destination, TBuffer *source, size_t *
 			if (chunkSize > *size)
 				break;
 			srcPtr++;
+			RecordCommand(SNPLAYER_OTHERS, /*sent=*/true, srcPtr, chunkSize);
 			memcpy(destination, srcPtr, chunkSize);
 			destination += chunkSize;
 			srcPtr += chunkSize;
@@ -216,7 +246,14 @@ void CheckPlayerInfoTimeouts()
 	}
 }
 
-void SendPacket(uint8_t playerId, const std::byte *packet, size_t size)
+bool SendNetMessage(uint8_t playerId, void *data, size_t size)
+{
+	TrafficCounters.packetsSent++;
+	TrafficCounters.bytesSent += size;
+	return SNetSendMessage(playerId, data, size);
+}
+
+void SendPacketNow(uint8_t playerId, const std::byte *packet, size_t size)
 {
 	TPkt pkt;
 
@@ -224,10 +261,68 @@ void SendPacket(uint8_t playerId, const std::byte *packet, size_t size)
 	const size_t sizeWithheader = size + sizeof(pkt.hdr);
 	pkt.hdr.wLen = Swap16LE(static_cast<uint16_t>(sizeWithheader));
 	memcpy(pkt.body, packet, size);
-	if (!SNetSendMessage(playerId, &pkt.hdr, sizeWithheader))
+	if (!SendNetMessage(playerId, &pkt.hdr, sizeWithheader))
 		nthread_terminate_game("SNetSendMessage0");
 }
 
+/** @brief The most message bytes that fit into one packet. */
+size_t GetPacketBodyCapacity()
+{
+	const size_t largestBody = gdwLargestMsgSize > sizeof(TPktHdr) ? gdwLargestMsgSize - sizeof(TPktHdr) : 0;
+	return std::min(sizeof(TPkt::body), largestBody);
+}
+
+void SendCoalescedPacket(uint8_t playerId)
+{
+	CoalescedPacket &coalescedPacket = CoalescedPackets[playerId];
+	if (coalescedPacket.size == 0)
+		return;
+	const size_t size = coalescedPacket.size;
+	coalescedPacket.size = 0;
+	SendPacketNow(playerId, coalescedPacket.body, size);
+}
+
+void ShareBufferedPackets()
+{
+	TPkt pkt;
+	NetReceivePlayerData(&pkt);
+	std::byte *destination = pkt.body;
+	size_t remainingSpace = gdwNormalMsgSize - sizeof(TPktHdr);
+	destination = CopyBufferedPackets(destination, &highPriorityBuffer, &remainingSpace);
+	destination = CopyBufferedPackets(destination, &lowPriorityBuffer, &remainingSpace);
+	const size_t spaceBeforeSync = remainingSpace;
+	remainingSpace = sync_all_monsters(destination, remainingSpace);
+	RecordCommand(SNPLAYER_OTHERS, /*sent=*/true, destination, spaceBeforeSync - remainingSpace);
+	const size_t len = gdwNormalMsgSize - remainingSpace;
+	pkt.hdr.wLen = Swap16LE(static_cast<uint16_t>(len));
+	if (!SendNetMessage(SNPLAYER_OTHERS, &pkt.hdr, len))
+		nthread_terminate_game("SNetSendMessage");
+}
+
+/**
+ * @brief Queues a message for a player, to be sent with the other messages for that player in this tick.
+ *
+ * Bursts of commands, e.g. a chain lightning hitting many monsters, then take a single packet and header.
+ */
+void SendPacket(uint8_t playerId, const std::byte *packet, size_t size)
+{
+	RecordCommand(playerId, /*sent=*/true, packet, size);
+	const size_t capacity = GetPacketBodyCapacity();
+	if (playerId >= CoalescedPackets.size() || size > capacity) {
+		multi_flush_packets();
+		SendPacketNow(playerId, packet, size);
+		return;
+	}
+
+	CoalescedPacket &coalescedPacket = CoalescedPackets[playerId];
+	if (coalescedPacket.size + size > capacity)
+		SendCoalescedPacket(playerId);
+	else if (coalescedPacket.size != 0)
+		TrafficCounters.messagesCoalesced++;
+	memcpy(&coalescedPacket.body[coalescedPacket.size], packet, size);
+	coalescedPacket.size += size;
+}
+
 void MonsterSeeds()
 {
 	sgdwGameLoops++;
@@ -419,6 +514,7 @@ void HandleAllPackets(uint8_t pnum, const std::byte *data, size_t size)
 		if (messageSize == 0) {
 			break;
 		}
+		RecordCommand(pnum, /*sent=*/false, &data[offset], messageSize);
 		offset += messageSize;
 	}
 }
@@ -515,6 +611,21 @@ void RegisterNetEventHandlers()
 	}
 }
 
+void WriteNetStats()
+{
+	if (NetStatsPath.empty() || !gbIsMultiplayer)
+		return;
+	const std::string csv = net::FormatNetStatsCsv(DvlNet_GetStats(), [](uint8_t cmd) { return CmdIdString(static_cast<_cmd_id>(cmd)); });
+	FILE *file = OpenFile(NetStatsPath.c_str(), "wb");
+	if (file == nullptr) {
+		LogError("Failed to open network statistics file {}", NetStatsPath);
+		return;
+	}
+	if (std::fwrite(csv.data(), csv.size(), 1, file) != 1)
+		LogError("Failed to write network statistics file {}", NetStatsPath);
+	std::fclose(file);
+}
+
 void UnregisterNetEventHandlers()
 {
 	for (auto eventType : EventTypes) {
@@ -635,23 +746,36 @@ void NetSendHiPri(uint8_t playerId, const std::byte *data, size_t size)
 		SendPacket(playerId, data, size);
 	}
 	if (shareNextHighPriorityMessage) {
+		// Sent at the end of the tick, so that the messages that follow in this tick go into the same packet
 		shareNextHighPriorityMessage = false;
-		TPkt pkt;
-		NetReceivePlayerData(&pkt);
-		std::byte *destination = pkt.body;
-		size_t remainingSpace = gdwNormalMsgSize - sizeof(TPktHdr);
-		destination = CopyBufferedPackets(destination, &highPriorityBuffer, &remainingSpace);
-		destination = CopyBufferedPackets(destination, &lowPriorityBuffer, &remainingSpace);
-		remainingSpace = sync_all_monsters(destination, remainingSpace);
-		const size_t len = gdwNormalMsgSize - remainingSpace;
-		pkt.hdr.wLen = Swap16LE(static_cast<uint16_t>(len));
-		if (!SNetSendMessage(SNPLAYER_OTHERS, &pkt.hdr, len))
-			nthread_terminate_game("SNetSendMessage");
+		sgbShareBufferedPackets = true;
 	}
 }
 
+void multi_flush_packets()
+{
+	for (uint8_t playerId = 0; playerId < CoalescedPackets.size(); playerId++)
+		SendCoalescedPacket(playerId);
+	if (sgbShareBufferedPackets) {
+		sgbShareBufferedPackets = false;
+		ShareBufferedPackets();
+	}
+}
+
+const NetTrafficCounters &multi_get_traffic_counters()
+{
+	return TrafficCounters;
+}
+
+void SetNetStatsPath(std::string_view path)
+{
+	NetStatsPath = path;
+}
+
 void multi_send_msg_packet(uint32_t pmask, const std::byte *data, size_t size)
 {
+	multi_flush_packets();
+
 	TPkt pkt;
 	NetReceivePlayerData(&pkt);
 	const size_t len = size + sizeof(pkt.hdr);
@@ -660,10 +784,11 @@ void multi_send_msg_packet(uint32_t pmask, const std::byte *data, size_t size)
 	uint8_t playerID = 0;
 	for (uint32_t v = 1; playerID < Players.size(); playerID++, v <<= 1) {
 		if ((v & pmask) != 0) {
-			if (!SNetSendMessage(playerID, &pkt.hdr, len)) {
+			if (!SendNetMessage(playerID, &pkt.hdr, len)) {
 				nthread_terminate_game("SNetSendMessage");
 				return;
 			}
+			RecordCommand(playerID, /*sent=*/true, data, size);
 		}
 	}
 }
@@ -713,6 +838,7 @@ bool multi_handle_delta()
 	}
 
 	sgbTimeout = false;
+	nthread_update_turn_delay();
 	if (received) {
 		if (!shareNextHighPriorityMessage) {
 			// If there are any high priority messages pending,
@@ -734,6 +860,8 @@ bool multi_handle_delta()
 
 void ProcessGameMessagePackets()
 {
+	// Our own messages of the last tick are received below
+	multi_flush_packets();
 	ClearPlayerLeftState();
 	ProcessTmsgs();
 
@@ -785,6 +913,8 @@ void multi_send_zero_packet(uint8_t pnum, _cmd_id bCmd, const std::byte *data, s
 	assert(data != nullptr);
 	assert(size <= 0x0ffff);
 
+	multi_flush_packets();
+
 	for (size_t offset = 0; offset < size;) {
 		TPkt pkt {};
 		pkt.hdr.wCheck = HeaderCheckVal;
@@ -804,10 +934,11 @@ void multi_send_zero_packet(uint8_t pnum, _cmd_id bCmd, const std::byte *data, s
 		assert(dwMsg <= 0x0ffff);
 		pkt.hdr.wLen = Swap16LE(static_cast<uint16_t>(dwMsg));
 
-		if (!SNetSendMessage(pnum, &pkt, dwMsg)) {
+		if (!SendNetMessage(pnum, &pkt, dwMsg)) {
 			nthread_terminate_game("SNetSendMessage2");
 			return;
 		}
+		RecordCommand(pnum, /*sent=*/true, pkt.body, sizeof(message) + dwBody);
 
 		offset += dwBody;
 	}
@@ -822,6 +953,7 @@ void NetClose()
 	sgbNetInited = false;
 	nthread_cleanup();
 	tmsg_cleanup();
+	WriteNetStats();
 	UnregisterNetEventHandlers();
 	SNetLeaveGame(leaveinfo_t::LEAVE_EXIT);
 	if (gbIsMultiplayer)
@@ -859,6 +991,10 @@ bool NetInit(bool bSinglePlayer)
 		InitPlrMsg();
 		BufferInit(&highPriorityBuffer);
 		BufferInit(&lowPriorityBuffer);
+		for (CoalescedPacket &coalescedPacket : CoalescedPackets)
+			coalescedPacket.size = 0;
+		sgbShareBufferedPackets = false;
+		TrafficCounters = {};
 		shareNextHighPriorityMessage = true;
 		sync_init();
 		nthread_start(sgbPlayerTurnBitTbl[MyPlayerId]);
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "dvlnet/leaveinfo.hpp"
@@ -78,6 +79,30 @@ std::string FormatGameSeed(const uint32_t gameSeed[4]);
 void InitGameInfo();
 void NetSendLoPri(uint8_t playerId, const std::byte *data, size_t size);
 void NetSendHiPri(uint8_t playerId, const std::byte *data, size_t size);
+
+/**
+ * @brief Sends the messages that were queued in this tick, each player's in as few packets as possible.
+ *
+ * Called at the end of each game tick and before received messages are processed.
+ */
+void multi_flush_packets();
+
+/** @brief Messages handed to the network provider since the game started. */
+struct NetTrafficCounters {
+	uint32_t packetsSent;
+	uint64_t bytesSent;
+	/** Messages that shared a packet with an earlier message instead of getting their own. */
+	uint32_t messagesCoalesced;
+};
+
+const NetTrafficCounters &multi_get_traffic_counters();
+
+/**
+ * @brief Writes the network statistics of each multiplayer game to the given CSV file when the game ends.
+ *
+ * The file is overwritten by the next game. See `net::FormatNetStatsCsv` for the format.
+ */
+void SetNetStatsPath(std::string_view path);
 void multi_send_msg_packet(uint32_t pmask, const std::byte *data, size_t size);
 void multi_msg_countdown();
 void multi_player_left(uint8_t pnum, leaveinfo_t reason);
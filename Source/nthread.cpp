@@ -5,8 +5,10 @@
  */
 #include "nthread.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_timer.h>
@@ -15,10 +17,13 @@
 #endif
 
 #include "diablo.h"
+#include "dvlnet/turn_delay.hpp"
 #include "engine/animationinfo.h"
 #include "engine/demomode.h"
 #include "game_mode.hpp"
 #include "gmenu.h"
+#include "msg.h"
+#include "multi.h"
 #include "storm/storm_net.hpp"
 #include "utils/sdl_mutex.h"
 #include "utils/sdl_thread.h"
@@ -44,6 +49,20 @@ bool sgbTicsOutOfSync;
 int8_t sgbPacketCountdown;
 bool sgbThreadIsRunning;
 SdlThread Thread;
+net::TurnDelayController TurnDelay;
+/** Whether the game is waiting for late turns, so that a wait is only counted once. */
+bool sgbWaitingForTurns;
+uint32_t sgdwTurnsReceived;
+uint32_t sgdwTurnDelayUpdatedAt;
+uint32_t sgdwAnnouncedTurnDelay;
+uint32_t sgdwLastRoundTrip;
+bool sgbTurnDelayPlayerKnown[MAX_PLRS];
+
+/** @brief The time between two turns that are received */
+uint32_t TurnPeriodMs()
+{
+	return 4 * sgbNetUpdateRate * gnTickDelay;
+}
 
 void NthreadHandler()
 {
@@ -120,6 +139,10 @@ bool nthread_recv_turns(bool *pfSendAsync)
 		return true;
 	}
 	if (!SNetReceiveTurns(MAX_PLRS, (char **)glpMsgTbl, gdwMsgLenTbl, &player_state[0])) {
+		if (!sgbWaitingForTurns) {
+			sgbWaitingForTurns = true;
+			TurnDelay.AddStall();
+		}
 		sgbTicsOutOfSync = false;
 		sgbSyncCountdown = 1;
 		sgbPacketCountdown = 1;
@@ -129,6 +152,8 @@ bool nthread_recv_turns(bool *pfSendAsync)
 		sgbTicsOutOfSync = true;
 		last_tick = SDL_GetTicks();
 	}
+	sgbWaitingForTurns = false;
+	sgdwTurnsReceived++;
 	sgbSyncCountdown = 4;
 	multi_msg_countdown();
 	if (pfSendAsync != nullptr)
@@ -178,6 +203,13 @@ void nthread_start(bool setTurnUpperBit)
 	}
 	if (gdwNormalMsgSize > largestMsgSize)
 		gdwNormalMsgSize = largestMsgSize;
+	TurnDelay.Reset(gdwTurnsInTransit);
+	sgbWaitingForTurns = false;
+	sgdwTurnsReceived = 0;
+	sgdwTurnDelayUpdatedAt = 0;
+	sgdwAnnouncedTurnDelay = gdwTurnsInTransit;
+	sgdwLastRoundTrip = 0;
+	memset(sgbTurnDelayPlayerKnown, 0, sizeof(sgbTurnDelayPlayerKnown));
 	if (gbIsMultiplayer) {
 		sgbThreadIsRunning = false;
 		MemCrit.lock();
@@ -211,6 +243,53 @@ void nthread_ignore_mutex(bool bStart)
 	sgbThreadIsRunning = bStart;
 }
 
+void nthread_update_turn_delay()
+{
+	if (!gbIsMultiplayer || sgdwTurnsReceived == sgdwTurnDelayUpdatedAt)
+		return;
+	sgdwTurnDelayUpdatedAt = sgdwTurnsReceived;
+
+	bool playerJoined = false;
+	bool hasOtherPlayers = false;
+	uint32_t roundTrip = 0;
+	for (uint8_t i = 0; i < Players.size(); i++) {
+		if (i == MyPlayerId || (player_state[i] & PS_CONNECTED) == 0) {
+			TurnDelay.SetPlayerTurns(i, 0);
+			sgbTurnDelayPlayerKnown[i] = false;
+			continue;
+		}
+		if (!sgbTurnDelayPlayerKnown[i]) {
+			sgbTurnDelayPlayerKnown[i] = true;
+			playerJoined = true;
+		}
+		hasOtherPlayers = true;
+		roundTrip = std::max(roundTrip, DvlNet_GetLatencies(i).echoLatency);
+	}
+	// Echoes are only sent every few seconds, so only a new measurement is a new sample.
+	if (hasOtherPlayers && roundTrip != sgdwLastRoundTrip) {
+		TurnDelay.AddRoundTripSample(roundTrip);
+		sgdwLastRoundTrip = roundTrip;
+	}
+	TurnDelay.Update(TurnPeriodMs());
+
+	const uint32_t desiredTurns = TurnDelay.DesiredTurns();
+	if (hasOtherPlayers && (desiredTurns != sgdwAnnouncedTurnDelay || playerJoined)) {
+		NetSendCmdParam1(true, CMD_TURNDELAY, static_cast<uint16_t>(desiredTurns));
+		sgdwAnnouncedTurnDelay = desiredTurns;
+	}
+	gdwTurnsInTransit = TurnDelay.AgreedTurns();
+}
+
+void nthread_set_player_turn_delay(uint8_t pnum, uint32_t turns)
+{
+	TurnDelay.SetPlayerTurns(pnum, turns);
+}
+
+uint32_t nthread_turn_delay_ms()
+{
+	return gdwTurnsInTransit * TurnPeriodMs();
+}
+
 bool nthread_has_500ms_passed(bool *drawGame /*= nullptr*/)
 {
 	const int currentTickCount = SDL_GetTicks();
@@ -30,6 +30,21 @@ void nthread_start(bool setTurnUpperBit);
 void nthread_cleanup();
 void nthread_ignore_mutex(bool bStart);
 
+/**
+ * @brief Adapts gdwTurnsInTransit to the latency to the other players, once per turn
+ *
+ * Tells the other players when the number of turns this player wants changes, or when a player joined.
+ */
+void nthread_update_turn_delay();
+/**
+ * @brief Records the number of turns in transit that another player wants
+ */
+void nthread_set_player_turn_delay(uint8_t pnum, uint32_t turns);
+/**
+ * @brief The time covered by the turns in transit
+ */
+uint32_t nthread_turn_delay_ms();
+
 /**
  * @brief Checks if it's time for the logic to advance
  * @return True if the engine should tick
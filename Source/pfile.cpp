@@ -7,10 +7,12 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <ankerl/unordered_dense.h>
 
@@ -26,12 +28,16 @@
 #include "engine/load_file.hpp"
 #include "engine/render/primitive_render.hpp"
 #include "game_mode.hpp"
+#include "hero_index.hpp"
 #include "loadsave.h"
 #include "menu.h"
 #include "mods/mod_identity.h"
 #include "mpq/mpq_common.hpp"
 #include "pack.h"
 #include "qol/stash.h"
+#include "save_container.hpp"
+#include "save_profile.hpp"
+#include "tables/deferred_tables.hpp"
 #include "tables/playerdat.hpp"
 #include "utils/endian_read.hpp"
 #include "utils/endian_swap.hpp"
@@ -69,6 +75,12 @@ namespace {
 /** List of character names for the character selection screen. */
 char hero_names[MAX_CHARACTERS][PlayerNameLength];
 
+/**
+ * Heroes written since the hero index was last updated, by the path returned from `GetHeroStampPath`.
+ * They are added to the index once the writes have finished, as only then the stamps of the saves are known.
+ */
+ankerl::unordered_dense::map<std::string, _uiheroinfo> WrittenHeroes;
+
 // Effective save-file extension token (no leading dot). Defaults to "sv"; an active mod may
 // override the save namespace by declaring `saveExtension` in its manifest.
 std::string_view GetSaveExtension()
@@ -93,6 +105,33 @@ std::string GetSavePath(uint32_t saveNum, std::string_view savePrefix = {})
 	);
 }
 
+/** @brief Returns the file whose stamp identifies the version of a hero's save. */
+std::string GetHeroStampPath(uint32_t saveNum)
+{
+#ifdef UNPACKED_SAVES
+	// The hero file is rewritten whenever anything else shown on the character selection screen changes.
+	return GetSavePath(saveNum) + "hero";
+#else
+	return GetSavePath(saveNum);
+#endif
+}
+
+std::string GetHeroIndexPath()
+{
+	return paths::PrefPath() + "heroes.idx";
+}
+
+/** @brief Adds the heroes written since the last call to the index, must be called after `WaitForPendingSaves`. */
+void IndexWrittenHeroes(HeroIndex &index)
+{
+	for (const auto &[stampPath, hero] : WrittenHeroes) {
+		const std::optional<SaveFileStamp> stamp = GetSaveFileStamp(stampPath);
+		if (stamp)
+			index.insert(stampPath, *stamp, hero);
+	}
+	WrittenHeroes.clear();
+}
+
 std::string GetStashSavePath()
 {
 	const std::string_view ext = GetSaveExtension();
@@ -132,6 +171,14 @@ bool GetTempSaveNames(uint8_t dwIndex, char *szTemp)
 	return GetSaveNames(dwIndex, "temp", szTemp);
 }
 
+bool GetTempDeltaSaveNames(uint8_t dwIndex, char *szTemp)
+{
+	if (!GetTempSaveNames(dwIndex, szTemp))
+		return false;
+	*BufCopy(szTemp + strlen(szTemp), LevelDeltaSuffix) = '\0';
+	return true;
+}
+
 void RenameTempToPerm(SaveWriter &saveWriter)
 {
 	char szTemp[MaxMpqPathSize];
@@ -142,11 +189,7 @@ void RenameTempToPerm(SaveWriter &saveWriter)
 		[[maybe_unused]] const bool result = GetPermSaveNames(dwIndex, szPerm); // DO NOT PUT DIRECTLY INTO ASSERT!
 		assert(result);
 		dwIndex++;
-		if (saveWriter.HasFile(szTemp)) {
-			if (saveWriter.HasFile(szPerm))
-				saveWriter.RemoveHashEntry(szPerm);
-			saveWriter.RenameFile(szTemp, szPerm);
-		}
+		saveWriter.RenameFile(szTemp, szPerm);
 	}
 	assert(!GetPermSaveNames(dwIndex, szPerm));
 }
@@ -171,11 +214,10 @@ bool ReadHero(SaveReader &archive, PlayerPack *pPack)
 void EncodeHero(SaveWriter &saveWriter, const PlayerPack *pack)
 {
 	const size_t packedLen = codec_get_encoded_len(sizeof(*pack));
-	const std::unique_ptr<std::byte[]> packed { new std::byte[packedLen] };
+	std::unique_ptr<std::byte[]> packed { new std::byte[packedLen] };
 
 	memcpy(packed.get(), pack, sizeof(*pack));
-	codec_encode(packed.get(), sizeof(*pack), packedLen, pfile_get_password());
-	saveWriter.WriteFile("hero", packed.get(), packedLen);
+	saveWriter.WriteFile("hero", std::move(packed), sizeof(*pack), pfile_get_password());
 }
 
 SaveWriter GetSaveWriter(uint32_t saveNum, bool carryForward = true)
@@ -191,6 +233,7 @@ SaveWriter GetStashWriter()
 #ifndef DISABLE_DEMOMODE
 void CopySaveFile(uint32_t saveNum, std::string targetPath)
 {
+	WaitForPendingSaves();
 	const std::string savePath = GetSavePath(saveNum);
 #if defined(UNPACKED_SAVES)
 #ifdef DVL_NO_FILESYSTEM
@@ -258,17 +301,23 @@ bool ArchiveContainsGame(SaveReader &hsArchive)
 	return IsHeaderValid(hdr);
 }
 
-std::optional<SaveReader> CreateSaveReader(std::string &&path)
+std::expected<SaveReader, std::string> CreateSaveReaderWithoutWaiting(std::string &&path)
 {
 #ifdef UNPACKED_SAVES
 	if (!FileExists(path))
-		return std::nullopt;
+		return std::unexpected(StrCat(path, _(" does not exist")));
 	return SaveReader(std::move(path));
 #else
-	std::expected<MpqArchive, std::string> opened = MpqArchive::Open(path.c_str());
+	return MpqArchive::Open(path.c_str());
+#endif
+}
+
+std::optional<SaveReader> CreateSaveReader(std::string &&path)
+{
+	WaitForPendingSaves();
+	std::expected<SaveReader, std::string> opened = CreateSaveReaderWithoutWaiting(std::move(path));
 	if (!opened.has_value()) return std::nullopt;
 	return std::move(*opened);
-#endif
 }
 
 #ifndef DISABLE_DEMOMODE
@@ -524,10 +573,38 @@ HeroCompareResult CompareSaves(const std::string &actualSavePath, const std::str
 }
 #endif // !DISABLE_DEMOMODE
 
+/**
+ * @brief Writes the levels that have a delta file in full, so that only full level files are made permanent.
+ */
+void CompactLevelDeltas(SaveWriter &saveWriter)
+{
+	ClearLevelSnapshot();
+	std::optional<SaveReader> archive = CreateSaveReader(std::string(saveWriter.path()));
+	if (!archive)
+		return;
+
+	char szTemp[MaxMpqPathSize];
+	char szDelta[MaxMpqPathSize];
+	for (uint8_t i = 0; GetTempDeltaSaveNames(i, szDelta); i++) {
+		if (!archive->HasFile(szDelta))
+			continue;
+		GetTempSaveNames(i, szTemp);
+		size_t size;
+		const std::unique_ptr<std::byte[]> level = ReadLevelFile(*archive, szTemp, &size);
+		if (level != nullptr) {
+			std::unique_ptr<std::byte[]> buffer { new std::byte[codec_get_encoded_len(size)] };
+			memcpy(buffer.get(), level.get(), size);
+			saveWriter.WriteFile(szTemp, std::move(buffer), size, pfile_get_password());
+		}
+		saveWriter.RemoveHashEntry(szDelta);
+	}
+}
+
 void pfile_write_hero(SaveWriter &saveWriter, bool writeGameData)
 {
 	if (writeGameData) {
 		SaveGameData(saveWriter);
+		CompactLevelDeltas(saveWriter);
 		RenameTempToPerm(saveWriter);
 	}
 	PlayerPack pkplr;
@@ -581,22 +658,54 @@ std::unique_ptr<std::byte[]> SaveReader::ReadFile(const char *filename, std::siz
 	return result;
 }
 
-bool SaveWriter::WriteFile(const char *filename, const std::byte *data, size_t size)
+SaveArchiveWriter::SaveArchiveWriter(std::string &&dir, bool carryForward)
+    : dir_(std::move(dir))
+    , carryForward_(carryForward)
+{
+}
+
+SaveArchiveWriter::~SaveArchiveWriter()
+{
+#ifndef DVL_NO_FILESYSTEM
+	if (carryForward_ || failed_ || !FileExists(dir_))
+		return;
+	std::vector<std::string> staleFiles;
+	std::error_code error;
+	for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(dir_, error)) {
+		if (writtenFiles_.find(entry.path().filename().string()) == writtenFiles_.end())
+			staleFiles.push_back(entry.path().string());
+	}
+	for (const std::string &path : staleFiles) {
+		RemoveFile(path.c_str());
+	}
+#endif
+}
+
+bool SaveArchiveWriter::WriteFile(const char *filename, const std::byte *data, size_t size)
 {
 	const std::string path = dir_ + filename;
-	FILE *file = OpenFile(path.c_str(), "wb");
+	const std::string tmpPath = path + ".tmp";
+	FILE *file = OpenFile(tmpPath.c_str(), "wb");
 	if (file == nullptr) {
+		failed_ = true;
 		return false;
 	}
 	if (std::fwrite(data, size, 1, file) != 1) {
 		std::fclose(file);
+		RemoveFile(tmpPath.c_str());
+		failed_ = true;
 		return false;
 	}
-	std::fclose(file);
+	if (std::fclose(file) != 0 || !RenameFileOverwrite(tmpPath.c_str(), path.c_str())) {
+		RemoveFile(tmpPath.c_str());
+		failed_ = true;
+		return false;
+	}
+	writtenFiles_.emplace(filename);
 	return true;
 }
 
-void SaveWriter::RemoveHashEntries(bool (*fnGetName)(uint8_t, char *))
+void SaveArchiveWriter::RemoveHashEntries(bool (*fnGetName)(uint8_t, char *))
 {
 	char pszFileName[MaxMpqPathSize];
 
@@ -611,6 +720,11 @@ std::optional<SaveReader> OpenSaveArchive(uint32_t saveNum)
 	return CreateSaveReader(GetSavePath(saveNum));
 }
 
+std::expected<SaveReader, std::string> OpenSaveArchiveWithoutWaiting(uint32_t saveNum)
+{
+	return CreateSaveReaderWithoutWaiting(GetSavePath(saveNum));
+}
+
 std::optional<SaveReader> OpenStashArchive()
 {
 	return CreateSaveReader(GetStashSavePath());
@@ -625,10 +739,21 @@ std::unique_ptr<std::byte[]> ReadArchive(SaveReader &archive, const char *pszNam
 	if (error != 0)
 		return nullptr;
 
-	const std::size_t decodedLength = codec_decode(result.get(), length, pfile_get_password());
+	std::size_t decodedLength;
+	{
+		const SaveProfileScope profileScope(SaveProfileSection::Decode);
+		decodedLength = codec_decode(result.get(), length, pfile_get_password());
+	}
 	if (decodedLength == 0)
 		return nullptr;
 
+	if (IsPackedSaveFile({ result.get(), decodedLength })) {
+		const SaveProfileScope profileScope(SaveProfileSection::Unpack);
+		result = UnpackSaveFile({ result.get(), decodedLength }, decodedLength);
+		if (result == nullptr)
+			return nullptr;
+	}
+
 	if (pdwLen != nullptr)
 		*pdwLen = decodedLength;
 
@@ -644,9 +769,16 @@ const char *pfile_get_password()
 
 void pfile_write_hero(bool writeGameData)
 {
+	// Without game data the archive is recreated with only the hero files, which drops the previous game
+	// and any hero file that is no longer written (e.g. the hotkeys in vanilla mode).
 	SaveWriter saveWriter = GetSaveWriter(gSaveNumber, /*carryForward=*/writeGameData);
 	pfile_write_hero(saveWriter, writeGameData);
 
+	_uiheroinfo hero;
+	hero.saveNumber = gSaveNumber;
+	Game2UiPlayer(*MyPlayer, &hero, writeGameData && !gbIsMultiplayer);
+	WrittenHeroes.insert_or_assign(GetHeroStampPath(gSaveNumber), hero);
+
 #ifdef __EMSCRIPTEN__
 	// Persist saves to IndexedDB for browser storage
 	emscripten_run_script("if (typeof Module !== 'undefined' && Module.saveToIndexedDB) Module.saveToIndexedDB();");
@@ -696,11 +828,34 @@ bool pfile_ui_set_hero_infos(bool (*uiAddHeroInfo)(_uiheroinfo *))
 {
 	memset(hero_names, 0, sizeof(hero_names));
 
+	WaitForPendingSaves();
+	const std::string indexPath = GetHeroIndexPath();
+	HeroIndex index = HeroIndex::Load(indexPath);
+	IndexWrittenHeroes(index);
+
 	for (uint32_t i = 0; i < MAX_CHARACTERS; i++) {
+		const std::string stampPath = GetHeroStampPath(i);
+		const std::optional<SaveFileStamp> stamp = GetSaveFileStamp(stampPath);
+		if (!stamp) {
+			index.erase(stampPath);
+			continue;
+		}
+
+		if (const _uiheroinfo *indexedHero = index.find(stampPath, *stamp); indexedHero != nullptr) {
+			_uiheroinfo uihero = *indexedHero;
+			uihero.saveNumber = i;
+			CopyUtf8(hero_names[i], uihero.name, sizeof(hero_names[i]));
+			uiAddHeroInfo(&uihero);
+			continue;
+		}
+
 		std::optional<SaveReader> archive = OpenSaveArchive(i);
 		if (archive) {
 			PlayerPack pkplr;
 			if (ReadHero(*archive, &pkplr)) {
+				// Unpacking the heroes needs the item and spell tables.
+				EnsureDeferredTablesLoaded();
+
 				_uiheroinfo uihero;
 				uihero.saveNumber = i;
 				CopyUtf8(hero_names[i], std::string_view(pkplr.pName, PlayerNameLength), sizeof(hero_names[i]));
@@ -716,11 +871,13 @@ bool pfile_ui_set_hero_infos(bool (*uiAddHeroInfo)(_uiheroinfo *))
 				CalcPlrInv(player, false);
 
 				Game2UiPlayer(player, &uihero, hasSaveGame);
+				index.insert(stampPath, *stamp, uihero);
 				uiAddHeroInfo(&uihero);
 			}
 		}
 	}
 
+	index.save(indexPath);
 	return true;
 }
 
@@ -768,6 +925,7 @@ bool pfile_ui_save_create(_uiheroinfo *heroinfo)
 		SaveHotkeys(saveWriter, player);
 		SaveHeroItems(saveWriter, player);
 	}
+	WrittenHeroes.insert_or_assign(GetHeroStampPath(saveNum), *heroinfo);
 
 	return true;
 }
@@ -777,6 +935,8 @@ bool pfile_delete_save(_uiheroinfo *heroInfo)
 	const uint32_t saveNum = heroInfo->saveNumber;
 	if (saveNum < MAX_CHARACTERS) {
 		hero_names[saveNum][0] = '\0';
+		WrittenHeroes.erase(GetHeroStampPath(saveNum));
+		WaitForPendingSaves();
 		RemoveFile(GetSavePath(saveNum).c_str());
 	}
 	return true;
@@ -812,16 +972,21 @@ void pfile_save_level()
 std::expected<void, std::string> pfile_convert_levels()
 {
 	SaveWriter saveWriter = GetSaveWriter(gSaveNumber);
-	return ConvertLevels(saveWriter);
+	std::optional<SaveReader> archive = OpenSaveArchive(gSaveNumber);
+	if (!archive)
+		return std::unexpected(std::string(_("Unable to open save file archive")));
+	return ConvertLevels(*archive, saveWriter);
 }
 
 void pfile_remove_temp_files()
 {
+	ClearLevelSnapshot();
 	if (gbIsMultiplayer)
 		return;
 
 	SaveWriter saveWriter = GetSaveWriter(gSaveNumber, /*carryForward=*/true);
 	saveWriter.RemoveHashEntries(GetTempSaveNames);
+	saveWriter.RemoveHashEntries(GetTempDeltaSaveNames);
 }
 
 void pfile_update(bool forceSave)
@@ -11,8 +11,11 @@
 
 #include "DiabloUI/diabloui.h"
 #include "player.h"
+#include "save_queue.hpp"
 
 #ifdef UNPACKED_SAVES
+#include <ankerl/unordered_dense.h>
+
 #include "utils/file_util.h"
 #else
 #include "mpq/mpq_reader.hpp"
@@ -48,12 +51,26 @@ private:
 	std::string dir_;
 };
 
-struct SaveWriter {
-	explicit SaveWriter(std::string &&dir)
-	    : dir_(std::move(dir))
-	{
-	}
-
+struct SaveArchiveWriter {
+	/**
+	 * @param dir the save directory
+	 * @param carryForward keep the files that are already in the directory
+	 */
+	explicit SaveArchiveWriter(std::string &&dir, bool carryForward = true);
+
+	/**
+	 * @brief Without `carryForward`, removes the files that were already in the directory and were not written again.
+	 *
+	 * This happens only once all the new files are in place, so that a crash never leaves the directory without a save.
+	 */
+	~SaveArchiveWriter();
+
+	SaveArchiveWriter(const SaveArchiveWriter &) = delete;
+	SaveArchiveWriter &operator=(const SaveArchiveWriter &) = delete;
+
+	/**
+	 * @brief Writes a file, replacing any existing one only once the new one has been written completely.
+	 */
 	bool WriteFile(const char *filename, const std::byte *data, size_t size);
 
 	bool HasFile(const char *path)
@@ -64,22 +81,30 @@ struct SaveWriter {
 	void RenameFile(const char *from, const char *to)
 	{
 		::devilution::RenameFile((dir_ + from).c_str(), (dir_ + to).c_str());
+		writtenFiles_.erase(from);
+		writtenFiles_.emplace(to);
 	}
 
 	void RemoveHashEntry(const char *path)
 	{
 		RemoveFile((dir_ + path).c_str());
+		writtenFiles_.erase(path);
 	}
 
 	void RemoveHashEntries(bool (*fnGetName)(uint8_t, char *));
 
 private:
 	std::string dir_;
+	bool carryForward_;
+	/** Set if a write failed, the files of the previous save are kept then. */
+	bool failed_ = false;
+	/** The files that make up the new save if the previous one is not carried forward. */
+	ankerl::unordered_dense::set<std::string> writtenFiles_;
 };
 
 #else
 using SaveReader = MpqArchive;
-using SaveWriter = MpqWriter;
+using SaveArchiveWriter = MpqWriter;
 #endif
 
 /**
@@ -96,6 +121,13 @@ struct HeroCompareResult {
 };
 
 std::optional<SaveReader> OpenSaveArchive(uint32_t saveNum);
+/**
+ * @brief Same as `OpenSaveArchive`, without waiting for the saves that are still being written.
+ *
+ * Only for opening more readers of an archive that was already opened with `OpenSaveArchive`.
+ * @return the archive, or why it could not be opened
+ */
+std::expected<SaveReader, std::string> OpenSaveArchiveWithoutWaiting(uint32_t saveNum);
 std::optional<SaveReader> OpenStashArchive();
 const char *pfile_get_password();
 std::unique_ptr<std::byte[]> ReadArchive(SaveReader &archive, const char *pszName, size_t *pdwLen = nullptr);
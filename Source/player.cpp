@@ -27,7 +27,6 @@
 #include "engine/load_file.hpp"
 #include "engine/points_in_rectangle_range.hpp"
 #include "engine/random.hpp"
-#include "engine/render/clx_render.hpp"
 #include "engine/trn.hpp"
 #include "engine/world_tile.hpp"
 #include "game_mode.hpp"
@@ -2166,15 +2165,8 @@ void LoadPlrGFX(Player &player, player_graphic graphic)
 	char pszName[256];
 	GetPlayerGraphicsPath(path, std::string_view(prefixBuf, 3), szCel, pszName);
 	const uint16_t animationWidth = GetPlayerSpriteWidth(cls, graphic, animWeaponId);
-	animationData.sprites = LoadCl2Sheet(pszName, animationWidth);
-	std::optional<std::array<uint8_t, 256>> graphicTRN = GetPlayerGraphicTRN(pszName);
-	if (graphicTRN) {
-		ClxApplyTrans(*animationData.sprites, graphicTRN->data());
-	}
-	std::optional<std::array<uint8_t, 256>> classTRN = GetClassTRN(player);
-	if (classTRN) {
-		ClxApplyTrans(*animationData.sprites, classTRN->data());
-	}
+	const std::optional<std::array<uint8_t, 256>> trn = GetPlayerSpriteTRN(player, pszName);
+	animationData.sprites = LoadCl2Sheet(pszName, animationWidth, trn ? trn->data() : nullptr);
 }
 
 void InitPlayerGFX(Player &player)
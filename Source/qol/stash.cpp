@@ -23,6 +23,7 @@
 #include "headless_mode.hpp"
 #include "hwcursor.hpp"
 #include "inv.h"
+#include "loadsave.h"
 #include "minitext.h"
 #include "stores.h"
 #include "utils/display.h"
@@ -557,6 +558,7 @@ void StashStruct::RemoveStashItem(StashStruct::StashCell iv)
 void StashStruct::SetPage(unsigned newPage)
 {
 	page = std::min(newPage, LastStashPage);
+	UnpackPage(page);
 	dirty = true;
 }
 
@@ -567,6 +569,7 @@ void StashStruct::NextPage(unsigned offset)
 	} else {
 		page = LastStashPage;
 	}
+	UnpackPage(page);
 	dirty = true;
 }
 
@@ -577,6 +580,7 @@ void StashStruct::PreviousPage(unsigned offset)
 	} else {
 		page = LastStashPage;
 	}
+	UnpackPage(page);
 	dirty = true;
 }
 
@@ -587,6 +591,45 @@ void StashStruct::RefreshItemStatFlags()
 	}
 }
 
+void StashStruct::UnpackPage(unsigned pageIndex)
+{
+	const auto it = packedPages.find(pageIndex);
+	if (it == packedPages.end())
+		return;
+	const PackedPage packedPage = std::move(it->second);
+	packedPages.erase(it);
+
+	// stashList will have at most 10 000 items, so the indexes of the unpacked items still fit in a StashCell
+	const auto firstIndex = static_cast<StashCell>(stashList.size());
+	LoadPackedStashItems(packedPage.items, packedHellfire, stashList);
+	if (MyPlayer != nullptr) {
+		for (size_t i = firstIndex; i < stashList.size(); i++)
+			stashList[i].updateRequiredStatsCacheForPlayer(*MyPlayer);
+	}
+
+	StashGrid &grid = stashGrids[pageIndex];
+	for (size_t x = 0; x < grid.size(); x++) {
+		for (size_t y = 0; y < grid[x].size(); y++) {
+			const StashCell cell = packedPage.grid[x][y];
+			grid[x][y] = cell == 0 ? 0 : static_cast<StashCell>(firstIndex + cell);
+		}
+	}
+}
+
+void StashStruct::UnpackAllPages()
+{
+	while (!packedPages.empty())
+		UnpackPage(packedPages.begin()->first);
+}
+
+size_t StashStruct::ItemCount() const
+{
+	size_t count = stashList.size();
+	for (const auto &[_, packedPage] : packedPages)
+		count += packedPage.itemCount;
+	return count;
+}
+
 void StartGoldWithdraw()
 {
 	CloseGoldDrop();
@@ -707,12 +750,15 @@ bool AutoPlaceItemInStash(const Item &item, bool persistItem)
 		// Wrap around if needed
 		if (pageIndex >= CountStashPages)
 			pageIndex -= CountStashPages;
+		// A packed page only has to be unpacked once the item is placed on it
+		const auto packedPage = Stash.packedPages.find(pageIndex);
+		const StashStruct::StashGrid &grid = packedPage != Stash.packedPages.end() ? packedPage->second.grid : Stash.stashGrids[pageIndex];
 		// Search all possible position in stash grid
 		for (auto stashPosition : PointsInRectangle(Rectangle { { 0, 0 }, Size { 10 - (itemSize.width - 1), 10 - (itemSize.height - 1) } })) {
 			// Check that all needed slots are free
 			bool isSpaceFree = true;
 			for (auto itemPoint : PointsInRectangle(Rectangle { stashPosition, itemSize })) {
-				const uint16_t iv = Stash.stashGrids[pageIndex][itemPoint.x][itemPoint.y];
+				const uint16_t iv = grid[itemPoint.x][itemPoint.y];
 				if (iv != 0) {
 					isSpaceFree = false;
 					break;
@@ -721,6 +767,7 @@ bool AutoPlaceItemInStash(const Item &item, bool persistItem)
 			if (!isSpaceFree)
 				continue;
 			if (persistItem) {
+				Stash.UnpackPage(pageIndex);
 				Stash.stashList.push_back(item);
 				const auto stashIndex = static_cast<uint16_t>(Stash.stashList.size() - 1);
 				Stash.stashList[stashIndex].position = stashPosition + Displacement { 0, itemSize.height - 1 };
@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -23,9 +24,26 @@ public:
 	using StashGrid = std::array<std::array<StashCell, 10>, 10>;
 	static constexpr StashCell EmptyCell = -1;
 
+	/**
+	 * @brief A page as it was loaded from the save, its items are only read once the page is used.
+	 *
+	 * The cells of the grid refer to the items of the page instead of to stashList.
+	 */
+	struct PackedPage {
+		StashGrid grid;
+		/** The items in the format of the save, see `LoadPackedStashItems`. */
+		std::vector<std::byte> items;
+		uint16_t itemCount;
+	};
+
 	void RemoveStashItem(StashCell iv);
+	/** Pages that have been used since the stash was loaded, their cells refer to stashList. */
 	ankerl::unordered_dense::map<unsigned, StashGrid> stashGrids;
 	std::vector<Item> stashList;
+	/** Pages that have not been used since the stash was loaded, a page is never in both maps. */
+	ankerl::unordered_dense::map<unsigned, PackedPage> packedPages;
+	/** Whether the packed items were saved by Hellfire, which determines their format. */
+	bool packedHellfire = false;
 	int gold;
 	bool dirty = false;
 
@@ -62,6 +80,15 @@ public:
 	/** @brief Updates _iStatFlag for all stash items. */
 	void RefreshItemStatFlags();
 
+	/** @brief Moves the items of a packed page to stashList, does nothing if the page is not packed. */
+	void UnpackPage(unsigned pageIndex);
+
+	/** @brief Unpacks all pages, for when every item has to be in stashList. */
+	void UnpackAllPages();
+
+	/** @brief Returns the number of items in the stash, including the ones on packed pages. */
+	[[nodiscard]] size_t ItemCount() const;
+
 private:
 	/** Current Page */
 	unsigned page;
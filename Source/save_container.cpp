@@ -0,0 +1,169 @@
+#include "save_container.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+
+#define DEVILUTIONX_SAVE_COMPRESSION_NONE 0
+#define DEVILUTIONX_SAVE_COMPRESSION_LZ4 1
+#define DEVILUTIONX_SAVE_COMPRESSION_ZSTD 2
+
+#include <lz4.h>
+#include <zstd.h>
+
+#include "codec.h"
+#include "utils/endian_read.hpp"
+#include "utils/endian_write.hpp"
+#include "utils/log.hpp"
+
+namespace devilution {
+
+namespace {
+
+/*
+ * Layout (all integers are little-endian):
+ *
+ *   offset  size
+ *   0       4     magic "DXSC"
+ *   4       1     format version
+ *   5       1     compression, see `SaveCompression`
+ *   6       2     reserved, 0
+ *   8       4     size of the file
+ *   12            compressed file
+ */
+constexpr uint32_t Magic = 0x43535844; // "DXSC"
+constexpr uint8_t FormatVersion = 1;
+constexpr size_t HeaderSize = 12;
+
+/** @return The size of the compressed data, or 0 on failure. */
+size_t Compress(std::span<const std::byte> data, SaveCompression compression, std::byte *out, size_t capacity)
+{
+	switch (compression) {
+	case SaveCompression::LZ4:
+		return static_cast<size_t>(LZ4_compress_default(reinterpret_cast<const char *>(data.data()), reinterpret_cast<char *>(out),
+		    static_cast<int>(data.size()), static_cast<int>(capacity)));
+	case SaveCompression::Zstd: {
+		// Higher levels barely make level files smaller but are several times slower.
+		const size_t result = ZSTD_compress(out, capacity, data.data(), data.size(), ZSTD_CLEVEL_DEFAULT);
+		return ZSTD_isError(result) != 0 ? 0 : result;
+	}
+	default:
+		return 0;
+	}
+}
+
+size_t GetCompressBound(size_t size, SaveCompression compression)
+{
+	switch (compression) {
+	case SaveCompression::LZ4:
+		return static_cast<size_t>(LZ4_compressBound(static_cast<int>(size)));
+	case SaveCompression::Zstd:
+		return ZSTD_compressBound(size);
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief The largest file that `data` can decompress to, checked before allocating the size from the header.
+ * @return 0 if `data` can not be decompressed, the reason is logged then
+ */
+size_t GetMaxDecompressedSize(std::span<const std::byte> data, SaveCompression compression)
+{
+	switch (compression) {
+	case SaveCompression::LZ4:
+		// LZ4 can not compress better than 255:1.
+		return data.size() * 255;
+	case SaveCompression::Zstd: {
+		// `ZSTD_compress` stores the size of the file in the frame.
+		const unsigned long long frameSize = ZSTD_getFrameContentSize(data.data(), data.size());
+		if (frameSize == ZSTD_CONTENTSIZE_UNKNOWN || frameSize == ZSTD_CONTENTSIZE_ERROR || frameSize > SIZE_MAX) {
+			LogError("Save file is corrupt, its Zstandard frame has no valid size");
+			return 0;
+		}
+		return static_cast<size_t>(frameSize);
+	}
+	default:
+		LogError("Save file was compressed with an unknown compression ({})", static_cast<int>(compression));
+		return 0;
+	}
+}
+
+bool Decompress(std::span<const std::byte> data, SaveCompression compression, std::byte *out, size_t size)
+{
+	switch (compression) {
+	case SaveCompression::LZ4:
+		return LZ4_decompress_safe(reinterpret_cast<const char *>(data.data()), reinterpret_cast<char *>(out),
+		           static_cast<int>(data.size()), static_cast<int>(size))
+		    == static_cast<int>(size);
+	case SaveCompression::Zstd:
+		return ZSTD_decompress(out, size, data.data(), data.size()) == size;
+	default:
+		return false;
+	}
+}
+
+} // namespace
+
+SaveCompression GetSaveCompression()
+{
+#if DEVILUTIONX_SAVE_COMPRESSION == DEVILUTIONX_SAVE_COMPRESSION_LZ4
+	return SaveCompression::LZ4;
+#elif DEVILUTIONX_SAVE_COMPRESSION == DEVILUTIONX_SAVE_COMPRESSION_ZSTD
+	return SaveCompression::Zstd;
+#else
+	return SaveCompression::None;
+#endif
+}
+
+std::unique_ptr<std::byte[]> PackSaveFile(std::span<const std::byte> data, SaveCompression compression, size_t &size)
+{
+	const size_t bound = GetCompressBound(data.size(), compression);
+	if (bound == 0 || data.size() > UINT32_MAX)
+		return nullptr;
+
+	std::unique_ptr<std::byte[]> result { new std::byte[codec_get_encoded_len(HeaderSize + bound)] };
+	const size_t compressedSize = Compress(data, compression, &result[HeaderSize], bound);
+	// The legacy form is just as good if compression doesn't reduce the number of encoded blocks.
+	if (compressedSize == 0 || codec_get_encoded_len(HeaderSize + compressedSize) >= codec_get_encoded_len(data.size()))
+		return nullptr;
+
+	WriteLE32(&result[0], Magic);
+	result[4] = static_cast<std::byte>(FormatVersion);
+	result[5] = static_cast<std::byte>(compression);
+	WriteLE16(&result[6], 0);
+	WriteLE32(&result[8], static_cast<uint32_t>(data.size()));
+	size = HeaderSize + compressedSize;
+	return result;
+}
+
+bool IsPackedSaveFile(std::span<const std::byte> data)
+{
+	return data.size() >= HeaderSize && LoadLE32(&data[0]) == Magic && static_cast<uint8_t>(data[4]) == FormatVersion;
+}
+
+std::unique_ptr<std::byte[]> UnpackSaveFile(std::span<const std::byte> data, size_t &size)
+{
+	if (!IsPackedSaveFile(data))
+		return nullptr;
+
+	const auto compression = static_cast<SaveCompression>(data[5]);
+	const size_t unpackedSize = LoadLE32(&data[8]);
+	const size_t maxSize = GetMaxDecompressedSize(data.subspan(HeaderSize), compression);
+	if (maxSize == 0)
+		return nullptr;
+	if (unpackedSize > maxSize) {
+		LogError("Save file is corrupt, its size of {} bytes is more than it can decompress to", unpackedSize);
+		return nullptr;
+	}
+	std::unique_ptr<std::byte[]> result { new std::byte[unpackedSize] };
+	if (!Decompress(data.subspan(HeaderSize), compression, result.get(), unpackedSize))
+		return nullptr;
+
+	size = unpackedSize;
+	return result;
+}
+
+} // namespace devilution
@@ -0,0 +1,48 @@
+/**
+ * @file save_container.hpp
+ *
+ * Compression of the files in a save archive.
+ *
+ * A compressed file starts with a header that names the compression, files without the header are
+ * read as they are, so saves written by builds without compression keep loading. Every build reads
+ * all the compressions, whichever one it uses for new saves.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace devilution {
+
+enum class SaveCompression : uint8_t {
+	None,
+	/** Fast, for platforms where saving time matters most. */
+	LZ4,
+	/** Smaller, at the cost of slower compression. */
+	Zstd,
+};
+
+/** @brief The compression used for new saves, see `DEVILUTIONX_SAVE_COMPRESSION`. */
+SaveCompression GetSaveCompression();
+
+/**
+ * @brief Compresses a file into a container.
+ * @param size set to the size of the container
+ * @return The container, with room to encode it (see `codec_encode`), or nullptr if the file is
+ * better stored as it is, e.g. when compression is disabled or does not make it smaller.
+ */
+std::unique_ptr<std::byte[]> PackSaveFile(std::span<const std::byte> data, SaveCompression compression, size_t &size);
+
+/** @brief Whether `data` is a container created by `PackSaveFile`. */
+bool IsPackedSaveFile(std::span<const std::byte> data);
+
+/**
+ * @brief Decompresses a container created by `PackSaveFile`.
+ * @param size set to the size of the file
+ * @return The file, or nullptr if the container is invalid or its compression is unknown.
+ */
+std::unique_ptr<std::byte[]> UnpackSaveFile(std::span<const std::byte> data, size_t &size);
+
+} // namespace devilution
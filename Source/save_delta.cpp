@@ -0,0 +1,234 @@
+#include "save_delta.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "utils/endian_read.hpp"
+#include "utils/endian_write.hpp"
+
+namespace devilution {
+
+namespace {
+
+/*
+ * Layout (all integers are little-endian):
+ *
+ *   offset  size
+ *   0       4     magic "DXLD"
+ *   4       2     format version
+ *   6       2     generation
+ *   8       4     size of the base
+ *   12      4     size of the result
+ *   16      8     hash of the base
+ *   24            operations, until the end of the delta:
+ *                   4     size of the following new data
+ *                         new data
+ *                   4     offset in the base of the data to copy
+ *                   4     size of the data to copy
+ */
+constexpr uint32_t Magic = 0x444C5844; // "DXLD"
+constexpr uint16_t FormatVersion = 1;
+constexpr size_t HeaderSize = 24;
+constexpr size_t OperationSize = 12;
+
+/** Size of the blocks of the base that are indexed, shorter matches are stored as new data. */
+constexpr size_t BlockSize = 32;
+
+constexpr uint32_t HashMultiplier = 0x01000193;
+
+/** HashMultiplier^(BlockSize - 1), the weight of the first byte in a block hash. */
+constexpr uint32_t FirstByteWeight = [] {
+	uint32_t weight = 1;
+	for (size_t i = 1; i < BlockSize; ++i)
+		weight *= HashMultiplier;
+	return weight;
+}();
+
+uint32_t GetBlockHash(const std::byte *block)
+{
+	uint32_t hash = 0;
+	for (size_t i = 0; i < BlockSize; ++i)
+		hash = hash * HashMultiplier + static_cast<uint8_t>(block[i]);
+	return hash;
+}
+
+/** @brief Moves the hashed block one byte forward. */
+uint32_t RollBlockHash(uint32_t hash, std::byte removed, std::byte added)
+{
+	return (hash - static_cast<uint8_t>(removed) * FirstByteWeight) * HashMultiplier + static_cast<uint8_t>(added);
+}
+
+/**
+ * @brief Maps the hashes of the aligned blocks of the base to their offsets.
+ *
+ * Each slot only holds the first block with that slot, so lookups may miss, which only makes the delta larger.
+ */
+class BlockIndex {
+public:
+	static constexpr uint32_t NoBlock = UINT32_MAX;
+
+	explicit BlockIndex(std::span<const std::byte> base)
+	{
+		const size_t numBlocks = base.size() / BlockSize;
+		size_t numSlots = 16;
+		while (numSlots < numBlocks * 2)
+			numSlots *= 2;
+		slots_.assign(numSlots, NoBlock);
+		for (size_t offset = 0; offset + BlockSize <= base.size(); offset += BlockSize) {
+			uint32_t &slot = slots_[getSlot(GetBlockHash(&base[offset]))];
+			if (slot == NoBlock)
+				slot = static_cast<uint32_t>(offset);
+		}
+	}
+
+	[[nodiscard]] uint32_t find(uint32_t hash) const
+	{
+		return slots_[getSlot(hash)];
+	}
+
+private:
+	[[nodiscard]] size_t getSlot(uint32_t hash) const
+	{
+		return (hash ^ (hash >> 15)) & (slots_.size() - 1);
+	}
+
+	std::vector<uint32_t> slots_;
+};
+
+void AppendLE32(std::vector<std::byte> &out, uint32_t value)
+{
+	const size_t pos = out.size();
+	out.resize(pos + sizeof(value));
+	WriteLE32(&out[pos], value);
+}
+
+void AppendOperation(std::vector<std::byte> &out, std::span<const std::byte> newData, size_t copyOffset, size_t copySize)
+{
+	AppendLE32(out, static_cast<uint32_t>(newData.size()));
+	out.insert(out.end(), newData.begin(), newData.end());
+	AppendLE32(out, static_cast<uint32_t>(copyOffset));
+	AppendLE32(out, static_cast<uint32_t>(copySize));
+}
+
+bool BlocksEqual(std::span<const std::byte> base, size_t baseOffset, std::span<const std::byte> target, size_t targetOffset)
+{
+	return baseOffset + BlockSize <= base.size()
+	    && memcmp(&base[baseOffset], &target[targetOffset], BlockSize) == 0;
+}
+
+} // namespace
+
+uint64_t GetSaveDeltaBaseHash(std::span<const std::byte> base)
+{
+	// FNV-1a
+	uint64_t hash = 0xCBF29CE484222325;
+	for (const std::byte b : base) {
+		hash ^= static_cast<uint8_t>(b);
+		hash *= 0x100000001B3;
+	}
+	return hash;
+}
+
+std::vector<std::byte> CreateSaveDelta(std::span<const std::byte> base, uint64_t baseHash, std::span<const std::byte> target, uint16_t generation)
+{
+	std::vector<std::byte> delta(HeaderSize);
+	WriteLE32(&delta[0], Magic);
+	WriteLE16(&delta[4], FormatVersion);
+	WriteLE16(&delta[6], generation);
+	WriteLE32(&delta[8], static_cast<uint32_t>(base.size()));
+	WriteLE32(&delta[12], static_cast<uint32_t>(target.size()));
+	WriteLE32(&delta[16], static_cast<uint32_t>(baseHash));
+	WriteLE32(&delta[20], static_cast<uint32_t>(baseHash >> 32));
+
+	const BlockIndex index(base);
+	size_t newDataBegin = 0;
+	// Where the data following the last copy continues in the base, if it was changed in place.
+	size_t baseContinuation = 0;
+	size_t pos = 0;
+	uint32_t hash = target.size() >= BlockSize ? GetBlockHash(target.data()) : 0;
+	while (pos + BlockSize <= target.size()) {
+		size_t match = baseContinuation + (pos - newDataBegin);
+		if (!BlocksEqual(base, match, target, pos)) {
+			match = index.find(hash);
+			if (match == BlockIndex::NoBlock || !BlocksEqual(base, match, target, pos)) {
+				if (pos + BlockSize < target.size())
+					hash = RollBlockHash(hash, target[pos], target[pos + BlockSize]);
+				++pos;
+				continue;
+			}
+		}
+
+		size_t begin = pos;
+		while (begin > newDataBegin && match > 0 && base[match - 1] == target[begin - 1]) {
+			--begin;
+			--match;
+		}
+		size_t end = pos + BlockSize;
+		size_t baseEnd = match + (end - begin);
+		while (end < target.size() && baseEnd < base.size() && base[baseEnd] == target[end]) {
+			++end;
+			++baseEnd;
+		}
+
+		AppendOperation(delta, target.subspan(newDataBegin, begin - newDataBegin), match, end - begin);
+		pos = newDataBegin = end;
+		baseContinuation = baseEnd;
+		if (pos + BlockSize <= target.size())
+			hash = GetBlockHash(&target[pos]);
+	}
+	if (newDataBegin < target.size())
+		AppendOperation(delta, target.subspan(newDataBegin), 0, 0);
+
+	return delta;
+}
+
+uint16_t GetSaveDeltaGeneration(std::span<const std::byte> delta)
+{
+	if (delta.size() < HeaderSize || LoadLE32(&delta[0]) != Magic || LoadLE16(&delta[4]) != FormatVersion)
+		return 0;
+	return LoadLE16(&delta[6]);
+}
+
+std::unique_ptr<std::byte[]> ApplySaveDelta(std::span<const std::byte> base, std::span<const std::byte> delta, size_t &size)
+{
+	if (GetSaveDeltaGeneration(delta) == 0)
+		return nullptr;
+	const uint64_t baseHash = LoadLE32(&delta[16]) | (static_cast<uint64_t>(LoadLE32(&delta[20])) << 32);
+	if (LoadLE32(&delta[8]) != base.size() || baseHash != GetSaveDeltaBaseHash(base))
+		return nullptr;
+
+	const size_t targetSize = LoadLE32(&delta[12]);
+	std::unique_ptr<std::byte[]> result { new std::byte[targetSize] };
+	size_t out = 0;
+	size_t in = HeaderSize;
+	while (in != delta.size()) {
+		if (delta.size() - in < OperationSize)
+			return nullptr;
+		const size_t newDataSize = LoadLE32(&delta[in]);
+		in += 4;
+		if (newDataSize > delta.size() - in - (OperationSize - 4) || newDataSize > targetSize - out)
+			return nullptr;
+		memcpy(&result[out], &delta[in], newDataSize);
+		in += newDataSize;
+		out += newDataSize;
+
+		const size_t copyOffset = LoadLE32(&delta[in]);
+		const size_t copySize = LoadLE32(&delta[in + 4]);
+		in += 8;
+		if (copyOffset > base.size() || copySize > base.size() - copyOffset || copySize > targetSize - out)
+			return nullptr;
+		memcpy(&result[out], &base[copyOffset], copySize);
+		out += copySize;
+	}
+	if (out != targetSize)
+		return nullptr;
+
+	size = targetSize;
+	return result;
+}
+
+} // namespace devilution
@@ -0,0 +1,41 @@
+/**
+ * @file save_delta.hpp
+ *
+ * Deltas between two versions of a save file.
+ *
+ * A delta is a list of copies from the base file interleaved with new data, so that data that moved
+ * (e.g. everything after a removed item) is still copied from the base rather than written again.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace devilution {
+
+/** @brief Fingerprint of the base that a delta was created against. */
+uint64_t GetSaveDeltaBaseHash(std::span<const std::byte> base);
+
+/**
+ * @brief Creates a delta that turns `base` into `target`.
+ * @param baseHash result of `GetSaveDeltaBaseHash(base)`
+ * @param generation number of deltas created against `base` so far, including this one
+ */
+std::vector<std::byte> CreateSaveDelta(std::span<const std::byte> base, uint64_t baseHash, std::span<const std::byte> target, uint16_t generation);
+
+/**
+ * @brief Returns the generation that was passed to `CreateSaveDelta`, or 0 if `delta` is not a valid delta.
+ */
+uint16_t GetSaveDeltaGeneration(std::span<const std::byte> delta);
+
+/**
+ * @brief Applies a delta created by `CreateSaveDelta`.
+ * @param size set to the size of the result
+ * @return The patched file, or nullptr if the delta is invalid or was created against a different base.
+ */
+std::unique_ptr<std::byte[]> ApplySaveDelta(std::span<const std::byte> base, std::span<const std::byte> delta, size_t &size);
+
+} // namespace devilution
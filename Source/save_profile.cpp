@@ -0,0 +1,68 @@
+#include "save_profile.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <magic_enum/magic_enum.hpp>
+
+namespace devilution {
+
+namespace {
+
+constexpr size_t NumSections = magic_enum::enum_count<SaveProfileSection>();
+
+std::atomic<bool> Enabled;
+std::array<std::atomic<int64_t>, NumSections> SectionTimesNs;
+
+int64_t NowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+void SetSaveProfilingEnabled(bool enabled)
+{
+	Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsSaveProfilingEnabled()
+{
+	return Enabled.load(std::memory_order_relaxed);
+}
+
+void ResetSaveProfile()
+{
+	for (std::atomic<int64_t> &time : SectionTimesNs)
+		time.store(0, std::memory_order_relaxed);
+}
+
+int64_t GetSaveProfileTimeNs(SaveProfileSection section)
+{
+	return SectionTimesNs[static_cast<size_t>(section)].load(std::memory_order_relaxed);
+}
+
+std::string_view SaveProfileSectionName(SaveProfileSection section)
+{
+	return magic_enum::enum_name(section);
+}
+
+SaveProfileScope::SaveProfileScope(SaveProfileSection section)
+    : section_(section)
+    , startNs_(IsSaveProfilingEnabled() ? NowNs() : 0)
+{
+}
+
+SaveProfileScope::~SaveProfileScope()
+{
+	// Profiling may have been enabled while the scope was open, in which case there is no start time.
+	if (startNs_ == 0 || !IsSaveProfilingEnabled())
+		return;
+	SectionTimesNs[static_cast<size_t>(section_)].fetch_add(NowNs() - startNs_, std::memory_order_relaxed);
+}
+
+} // namespace devilution
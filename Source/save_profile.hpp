@@ -0,0 +1,62 @@
+/**
+ * @file save_profile.hpp
+ *
+ * Accumulates the time spent in each section of loading and saving a game.
+ *
+ * Profiling is off by default and only meant for benchmarks, when it is off the timers do not read the clock.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace devilution {
+
+enum class SaveProfileSection : uint8_t {
+	LoadPlayer,
+	LoadMonsters,
+	LoadMissiles,
+	LoadObjects,
+	LoadDroppedItems,
+	LoadStash,
+	/** Decrypting a file read from a save archive. */
+	Decode,
+	/** Decompressing a file read from a save archive. */
+	Unpack,
+	/** Compressing a file before it is written to a save archive. */
+	Pack,
+	/** Encrypting a file before it is written to a save archive. */
+	Encode,
+};
+
+void SetSaveProfilingEnabled(bool enabled);
+
+[[nodiscard]] bool IsSaveProfilingEnabled();
+
+/** @brief Clears the time recorded for all sections. */
+void ResetSaveProfile();
+
+/** @brief Returns the total time recorded for the section since the last reset, in nanoseconds. */
+[[nodiscard]] int64_t GetSaveProfileTimeNs(SaveProfileSection section);
+
+[[nodiscard]] std::string_view SaveProfileSectionName(SaveProfileSection section);
+
+/**
+ * @brief Adds the lifetime of the object to the time of a section.
+ *
+ * Files are encoded on worker threads, so this can be used from any thread.
+ */
+class SaveProfileScope {
+public:
+	explicit SaveProfileScope(SaveProfileSection section);
+	~SaveProfileScope();
+
+	SaveProfileScope(const SaveProfileScope &) = delete;
+	SaveProfileScope &operator=(const SaveProfileScope &) = delete;
+
+private:
+	SaveProfileSection section_;
+	int64_t startNs_;
+};
+
+} // namespace devilution
@@ -0,0 +1,245 @@
+#include "save_queue.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "codec.h"
+#include "mpq/mpq_common.hpp"
+#include "pfile.h"
+#include "save_container.hpp"
+#include "save_profile.hpp"
+#include "utils/log.hpp"
+#include "utils/parallel_for.hpp"
+#include "utils/sdl_mutex.h"
+#include "utils/sdl_thread.h"
+#include "utils/timer.hpp"
+
+namespace devilution {
+
+struct SaveOperation {
+	enum class Type : uint8_t {
+		Write,
+		Remove,
+		Rename,
+	};
+
+	Type type;
+	std::string name;
+	std::string newName;
+	std::unique_ptr<std::byte[]> data;
+	size_t size = 0;
+	const char *password = nullptr;
+};
+
+namespace {
+
+struct SaveJob {
+	std::string path;
+	bool carryForward = true;
+	std::vector<SaveOperation> operations;
+};
+
+bool BackgroundSavesEnabled;
+
+/** Guards `Worker`, held while submitting so that a concurrent flush can't miss a submitted job. */
+SdlMutex WorkerMutex;
+SdlThread Worker;
+
+/** Guards `PendingJobs` and `WorkerRunning`, shared with the worker. */
+SdlMutex QueueMutex;
+std::deque<SaveJob> PendingJobs;
+bool WorkerRunning;
+
+/**
+ * @brief Compresses and encodes the contents of a write in place.
+ *
+ * Afterwards, `operation.size` is the number of bytes to write.
+ */
+void EncodeFile(SaveOperation &operation)
+{
+	{
+		const SaveProfileScope profileScope(SaveProfileSection::Pack);
+		std::unique_ptr<std::byte[]> packed = PackSaveFile({ operation.data.get(), operation.size }, GetSaveCompression(), operation.size);
+		if (packed != nullptr)
+			operation.data = std::move(packed);
+	}
+	const size_t encodedLen = codec_get_encoded_len(operation.size);
+	const SaveProfileScope profileScope(SaveProfileSection::Encode);
+	codec_encode(operation.data.get(), operation.size, encodedLen, operation.password);
+	operation.size = encodedLen;
+}
+
+void ApplySaveJob(SaveJob &job)
+{
+	const uint32_t start = GetMillisecondsSinceStartup();
+
+	// Files are encoded independently of each other, so they can be encoded in parallel before being written in order.
+	// This matters when many levels are written at once, e.g. when they are converted.
+	std::vector<SaveOperation *> writes;
+	for (SaveOperation &operation : job.operations) {
+		if (operation.type == SaveOperation::Type::Write)
+			writes.push_back(&operation);
+	}
+	const auto encodeFiles = [&writes](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			EncodeFile(*writes[i]);
+	};
+	ParallelFor(writes.size(), encodeFiles, /*minItemsPerWorker=*/2);
+
+	bool failed = false;
+	{
+		SaveArchiveWriter writer(std::string(job.path), job.carryForward);
+		for (SaveOperation &operation : job.operations) {
+			switch (operation.type) {
+			case SaveOperation::Type::Write:
+				// The game thread does not wait for the result of a save, so failures are logged.
+				if (!writer.WriteFile(operation.name.c_str(), operation.data.get(), operation.size)) {
+					LogError("Failed to write {} to {}", operation.name, job.path);
+					failed = true;
+				}
+				operation.data = nullptr;
+				break;
+			case SaveOperation::Type::Remove:
+				writer.RemoveHashEntry(operation.name.c_str());
+				break;
+			case SaveOperation::Type::Rename:
+				if (writer.HasFile(operation.name.c_str())) {
+					if (writer.HasFile(operation.newName.c_str()))
+						writer.RemoveHashEntry(operation.newName.c_str());
+					writer.RenameFile(operation.name.c_str(), operation.newName.c_str());
+				}
+				break;
+			}
+		}
+	}
+	if (!failed)
+		LogVerbose("Wrote {} in {}ms", job.path, GetMillisecondsSinceStartup() - start);
+}
+
+/**
+ * @brief Adds a job to the queue, merging it into the last queued job for the same archive so that
+ * the archive is only rewritten once.
+ */
+void EnqueueSaveJob(SaveJob &&job)
+{
+	if (!PendingJobs.empty() && PendingJobs.back().path == job.path) {
+		SaveJob &last = PendingJobs.back();
+		if (!job.carryForward) {
+			// The archive is recreated from scratch, so the earlier changes do not matter.
+			last = std::move(job);
+			return;
+		}
+		for (SaveOperation &operation : job.operations) {
+			last.operations.push_back(std::move(operation));
+		}
+		return;
+	}
+	PendingJobs.push_back(std::move(job));
+}
+
+void SaveWorker()
+{
+	while (true) {
+		SaveJob job;
+		{
+			const std::lock_guard<SdlMutex> lock(QueueMutex);
+			if (PendingJobs.empty()) {
+				WorkerRunning = false;
+				return;
+			}
+			job = std::move(PendingJobs.front());
+			PendingJobs.pop_front();
+		}
+		ApplySaveJob(job);
+	}
+}
+
+void SubmitSaveJob(SaveJob &&job)
+{
+	if (!BackgroundSavesEnabled) {
+		ApplySaveJob(job);
+		return;
+	}
+
+	const std::lock_guard<SdlMutex> workerLock(WorkerMutex);
+	bool startWorker;
+	{
+		const std::lock_guard<SdlMutex> queueLock(QueueMutex);
+		EnqueueSaveJob(std::move(job));
+		startWorker = !WorkerRunning;
+		WorkerRunning = true;
+	}
+	if (startWorker) {
+		// The previous worker has already left its loop, so this doesn't block for long.
+		Worker.join();
+		Worker = SdlThread { SaveWorker };
+	}
+}
+
+} // namespace
+
+SaveWriter::SaveWriter(std::string &&path, bool carryForward)
+    : path_(std::move(path))
+    , carryForward_(carryForward)
+{
+}
+
+SaveWriter::SaveWriter(SaveWriter &&other) noexcept
+    : path_(std::move(other.path_))
+    , carryForward_(other.carryForward_)
+    , operations_(std::move(other.operations_))
+{
+	other.moved_ = true;
+}
+
+SaveWriter::~SaveWriter()
+{
+	if (moved_)
+		return;
+	SubmitSaveJob(SaveJob { std::move(path_), carryForward_, std::move(operations_) });
+}
+
+void SaveWriter::WriteFile(std::string_view filename, std::unique_ptr<std::byte[]> &&data, size_t size, const char *password)
+{
+	operations_.push_back(SaveOperation { .type = SaveOperation::Type::Write, .name = std::string(filename), .data = std::move(data), .size = size, .password = password });
+}
+
+void SaveWriter::RemoveHashEntry(std::string_view filename)
+{
+	operations_.push_back(SaveOperation { .type = SaveOperation::Type::Remove, .name = std::string(filename) });
+}
+
+void SaveWriter::RemoveHashEntries(bool (*fnGetName)(uint8_t, char *))
+{
+	char pszFileName[MaxMpqPathSize];
+	for (uint8_t i = 0; fnGetName(i, pszFileName); i++) {
+		RemoveHashEntry(pszFileName);
+	}
+}
+
+void SaveWriter::RenameFile(std::string_view name, std::string_view newName)
+{
+	operations_.push_back(SaveOperation { .type = SaveOperation::Type::Rename, .name = std::string(name), .newName = std::string(newName) });
+}
+
+void SetBackgroundSavesEnabled(bool enabled)
+{
+	if (!enabled)
+		WaitForPendingSaves();
+	BackgroundSavesEnabled = enabled;
+}
+
+void WaitForPendingSaves()
+{
+	const std::lock_guard<SdlMutex> lock(WorkerMutex);
+	Worker.join();
+}
+
+} // namespace devilution
@@ -0,0 +1,87 @@
+/**
+ * @file save_queue.hpp
+ *
+ * Writing of save archives on a background thread.
+ *
+ * The game state is serialized on the calling thread into buffers that are recorded by a `SaveWriter`.
+ * Encoding the buffers and writing the archive happens on the save worker once the writer is destroyed.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace devilution {
+
+struct SaveOperation;
+
+/**
+ * @brief Records changes to a save archive, they are applied once the writer is destroyed.
+ *
+ * Changes are applied in the order they were recorded, also across writers.
+ */
+class SaveWriter {
+public:
+	/**
+	 * @param path the archive to write
+	 * @param carryForward keep the files that are already in the archive
+	 */
+	explicit SaveWriter(std::string &&path, bool carryForward = true);
+	SaveWriter(SaveWriter &&other) noexcept;
+	~SaveWriter();
+
+	SaveWriter(const SaveWriter &) = delete;
+	SaveWriter &operator=(const SaveWriter &) = delete;
+	SaveWriter &operator=(SaveWriter &&) = delete;
+
+	/** @brief The archive that is written. */
+	[[nodiscard]] const std::string &path() const
+	{
+		return path_;
+	}
+
+	/**
+	 * @brief Compresses (see `PackSaveFile`), encodes (see `codec_encode`) and writes a file
+	 * @param filename name of the file in the archive
+	 * @param data the contents, the buffer must hold at least `codec_get_encoded_len(size)` bytes
+	 * @param size size of the contents
+	 * @param password password to encode the contents with
+	 */
+	void WriteFile(std::string_view filename, std::unique_ptr<std::byte[]> &&data, size_t size, const char *password);
+
+	void RemoveHashEntry(std::string_view filename);
+
+	void RemoveHashEntries(bool (*fnGetName)(uint8_t, char *));
+
+	/**
+	 * @brief Renames a file if it exists, replacing any file with the new name
+	 */
+	void RenameFile(std::string_view name, std::string_view newName);
+
+private:
+	std::string path_;
+	bool carryForward_;
+	bool moved_ = false;
+	std::vector<SaveOperation> operations_;
+};
+
+/**
+ * @brief Enables applying the recorded changes on a background thread.
+ *
+ * When disabled (the default), the changes are applied before the `SaveWriter` destructor returns.
+ * Disabling waits for all pending saves.
+ */
+void SetBackgroundSavesEnabled(bool enabled);
+
+/**
+ * @brief Flush barrier: blocks until all the changes recorded so far have been written to disk.
+ *
+ * Must be called before reading a save archive.
+ */
+void WaitForPendingSaves();
+
+} // namespace devilution
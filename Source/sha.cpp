@@ -2,11 +2,21 @@
 
 #include <cstdint>
 #include <cstring>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DVL_SHA_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DVL_SHA_NEON
+#endif
 
 namespace devilution {
 
 // NOTE: Diablo's "SHA1" is different from actual SHA1 in that it uses arithmetic
-// right shifts (sign bit extension).
+// right shifts (sign bit extension), and its message schedule does not rotate.
+// Because of this, the SHA-1 instructions of x86 and ARMv8 can not be used for it.
 
 namespace {
 
@@ -17,67 +27,95 @@ uint32_t SHA1CircularShift(uint32_t word, size_t bits)
 {
 	// The SHA-like algorithm as originally implemented treated word as a signed value and used arithmetic right shifts
 	//  (sign-extending). This results in the high 32-`bits` bits being set to 1.
-	if ((word & (1 << 31)) != 0)
-		return (0xFFFFFFFF << bits) | (word >> (32 - bits));
-	return (word << bits) | (word >> (32 - bits));
+	return (word << bits) | static_cast<uint32_t>(static_cast<int32_t>(word) >> (32 - bits));
 }
 
-void SHA1ProcessMessageBlock(SHA1Context *context)
+/**
+ * @brief Expands the 16 words of a block into the 80 words used by the rounds.
+ *
+ * w[i] = w[i - 16] ^ w[i - 14] ^ w[i - 8] ^ w[i - 3], the SIMD versions compute 4 words at a time
+ * and then add w[i] into w[i + 3].
+ */
+void SHA1ExpandMessage(const uint32_t data[BlockSize], uint32_t w[80])
 {
-	std::uint32_t w[80];
-
-	memcpy(w, context->buffer, BlockSize * sizeof(uint32_t));
-	for (int i = 16; i < 80; i++) {
-		w[i] = w[i - 16] ^ w[i - 14] ^ w[i - 8] ^ w[i - 3];
+#if defined(DVL_SHA_SSE2)
+	__m128i v[20];
+	for (size_t i = 0; i < 4; ++i) {
+		v[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data) + i);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(w) + i, v[i]);
 	}
-
-	std::uint32_t a = context->state[0];
-	std::uint32_t b = context->state[1];
-	std::uint32_t c = context->state[2];
-	std::uint32_t d = context->state[3];
-	std::uint32_t e = context->state[4];
-
-	for (int i = 0; i < 20; i++) {
-		const std::uint32_t temp = SHA1CircularShift(a, 5) + ((b & c) | ((~b) & d)) + e + w[i] + 0x5A827999;
-		e = d;
-		d = c;
-		c = SHA1CircularShift(b, 30);
-		b = a;
-		a = temp;
+	for (size_t i = 4; i < 20; ++i) {
+		const __m128i w14 = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(v[i - 4]), _mm_castsi128_pd(v[i - 3]), 1));
+		__m128i t = _mm_xor_si128(_mm_xor_si128(v[i - 4], w14), _mm_xor_si128(v[i - 2], _mm_srli_si128(v[i - 1], 4)));
+		t = _mm_xor_si128(t, _mm_slli_si128(t, 12));
+		v[i] = t;
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(w) + i, t);
 	}
-
-	for (int i = 20; i < 40; i++) {
-		const std::uint32_t temp = SHA1CircularShift(a, 5) + (b ^ c ^ d) + e + w[i] + 0x6ED9EBA1;
-		e = d;
-		d = c;
-		c = SHA1CircularShift(b, 30);
-		b = a;
-		a = temp;
+#elif defined(DVL_SHA_NEON)
+	const uint32x4_t zero = vdupq_n_u32(0);
+	uint32x4_t v[20];
+	for (size_t i = 0; i < 4; ++i) {
+		v[i] = vld1q_u32(data + 4 * i);
+		vst1q_u32(w + 4 * i, v[i]);
 	}
-
-	for (int i = 40; i < 60; i++) {
-		const std::uint32_t temp = SHA1CircularShift(a, 5) + ((b & c) | (b & d) | (c & d)) + e + w[i] + 0x8F1BBCDC;
-		e = d;
-		d = c;
-		c = SHA1CircularShift(b, 30);
-		b = a;
-		a = temp;
+	for (size_t i = 4; i < 20; ++i) {
+		const uint32x4_t w14 = vextq_u32(v[i - 4], v[i - 3], 2);
+		uint32x4_t t = veorq_u32(veorq_u32(v[i - 4], w14), veorq_u32(v[i - 2], vextq_u32(v[i - 1], zero, 1)));
+		t = veorq_u32(t, vextq_u32(zero, t, 1));
+		v[i] = t;
+		vst1q_u32(w + 4 * i, t);
+	}
+#else
+	memcpy(w, data, BlockSize * sizeof(uint32_t));
+	for (int i = 16; i < 80; i++) {
+		w[i] = w[i - 16] ^ w[i - 14] ^ w[i - 8] ^ w[i - 3];
 	}
+#endif
+}
 
-	for (int i = 60; i < 80; i++) {
-		const std::uint32_t temp = SHA1CircularShift(a, 5) + (b ^ c ^ d) + e + w[i] + 0xCA62C1D6;
-		e = d;
-		d = c;
-		c = SHA1CircularShift(b, 30);
-		b = a;
-		a = temp;
+template <int Round>
+void SHA1Round(uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d, uint32_t &e, uint32_t w)
+{
+	uint32_t f;
+	uint32_t k;
+	if constexpr (Round < 20) {
+		f = (b & c) | ((~b) & d);
+		k = 0x5A827999;
+	} else if constexpr (Round < 40) {
+		f = b ^ c ^ d;
+		k = 0x6ED9EBA1;
+	} else if constexpr (Round < 60) {
+		f = (b & c) | (b & d) | (c & d);
+		k = 0x8F1BBCDC;
+	} else {
+		f = b ^ c ^ d;
+		k = 0xCA62C1D6;
 	}
+	const uint32_t temp = SHA1CircularShift(a, 5) + f + e + w + k;
+	e = d;
+	d = c;
+	c = SHA1CircularShift(b, 30);
+	b = a;
+	a = temp;
+}
 
-	context->state[0] += a;
-	context->state[1] += b;
-	context->state[2] += c;
-	context->state[3] += d;
-	context->state[4] += e;
+/** @brief Runs all the rounds unrolled, so that each one uses the right function and constant without branching. */
+template <int... Rounds>
+void SHA1Rounds(uint32_t state[SHA1HashSize], const uint32_t w[80], std::integer_sequence<int, Rounds...> /*rounds*/)
+{
+	uint32_t a = state[0];
+	uint32_t b = state[1];
+	uint32_t c = state[2];
+	uint32_t d = state[3];
+	uint32_t e = state[4];
+
+	(SHA1Round<Rounds>(a, b, c, d, e, w[Rounds]), ...);
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
 }
 
 } // namespace
@@ -89,8 +127,9 @@ void SHA1Result(SHA1Context &context, uint32_t messageDigest[SHA1HashSize])
 
 void SHA1Calculate(SHA1Context &context, const uint32_t data[BlockSize])
 {
-	memcpy(&context.buffer[0], data, BlockSize * sizeof(uint32_t));
-	SHA1ProcessMessageBlock(&context);
+	uint32_t w[80];
+	SHA1ExpandMessage(data, w);
+	SHA1Rounds(context.state, w, std::make_integer_sequence<int, 80>());
 }
 
 } // namespace devilution
@@ -279,4 +279,32 @@ DvlNetLatencies DvlNet_GetLatencies(uint8_t playerId)
 	return dvlnet_inst->get_latencies(playerId);
 }
 
+void DvlNet_RecordCommand(uint8_t playerId, bool sent, uint8_t cmd, size_t size)
+{
+#ifndef NONET
+	std::lock_guard<SdlMutex> lg(storm_net_mutex);
+#endif
+	if (dvlnet_inst != nullptr)
+		dvlnet_inst->record_command(playerId, sent, cmd, size);
+}
+
+void DvlNet_RecordWaitForTurns(uint32_t ms)
+{
+#ifndef NONET
+	std::lock_guard<SdlMutex> lg(storm_net_mutex);
+#endif
+	if (dvlnet_inst != nullptr)
+		dvlnet_inst->record_wait_for_turns(ms);
+}
+
+net::NetStats DvlNet_GetStats()
+{
+#ifndef NONET
+	std::lock_guard<SdlMutex> lg(storm_net_mutex);
+#endif
+	if (dvlnet_inst == nullptr)
+		return {};
+	return dvlnet_inst->get_stats();
+}
+
 } // namespace devilution
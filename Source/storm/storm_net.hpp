@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "dvlnet/net_stats.hpp"
 #include "multi.h"
 
 namespace devilution {
@@ -148,4 +149,12 @@ void DvlNet_ClearPassword();
 bool DvlNet_IsPublicGame();
 DvlNetLatencies DvlNet_GetLatencies(uint8_t playerId);
 
+/**
+ * @brief Counts a game command in the network statistics.
+ * @param playerId The player the command was sent to or received from, `SNPLAYER_OTHERS` for all other players.
+ */
+void DvlNet_RecordCommand(uint8_t playerId, bool sent, uint8_t cmd, size_t size);
+void DvlNet_RecordWaitForTurns(uint32_t ms);
+net::NetStats DvlNet_GetStats();
+
 } // namespace devilution
@@ -3,6 +3,8 @@
  *
  * Implementation of functionality for syncing game state with other players.
  */
+#include <algorithm>
+#include <array>
 #include <cstdint>
 
 #include <limits>
@@ -10,6 +12,7 @@
 #include "levels/gendung.h"
 #include "lighting.h"
 #include "monster.h"
+#include "monsters/sync_priority.hpp"
 #include "monsters/validation.hpp"
 #include "player.h"
 #include "utils/endian_swap.hpp"
@@ -19,24 +22,30 @@ namespace devilution {
 
 namespace {
 
-uint16_t sgnMonsterPriority[MaxMonsters];
-size_t sgnMonsters;
-uint16_t sgwLRU[MaxMonsters];
+static_assert(MaxMonsters <= MonsterSyncScheduler::MaxMonsterId, "Monster ids are sent as one byte");
+
+MonsterSyncScheduler MonsterSyncs;
+std::array<MonsterSyncState, MaxMonsters> MonsterSyncStates;
+uint8_t sgbSyncLevel;
 int sgnSyncItem;
 int sgnSyncPInv;
 
-void SyncOneMonster()
+/**
+ * @brief Distance from the monster to the closest other player on this level that doesn't ignore this player's syncs of it.
+ *
+ * Players drop syncs from players that are further away from the monster than they are, see `SyncMonster`.
+ */
+uint32_t GetViewerDistance(const Monster &monster, uint32_t distance)
 {
-	for (size_t i = 0; i < ActiveMonsterCount; i++) {
-		const unsigned m = ActiveMonsters[i];
-		const Monster &monster = Monsters[m];
-		sgnMonsterPriority[m] = MyPlayer->position.tile.ManhattanDistance(monster.position.tile);
-		if (monster.activeForTicks == 0) {
-			sgnMonsterPriority[m] += 0x1000;
-		} else if (sgwLRU[m] != 0) {
-			sgwLRU[m]--;
-		}
+	uint32_t viewerDistance = MonsterSyncState::NoViewer;
+	for (const Player &player : Players) {
+		if (&player == MyPlayer || !player.plractive || !player.isOnActiveLevel() || player._pLvlChanging)
+			continue;
+		const uint32_t playerDistance = player.position.tile.ManhattanDistance(monster.position.tile);
+		if (playerDistance >= distance)
+			viewerDistance = std::min(viewerDistance, playerDistance);
 	}
+	return viewerDistance;
 }
 
 void SyncMonsterPos(TSyncMonster &monsterSync, int ndx)
@@ -46,58 +55,10 @@ void SyncMonsterPos(TSyncMonster &monsterSync, int ndx)
 	monsterSync._mx = monster.position.tile.x;
 	monsterSync._my = monster.position.tile.y;
 	monsterSync._menemy = encode_enemy(monster);
-	monsterSync._mdelta = sgnMonsterPriority[ndx] > 255 ? 255 : sgnMonsterPriority[ndx];
+	const uint32_t distance = MyPlayer->position.tile.ManhattanDistance(monster.position.tile);
+	monsterSync._mdelta = monster.activeForTicks == 0 || distance > 255 ? 255 : distance;
 	monsterSync.mWhoHit = monster.whoHit;
 	monsterSync._mhitpoints = Swap32LE(monster.hitPoints);
-
-	sgnMonsterPriority[ndx] = 0xFFFF;
-	sgwLRU[ndx] = monster.activeForTicks == 0 ? 0xFFFF : 0xFFFE;
-}
-
-bool SyncMonsterActive(TSyncMonster &monsterSync)
-{
-	unsigned ndx = std::numeric_limits<unsigned>::max();
-	uint32_t lru = 0xFFFFFFFF;
-
-	for (size_t i = 0; i < ActiveMonsterCount; i++) {
-		const unsigned m = ActiveMonsters[i];
-		if (sgnMonsterPriority[m] < lru && sgwLRU[m] < 0xFFFE) {
-			lru = sgnMonsterPriority[m];
-			ndx = ActiveMonsters[i];
-		}
-	}
-
-	if (ndx == std::numeric_limits<unsigned>::max()) {
-		return false;
-	}
-
-	SyncMonsterPos(monsterSync, static_cast<int>(ndx));
-	return true;
-}
-
-bool SyncMonsterActive2(TSyncMonster &monsterSync)
-{
-	unsigned ndx = std::numeric_limits<unsigned>::max();
-	uint32_t lru = 0xFFFE;
-
-	for (size_t i = 0; i < ActiveMonsterCount; i++) {
-		if (sgnMonsters >= ActiveMonsterCount) {
-			sgnMonsters = 0;
-		}
-		const unsigned m = ActiveMonsters[sgnMonsters];
-		if (sgwLRU[m] < lru) {
-			lru = sgwLRU[m];
-			ndx = ActiveMonsters[sgnMonsters];
-		}
-		sgnMonsters++;
-	}
-
-	if (ndx == std::numeric_limits<unsigned>::max()) {
-		return false;
-	}
-
-	SyncMonsterPos(monsterSync, static_cast<int>(ndx));
-	return true;
 }
 
 void SyncPlrInv(TSyncHeader *pHdr)
@@ -251,20 +212,32 @@ size_t sync_all_monsters(std::byte *pbBuf, size_t dwMaxLen)
 	pHdr->wLen = 0;
 	SyncPlrInv(pHdr);
 	assert(dwMaxLen <= 0xffff);
-	SyncOneMonster();
 
-	for (size_t i = 0; i < ActiveMonsterCount && dwMaxLen >= sizeof(TSyncMonster); i++) {
+	if (pHdr->bLevel != sgbSyncLevel) {
+		sgbSyncLevel = pHdr->bLevel;
+		MonsterSyncs.Reset();
+	}
+
+	for (size_t i = 0; i < ActiveMonsterCount; i++) {
+		const Monster &monster = Monsters[ActiveMonsters[i]];
+		const uint32_t distance = MyPlayer->position.tile.ManhattanDistance(monster.position.tile);
+		MonsterSyncStates[i] = MonsterSyncState {
+			.monsterId = static_cast<uint8_t>(ActiveMonsters[i]),
+			.x = static_cast<uint8_t>(monster.position.tile.x),
+			.y = static_cast<uint8_t>(monster.position.tile.y),
+			.mode = static_cast<uint8_t>(monster.mode),
+			.hitPoints = monster.hitPoints,
+			.active = monster.activeForTicks != 0,
+			.viewerDistance = GetViewerDistance(monster, distance),
+		};
+	}
+
+	std::array<uint8_t, MaxMonsters> selected;
+	const size_t maxSyncs = std::min(dwMaxLen / sizeof(TSyncMonster), selected.size());
+	const size_t numSyncs = MonsterSyncs.Schedule({ MonsterSyncStates.data(), ActiveMonsterCount }, { selected.data(), maxSyncs });
+	for (size_t i = 0; i < numSyncs; i++) {
 		auto &monsterSync = *reinterpret_cast<TSyncMonster *>(pbBuf);
-		bool sync = false;
-		if (i < 2) {
-			sync = SyncMonsterActive2(monsterSync);
-		}
-		if (!sync) {
-			sync = SyncMonsterActive(monsterSync);
-		}
-		if (!sync) {
-			break;
-		}
+		SyncMonsterPos(monsterSync, selected[i]);
 		pbBuf += sizeof(TSyncMonster);
 		pHdr->wLen += sizeof(TSyncMonster);
 		dwMaxLen -= sizeof(TSyncMonster);
@@ -319,8 +292,8 @@ size_t OnSyncData(const TSyncHeader &header, size_t maxCmdSize, const Player &pl
 
 void sync_init()
 {
-	sgnMonsters = static_cast<size_t>(16 * MyPlayerId);
-	memset(sgwLRU, 255, sizeof(sgwLRU));
+	sgbSyncLevel = 0xFF;
+	MonsterSyncs.Reset();
 }
 
 } // namespace devilution
@@ -0,0 +1,81 @@
+#include "tables/deferred_tables.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "items.h"
+#include "lua/lua_event.hpp"
+#include "quests.h"
+#include "tables/itemdat.h"
+#include "tables/misdat.h"
+#include "tables/monstdat.h"
+#include "tables/objdat.h"
+#include "tables/spelldat.h"
+#include "utils/startup_trace.hpp"
+
+namespace devilution {
+
+namespace {
+
+struct DeferredTable {
+	std::string_view name;
+	void (*load)();
+};
+
+/** In load order, later tables may refer to the earlier ones. */
+constexpr std::array<DeferredTable, 6> DeferredTables { {
+	{ "LoadSpellData", LoadSpellData },
+	{ "LoadMissileData", LoadMissileData },
+	{ "LoadMonsterData", LoadMonsterData },
+	{ "LoadItemData", LoadItemData },
+	{ "LoadObjectData", LoadObjectData },
+	{ "LoadQuestData", LoadQuestData },
+} };
+
+/** Index of the first table in `DeferredTables` that is not loaded yet. */
+size_t NextDeferredTable = 0;
+bool NotifyModsWhenLoaded = false;
+
+void OnDeferredTablesLoaded()
+{
+	if (NotifyModsWhenLoaded) {
+		NotifyModsWhenLoaded = false;
+		lua::LoadModsComplete();
+	}
+	FinishStartupTrace();
+}
+
+} // namespace
+
+void InvalidateDeferredTables(bool notifyMods)
+{
+	NextDeferredTable = 0;
+	NotifyModsWhenLoaded = NotifyModsWhenLoaded || notifyMods;
+	ClearItemRecreationCache();
+}
+
+void EnsureDeferredTablesLoaded()
+{
+	while (!AreDeferredTablesLoaded()) {
+		LoadNextDeferredTable();
+	}
+}
+
+void LoadNextDeferredTable()
+{
+	if (AreDeferredTablesLoaded())
+		return;
+	const DeferredTable &table = DeferredTables[NextDeferredTable];
+	TraceStartupPhase(table.name, table.load);
+	++NextDeferredTable;
+	if (AreDeferredTablesLoaded())
+		OnDeferredTablesLoaded();
+}
+
+bool AreDeferredTablesLoaded()
+{
+	return NextDeferredTable == DeferredTables.size();
+}
+
+} // namespace devilution
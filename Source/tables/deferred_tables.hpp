@@ -0,0 +1,34 @@
+/**
+ * @file deferred_tables.hpp
+ *
+ * Loading of the data tables that are not needed to show the main menu:
+ * spells, missiles, monsters, items, objects and quests.
+ *
+ * The tables are loaded one at a time while the main menu is idle.
+ * Anything that reads them before a game is running must call `EnsureDeferredTablesLoaded()` first.
+ */
+#pragma once
+
+namespace devilution {
+
+/**
+ * @brief Marks all deferred tables as needing a (re)load, e.g. because the active mods have changed.
+ *
+ * @param notifyMods Fire the `LoadModsComplete` Lua event once the tables have been loaded,
+ *                   so that mods can extend them.
+ */
+void InvalidateDeferredTables(bool notifyMods);
+
+/**
+ * @brief Readiness barrier: loads all deferred tables that are not loaded yet.
+ */
+void EnsureDeferredTablesLoaded();
+
+/**
+ * @brief Loads the next deferred table that is not loaded yet, if any.
+ */
+void LoadNextDeferredTable();
+
+[[nodiscard]] bool AreDeferredTablesLoaded();
+
+} // namespace devilution
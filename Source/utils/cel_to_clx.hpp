@@ -8,6 +8,9 @@
 
 namespace devilution {
 
+/** @brief Version of the `CelToClx` output, bump when the output changes (see `engine/asset_cache.hpp`). */
+constexpr uint32_t CelToClxVersion = 1;
+
 OwnedClxSpriteListOrSheet CelToClx(const uint8_t *data, size_t size, PointerOrValue<uint16_t> widthOrWidths);
 
 } // namespace devilution
@@ -9,9 +9,96 @@
 #include "utils/clx_encode.hpp"
 #include "utils/endian_read.hpp"
 #include "utils/endian_write.hpp"
+#include "utils/parallel_for.hpp"
 
 namespace devilution {
 
+namespace {
+
+/**
+ * @brief Appends a single CL2 frame converted to CLX (including the frame header) to `clxData`.
+ *
+ * @param trn If not null, the color translation applied to every pixel.
+ * @param pixels Transient buffer for a contiguous run of non-transparent pixels.
+ */
+void AppendCl2FrameAsClx(const uint8_t *frameBegin, const uint8_t *frameEnd, uint16_t frameWidth, const uint8_t *trn,
+    std::vector<uint8_t> &clxData, std::vector<uint8_t> &pixels)
+{
+	const size_t frameHeaderPos = clxData.size();
+	clxData.resize(clxData.size() + ClxFrameHeaderSize);
+	WriteLE16(&clxData[frameHeaderPos], ClxFrameHeaderSize);
+	WriteLE16(&clxData[frameHeaderPos + 2], frameWidth);
+
+	unsigned transparentRunWidth = 0;
+	int_fast16_t xOffset = 0;
+	size_t frameHeight = 0;
+	const uint8_t *src = frameBegin + LoadLE16(frameBegin);
+	while (src != frameEnd) {
+		auto remainingWidth = static_cast<int_fast16_t>(frameWidth) - xOffset;
+		while (remainingWidth > 0) {
+			const uint8_t control = *src++;
+			if (!IsClxOpaque(control)) {
+				if (!pixels.empty()) {
+					AppendClxPixelsOrFillRun(pixels.data(), pixels.size(), clxData);
+					pixels.clear();
+				}
+				transparentRunWidth += control;
+				remainingWidth -= control;
+			} else if (IsClxOpaqueFill(control)) {
+				AppendClxTransparentRun(transparentRunWidth, clxData);
+				transparentRunWidth = 0;
+				const uint8_t width = GetClxOpaqueFillWidth(control);
+				const uint8_t color = trn != nullptr ? trn[*src] : *src;
+				++src;
+				pixels.insert(pixels.end(), width, color);
+				remainingWidth -= width;
+			} else {
+				AppendClxTransparentRun(transparentRunWidth, clxData);
+				transparentRunWidth = 0;
+				const uint8_t width = GetClxOpaquePixelsWidth(control);
+				if (trn != nullptr) {
+					for (const uint8_t *end = src + width; src != end; ++src)
+						pixels.push_back(trn[*src]);
+				} else {
+					pixels.insert(pixels.end(), src, src + width);
+					src += width;
+				}
+				remainingWidth -= width;
+			}
+		}
+
+		const auto skipSize = GetSkipSize(remainingWidth, static_cast<int_fast16_t>(frameWidth));
+		xOffset = skipSize.xOffset;
+		frameHeight += skipSize.wholeLines;
+	}
+	if (!pixels.empty()) {
+		AppendClxPixelsOrFillRun(pixels.data(), pixels.size(), clxData);
+		pixels.clear();
+	}
+	AppendClxTransparentRun(transparentRunWidth, clxData);
+
+	WriteLE16(&clxData[frameHeaderPos + 4], static_cast<uint16_t>(frameHeight));
+}
+
+/**
+ * @brief A single CL2 frame in a sprite list or sheet.
+ */
+struct Cl2FrameRef {
+	const uint8_t *begin;
+	const uint8_t *end;
+	uint16_t width;
+};
+
+/**
+ * @brief The frames of a single CL2 sprite list (a group in a sheet).
+ */
+struct Cl2GroupRef {
+	size_t firstFrame;
+	uint32_t numFrames;
+};
+
+} // namespace
+
 uint16_t Cl2ToClx(const uint8_t *data, size_t size,
     PointerOrValue<uint16_t> widthOrWidths, std::vector<uint8_t> &clxData)
 {
@@ -55,58 +142,89 @@ uint16_t Cl2ToClx(const uint8_t *data, size_t size,
 			frameEnd = &groupBegin[LoadLE32(&groupBegin[4 * (frame + 1)])];
 
 			const uint16_t frameWidth = widthOrWidths.HoldsPointer() ? widthOrWidths.AsPointer()[frame - 1] : widthOrWidths.AsValue();
+			AppendCl2FrameAsClx(frameBegin, frameEnd, frameWidth, /*trn=*/nullptr, clxData, pixels);
+		}
 
-			const size_t frameHeaderPos = clxData.size();
-			clxData.resize(clxData.size() + ClxFrameHeaderSize);
-			WriteLE16(&clxData[frameHeaderPos], ClxFrameHeaderSize);
-			WriteLE16(&clxData[frameHeaderPos + 2], frameWidth);
-
-			unsigned transparentRunWidth = 0;
-			int_fast16_t xOffset = 0;
-			size_t frameHeight = 0;
-			const uint8_t *src = frameBegin + LoadLE16(frameBegin);
-			while (src != frameEnd) {
-				auto remainingWidth = static_cast<int_fast16_t>(frameWidth) - xOffset;
-				while (remainingWidth > 0) {
-					const uint8_t control = *src++;
-					if (!IsClxOpaque(control)) {
-						if (!pixels.empty()) {
-							AppendClxPixelsOrFillRun(pixels.data(), pixels.size(), clxData);
-							pixels.clear();
-						}
-						transparentRunWidth += control;
-						remainingWidth -= control;
-					} else if (IsClxOpaqueFill(control)) {
-						AppendClxTransparentRun(transparentRunWidth, clxData);
-						transparentRunWidth = 0;
-						const uint8_t width = GetClxOpaqueFillWidth(control);
-						const uint8_t color = *src++;
-						pixels.insert(pixels.end(), width, color);
-						remainingWidth -= width;
-					} else {
-						AppendClxTransparentRun(transparentRunWidth, clxData);
-						transparentRunWidth = 0;
-						const uint8_t width = GetClxOpaquePixelsWidth(control);
-						pixels.insert(pixels.end(), src, src + width);
-						src += width;
-						remainingWidth -= width;
-					}
-				}
+		WriteLE32(&clxData[clxDataOffset + (4 * (1 + static_cast<size_t>(numFrames)))], static_cast<uint32_t>(clxData.size() - clxDataOffset));
+	}
+	return numGroups == 1 ? 0 : numGroups;
+}
 
-				const auto skipSize = GetSkipSize(remainingWidth, static_cast<int_fast16_t>(frameWidth));
-				xOffset = skipSize.xOffset;
-				frameHeight += skipSize.wholeLines;
-			}
-			if (!pixels.empty()) {
-				AppendClxPixelsOrFillRun(pixels.data(), pixels.size(), clxData);
-				pixels.clear();
-			}
-			AppendClxTransparentRun(transparentRunWidth, clxData);
+uint16_t Cl2ToClxParallel(const uint8_t *data, size_t size,
+    PointerOrValue<uint16_t> widthOrWidths, const uint8_t *trn, std::vector<uint8_t> &clxData)
+{
+	uint32_t numGroups = 1;
+	const uint32_t maybeNumFrames = LoadLE32(data);
+
+	// If it is a number of frames, then the last frame offset will be equal to the size of the file.
+	if (LoadLE32(&data[(maybeNumFrames * 4) + 4]) != size) {
+		numGroups = maybeNumFrames / 4;
+	}
 
-			WriteLE16(&clxData[frameHeaderPos + 4], static_cast<uint16_t>(frameHeight));
+	// Collect all the frames first so that they can be converted independently.
+	std::vector<Cl2GroupRef> groups;
+	groups.reserve(numGroups);
+	std::vector<Cl2FrameRef> frames;
+	for (size_t group = 0; group < numGroups; ++group) {
+		const uint8_t *groupBegin = numGroups == 1 ? data : &data[LoadLE32(&data[group * 4])];
+		const uint32_t numFrames = LoadLE32(groupBegin);
+		groups.push_back(Cl2GroupRef { frames.size(), numFrames });
+		for (size_t frame = 1; frame <= numFrames; ++frame) {
+			const uint16_t frameWidth = widthOrWidths.HoldsPointer() ? widthOrWidths.AsPointer()[frame - 1] : widthOrWidths.AsValue();
+			frames.push_back(Cl2FrameRef {
+			    &groupBegin[LoadLE32(&groupBegin[4 * frame])],
+			    &groupBegin[LoadLE32(&groupBegin[4 * (frame + 1)])],
+			    frameWidth,
+			});
 		}
+	}
 
-		WriteLE32(&clxData[clxDataOffset + (4 * (1 + static_cast<size_t>(numFrames)))], static_cast<uint32_t>(clxData.size() - clxDataOffset));
+	// Each worker converts a contiguous range of frames `[begin, end)` into the buffer `chunks[begin]`.
+	// `frameEnds[i]` is the end offset of frame `i` within that buffer.
+	std::vector<std::vector<uint8_t>> chunks(frames.size());
+	std::vector<size_t> chunkIndex(frames.size());
+	std::vector<size_t> frameEnds(frames.size());
+	const auto convertFrames = [&](size_t begin, size_t end) {
+		std::vector<uint8_t> &chunk = chunks[begin];
+		std::vector<uint8_t> pixels;
+		pixels.reserve(4096);
+		for (size_t i = begin; i < end; ++i) {
+			AppendCl2FrameAsClx(frames[i].begin, frames[i].end, frames[i].width, trn, chunk, pixels);
+			chunkIndex[i] = begin;
+			frameEnds[i] = chunk.size();
+		}
+	};
+	ParallelFor(frames.size(), convertFrames, /*minItemsPerWorker=*/8);
+
+	// Stitch the converted frames together, adding the list and sheet headers.
+	size_t totalSize = numGroups == 1 ? 0 : 4 * numGroups;
+	for (const Cl2GroupRef &group : groups)
+		totalSize += 4 * (2 + static_cast<size_t>(group.numFrames));
+	for (const std::vector<uint8_t> &chunk : chunks)
+		totalSize += chunk.size();
+	clxData.clear();
+	clxData.resize(totalSize);
+
+	size_t outPos = numGroups == 1 ? 0 : 4 * numGroups;
+	for (size_t group = 0; group < numGroups; ++group) {
+		const Cl2GroupRef &groupRef = groups[group];
+		if (numGroups != 1)
+			WriteLE32(&clxData[4 * group], static_cast<uint32_t>(outPos));
+
+		// CLX header: frame count, frame offset for each frame, file size
+		const size_t clxDataOffset = outPos;
+		WriteLE32(&clxData[clxDataOffset], groupRef.numFrames);
+		outPos += 4 * (2 + static_cast<size_t>(groupRef.numFrames));
+		for (size_t frame = 0; frame < groupRef.numFrames; ++frame) {
+			const size_t i = groupRef.firstFrame + frame;
+			const std::vector<uint8_t> &chunk = chunks[chunkIndex[i]];
+			const size_t frameBegin = i == chunkIndex[i] ? 0 : frameEnds[i - 1];
+			const size_t frameSize = frameEnds[i] - frameBegin;
+			WriteLE32(&clxData[clxDataOffset + (4 * (frame + 1))], static_cast<uint32_t>(outPos - clxDataOffset));
+			std::memcpy(&clxData[outPos], &chunk[frameBegin], frameSize);
+			outPos += frameSize;
+		}
+		WriteLE32(&clxData[clxDataOffset + (4 * (1 + static_cast<size_t>(groupRef.numFrames)))], static_cast<uint32_t>(outPos - clxDataOffset));
 	}
 	return numGroups == 1 ? 0 : numGroups;
 }
@@ -12,6 +12,9 @@
 
 namespace devilution {
 
+/** @brief Version of the `Cl2ToClx` output, bump when the output changes (see `engine/asset_cache.hpp`). */
+constexpr uint32_t Cl2ToClxVersion = 1;
+
 /**
  * @brief Converts CL2 to CLX in-place.
  *
@@ -30,4 +33,24 @@ inline OwnedClxSpriteListOrSheet Cl2ToClx(std::unique_ptr<uint8_t[]> &&data, siz
 	return OwnedClxSpriteListOrSheet { std::move(data), numLists };
 }
 
+/**
+ * @brief Converts CL2 to CLX, converting the frames on multiple threads.
+ *
+ * @param trn If not null, a color translation that is applied to every pixel during the conversion.
+ *            This is equivalent to calling `ClxApplyTrans` on the result but avoids another pass over the data.
+ * @return uint16_t The number of lists in a sheet if it is a sheet, 0 otherwise.
+ */
+uint16_t Cl2ToClxParallel(const uint8_t *data, size_t size,
+    PointerOrValue<uint16_t> widthOrWidths, const uint8_t *trn, std::vector<uint8_t> &clxData);
+
+inline OwnedClxSpriteListOrSheet Cl2ToClxParallel(std::unique_ptr<uint8_t[]> &&data, size_t size, PointerOrValue<uint16_t> widthOrWidths, const uint8_t *trn)
+{
+	std::vector<uint8_t> clxData;
+	const uint16_t numLists = Cl2ToClxParallel(data.get(), size, widthOrWidths, trn, clxData);
+	data = nullptr;
+	data = std::unique_ptr<uint8_t[]>(new uint8_t[clxData.size()]);
+	memcpy(&data[0], clxData.data(), clxData.size());
+	return OwnedClxSpriteListOrSheet { std::move(data), numLists };
+}
+
 } // namespace devilution
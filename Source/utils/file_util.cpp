@@ -263,6 +263,43 @@ bool GetFileSize(const char *path, std::uintmax_t *size)
 #endif
 }
 
+bool GetFileModificationTime(const char *path, std::int64_t *time)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attr;
+#if defined(DEVILUTIONX_WINDOWS_NO_WCHAR) || (defined(WINVER) && WINVER <= 0x0500 && (!defined(_WIN32_WINNT) || _WIN32_WINNT == 0))
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attr)) {
+		return false;
+	}
+#else
+	const auto pathUtf16 = ToWideChar(path);
+	if (pathUtf16 == nullptr) {
+		LogError("UTF-8 -> UTF-16 conversion error code {}", ::GetLastError());
+		return false;
+	}
+	if (!GetFileAttributesExW(&pathUtf16[0], GetFileExInfoStandard, &attr)) {
+		return false;
+	}
+#endif
+	*time = static_cast<std::int64_t>(static_cast<std::uint64_t>(attr.ftLastWriteTime.dwHighDateTime) << 32 | attr.ftLastWriteTime.dwLowDateTime);
+	return true;
+#else
+	struct ::stat statResult;
+	if (::stat(path, &statResult) == -1)
+		return false;
+	// Prefer nanosecond timestamps so that a file rewritten within the same second still compares different.
+#if defined(__APPLE__)
+	*time = static_cast<std::int64_t>(statResult.st_mtimespec.tv_sec) * 1000000000 + statResult.st_mtimespec.tv_nsec;
+#elif defined(st_mtime)
+	// C libraries that provide `st_mtim` define `st_mtime` as a macro for `st_mtim.tv_sec`.
+	*time = static_cast<std::int64_t>(statResult.st_mtim.tv_sec) * 1000000000 + statResult.st_mtim.tv_nsec;
+#else
+	*time = static_cast<std::int64_t>(statResult.st_mtime);
+#endif
+	return true;
+#endif
+}
+
 bool CreateDir(const char *path)
 {
 #ifdef DVL_HAS_FILESYSTEM
@@ -413,6 +450,41 @@ void RenameFile(const char *from, const char *to)
 #endif
 }
 
+bool RenameFileOverwrite(const char *from, const char *to)
+{
+#ifdef _WIN32
+#ifdef DEVILUTIONX_WINDOWS_NO_WCHAR
+	if (!::MoveFileEx(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+#else
+	const auto fromUtf16 = ToWideChar(from);
+	const auto toUtf16 = ToWideChar(to);
+	if (fromUtf16 == nullptr || toUtf16 == nullptr) {
+		LogError("UTF-8 -> UTF-16 conversion error code {}", ::GetLastError());
+		return false;
+	}
+	if (!::MoveFileExW(&fromUtf16[0], &toUtf16[0], MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+#endif // DEVILUTIONX_WINDOWS_NO_WCHAR
+		LogError("Failed to rename {} to {}", from, to);
+		return false;
+	}
+	return true;
+#elif defined(DVL_HAS_FILESYSTEM)
+	std::error_code error;
+	std::filesystem::rename(reinterpret_cast<const char8_t *>(from), reinterpret_cast<const char8_t *>(to), error);
+	if (error) {
+		LogError("Failed to rename {} to {}: {}", from, to, error.message());
+		return false;
+	}
+	return true;
+#else
+	if (::rename(from, to) != 0) {
+		LogError("Failed to rename {} to {}: {}", from, to, std::strerror(errno));
+		return false;
+	}
+	return true;
+#endif
+}
+
 void CopyFileOverwrite(const char *from, const char *to)
 {
 #ifdef _WIN32
@@ -35,6 +35,13 @@ std::string_view Dirname(std::string_view path);
 bool FileExistsAndIsWriteable(const char *path);
 bool GetFileSize(const char *path, std::uintmax_t *size);
 
+/**
+ * @brief Returns the time the file was last written to.
+ *
+ * The unit and epoch depend on the platform, the result is only meant to be compared with other results.
+ */
+bool GetFileModificationTime(const char *path, std::int64_t *time);
+
 /**
  * @brief Creates a single directory (non-recursively).
  *
@@ -45,6 +52,9 @@ bool CreateDir(const char *path);
 void RecursivelyCreateDir(const char *path);
 bool ResizeFile(const char *path, std::uintmax_t size);
 void RenameFile(const char *from, const char *to);
+
+/** @brief Renames a file, atomically replacing the destination if it exists. */
+bool RenameFileOverwrite(const char *from, const char *to);
 void CopyFileOverwrite(const char *from, const char *to);
 void RemoveFile(const char *path);
 FILE *OpenFile(const char *path, const char *mode);
@@ -0,0 +1,91 @@
+#include "utils/parallel_for.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_cpuinfo.h>
+#else
+#include <SDL.h>
+#endif
+
+#include "utils/sdl_thread.h"
+
+namespace devilution {
+
+namespace {
+
+/** Spawning more threads than this does not pay off for our workloads. */
+constexpr size_t MaxParallelWorkers = 8;
+
+struct ParallelForTask {
+	tl::function_ref<void(size_t, size_t)> fn;
+	size_t begin;
+	size_t end;
+};
+
+int SDLCALL RunParallelForTask(void *data)
+{
+	const auto &task = *static_cast<const ParallelForTask *>(data);
+	task.fn(task.begin, task.end);
+	return 0;
+}
+
+} // namespace
+
+size_t GetParallelWorkerCount()
+{
+#if defined(__EMSCRIPTEN__) || defined(USE_SDL1)
+	return 1;
+#elif defined(USE_SDL3)
+	static const size_t Count = std::clamp<size_t>(SDL_GetNumLogicalCPUCores(), 1, MaxParallelWorkers);
+	return Count;
+#else
+	static const size_t Count = std::clamp<size_t>(SDL_GetCPUCount(), 1, MaxParallelWorkers);
+	return Count;
+#endif
+}
+
+void ParallelFor(size_t count, tl::function_ref<void(size_t, size_t)> fn, size_t minItemsPerWorker)
+{
+	if (count == 0)
+		return;
+	const size_t numWorkers = std::clamp<size_t>(count / std::max<size_t>(minItemsPerWorker, 1), 1, GetParallelWorkerCount());
+	if (numWorkers == 1) {
+		fn(0, count);
+		return;
+	}
+
+	std::vector<ParallelForTask> tasks;
+	tasks.reserve(numWorkers);
+	const size_t itemsPerWorker = count / numWorkers;
+	const size_t remainder = count % numWorkers;
+	size_t begin = 0;
+	for (size_t i = 0; i < numWorkers; ++i) {
+		const size_t end = begin + itemsPerWorker + (i < remainder ? 1 : 0);
+		tasks.push_back(ParallelForTask { fn, begin, end });
+		begin = end;
+	}
+
+	std::vector<SdlThread> threads;
+	threads.reserve(numWorkers - 1);
+	for (size_t i = 1; i < numWorkers; ++i) {
+		std::optional<SdlThread> thread = SdlThread::TryCreate(RunParallelForTask, &tasks[i]);
+		if (!thread)
+			break;
+		threads.push_back(std::move(*thread));
+	}
+	RunParallelForTask(&tasks[0]);
+	// The sub-ranges that didn't get a thread.
+	for (size_t i = threads.size() + 1; i < numWorkers; ++i) {
+		RunParallelForTask(&tasks[i]);
+	}
+	for (SdlThread &thread : threads) {
+		thread.join();
+	}
+}
+
+} // namespace devilution
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+#include <function_ref.hpp>
+
+namespace devilution {
+
+/**
+ * @brief The number of threads (including the calling thread) that `ParallelFor` may use.
+ */
+[[nodiscard]] size_t GetParallelWorkerCount();
+
+/**
+ * @brief Calls `fn(begin, end)` for disjoint contiguous sub-ranges that cover `[0, count)`.
+ *
+ * Sub-ranges are processed on up to `GetParallelWorkerCount()` threads,
+ * the first one on the calling thread. Returns once all of them have been processed.
+ *
+ * The threads are created for each call and joined before it returns, which costs far less than
+ * the work this is used for (converting sprites, reading and encoding save files). If a thread
+ * can't be created, its sub-range is processed on the calling thread instead.
+ *
+ * @param minItemsPerWorker Do not spawn a thread for fewer items than this.
+ */
+void ParallelFor(size_t count, tl::function_ref<void(size_t, size_t)> fn, size_t minItemsPerWorker = 1);
+
+} // namespace devilution
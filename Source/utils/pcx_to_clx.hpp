@@ -14,6 +14,9 @@
 
 namespace devilution {
 
+/** @brief Version of the `PcxToClx` output, bump when the output changes (see `engine/asset_cache.hpp`). */
+constexpr uint32_t PcxToClxVersion = 1;
+
 /**
  * @brief Loads a PCX file as a CLX sprite.
  *
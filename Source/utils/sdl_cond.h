@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef USE_SDL3
+#include <SDL3/SDL_mutex.h>
+#else
+#include <SDL_mutex.h>
+#endif
+
+#include "appfat.h"
+#include "utils/sdl_mutex.h"
+
+namespace devilution {
+
+/*
+ * RAII wrapper for SDL_cond, waited on with an `SdlMutex` held by the caller.
+ */
+class SdlCondition final {
+public:
+	SdlCondition()
+#ifdef USE_SDL3
+	    : cond_(SDL_CreateCondition())
+#else
+	    : cond_(SDL_CreateCond())
+#endif
+	{
+		if (cond_ == nullptr)
+			ErrSdl();
+	}
+
+	~SdlCondition()
+	{
+#ifdef USE_SDL3
+		SDL_DestroyCondition(cond_);
+#else
+		SDL_DestroyCond(cond_);
+#endif
+	}
+
+	SdlCondition(const SdlCondition &) = delete;
+	SdlCondition(SdlCondition &&) = delete;
+	SdlCondition &operator=(const SdlCondition &) = delete;
+	SdlCondition &operator=(SdlCondition &&) = delete;
+
+	void signal() noexcept
+	{
+#ifdef USE_SDL3
+		SDL_SignalCondition(cond_);
+#else
+		if (SDL_CondSignal(cond_) < 0) ErrSdl();
+#endif
+	}
+
+	/**
+	 * @brief Unlocks `mutex` until the condition is signalled or `timeoutMs` have passed, then locks it again.
+	 * @return false if the wait timed out. Like any condition variable, it may also wake up spuriously.
+	 */
+	bool waitFor(SdlMutex &mutex, uint32_t timeoutMs) noexcept
+	{
+#ifdef USE_SDL3
+		return SDL_WaitConditionTimeout(cond_, mutex.get(), static_cast<Sint32>(timeoutMs));
+#else
+		const int result = SDL_CondWaitTimeout(cond_, mutex.get(), timeoutMs);
+		if (result < 0) ErrSdl();
+		return result == 0;
+#endif
+	}
+
+private:
+#ifdef USE_SDL3
+	SDL_Condition *cond_;
+#else
+	SDL_cond *cond_;
+#endif
+};
+
+} // namespace devilution
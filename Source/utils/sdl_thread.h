@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #ifdef USE_SDL3
 #include <SDL3/SDL_thread.h>
@@ -44,6 +45,12 @@ public:
 		if (handler != nullptr) handler();
 	}
 	SdlThread() = default;
+
+	static std::optional<SdlThread> TryCreate(int(SDLCALL *handler)(void *), void *data)
+	{
+		return SdlThread(handler, data);
+	}
+
 	bool joinable() const
 	{
 		return false;
@@ -88,6 +95,22 @@ public:
 
 	SdlThread() = default;
 
+	/**
+	 * @brief Like the constructor, but returns nothing instead of failing if the thread can't be created.
+	 */
+	static std::optional<SdlThread> TryCreate(int(SDLCALL *handler)(void *), void *data)
+	{
+		SdlThread result;
+#ifdef USE_SDL1
+		result.thread.reset(SDL_CreateThread(handler, data));
+#else
+		result.thread.reset(SDL_CreateThread(handler, nullptr, data));
+#endif
+		if (result.thread == nullptr)
+			return std::nullopt;
+		return result;
+	}
+
 	bool joinable() const
 	{
 		return thread != nullptr;
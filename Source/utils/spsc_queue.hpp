@@ -0,0 +1,76 @@
+/**
+ * @file spsc_queue.hpp
+ *
+ * A bounded lock-free queue for handing items from one thread to another.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace devilution {
+
+/**
+ * @brief A ring buffer with a single producer thread and a single consumer thread that never lock.
+ *
+ * Items are written and read in place. A popped item stays in its slot until the slot comes around
+ * again, so items that own memory, like a `std::vector`, keep their capacity for the next item.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+	static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	/**
+	 * @brief Producer: the slot of the next item, or nullptr if the queue is full.
+	 *
+	 * Call `Push` once the item is written to the slot.
+	 */
+	[[nodiscard]] T *BackSlot()
+	{
+		const size_t tail = tail_.load(std::memory_order_relaxed);
+		if (tail - head_.load(std::memory_order_acquire) == Capacity)
+			return nullptr;
+		return &items_[tail & (Capacity - 1)];
+	}
+
+	/** @brief Producer: hands the item in `BackSlot` to the consumer. */
+	void Push()
+	{
+		tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Consumer: the oldest item, or nullptr if the queue is empty.
+	 *
+	 * Call `Pop` once done with the item.
+	 */
+	[[nodiscard]] T *Front()
+	{
+		const size_t head = head_.load(std::memory_order_relaxed);
+		if (head == tail_.load(std::memory_order_acquire))
+			return nullptr;
+		return &items_[head & (Capacity - 1)];
+	}
+
+	/** @brief Consumer: gives the slot of the item in `Front` back to the producer. */
+	void Pop()
+	{
+		head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	/** @brief True if the consumer has popped all items pushed so far. */
+	[[nodiscard]] bool Empty() const
+	{
+		return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+	}
+
+private:
+	std::array<T, Capacity> items_ {};
+	/** The two positions are written by different threads, so they get a cache line each. */
+	alignas(64) std::atomic<size_t> head_ = 0;
+	alignas(64) std::atomic<size_t> tail_ = 0;
+};
+
+} // namespace devilution
@@ -0,0 +1,109 @@
+#include "utils/startup_trace.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+
+namespace devilution {
+
+namespace {
+
+struct StartupTraceEvent {
+	std::string_view name;
+	int64_t startUs;
+	int64_t durationUs;
+};
+
+/** Static initialization happens right before `main`, which is close enough to the process start. */
+const std::chrono::steady_clock::time_point ProcessStart = std::chrono::steady_clock::now();
+
+std::string TracePath;
+std::vector<StartupTraceEvent> Events;
+std::optional<int64_t> TimeToMenuUs;
+
+int64_t NowUs()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - ProcessStart).count();
+}
+
+void WriteTrace()
+{
+	std::string json = R"({"displayTimeUnit":"ms","traceEvents":[)";
+	for (size_t i = 0; i < Events.size(); ++i) {
+		const StartupTraceEvent &event = Events[i];
+		json += std::format(R"({}{{"name":"{}","ph":"X","pid":1,"tid":1,"ts":{},"dur":{}}})",
+		    i == 0 ? "" : ",", event.name, event.startUs, event.durationUs);
+	}
+	json += R"(],"otherData":{)";
+	if (TimeToMenuUs.has_value())
+		json += std::format(R"("timeToMenuUs":{})", *TimeToMenuUs);
+	json += "}}\n";
+
+	// Readers poll for the file, so make sure they never see a partially written one.
+	const std::string tempPath = TracePath + ".tmp";
+	FILE *file = OpenFile(tempPath.c_str(), "wb");
+	if (file == nullptr) {
+		LogError("Failed to open startup trace file {}", tempPath);
+		return;
+	}
+	const bool ok = std::fwrite(json.data(), json.size(), 1, file) == 1;
+	std::fclose(file);
+	if (!ok) {
+		LogError("Failed to write startup trace file {}", tempPath);
+		return;
+	}
+	RenameFileOverwrite(tempPath.c_str(), TracePath.c_str());
+}
+
+} // namespace
+
+void InitStartupTrace(std::string_view path)
+{
+	TracePath = path;
+}
+
+bool IsStartupTraceEnabled()
+{
+	return !TracePath.empty();
+}
+
+StartupTracePhase::StartupTracePhase(std::string_view name)
+    : name_(name)
+    , startUs_(IsStartupTraceEnabled() ? NowUs() : 0)
+{
+}
+
+StartupTracePhase::~StartupTracePhase()
+{
+	if (!IsStartupTraceEnabled())
+		return;
+	Events.push_back(StartupTraceEvent { name_, startUs_, NowUs() - startUs_ });
+}
+
+void MarkStartupTraceMenuShown()
+{
+	if (!IsStartupTraceEnabled() || TimeToMenuUs.has_value())
+		return;
+	TimeToMenuUs = NowUs();
+	LogVerbose("Time to main menu: {}ms", *TimeToMenuUs / 1000);
+	WriteTrace();
+}
+
+void FinishStartupTrace()
+{
+	if (!IsStartupTraceEnabled())
+		return;
+	WriteTrace();
+	TracePath.clear();
+	Events.clear();
+}
+
+} // namespace devilution
@@ -0,0 +1,61 @@
+/**
+ * @file startup_trace.hpp
+ *
+ * Records the wall time of the startup phases to a JSON file (`--startup-trace`).
+ *
+ * The file uses the Chrome trace event format and can be opened in `about:tracing` or Perfetto.
+ * The time from process start until the main menu is first rendered is stored as `otherData.timeToMenuUs`.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include <function_ref.hpp>
+
+namespace devilution {
+
+/**
+ * @brief Enables the startup trace, writing it to the given path.
+ */
+void InitStartupTrace(std::string_view path);
+
+[[nodiscard]] bool IsStartupTraceEnabled();
+
+/**
+ * @brief Records the lifetime of the object as a startup phase.
+ *
+ * @param name A string literal, it is neither copied nor escaped.
+ */
+class StartupTracePhase {
+public:
+	explicit StartupTracePhase(std::string_view name);
+	~StartupTracePhase();
+
+	StartupTracePhase(const StartupTracePhase &) = delete;
+	StartupTracePhase &operator=(const StartupTracePhase &) = delete;
+
+private:
+	std::string_view name_;
+	int64_t startUs_;
+};
+
+inline void TraceStartupPhase(std::string_view name, tl::function_ref<void()> fn)
+{
+	const StartupTracePhase phase(name);
+	fn();
+}
+
+/**
+ * @brief Records the time to the main menu and writes the trace.
+ *
+ * Only the first call has an effect.
+ */
+void MarkStartupTraceMenuShown();
+
+/**
+ * @brief Writes the trace including any phases recorded after the main menu was shown, then stops tracing.
+ */
+void FinishStartupTrace();
+
+} // namespace devilution
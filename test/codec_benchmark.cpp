@@ -0,0 +1,56 @@
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "codec.h"
+
+namespace devilution {
+namespace {
+
+/** About the size of a level file. */
+constexpr size_t FileSize = 256 * 1024;
+
+constexpr char Password[] = "xrgyrkj1";
+
+std::unique_ptr<std::byte[]> MakeFile(size_t encodedLen)
+{
+	std::unique_ptr<std::byte[]> data { new std::byte[encodedLen] };
+	for (size_t i = 0; i < FileSize; ++i)
+		data[i] = static_cast<std::byte>(i * 31);
+	return data;
+}
+
+void BM_CodecEncode(benchmark::State &state)
+{
+	const size_t encodedLen = codec_get_encoded_len(FileSize);
+	const std::unique_ptr<std::byte[]> data = MakeFile(encodedLen);
+	for (auto _ : state) {
+		codec_encode(data.get(), FileSize, encodedLen, Password);
+		benchmark::DoNotOptimize(data.get());
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * FileSize));
+}
+
+void BM_CodecDecode(benchmark::State &state)
+{
+	const size_t encodedLen = codec_get_encoded_len(FileSize);
+	const std::unique_ptr<std::byte[]> encoded = MakeFile(encodedLen);
+	codec_encode(encoded.get(), FileSize, encodedLen, Password);
+	const std::unique_ptr<std::byte[]> data { new std::byte[encodedLen] };
+	for (auto _ : state) {
+		state.PauseTiming();
+		memcpy(data.get(), encoded.get(), encodedLen);
+		state.ResumeTiming();
+		if (codec_decode(data.get(), encodedLen, Password) != FileSize)
+			state.SkipWithError("Failed to decode");
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * FileSize));
+}
+
+BENCHMARK(BM_CodecEncode);
+BENCHMARK(BM_CodecDecode);
+
+} // namespace
+} // namespace devilution
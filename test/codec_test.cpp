@@ -1,9 +1,25 @@
+#include <cstddef>
+#include <cstdint>
+
 #include <gtest/gtest.h>
 
 #include "codec.h"
 
 using namespace devilution;
 
+namespace {
+
+constexpr char Password[] = "xrgyrkj1";
+
+/** 100 bytes, so that the last block is not full. */
+void FillInput(std::byte *data)
+{
+	for (size_t i = 0; i < 100; ++i)
+		data[i] = static_cast<std::byte>(i * 7 + 3);
+}
+
+} // namespace
+
 TEST(Codec, codec_get_encoded_len)
 {
 	EXPECT_EQ(codec_get_encoded_len(50), 72);
@@ -13,3 +29,41 @@ TEST(Codec, codec_get_encoded_len_eq)
 {
 	EXPECT_EQ(codec_get_encoded_len(128), 136);
 }
+
+TEST(Codec, codec_encode_matches_saves)
+{
+	// Encoded by the original implementation, saves must stay byte-identical.
+	constexpr uint8_t Expected[] = {
+	0x61, 0x67, 0xE5, 0x33, 0x51, 0xC2, 0x0E, 0xA0, 0xE9, 0xFC, 0x82, 0xC7,
+	0x4E, 0x4B, 0x2A, 0x00, 0x45, 0x2D, 0x92, 0xAB, 0xED, 0xFB, 0x69, 0x8F,
+	0xE5, 0x56, 0x9A, 0x54, 0x15, 0x70, 0x1E, 0x4B, 0xFA, 0xFF, 0xBE, 0x94,
+	0xC9, 0x51, 0x1E, 0x37, 0x79, 0x4F, 0xDD, 0x1B, 0x79, 0xDA, 0x66, 0xD8,
+	0x81, 0xE4, 0xAA, 0xFF, 0x76, 0x63, 0x32, 0xE8, 0xBD, 0xC5, 0x8A, 0x83,
+	0xC5, 0xC3, 0x41, 0x97, 0x0B, 0x5B, 0x9D, 0x9C, 0x70, 0x45, 0x8F, 0x4B,
+	0x9C, 0x30, 0x61, 0xBC, 0x0C, 0x17, 0xE7, 0x7E, 0xC5, 0x85, 0x33, 0x2E,
+	0x87, 0xC7, 0x11, 0x20, 0xC4, 0xD1, 0x1B, 0x3F, 0xE0, 0xBC, 0xFD, 0x30,
+	0xB8, 0xA3, 0x73, 0xEA, 0xF6, 0xBF, 0x72, 0x66, 0xC8, 0x91, 0x4C, 0x44,
+	0xAF, 0xA3, 0x62, 0xBF, 0x67, 0x32, 0x68, 0xAC, 0x1B, 0x09, 0xC2, 0x52,
+	0xF6, 0xBF, 0x72, 0x66, 0xC8, 0x91, 0x4C, 0x44, 0xF4, 0x5C, 0xC5, 0x1B,
+	0x00, 0x24, 0x00, 0x00
+	};
+	std::byte data[sizeof(Expected)] {};
+	FillInput(data);
+	codec_encode(data, 100, sizeof(data), Password);
+	for (size_t i = 0; i < sizeof(Expected); ++i)
+		EXPECT_EQ(static_cast<uint8_t>(data[i]), Expected[i]) << "at byte " << i;
+}
+
+TEST(Codec, codec_decode_roundtrip)
+{
+	std::byte data[136] {};
+	std::byte input[100];
+	FillInput(data);
+	FillInput(input);
+	codec_encode(data, 100, sizeof(data), Password);
+	ASSERT_EQ(codec_decode(data, sizeof(data), Password), 100);
+	for (size_t i = 0; i < 100; ++i)
+		EXPECT_EQ(data[i], input[i]) << "at byte " << i;
+	codec_encode(data, 100, sizeof(data), Password);
+	EXPECT_EQ(codec_decode(data, sizeof(data), "wrong"), 0);
+}
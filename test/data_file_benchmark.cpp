@@ -0,0 +1,121 @@
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "data/file.hpp"
+#include "data/parser.hpp"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace {
+
+/** @brief A table the size of a large mod-provided one: 20000 records of 32 short fields. */
+std::string MakeTable()
+{
+	std::string result;
+	for (unsigned col = 0; col < 32; ++col) {
+		StrAppend(result, col == 0 ? "" : "\t", "Column", col);
+	}
+	result += '\n';
+	for (unsigned row = 0; row < 20000; ++row) {
+		for (unsigned col = 0; col < 32; ++col) {
+			if (col != 0) result += '\t';
+			if ((row + col) % 5 == 0) continue; // empty field
+			StrAppend(result, col % 3 == 0 ? "Name" : "", row * 31 + col);
+		}
+		result += '\n';
+	}
+	return result;
+}
+
+const std::string &GetTable()
+{
+	static const std::string Table = MakeTable();
+	return Table;
+}
+
+size_t CountFields(std::string_view content, const SeparatorIndex &index)
+{
+	const char *end = content.data() + content.size();
+	size_t numFields = 0;
+	GetFieldResult result { content.data() };
+	do {
+		result = GetNextField(result.next, end, index);
+		benchmark::DoNotOptimize(result.value);
+		++numFields;
+	} while (!result.endOfFile());
+	return numFields;
+}
+
+void BM_ScanFieldsBytewise(benchmark::State &state)
+{
+	const std::string_view content = GetTable();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(CountFields(content, {}));
+	}
+	state.SetBytesProcessed(state.iterations() * content.size());
+}
+
+void BM_BuildSeparatorIndex(benchmark::State &state)
+{
+	const std::string_view content = GetTable();
+	const size_t maskWords = SeparatorIndex::maskWords(content.size());
+	const std::unique_ptr<uint64_t[]> masks { new uint64_t[2 * maskWords] };
+	for (auto _ : state) {
+		BuildSeparatorIndex(content, masks.get(), masks.get() + maskWords);
+		benchmark::DoNotOptimize(masks.get());
+	}
+	state.SetBytesProcessed(state.iterations() * content.size());
+}
+
+void BM_ScanFieldsIndexed(benchmark::State &state)
+{
+	const std::string_view content = GetTable();
+	const size_t maskWords = SeparatorIndex::maskWords(content.size());
+	const std::unique_ptr<uint64_t[]> masks { new uint64_t[2 * maskWords] };
+	for (auto _ : state) {
+		BuildSeparatorIndex(content, masks.get(), masks.get() + maskWords);
+		const SeparatorIndex index { content.data(), masks.get(), masks.get() + maskWords };
+		benchmark::DoNotOptimize(CountFields(content, index));
+	}
+	state.SetBytesProcessed(state.iterations() * content.size());
+}
+
+size_t CountFields(const DataFile &dataFile)
+{
+	size_t numFields = 0;
+	for (DataFileRecord record : dataFile) {
+		for (DataFileField field : record) {
+			benchmark::DoNotOptimize(field.value());
+			++numFields;
+		}
+	}
+	return numFields;
+}
+
+constexpr std::string_view GameTable = "txtdata\\items\\itemdat.tsv";
+
+void BM_LoadDataFile(benchmark::State &state)
+{
+	for (auto _ : state) {
+		std::expected<DataFile, DataFile::Error> dataFile = DataFile::load(GameTable);
+		if (!dataFile.has_value()) {
+			state.SkipWithError(StrCat("Unable to load ", GameTable).c_str());
+			return;
+		}
+		benchmark::DoNotOptimize(CountFields(*dataFile));
+	}
+}
+
+BENCHMARK(BM_ScanFieldsBytewise);
+BENCHMARK(BM_BuildSeparatorIndex);
+BENCHMARK(BM_ScanFieldsIndexed);
+BENCHMARK(BM_LoadDataFile);
+
+} // namespace
+} // namespace devilution
@@ -3,6 +3,9 @@
 #include "data/file.hpp"
 #include "data/parser.hpp"
 
+#include <cstdint>
+#include <random>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -529,4 +532,64 @@ TEST(DataFileTest, SkipRowIterator)
 	EXPECT_EQ(row, expectedFields.size()) << "Parsing returned fewer records than expected";
 }
 
+TEST(DataFileTest, RandomAccessRecords)
+{
+	for (std::string_view path : { "txtdata\\lf.tsv", "txtdata\\cr.tsv", "txtdata\\crlf.tsv", "txtdata\\lf_no_trail.tsv", "txtdata\\utf8_bom.tsv", "txtdata\\empty.tsv" }) {
+		auto result = LoadDataFile(path);
+		ASSERT_TRUE(result.has_value()) << "Unable to load " << path;
+
+		const DataFile &dataFile = result.value();
+
+		std::vector<std::vector<std::string_view>> expectedFields;
+		for (DataFileRecord record : dataFile) {
+			std::vector<std::string_view> &fields = expectedFields.emplace_back();
+			for (DataFileField field : record) {
+				fields.push_back(*field);
+			}
+		}
+		ASSERT_EQ(dataFile.numRows(), expectedFields.size()) << "Record index should have one entry per record in " << path;
+
+		// Visit the records in reverse so that no record depends on the previous one being parsed
+		for (size_t row = expectedFields.size(); row-- > 0;) {
+			RecordIterator it = dataFile.recordAt(row);
+			ASSERT_NE(it, dataFile.end()) << "Missing record " << row << " in " << path;
+			DataFileRecord record = *it;
+			EXPECT_EQ(record.row(), row) << "Record should report its position in the file";
+			unsigned col = 0;
+			for (DataFileField field : record) {
+				ASSERT_LT(col, expectedFields[row].size()) << "Too many fields in record " << row << " of " << path;
+				EXPECT_EQ(*field, expectedFields[row][col]) << "Unexpected value at record " << row << " and field " << col << " of " << path;
+				col++;
+			}
+			EXPECT_EQ(col, expectedFields[row].size()) << "Parsing returned fewer fields than expected in record " << row << " of " << path;
+		}
+		EXPECT_EQ(dataFile.recordAt(expectedFields.size()), dataFile.end()) << "Reading past the last record should return the end iterator";
+	}
+}
+
+TEST(DataFileTest, SeparatorIndexMatchesScalar)
+{
+	// Mostly separators so that every lane of the vector compares sees them, and bytes with the high bit set
+	constexpr std::string_view Alphabet = "\t\t\r\n\nab1 \x80\xff";
+	std::mt19937 rng(1234);
+	std::uniform_int_distribution<size_t> pick(0, Alphabet.size() - 1);
+	std::string buffer;
+	for (size_t size = 0; size <= 300; ++size) {
+		for (size_t offset = 0; offset < 4; ++offset) {
+			// The offset makes the content start at addresses that are not aligned to the vector size
+			buffer.resize(offset + size);
+			for (char &c : buffer)
+				c = Alphabet[pick(rng)];
+			const std::string_view content = std::string_view(buffer).substr(offset);
+
+			const size_t maskWords = SeparatorIndex::maskWords(content.size());
+			std::vector<uint64_t> masks(2 * maskWords, 0xAAAAAAAAAAAAAAAA);
+			std::vector<uint64_t> expectedMasks(2 * maskWords, 0x5555555555555555);
+			BuildSeparatorIndex(content, masks.data(), masks.data() + maskWords);
+			BuildSeparatorIndexScalar(content, expectedMasks.data(), expectedMasks.data() + maskWords);
+			ASSERT_EQ(masks, expectedMasks) << "Masks differ for " << size << " bytes at offset " << offset;
+		}
+	}
+}
+
 } // namespace devilution
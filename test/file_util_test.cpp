@@ -41,6 +41,16 @@ TEST(FileUtil, GetFileSize)
 	EXPECT_EQ(result, 42);
 }
 
+TEST(FileUtil, GetFileModificationTime)
+{
+	const std::string path = GetTmpPathName();
+	WriteDummyFile(path.c_str(), 42);
+	std::int64_t result;
+	ASSERT_TRUE(GetFileModificationTime(path.c_str(), &result));
+	EXPECT_NE(result, 0);
+	EXPECT_FALSE(GetFileModificationTime("this-file-should-not-exist", &result));
+}
+
 TEST(FileUtil, FileExists)
 {
 	EXPECT_FALSE(FileExists("this-file-should-not-exist"));
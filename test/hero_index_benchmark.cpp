@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "DiabloUI/diabloui.h"
+#include "engine/assets.hpp"
+#include "game_mode.hpp"
+#include "pfile.h"
+#include "player.h"
+#include "save_queue.hpp"
+#include "tables/deferred_tables.hpp"
+#include "tables/playerdat.hpp"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace {
+
+constexpr uint32_t NumHeroes = 50;
+
+int NumHeroesListed;
+
+bool CountHero(_uiheroinfo * /*hero*/)
+{
+	++NumHeroesListed;
+	return true;
+}
+
+void InitOnce()
+{
+	[[maybe_unused]] static const bool GlobalInitDone = []() {
+		LoadCoreArchives();
+		LoadGameArchives();
+		if (!HaveMainData()) {
+			LogError("This benchmark needs spawn.mpq or diabdat.mpq");
+			exit(1);
+		}
+
+		const std::string prefPath = paths::BasePath() + "hero_index_benchmark/";
+		RecursivelyCreateDir(prefPath.c_str());
+		paths::SetPrefPath(prefPath);
+		gbIsSpawn = true;
+		gbIsMultiplayer = false;
+		LoadPlayerDataFiles();
+		EnsureDeferredTablesLoaded();
+
+		Players.resize(1);
+		constexpr HeroClass Classes[] = { HeroClass::Warrior, HeroClass::Rogue, HeroClass::Sorcerer };
+		for (uint32_t i = 0; i < NumHeroes; ++i) {
+			_uiheroinfo hero {};
+			hero.saveNumber = i;
+			std::snprintf(hero.name, sizeof(hero.name), "Hero%u", i);
+			hero.heroclass = Classes[i % 3];
+			pfile_ui_save_create(&hero);
+		}
+		WaitForPendingSaves();
+		return true;
+	}();
+}
+
+/** @brief Time until the character selection screen has all the heroes it shows, state.range(0) is whether the hero index is up to date. */
+void BM_ListHeroes(benchmark::State &state)
+{
+	InitOnce();
+	const bool indexed = state.range(0) != 0;
+	const std::string indexPath = paths::PrefPath() + "heroes.idx";
+	pfile_ui_set_hero_infos(CountHero);
+	for (auto _ : state) {
+		if (!indexed) {
+			state.PauseTiming();
+			RemoveFile(indexPath.c_str());
+			state.ResumeTiming();
+		}
+		NumHeroesListed = 0;
+		pfile_ui_set_hero_infos(CountHero);
+	}
+	if (NumHeroesListed != static_cast<int>(NumHeroes))
+		state.SkipWithError(StrCat("Listed ", NumHeroesListed, " heroes instead of ", NumHeroes).c_str());
+	state.SetLabel(indexed ? "indexed" : "not indexed");
+}
+
+BENCHMARK(BM_ListHeroes)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,100 @@
+#include <cstdio>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "game_mode.hpp"
+#include "hero_index.hpp"
+
+using namespace devilution;
+
+namespace {
+
+std::string GetTmpPathName()
+{
+	const auto *currentTest = ::testing::UnitTest::GetInstance()->current_test_info();
+	return std::string("Test_") + currentTest->test_case_name() + "_" + currentTest->name() + ".idx";
+}
+
+_uiheroinfo MakeHero(const char *name, uint8_t level)
+{
+	_uiheroinfo hero {};
+	std::snprintf(hero.name, sizeof(hero.name), "%s", name);
+	hero.level = level;
+	hero.heroclass = HeroClass::Rogue;
+	hero.herorank = 1;
+	hero.strength = 30;
+	hero.magic = 25;
+	hero.dexterity = 60;
+	hero.vitality = 40;
+	hero.hassaved = true;
+	hero.spawned = false;
+	return hero;
+}
+
+void ExpectSameHero(const _uiheroinfo *actual, const _uiheroinfo &expected)
+{
+	ASSERT_NE(actual, nullptr);
+	EXPECT_STREQ(actual->name, expected.name);
+	EXPECT_EQ(actual->level, expected.level);
+	EXPECT_EQ(actual->heroclass, expected.heroclass);
+	EXPECT_EQ(actual->herorank, expected.herorank);
+	EXPECT_EQ(actual->strength, expected.strength);
+	EXPECT_EQ(actual->magic, expected.magic);
+	EXPECT_EQ(actual->dexterity, expected.dexterity);
+	EXPECT_EQ(actual->vitality, expected.vitality);
+	EXPECT_EQ(actual->hassaved, expected.hassaved);
+	EXPECT_EQ(actual->spawned, expected.spawned);
+}
+
+} // namespace
+
+TEST(HeroIndex, Roundtrip)
+{
+	gbIsHellfire = false;
+	const std::string path = GetTmpPathName();
+	std::remove(path.c_str());
+
+	const _uiheroinfo first = MakeHero("Aelith", 12);
+	const _uiheroinfo second = MakeHero("Borin", 40);
+	{
+		HeroIndex index = HeroIndex::Load(path);
+		EXPECT_EQ(index.find("single_0.sv", { 1000, 1 }), nullptr);
+		index.insert("single_0.sv", { 1000, 1 }, first);
+		index.insert("single_1.sv", { 2000, 2 }, second);
+		index.save(path);
+	}
+
+	const HeroIndex index = HeroIndex::Load(path);
+	ExpectSameHero(index.find("single_0.sv", { 1000, 1 }), first);
+	ExpectSameHero(index.find("single_1.sv", { 2000, 2 }), second);
+}
+
+TEST(HeroIndex, ChangedSave)
+{
+	gbIsHellfire = false;
+	HeroIndex index;
+	index.insert("single_0.sv", { 1000, 1 }, MakeHero("Aelith", 12));
+	EXPECT_EQ(index.find("single_0.sv", { 1000, 2 }), nullptr);
+	EXPECT_EQ(index.find("single_0.sv", { 1004, 1 }), nullptr);
+	EXPECT_EQ(index.find("single_1.sv", { 1000, 1 }), nullptr);
+
+	gbIsHellfire = true;
+	EXPECT_EQ(index.find("single_0.sv", { 1000, 1 }), nullptr);
+	gbIsHellfire = false;
+
+	index.erase("single_0.sv");
+	EXPECT_EQ(index.find("single_0.sv", { 1000, 1 }), nullptr);
+}
+
+TEST(HeroIndex, InvalidFile)
+{
+	const std::string path = GetTmpPathName();
+	FILE *file = std::fopen(path.c_str(), "wb");
+	ASSERT_NE(file, nullptr);
+	std::fputs("DXHI garbage", file);
+	std::fclose(file);
+
+	const HeroIndex index = HeroIndex::Load(path);
+	EXPECT_EQ(index.find("single_0.sv", { 1000, 1 }), nullptr);
+}
@@ -1,5 +1,7 @@
 #include <climits>
+#include <cstring>
 #include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -122,5 +124,118 @@ TEST_F(ItemsTest, AllHellfireUniquesCanDrop)
 	GenerateAllUniques(true, 99);
 }
 
+struct RecreateArgs {
+	_item_indexes idx;
+	uint16_t createInfo;
+	uint32_t seed;
+	uint32_t dwBuff;
+};
+
+/** Dungeon drops, town items and potions on the dungeon floor, each with a different seed. */
+std::vector<RecreateArgs> GetRecreateArgs(size_t count)
+{
+	std::vector<_item_indexes> available;
+	for (size_t i = 0; i < AllItemsList.size(); i++) {
+		const auto idx = static_cast<_item_indexes>(i);
+		if (IsItemAvailable(static_cast<int>(i)) && AllItemsList[i].iMiscId != IMISC_UNIQUE && idx != IDI_GOLD)
+			available.push_back(idx);
+	}
+	constexpr uint16_t Sources[] = { 0, CF_USEFUL, CF_ONLYGOOD, CF_UPER15 | CF_ONLYGOOD, CF_SMITH, CF_SMITHPREMIUM, CF_BOY, CF_WITCH, CF_HEALER };
+
+	std::mt19937 rng(42);
+	std::vector<RecreateArgs> args;
+	for (size_t i = 0; i < count; i++) {
+		const uint16_t level = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 60)(rng));
+		const uint16_t source = Sources[std::uniform_int_distribution<size_t>(0, std::size(Sources) - 1)(rng)];
+		_item_indexes idx = available[std::uniform_int_distribution<size_t>(0, available.size() - 1)(rng)];
+		// Adria's and Pepin's potions and scrolls don't depend on their seed and aren't cached.
+		if ((source & CF_WITCH) != 0 && IsAnyOf(idx, IDI_MANA, IDI_FULLMANA, IDI_PORTAL))
+			idx = IDI_OIL;
+		if ((source & CF_HEALER) != 0 && IsAnyOf(idx, IDI_HEAL, IDI_FULLHEAL, IDI_RESURRECT))
+			idx = IDI_OIL;
+		const uint32_t dwBuff = (rng() % 2 == 0) ? CF_HELLFIRE : 0;
+		args.push_back({ idx, static_cast<uint16_t>(level | source), static_cast<uint32_t>(i) * 2654435761U, dwBuff });
+	}
+	return args;
+}
+
+/**
+ * @brief Recreates an item into `item` starting from a fixed random state.
+ * @return The state of the random number generator afterwards.
+ */
+uint32_t Recreate(Item &item, const RecreateArgs &args)
+{
+	SetRndSeed(0x5EED);
+	RecreateItem(*MyPlayer, item, args.idx, args.createInfo, args.seed, 0, args.dwBuff);
+	return GetLCGEngineState();
+}
+
+// Item has padding, so the items are value-initialized, which zeroes it, and compared as bytes.
+TEST_F(ItemsTest, RecreatedItemsAreIdenticalWhenCached)
+{
+	const bool tmpIsHellfire = gbIsHellfire;
+	const std::vector<RecreateArgs> recreateArgs = GetRecreateArgs(2000);
+
+	SetItemRecreationCacheEnabled(true);
+	ClearItemRecreationCache();
+	ResetItemRecreationCacheStats();
+	for (const RecreateArgs &args : recreateArgs) {
+		SetItemRecreationCacheEnabled(false);
+		Item generated {};
+		const uint32_t generatedRngState = Recreate(generated, args);
+
+		SetItemRecreationCacheEnabled(true);
+		Item added {};
+		const uint32_t addedRngState = Recreate(added, args);
+		Item cached {};
+		const uint32_t cachedRngState = Recreate(cached, args);
+
+		const std::string context = StrCat("idx ", static_cast<int>(args.idx), " createInfo ", args.createInfo, " seed ", args.seed, " dwBuff ", args.dwBuff);
+		EXPECT_EQ(std::memcmp(&added, &generated, sizeof(Item)), 0) << context;
+		EXPECT_EQ(std::memcmp(&cached, &generated, sizeof(Item)), 0) << context;
+		EXPECT_EQ(addedRngState, generatedRngState) << context;
+		EXPECT_EQ(cachedRngState, generatedRngState) << context;
+	}
+	const ItemRecreationCacheStats stats = GetItemRecreationCacheStats();
+	EXPECT_EQ(stats.hits, recreateArgs.size());
+	EXPECT_EQ(stats.misses, recreateArgs.size());
+	EXPECT_EQ(gbIsHellfire, tmpIsHellfire);
+}
+
+TEST_F(ItemsTest, RecreatedItemsDependOnGameMode)
+{
+	const RecreateArgs args { IDI_SHORTSTAFF, 20 | CF_ONLYGOOD, 1234, 0 };
+	SetItemRecreationCacheEnabled(true);
+	ClearItemRecreationCache();
+	ResetItemRecreationCacheStats();
+
+	Item singlePlayer {};
+	Recreate(singlePlayer, args);
+	gbIsMultiplayer = true;
+	Item multiplayer {};
+	Recreate(multiplayer, args);
+	gbIsMultiplayer = false;
+
+	const ItemRecreationCacheStats stats = GetItemRecreationCacheStats();
+	EXPECT_EQ(stats.hits, 0U);
+	EXPECT_EQ(stats.misses, 2U);
+}
+
+TEST_F(ItemsTest, TownPotionsAreNotCached)
+{
+	SetItemRecreationCacheEnabled(true);
+	ClearItemRecreationCache();
+	ResetItemRecreationCacheStats();
+
+	Item potion {};
+	Recreate(potion, { IDI_HEAL, 1 | CF_HEALER, 1234, 0 });
+	Recreate(potion, { IDI_HEAL, 1 | CF_HEALER, 1234, 0 });
+	EXPECT_EQ(potion.IDidx, IDI_HEAL);
+
+	const ItemRecreationCacheStats stats = GetItemRecreationCacheStats();
+	EXPECT_EQ(stats.hits, 0U);
+	EXPECT_EQ(stats.misses, 0U);
+}
+
 } // namespace
 } // namespace devilution
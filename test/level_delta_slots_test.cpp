@@ -0,0 +1,162 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "level_delta_slots.hpp"
+
+using namespace devilution;
+
+namespace {
+
+#pragma pack(push, 1)
+struct TestSlot {
+	uint8_t x;
+	int32_t hitPoints;
+
+	bool operator==(const TestSlot &other) const = default;
+};
+#pragma pack(pop)
+
+constexpr size_t NumSlots = 10;
+constexpr TestSlot UnusedSlot { 0xFF, -1 };
+
+using Table = std::array<TestSlot, NumSlots>;
+
+Table MakeTable()
+{
+	Table table;
+	table.fill(UnusedSlot);
+	table[0] = { 1, 100 };
+	table[3] = { 4, 0 };
+	table[9] = { 9, -5 };
+	return table;
+}
+
+std::vector<std::byte> Export(const Table &table)
+{
+	std::vector<std::byte> result(MaxDeltaSlotsSize<TestSlot, NumSlots>);
+	const std::byte *end = ExportDeltaSlots<NumSlots>(result.data(), table.data(), [](const TestSlot &slot) { return slot.x != 0xFF; });
+	result.resize(end - result.data());
+	return result;
+}
+
+/** @brief A record as written by `ExportDeltaSlots`. */
+void AppendSlot(std::vector<std::byte> &data, uint8_t index, const TestSlot &slot)
+{
+	data.push_back(static_cast<std::byte>(index));
+	const auto *bytes = reinterpret_cast<const std::byte *>(&slot);
+	data.insert(data.end(), bytes, bytes + sizeof(slot));
+}
+
+bool IsUnused(const Table &table)
+{
+	for (const TestSlot &slot : table) {
+		if (slot != UnusedSlot)
+			return false;
+	}
+	return true;
+}
+
+TEST(LevelDeltaSlotsTest, RoundTrip)
+{
+	const Table table = MakeTable();
+	const std::vector<std::byte> data = Export(table);
+	EXPECT_EQ(data.size(), 1 + 3 * (1 + sizeof(TestSlot)));
+
+	Table imported;
+	EXPECT_EQ(ImportDeltaSlots<NumSlots>(data.data(), data.data() + data.size(), imported.data()), data.data() + data.size());
+	EXPECT_EQ(imported, table);
+}
+
+TEST(LevelDeltaSlotsTest, RoundTripEmptyTable)
+{
+	Table table;
+	table.fill(UnusedSlot);
+	const std::vector<std::byte> data = Export(table);
+	ASSERT_EQ(data.size(), 1);
+
+	Table imported = MakeTable();
+	EXPECT_EQ(ImportDeltaSlots<NumSlots>(data.data(), data.data() + data.size(), imported.data()), data.data() + data.size());
+	EXPECT_TRUE(IsUnused(imported));
+}
+
+TEST(LevelDeltaSlotsTest, LeavesTheRestOfTheData)
+{
+	std::vector<std::byte> data = Export(MakeTable());
+	const size_t slotsSize = data.size();
+	data.push_back(std::byte { 42 });
+
+	Table imported;
+	EXPECT_EQ(ImportDeltaSlots<NumSlots>(data.data(), data.data() + data.size(), imported.data()), data.data() + slotsSize);
+}
+
+TEST(LevelDeltaSlotsTest, RejectsMissingData)
+{
+	Table imported;
+	EXPECT_EQ(ImportDeltaSlots<NumSlots>(nullptr, nullptr, imported.data()), nullptr);
+	EXPECT_TRUE(IsUnused(imported));
+
+	const std::byte data[1] {};
+	EXPECT_EQ(ImportDeltaSlots<NumSlots>(data, data, imported.data()), nullptr);
+}
+
+TEST(LevelDeltaSlotsTest, RejectsCountPastEnd)
+{
+	const std::vector<std::byte> data = Export(MakeTable());
+	Table imported;
+	for (size_t size = 1; size < data.size(); ++size) {
+		EXPECT_EQ(ImportDeltaSlots<NumSlots>(data.data(), data.data() + size, imported.data()), nullptr) << "Truncated to " << size << " bytes";
+		EXPECT_TRUE(IsUnused(imported));
+	}
+}
+
+TEST(LevelDeltaSlotsTest, RejectsCountAboveNumSlots)
+{
+	std::vector<std::byte> data { static_cast<std::byte>(NumSlots + 1) };
+	for (uint8_t i = 0; i <= NumSlots; ++i)
+		AppendSlot(data, i, { i, 1 });
+
+	Table imported;
+	EXPECT_EQ(ImportDeltaSlots<NumSlots>(data.data(), data.data() + data.size(), imported.data()), nullptr);
+	EXPECT_TRUE(IsUnused(imported));
+}
+
+TEST(LevelDeltaSlotsTest, RejectsOutOfRangeIndex)
+{
+	for (const uint8_t index : { static_cast<uint8_t>(NumSlots), static_cast<uint8_t>(0xFF) }) {
+		std::vector<std::byte> data { std::byte { 2 } };
+		AppendSlot(data, 1, { 1, 1 });
+		AppendSlot(data, index, { 2, 2 });
+
+		Table imported;
+		EXPECT_EQ(ImportDeltaSlots<NumSlots>(data.data(), data.data() + data.size(), imported.data()), nullptr) << "Index " << static_cast<int>(index);
+		EXPECT_TRUE(IsUnused(imported)) << "Index " << static_cast<int>(index);
+	}
+}
+
+TEST(LevelDeltaSlotsTest, RejectsDuplicateSlots)
+{
+	std::vector<std::byte> data { std::byte { 2 } };
+	AppendSlot(data, 3, { 1, 1 });
+	AppendSlot(data, 3, { 2, 2 });
+
+	Table imported;
+	EXPECT_EQ(ImportDeltaSlots<NumSlots>(data.data(), data.data() + data.size(), imported.data()), nullptr);
+	EXPECT_TRUE(IsUnused(imported));
+}
+
+TEST(LevelDeltaSlotsTest, RejectsSlotsOutOfOrder)
+{
+	std::vector<std::byte> data { std::byte { 2 } };
+	AppendSlot(data, 5, { 1, 1 });
+	AppendSlot(data, 2, { 2, 2 });
+
+	Table imported;
+	EXPECT_EQ(ImportDeltaSlots<NumSlots>(data.data(), data.data() + data.size(), imported.data()), nullptr);
+	EXPECT_TRUE(IsUnused(imported));
+}
+
+} // namespace
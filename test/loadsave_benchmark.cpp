@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "engine/assets.hpp"
+#include "game_mode.hpp"
+#include "headless_mode.hpp"
+#include "levels/gendung.h"
+#include "loadsave.h"
+#include "pfile.h"
+#include "player.h"
+#include "tables/itemdat.h"
+#include "tables/misdat.h"
+#include "tables/monstdat.h"
+#include "tables/objdat.h"
+#include "tables/playerdat.hpp"
+#include "tables/spelldat.h"
+#include "utils/log.hpp"
+#include "utils/parallel_for.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace {
+
+/** The fixture only contains one save, the one that `LoadGame` and `LoadLevel` read from by default. */
+constexpr uint32_t SaveNumber = 0;
+
+/** The level files in the fixture save, as `ConvertLevels` finds them. */
+std::vector<std::string> LevelFileNames;
+
+void InitOnce()
+{
+	[[maybe_unused]] static const bool GlobalInitDone = []() {
+		LoadCoreArchives();
+		LoadGameArchives();
+		if (!HaveMainData()) {
+			LogError("This benchmark needs spawn.mpq or diabdat.mpq");
+			exit(1);
+		}
+
+		paths::SetPrefPath(paths::BasePath() + "test/fixtures/timedemo/WarriorLevel1to2/");
+		gbIsSpawn = true;
+		gbIsHellfire = false;
+		gbIsMultiplayer = false;
+		HeadlessMode = true;
+
+		LoadSpellData();
+		LoadPlayerDataFiles();
+		LoadMissileData();
+		LoadMonsterData();
+		LoadItemData();
+		LoadObjectData();
+
+		Players.resize(1);
+		MyPlayerId = 0;
+		MyPlayer = &Players[MyPlayerId];
+		pfile_read_player_from_save(SaveNumber, *MyPlayer);
+
+		// Sets up the current level, so that it can be loaded again on its own.
+		if (!LoadGame(true).has_value()) {
+			LogError("Unable to load the fixture save");
+			exit(1);
+		}
+
+		std::optional<SaveReader> archive = OpenSaveArchive(SaveNumber);
+		const auto addLevelFile = [&](char kind, int num) {
+			for (const char *prefix : { "temp", "perm" }) {
+				std::string name = StrCat(prefix, kind, LeftPad(num, 2, '0'));
+				if (archive->HasFile(name.c_str())) {
+					LevelFileNames.push_back(std::move(name));
+					return;
+				}
+			}
+		};
+		for (int i = 0; i < giNumberOfLevels; i++)
+			addLevelFile('l', i);
+		for (int i = SL_SKELKING; i <= SL_LAST; i++)
+			addLevelFile('s', i);
+		return true;
+	}();
+}
+
+void BM_LoadHero(benchmark::State &state)
+{
+	InitOnce();
+	Player player;
+	for (auto _ : state) {
+		pfile_read_player_from_save(SaveNumber, player);
+		benchmark::DoNotOptimize(player);
+	}
+}
+
+void BM_LoadLevel(benchmark::State &state)
+{
+	InitOnce();
+	for (auto _ : state) {
+		if (!LoadLevel().has_value()) {
+			state.SkipWithError("Unable to load the level");
+			break;
+		}
+	}
+	state.SetLabel(StrCat("level ", currlevel));
+}
+
+/** @brief Reads all the level files of the save from one archive, as `ConvertLevels` used to. */
+void BM_ReadLevelFiles(benchmark::State &state)
+{
+	InitOnce();
+	std::optional<SaveReader> archive = OpenSaveArchive(SaveNumber);
+	for (auto _ : state) {
+		for (const std::string &name : LevelFileNames) {
+			size_t size;
+			std::unique_ptr<std::byte[]> data = ReadLevelFile(*archive, name.c_str(), &size);
+			benchmark::DoNotOptimize(data.get());
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * LevelFileNames.size());
+}
+
+/** @brief Reads all the level files of the save in batches, each level of a batch from its own archive, as `ConvertLevels` does. */
+void BM_ReadLevelFilesParallel(benchmark::State &state)
+{
+	InitOnce();
+	const size_t batchSize = std::min(GetParallelWorkerCount(), LevelFileNames.size());
+	std::vector<SaveReader> archives;
+	archives.reserve(batchSize);
+	archives.push_back(*OpenSaveArchive(SaveNumber));
+	for (size_t i = 1; i < batchSize; ++i)
+		archives.push_back(*OpenSaveArchiveWithoutWaiting(SaveNumber));
+	std::vector<std::unique_ptr<std::byte[]>> data(batchSize);
+	for (auto _ : state) {
+		for (size_t batchBegin = 0; batchBegin < LevelFileNames.size(); batchBegin += batchSize) {
+			const std::span<const std::string> batch { &LevelFileNames[batchBegin], std::min(batchSize, LevelFileNames.size() - batchBegin) };
+			ParallelFor(batch.size(), [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					size_t size;
+					data[i] = ReadLevelFile(archives[i], batch[i].c_str(), &size);
+				}
+			});
+			benchmark::DoNotOptimize(data.data());
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * LevelFileNames.size());
+	state.SetLabel(StrCat(batchSize, " archives"));
+}
+
+BENCHMARK(BM_LoadHero);
+BENCHMARK(BM_LoadLevel);
+BENCHMARK(BM_ReadLevelFiles);
+BENCHMARK(BM_ReadLevelFilesParallel);
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "monsters/sync_priority.hpp"
+
+namespace devilution {
+namespace {
+
+constexpr size_t NumPlayers = 4;
+constexpr size_t NumMonsters = 200;
+constexpr int MapSize = 96;
+/** Monsters this close to a player fight it, the others stand still. */
+constexpr int FightDistance = 8;
+constexpr int NumTicks = 1200;
+
+struct SimMonster {
+	int x;
+	int y;
+	uint8_t mode;
+	int32_t hitPoints;
+	bool active;
+};
+
+struct SimPlayer {
+	int x;
+	int y;
+};
+
+int Distance(const SimPlayer &player, const SimMonster &monster)
+{
+	return std::abs(player.x - monster.x) + std::abs(player.y - monster.y);
+}
+
+/** @brief The rotation that sync_all_monsters used before `MonsterSyncScheduler`. */
+class LegacyScheduler {
+public:
+	explicit LegacyScheduler(size_t playerId)
+	    : next_(16 * playerId)
+	{
+		lru_.fill(0xFFFF);
+	}
+
+	size_t Schedule(std::span<const MonsterSyncState> monsters, std::span<const uint32_t> distances, std::span<uint8_t> selected)
+	{
+		for (size_t i = 0; i < monsters.size(); i++) {
+			const uint8_t m = monsters[i].monsterId;
+			priority_[m] = distances[i];
+			if (!monsters[i].active)
+				priority_[m] += 0x1000;
+			else if (lru_[m] != 0)
+				lru_[m]--;
+		}
+
+		size_t count = 0;
+		for (; count < selected.size() && count < monsters.size(); count++) {
+			size_t pick = monsters.size();
+			if (count < 2) {
+				uint32_t lru = 0xFFFE;
+				for (size_t i = 0; i < monsters.size(); i++) {
+					if (next_ >= monsters.size())
+						next_ = 0;
+					if (lru_[monsters[next_].monsterId] < lru) {
+						lru = lru_[monsters[next_].monsterId];
+						pick = next_;
+					}
+					next_++;
+				}
+			}
+			if (pick == monsters.size()) {
+				uint32_t best = 0xFFFFFFFF;
+				for (size_t i = 0; i < monsters.size(); i++) {
+					const uint8_t m = monsters[i].monsterId;
+					if (priority_[m] < best && lru_[m] < 0xFFFE) {
+						best = priority_[m];
+						pick = i;
+					}
+				}
+			}
+			if (pick == monsters.size())
+				break;
+			const uint8_t m = monsters[pick].monsterId;
+			selected[count] = m;
+			priority_[m] = 0xFFFF;
+			lru_[m] = monsters[pick].active ? 0xFFFE : 0xFFFF;
+		}
+		return count;
+	}
+
+private:
+	std::array<uint32_t, MonsterSyncScheduler::MaxMonsterId> priority_ {};
+	std::array<uint16_t, MonsterSyncScheduler::MaxMonsterId> lru_ {};
+	size_t next_;
+};
+
+/**
+ * @brief Plays a fight of four players against a level full of monsters and measures how up to date
+ * each player's view of the fighting monsters is.
+ *
+ * Every player sends the monsters it is the closest player to, like the game: the other players drop
+ * syncs from players that are further away from the monster than they are. The argument is the number
+ * of monster syncs that fit into each packet after the other messages of the tick.
+ */
+template <bool Legacy>
+void BM_MonsterSync(benchmark::State &state)
+{
+	size_t staleViews = 0;
+	size_t views = 0;
+	int maxStaleTicks = 0;
+
+	for (auto _ : state) {
+		std::mt19937 rng(1);
+		std::vector<SimMonster> monsters(NumMonsters);
+		for (SimMonster &monster : monsters)
+			monster = { static_cast<int>(rng() % MapSize), static_cast<int>(rng() % MapSize), 0, 1000, false };
+		std::array<SimPlayer, NumPlayers> players {};
+		for (size_t p = 0; p < NumPlayers; p++)
+			players[p] = { 20 + static_cast<int>(p) * 16, 48 };
+
+		std::vector<MonsterSyncScheduler> schedulers(NumPlayers);
+		std::vector<LegacyScheduler> legacySchedulers;
+		for (size_t p = 0; p < NumPlayers; p++) {
+			schedulers[p].Reset();
+			legacySchedulers.emplace_back(p);
+		}
+		// What each player knows of each monster, and since when it is out of date.
+		std::vector<std::array<SimMonster, NumMonsters>> known(NumPlayers);
+		std::vector<std::array<int, NumMonsters>> staleSince(NumPlayers);
+		for (size_t p = 0; p < NumPlayers; p++) {
+			std::copy(monsters.begin(), monsters.end(), known[p].begin());
+			staleSince[p].fill(-1);
+		}
+
+		std::vector<MonsterSyncState> syncStates(NumMonsters);
+		std::vector<uint32_t> distances(NumMonsters);
+		std::vector<uint8_t> selected(static_cast<size_t>(state.range(0)));
+		for (int tick = 0; tick < NumTicks; tick++) {
+			// The players slowly cross the level, the monsters next to them fight.
+			if (tick % 20 == 0) {
+				for (SimPlayer &player : players)
+					player.y = (player.y + 1) % MapSize;
+			}
+			for (SimMonster &monster : monsters) {
+				bool fighting = false;
+				for (const SimPlayer &player : players)
+					fighting = fighting || Distance(player, monster) <= FightDistance;
+				monster.active = monster.active || fighting;
+				if (!fighting || monster.hitPoints <= 0)
+					continue;
+				if (rng() % 4 == 0)
+					monster.hitPoints -= static_cast<int32_t>(rng() % 20);
+				if (rng() % 6 == 0)
+					monster.mode = static_cast<uint8_t>(rng() % 8);
+				if (rng() % 8 == 0)
+					monster.x = std::clamp(monster.x + static_cast<int>(rng() % 3) - 1, 0, MapSize - 1);
+			}
+
+			for (size_t p = 0; p < NumPlayers; p++) {
+				for (size_t m = 0; m < NumMonsters; m++) {
+					const SimMonster &monster = monsters[m];
+					const auto distance = static_cast<uint32_t>(Distance(players[p], monster));
+					uint32_t viewerDistance = MonsterSyncState::NoViewer;
+					for (size_t other = 0; other < NumPlayers; other++) {
+						const auto otherDistance = static_cast<uint32_t>(Distance(players[other], monster));
+						if (other != p && otherDistance >= distance)
+							viewerDistance = std::min(viewerDistance, otherDistance);
+					}
+					distances[m] = distance;
+					syncStates[m] = MonsterSyncState {
+						.monsterId = static_cast<uint8_t>(m),
+						.x = static_cast<uint8_t>(monster.x),
+						.y = static_cast<uint8_t>(monster.y),
+						.mode = monster.mode,
+						.hitPoints = monster.hitPoints,
+						.active = monster.active,
+						.viewerDistance = viewerDistance,
+					};
+				}
+				size_t count;
+				if constexpr (Legacy)
+					count = legacySchedulers[p].Schedule(syncStates, distances, selected);
+				else
+					count = schedulers[p].Schedule(syncStates, selected);
+
+				for (size_t i = 0; i < count; i++) {
+					const uint8_t m = selected[i];
+					for (size_t other = 0; other < NumPlayers; other++) {
+						if (other != p && static_cast<uint32_t>(Distance(players[other], monsters[m])) >= distances[m])
+							known[other][m] = monsters[m];
+					}
+				}
+			}
+
+			for (size_t p = 0; p < NumPlayers; p++) {
+				for (size_t m = 0; m < NumMonsters; m++) {
+					const SimMonster &monster = monsters[m];
+					const int distance = Distance(players[p], monster);
+					if (!monster.active || distance > static_cast<int>(MonsterSyncScheduler::ViewDistance))
+						continue;
+					// The closest player is the one that corrects the others, its own view is never synced.
+					bool hasCloserPlayer = false;
+					for (size_t other = 0; other < NumPlayers; other++)
+						hasCloserPlayer = hasCloserPlayer || (other != p && Distance(players[other], monster) <= distance);
+					if (!hasCloserPlayer)
+						continue;
+					const SimMonster &view = known[p][m];
+					const bool stale = view.x != monster.x || view.y != monster.y || view.mode != monster.mode || view.hitPoints != monster.hitPoints;
+					views++;
+					if (!stale) {
+						staleSince[p][m] = -1;
+						continue;
+					}
+					staleViews++;
+					if (staleSince[p][m] < 0)
+						staleSince[p][m] = tick;
+					maxStaleTicks = std::max(maxStaleTicks, tick - staleSince[p][m]);
+				}
+			}
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * NumTicks * NumPlayers);
+	state.counters["stale_view_ratio"] = static_cast<double>(staleViews) / static_cast<double>(views);
+	state.counters["max_stale_ticks"] = maxStaleTicks;
+}
+
+BENCHMARK(BM_MonsterSync<true>)->Name("BM_MonsterSync/legacy")->Arg(8)->Arg(4)->Arg(2)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MonsterSync<false>)->Name("BM_MonsterSync/priority")->Arg(8)->Arg(4)->Arg(2)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,118 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "monsters/sync_priority.hpp"
+
+using namespace devilution;
+
+namespace {
+
+MonsterSyncState MakeMonster(uint8_t id)
+{
+	return MonsterSyncState {
+		.monsterId = id,
+		.x = static_cast<uint8_t>(10 + id),
+		.y = 10,
+		.mode = 0,
+		.hitPoints = 100,
+		.active = true,
+		.viewerDistance = MonsterSyncState::NoViewer,
+	};
+}
+
+std::vector<uint8_t> Schedule(MonsterSyncScheduler &scheduler, const std::vector<MonsterSyncState> &monsters, size_t capacity)
+{
+	std::vector<uint8_t> selected(capacity);
+	selected.resize(scheduler.Schedule(monsters, selected));
+	return selected;
+}
+
+TEST(MonsterSyncPriorityTest, FillsThePacket)
+{
+	MonsterSyncScheduler scheduler;
+	scheduler.Reset();
+	const std::vector<MonsterSyncState> monsters { MakeMonster(0), MakeMonster(1), MakeMonster(2) };
+	EXPECT_EQ(Schedule(scheduler, monsters, 2).size(), 2U);
+	EXPECT_EQ(Schedule(scheduler, monsters, 5).size(), 3U);
+}
+
+TEST(MonsterSyncPriorityTest, UnchangedMonstersWait)
+{
+	MonsterSyncScheduler scheduler;
+	scheduler.Reset();
+	std::vector<MonsterSyncState> monsters { MakeMonster(0), MakeMonster(1) };
+	monsters[0].viewerDistance = 0;
+	Schedule(scheduler, monsters, 1);
+	Schedule(scheduler, monsters, 1);
+	// The other players generated the same monsters, so an unchanged monster is only sent to refresh it.
+	EXPECT_LT(scheduler.Score(monsters[0]), MonsterSyncScheduler::AgeWeight);
+	monsters[1].hitPoints--;
+	EXPECT_EQ(Schedule(scheduler, monsters, 1), std::vector<uint8_t> { 1 });
+}
+
+TEST(MonsterSyncPriorityTest, ChangedMonstersGoFirst)
+{
+	MonsterSyncScheduler scheduler;
+	scheduler.Reset();
+	std::vector<MonsterSyncState> monsters { MakeMonster(0), MakeMonster(1), MakeMonster(2) };
+	Schedule(scheduler, monsters, 3);
+
+	monsters[2].hitPoints -= 10;
+	EXPECT_EQ(Schedule(scheduler, monsters, 1), std::vector<uint8_t> { 2 });
+	Schedule(scheduler, monsters, 3);
+
+	monsters[1].mode = 4;
+	EXPECT_EQ(Schedule(scheduler, monsters, 1), std::vector<uint8_t> { 1 });
+	Schedule(scheduler, monsters, 3);
+
+	monsters[0].x++;
+	EXPECT_EQ(Schedule(scheduler, monsters, 1), std::vector<uint8_t> { 0 });
+}
+
+TEST(MonsterSyncPriorityTest, MonstersCloseToOtherPlayersGoFirst)
+{
+	MonsterSyncScheduler scheduler;
+	scheduler.Reset();
+	std::vector<MonsterSyncState> monsters { MakeMonster(0), MakeMonster(1), MakeMonster(2) };
+	monsters[0].viewerDistance = 20;
+	monsters[1].viewerDistance = 3;
+	Schedule(scheduler, monsters, 3);
+	for (MonsterSyncState &monster : monsters)
+		monster.hitPoints -= 10;
+	EXPECT_EQ(Schedule(scheduler, monsters, 2), (std::vector<uint8_t> { 1, 0 }));
+	Schedule(scheduler, monsters, 3);
+
+	// Idle monsters don't change on their own, so being close to another player doesn't make them more important.
+	for (MonsterSyncState &monster : monsters)
+		monster.hitPoints -= 10;
+	monsters[1].active = false;
+	EXPECT_EQ(Schedule(scheduler, monsters, 1), std::vector<uint8_t> { 0 });
+}
+
+TEST(MonsterSyncPriorityTest, EveryMonsterIsSentEventually)
+{
+	MonsterSyncScheduler scheduler;
+	scheduler.Reset();
+	std::vector<MonsterSyncState> monsters;
+	for (uint8_t id = 0; id < 8; id++)
+		monsters.push_back(MakeMonster(id));
+	monsters[0].viewerDistance = 0;
+	Schedule(scheduler, monsters, monsters.size());
+
+	// Monster 0 keeps changing right next to another player, it still has to leave room for the others.
+	std::set<uint8_t> sent;
+	for (int i = 0; i < 100; i++) {
+		for (MonsterSyncState &monster : monsters)
+			monster.hitPoints--;
+		for (const uint8_t id : Schedule(scheduler, monsters, 1))
+			sent.insert(id);
+	}
+	EXPECT_EQ(sent.size(), monsters.size());
+}
+
+} // namespace
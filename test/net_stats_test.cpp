@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dvlnet/abstract_net.h"
+#include "dvlnet/net_stats.hpp"
+#include "dvlnet/protocol_sim.h"
+#include "player.h"
+#include "sim_game.hpp"
+
+namespace devilution {
+namespace net {
+namespace {
+
+TEST(NetStatsTest, RegularTurnsHaveNoJitter)
+{
+	PeerNetStats peer;
+	for (uint32_t i = 0; i < 20; ++i)
+		peer.AddTurnArrival(1000 + 50 * i);
+	EXPECT_EQ(peer.turnsReceived.count, 20U);
+	EXPECT_EQ(peer.turnJitterMs, 0);
+}
+
+TEST(NetStatsTest, UnevenTurnsHaveJitter)
+{
+	PeerNetStats peer;
+	uint32_t now = 1000;
+	for (uint32_t i = 0; i < 100; ++i) {
+		now += i % 2 == 0 ? 30 : 70;
+		peer.AddTurnArrival(now);
+	}
+	// Each interval is 40 ms off from the one before, the estimate approaches that.
+	EXPECT_GT(peer.turnJitterMs, 35);
+	EXPECT_LE(peer.turnJitterMs, 40);
+}
+
+TEST(NetStatsTest, CsvHasARowPerCommand)
+{
+	NetStats stats;
+	stats.peers[1].messagesSent.Add(100);
+	stats.peers[1].commands[3].sent.Add(40);
+	stats.peers[1].commands[3].received.Add(10);
+	stats.crypto.Add(2000);
+
+	const std::string csv = FormatNetStatsCsv(stats, [](uint8_t cmd) {
+		return cmd == 3 ? std::string_view("CMD_TEST") : std::string_view();
+	});
+	EXPECT_TRUE(csv.starts_with("player,metric,command,value\n"));
+	EXPECT_NE(csv.find(",crypto_us,,2\n"), std::string::npos);
+	EXPECT_NE(csv.find("1,message_bytes_sent,,100\n"), std::string::npos);
+	EXPECT_NE(csv.find("1,command_bytes_sent,CMD_TEST,40\n"), std::string::npos);
+	EXPECT_NE(csv.find("1,command_bytes_received,CMD_TEST,10\n"), std::string::npos);
+	// Players without any traffic are left out.
+	EXPECT_EQ(csv.find("\n2,"), std::string::npos);
+}
+
+class NetStatsSimTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		Players.resize(MAX_PLRS);
+	}
+};
+
+TEST_F(NetStatsSimTest, CountsTrafficPerPlayer)
+{
+	sim_network network(1);
+	const std::vector<abstract_net *> peers = StartSimGame(network, 3);
+
+	unsigned char message[] = { 7, 1, 2, 3 };
+	ASSERT_TRUE(peers[0]->SNetSendMessage(SNPLAYER_OTHERS, message, sizeof(message)));
+	peers[0]->record_command(SNPLAYER_OTHERS, /*sent=*/true, message[0], sizeof(message));
+	peers[0]->record_command(/*playerid=*/0, /*sent=*/true, message[0], sizeof(message));
+	network.Advance(10);
+	peers[1]->process_network_packets();
+
+	const NetStats sender = peers[0]->get_stats();
+	EXPECT_FALSE(sender.peers[0].isConnected);
+	for (uint8_t i = 1; i < 3; ++i) {
+		EXPECT_TRUE(sender.peers[i].isConnected);
+		EXPECT_EQ(sender.peers[i].messagesSent.bytes, sizeof(message));
+		EXPECT_EQ(sender.peers[i].commands[7].sent.count, 1U);
+	}
+	// Messages to oneself don't go over the network.
+	EXPECT_EQ(sender.peers[0].commands[7].sent.count, 0U);
+
+	const NetStats receiver = peers[1]->get_stats();
+	EXPECT_EQ(receiver.peers[0].messagesReceived.bytes, sizeof(message));
+	EXPECT_EQ(receiver.messageQueueDepth, 1U);
+	EXPECT_EQ(receiver.maxMessageQueueDepth, 1U);
+}
+
+} // namespace
+} // namespace net
+} // namespace devilution
@@ -0,0 +1,107 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <memory>
+#include <span>
+
+#include <benchmark/benchmark.h>
+
+#include "dvlnet/packet.h"
+#include "utils/str_cat.hpp"
+
+namespace {
+
+size_t NumAllocations;
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+	++NumAllocations;
+	void *ptr = std::malloc(size);
+	if (ptr == nullptr)
+		std::abort();
+	return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t /*size*/) noexcept
+{
+	std::free(ptr);
+}
+
+namespace devilution {
+namespace net {
+namespace {
+
+/** @brief A factory that encrypts its packets, or one that doesn't if `encrypted` is false. */
+std::unique_ptr<packet_factory> MakeFactory(benchmark::State &state, bool encrypted)
+{
+#ifndef PACKET_ENCRYPTION
+	if (encrypted) {
+		state.SkipWithError("Built without PACKET_ENCRYPTION");
+		return nullptr;
+	}
+#endif
+	if (encrypted)
+		return std::make_unique<packet_factory>("password");
+	return std::make_unique<packet_factory>();
+}
+
+void SetCounters(benchmark::State &state, size_t allocations, size_t packetSize)
+{
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(packetSize));
+	state.counters["allocs_per_packet"] = static_cast<double>(allocations) / static_cast<double>(state.iterations());
+	state.SetLabel(StrCat(state.range(0) != 0 ? "encrypted" : "plain", ", ", state.range(1), " byte messages"));
+}
+
+/** @brief Creating a message packet ready to be sent, state.range(0) is whether it is encrypted and state.range(1) the message size. */
+void BM_EncodeMessage(benchmark::State &state)
+{
+	std::unique_ptr<packet_factory> pktfty = MakeFactory(state, state.range(0) != 0);
+	if (pktfty == nullptr)
+		return;
+	const buffer_t message(static_cast<size_t>(state.range(1)));
+	size_t packetSize = 0;
+	const size_t allocationsBefore = NumAllocations;
+	for (auto _ : state) {
+		std::expected<std::unique_ptr<packet>, PacketError> pkt
+		    = pktfty->make_packet<PT_MESSAGE>(plr_t { 0 }, PLR_BROADCAST, std::span<const unsigned char>(message));
+		packetSize = (*pkt)->Data().size();
+		benchmark::DoNotOptimize((*pkt)->Data().data());
+	}
+	SetCounters(state, NumAllocations - allocationsBefore, packetSize);
+}
+
+/** @brief Reading the message of a received packet, state.range(0) is whether it is encrypted and state.range(1) the message size. */
+void BM_DecodeMessage(benchmark::State &state)
+{
+	std::unique_ptr<packet_factory> pktfty = MakeFactory(state, state.range(0) != 0);
+	if (pktfty == nullptr)
+		return;
+	const buffer_t message(static_cast<size_t>(state.range(1)));
+	const buffer_t received = (*pktfty->make_packet<PT_MESSAGE>(plr_t { 0 }, PLR_BROADCAST, std::span<const unsigned char>(message)))->Data();
+	const size_t allocationsBefore = NumAllocations;
+	for (auto _ : state) {
+		std::expected<std::unique_ptr<packet>, PacketError> pkt = pktfty->make_packet(std::span<const unsigned char>(received));
+		if (!pkt.has_value()) {
+			state.SkipWithError("Failed to decode the packet");
+			return;
+		}
+		benchmark::DoNotOptimize((*pkt)->Message()->data());
+	}
+	SetCounters(state, NumAllocations - allocationsBefore, received.size());
+}
+
+BENCHMARK(BM_EncodeMessage)->ArgsProduct({ { 0, 1 }, { 16, 512, 4096 } });
+BENCHMARK(BM_DecodeMessage)->ArgsProduct({ { 0, 1 }, { 16, 512, 4096 } });
+
+} // namespace
+} // namespace net
+} // namespace devilution
@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+
+#include <gtest/gtest.h>
+
+#include "dvlnet/packet.h"
+
+using namespace devilution;
+using namespace devilution::net;
+
+namespace {
+
+buffer_t MakeMessage(size_t size)
+{
+	buffer_t message(size);
+	for (size_t i = 0; i < size; ++i)
+		message[i] = static_cast<unsigned char>(i * 7);
+	return message;
+}
+
+void ExpectMessageRoundTrip(packet_factory &sender, packet_factory &receiver)
+{
+	const buffer_t message = MakeMessage(300);
+	std::expected<std::unique_ptr<packet>, PacketError> sent
+	    = sender.make_packet<PT_MESSAGE>(plr_t { 1 }, PLR_BROADCAST, std::span<const unsigned char>(message));
+	ASSERT_TRUE(sent.has_value());
+	const buffer_t data = (*sent)->Data();
+
+	std::expected<std::unique_ptr<packet>, PacketError> received = receiver.make_packet(std::span<const unsigned char>(data));
+	ASSERT_TRUE(received.has_value());
+	packet &pkt = **received;
+	EXPECT_EQ(pkt.Type(), PT_MESSAGE);
+	EXPECT_EQ(pkt.Source(), 1);
+	EXPECT_EQ(pkt.Destination(), PLR_BROADCAST);
+	std::expected<std::span<const unsigned char>, PacketError> receivedMessage = pkt.Message();
+	ASSERT_TRUE(receivedMessage.has_value());
+	EXPECT_EQ(buffer_t(receivedMessage->begin(), receivedMessage->end()), message);
+
+	// Forwarding a received packet sends the same data that was received.
+	EXPECT_EQ(pkt.Data(), data);
+	std::expected<std::span<const unsigned char>, PacketError> messageAfterForwarding = pkt.Message();
+	ASSERT_TRUE(messageAfterForwarding.has_value());
+	EXPECT_EQ(buffer_t(messageAfterForwarding->begin(), messageAfterForwarding->end()), message);
+}
+
+TEST(PacketTest, MessageRoundTrip)
+{
+	packet_factory sender;
+	packet_factory receiver;
+	ExpectMessageRoundTrip(sender, receiver);
+}
+
+TEST(PacketTest, TurnRoundTrip)
+{
+	packet_factory pktfty;
+	std::expected<std::unique_ptr<packet>, PacketError> sent
+	    = pktfty.make_packet<PT_TURN>(plr_t { 2 }, plr_t { 3 }, turn_t { 5, -123456 });
+	ASSERT_TRUE(sent.has_value());
+
+	std::expected<std::unique_ptr<packet>, PacketError> received = pktfty.make_packet(std::span<const unsigned char>((*sent)->Data()));
+	ASSERT_TRUE(received.has_value());
+	std::expected<turn_t, PacketError> turn = (*received)->Turn();
+	ASSERT_TRUE(turn.has_value());
+	EXPECT_EQ(turn->SequenceNumber, 5);
+	EXPECT_EQ(turn->Value, -123456);
+}
+
+TEST(PacketTest, TruncatedPacketIsRejected)
+{
+	packet_factory pktfty;
+	const buffer_t data = { PT_TURN, 0, 1, 5 };
+	EXPECT_FALSE(pktfty.make_packet(std::span<const unsigned char>(data)).has_value());
+}
+
+#ifdef PACKET_ENCRYPTION
+TEST(PacketTest, EncryptedMessageRoundTrip)
+{
+	packet_factory sender("password");
+	packet_factory receiver("password");
+	ExpectMessageRoundTrip(sender, receiver);
+}
+
+TEST(PacketTest, EncryptedPacketWithWrongPasswordIsRejected)
+{
+	packet_factory sender("password");
+	packet_factory receiver("other password");
+	const buffer_t message = MakeMessage(16);
+	std::expected<std::unique_ptr<packet>, PacketError> sent
+	    = sender.make_packet<PT_MESSAGE>(plr_t { 1 }, PLR_BROADCAST, std::span<const unsigned char>(message));
+	ASSERT_TRUE(sent.has_value());
+
+	std::expected<std::unique_ptr<packet>, PacketError> received = receiver.make_packet(std::span<const unsigned char>((*sent)->Data()));
+	ASSERT_FALSE(received.has_value());
+	EXPECT_EQ(received.error().code(), PacketError::ErrorCode::DecryptionFailed);
+}
+#endif
+
+} // namespace
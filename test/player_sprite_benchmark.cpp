@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "engine/assets.hpp"
+#include "engine/clx_sprite.hpp"
+#include "engine/load_file.hpp"
+#include "engine/render/clx_render.hpp"
+#include "player.h"
+#include "tables/playerdat.hpp"
+#include "utils/cl2_to_clx.hpp"
+#include "utils/log.hpp"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace {
+
+struct Cl2File {
+	std::unique_ptr<uint8_t[]> data;
+	size_t size;
+	uint16_t width;
+};
+
+/** Every player animation, for every class, armor and weapon, as `LoadPlrGFX` loads them. */
+std::vector<Cl2File> Sprites;
+size_t TotalSize;
+/** Stand-ins for the graphic TRN and the class TRN. */
+std::array<uint8_t, 256> GraphicTrn;
+std::array<uint8_t, 256> ClassTrn;
+/** `GraphicTrn` followed by `ClassTrn`, as `GetPlayerSpriteTRN` composes them. */
+std::array<uint8_t, 256> ComposedTrn;
+
+/** @brief Same as `GetPlayerSpriteWidth`, by animation file suffix. */
+uint16_t GetSpriteWidth(const PlayerSpriteData &spriteData, std::string_view type, char weapon)
+{
+	if (type == "st" || type == "as")
+		return spriteData.stand;
+	if (type == "wl" || type == "aw")
+		return spriteData.walk;
+	if (type == "at")
+		return weapon == 'b' ? spriteData.bow : spriteData.attack;
+	if (type == "ht")
+		return spriteData.swHit;
+	if (type == "bl")
+		return spriteData.block;
+	if (type == "lm")
+		return spriteData.lightning;
+	if (type == "fm")
+		return spriteData.fire;
+	if (type == "qm")
+		return spriteData.magic;
+	return spriteData.death;
+}
+
+void InitOnce()
+{
+	[[maybe_unused]] static const bool GlobalInitDone = []() {
+		LoadCoreArchives();
+		LoadGameArchives();
+		if (!HaveMainData()) {
+			LogError("This benchmark needs spawn.mpq or diabdat.mpq");
+			exit(1);
+		}
+		LoadPlayerDataFiles();
+
+		for (size_t cls = 0; cls < GetNumPlayerClasses(); ++cls) {
+			const PlayerSpriteData &spriteData = GetPlayerSpriteDataForClass(static_cast<HeroClass>(cls));
+			for (const char armor : ArmourChar) {
+				for (const char weapon : WepChar) {
+					for (const std::string_view type : { "st", "wl", "as", "aw", "at", "ht", "bl", "lm", "fm", "qm", "dt" }) {
+						// Only one Death animation exists, for unarmed characters.
+						if (type == "dt" && weapon != 'n')
+							continue;
+						const std::string prefix = StrCat(spriteData.classChar, armor, weapon);
+						const std::string path = StrCat("plrgfx\\", spriteData.classPath, "\\", prefix, "\\", prefix, type, ".cl2");
+						size_t size;
+						std::expected<std::unique_ptr<uint8_t[]>, std::string> data = LoadFileInMemWithStatus<uint8_t>(path.c_str(), &size);
+						if (!data.has_value())
+							continue; // Not every combination is present, e.g. in spawn.mpq or for classes without their own assets.
+						TotalSize += size;
+						Sprites.push_back(Cl2File { std::move(*data), size, GetSpriteWidth(spriteData, type, weapon) });
+					}
+				}
+			}
+		}
+		LogInfo("{} player sprites, {} bytes", Sprites.size(), TotalSize);
+
+		std::iota(GraphicTrn.begin(), GraphicTrn.end(), uint8_t { 0 });
+		std::reverse(GraphicTrn.begin() + 0x80, GraphicTrn.begin() + 0x90);
+		std::iota(ClassTrn.begin(), ClassTrn.end(), uint8_t { 0 });
+		std::rotate(ClassTrn.begin() + 0xA0, ClassTrn.begin() + 0xA8, ClassTrn.begin() + 0xB0);
+		for (size_t i = 0; i < ComposedTrn.size(); ++i)
+			ComposedTrn[i] = ClassTrn[GraphicTrn[i]];
+		return true;
+	}();
+}
+
+void SetCounters(benchmark::State &state)
+{
+	state.SetBytesProcessed(state.iterations() * TotalSize);
+	state.SetItemsProcessed(state.iterations() * Sprites.size());
+}
+
+void ApplyTrn(std::vector<uint8_t> &clxData, uint16_t numLists, const uint8_t *trn)
+{
+	if (numLists == 0)
+		ClxApplyTrans(ClxSpriteList { clxData.data() }, trn);
+	else
+		ClxApplyTrans(ClxSpriteSheet { clxData.data(), numLists }, trn);
+}
+
+void BM_Cl2ToClx(benchmark::State &state)
+{
+	InitOnce();
+	std::vector<uint8_t> clxData;
+	for (auto _ : state) {
+		for (const Cl2File &sprite : Sprites) {
+			clxData.clear();
+			Cl2ToClx(sprite.data.get(), sprite.size, sprite.width, clxData);
+			benchmark::DoNotOptimize(clxData.data());
+		}
+	}
+	SetCounters(state);
+}
+
+void BM_Cl2ToClxParallel(benchmark::State &state)
+{
+	InitOnce();
+	std::vector<uint8_t> clxData;
+	for (auto _ : state) {
+		for (const Cl2File &sprite : Sprites) {
+			clxData.clear();
+			Cl2ToClxParallel(sprite.data.get(), sprite.size, sprite.width, /*trn=*/nullptr, clxData);
+			benchmark::DoNotOptimize(clxData.data());
+		}
+	}
+	SetCounters(state);
+}
+
+/** @brief How player sprites with a graphic and a class TRN used to be loaded: a serial conversion and a pass for each TRN. */
+void BM_Cl2ToClxThenTwoTrns(benchmark::State &state)
+{
+	InitOnce();
+	std::vector<uint8_t> clxData;
+	for (auto _ : state) {
+		for (const Cl2File &sprite : Sprites) {
+			clxData.clear();
+			const uint16_t numLists = Cl2ToClx(sprite.data.get(), sprite.size, sprite.width, clxData);
+			ApplyTrn(clxData, numLists, GraphicTrn.data());
+			ApplyTrn(clxData, numLists, ClassTrn.data());
+			benchmark::DoNotOptimize(clxData.data());
+		}
+	}
+	SetCounters(state);
+}
+
+/** @brief The same sprites as `BM_Cl2ToClxThenTwoTrns`, with the composed TRN applied during a parallel conversion. */
+void BM_Cl2ToClxParallelWithComposedTrn(benchmark::State &state)
+{
+	InitOnce();
+	std::vector<uint8_t> clxData;
+	for (auto _ : state) {
+		for (const Cl2File &sprite : Sprites) {
+			clxData.clear();
+			Cl2ToClxParallel(sprite.data.get(), sprite.size, sprite.width, ComposedTrn.data(), clxData);
+			benchmark::DoNotOptimize(clxData.data());
+		}
+	}
+	SetCounters(state);
+}
+
+BENCHMARK(BM_Cl2ToClx);
+BENCHMARK(BM_Cl2ToClxParallel);
+BENCHMARK(BM_Cl2ToClxThenTwoTrns);
+BENCHMARK(BM_Cl2ToClxParallelWithComposedTrn);
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,161 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dvlnet/abstract_net.h"
+#include "dvlnet/protocol_sim.h"
+#include "player.h"
+#include "sim_game.hpp"
+
+namespace devilution {
+namespace net {
+namespace {
+
+void SendIndex(abstract_net &peer, uint8_t dest, uint32_t index)
+{
+	ASSERT_TRUE(peer.SNetSendMessage(dest, &index, sizeof(index)));
+}
+
+std::optional<uint32_t> ReceiveIndex(abstract_net &peer)
+{
+	uint8_t sender;
+	void *data;
+	size_t size;
+	if (!peer.SNetReceiveMessage(&sender, &data, &size) || size != sizeof(uint32_t))
+		return std::nullopt;
+	uint32_t index;
+	std::memcpy(&index, data, sizeof(index));
+	return index;
+}
+
+/** @brief Sends messages from the second peer to the first one and returns each one's index and arrival time, in the order they arrived. */
+std::vector<std::pair<uint32_t, uint32_t>> MessageArrivals(uint64_t seed, const LinkConditions &conditions, uint32_t numMessages)
+{
+	sim_network network(seed);
+	const std::vector<abstract_net *> peers = StartSimGame(network, 2);
+	network.SetConditions(conditions);
+	for (uint32_t i = 0; i < numMessages; ++i) {
+		SendIndex(*peers[1], 0, i);
+		network.Advance(1);
+	}
+	std::vector<std::pair<uint32_t, uint32_t>> arrivals;
+	for (int ms = 0; ms < 60000 && arrivals.size() < numMessages; ++ms) {
+		while (const std::optional<uint32_t> index = ReceiveIndex(*peers[0]))
+			arrivals.emplace_back(*index, network.Now());
+		network.Advance(1);
+	}
+	return arrivals;
+}
+
+class ProtocolSimTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		Players.resize(MAX_PLRS);
+	}
+};
+
+TEST_F(ProtocolSimTest, PeersJoinAndExchangeTurns)
+{
+	sim_network network(1);
+	const std::vector<abstract_net *> peers = StartSimGame(network, 3);
+
+	std::array<bool, 3> receivedTurn {};
+	for (int tick = 0; tick < 10; ++tick) {
+		for (size_t i = 0; i < peers.size(); ++i) {
+			int32_t turn = static_cast<int32_t>(100 + i);
+			peers[i]->SNetSendTurn(reinterpret_cast<char *>(&turn), sizeof(turn));
+		}
+		for (size_t i = 0; i < peers.size(); ++i) {
+			std::array<char *, MAX_PLRS> data {};
+			std::array<size_t, MAX_PLRS> size {};
+			std::array<uint32_t, MAX_PLRS> status {};
+			if (!peers[i]->SNetReceiveTurns(data.data(), size.data(), status.data()))
+				continue;
+			receivedTurn[i] = true;
+			for (size_t player = 0; player < peers.size(); ++player) {
+				ASSERT_EQ(size[player], sizeof(int32_t));
+				int32_t turn;
+				std::memcpy(&turn, data[player], sizeof(turn));
+				EXPECT_EQ(turn, static_cast<int32_t>(100 + player));
+			}
+		}
+		network.Advance(50);
+	}
+	EXPECT_EQ(receivedTurn, (std::array<bool, 3> { true, true, true }));
+}
+
+TEST_F(ProtocolSimTest, LatencyDelaysPackets)
+{
+	sim_network network(1);
+	const std::vector<abstract_net *> peers = StartSimGame(network, 2);
+	network.SetConditions(LinkConditions { .latencyMs = 100 });
+
+	SendIndex(*peers[1], 0, 7);
+	network.Advance(99);
+	EXPECT_EQ(ReceiveIndex(*peers[0]), std::nullopt);
+	network.Advance(1);
+	EXPECT_EQ(ReceiveIndex(*peers[0]), 7U);
+	EXPECT_EQ(peers[0]->get_latencies(1).providerLatency, 200);
+}
+
+TEST_F(ProtocolSimTest, BandwidthDelaysLargePackets)
+{
+	sim_network network(1);
+	const std::vector<abstract_net *> peers = StartSimGame(network, 2);
+	network.SetConditions(1, LinkConditions { .bytesPerSecond = 10000 });
+
+	const buffer_t message(500);
+	ASSERT_TRUE(peers[1]->SNetSendMessage(0, const_cast<unsigned char *>(message.data()), message.size()));
+	uint8_t sender;
+	void *data;
+	size_t size;
+	network.Advance(49);
+	EXPECT_FALSE(peers[0]->SNetReceiveMessage(&sender, &data, &size));
+	network.Advance(11);
+	ASSERT_TRUE(peers[0]->SNetReceiveMessage(&sender, &data, &size));
+	EXPECT_EQ(size, message.size());
+}
+
+TEST_F(ProtocolSimTest, LostPacketsAreResentInOrder)
+{
+	const LinkConditions conditions { .latencyMs = 20, .lossRate = 0.5F };
+	const std::vector<std::pair<uint32_t, uint32_t>> arrivals = MessageArrivals(1, conditions, 20);
+	ASSERT_EQ(arrivals.size(), 20U);
+	uint32_t lastArrival = 0;
+	for (uint32_t i = 0; i < arrivals.size(); ++i) {
+		EXPECT_EQ(arrivals[i].first, i);
+		EXPECT_GE(arrivals[i].second, lastArrival);
+		lastArrival = arrivals[i].second;
+	}
+	// Half the packets were lost at least once, so some waited for the retransmit timeout.
+	EXPECT_GE(lastArrival, conditions.retransmitTimeoutMs);
+}
+
+TEST_F(ProtocolSimTest, ReorderedPacketsOvertakeEachOther)
+{
+	const LinkConditions conditions { .jitterMs = 200, .reorderRate = 1 };
+	const std::vector<std::pair<uint32_t, uint32_t>> arrivals = MessageArrivals(1, conditions, 20);
+	ASSERT_EQ(arrivals.size(), 20U);
+	bool outOfOrder = false;
+	for (size_t i = 1; i < arrivals.size(); ++i)
+		outOfOrder = outOfOrder || arrivals[i].first < arrivals[i - 1].first;
+	EXPECT_TRUE(outOfOrder);
+}
+
+TEST_F(ProtocolSimTest, SameSeedRepeatsTheRun)
+{
+	const LinkConditions conditions { .latencyMs = 20, .jitterMs = 40, .lossRate = 0.2F, .reorderRate = 0.5F };
+	const std::vector<std::pair<uint32_t, uint32_t>> first = MessageArrivals(1, conditions, 20);
+	EXPECT_EQ(MessageArrivals(1, conditions, 20), first);
+	EXPECT_NE(MessageArrivals(2, conditions, 20), first);
+}
+
+} // namespace
+} // namespace net
+} // namespace devilution
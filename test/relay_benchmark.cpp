@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <asio/write.hpp>
+#include <benchmark/benchmark.h>
+
+#include "dvlnet/frame_queue.h"
+#include "dvlnet/packet.h"
+#include "dvlnet/relay_server.hpp"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace net {
+namespace {
+
+/** About the size of a turn with a few commands in it. */
+constexpr size_t MessageSize = 64;
+
+/**
+ * @brief A player that speaks the frame protocol directly.
+ *
+ * In every round it asks the relay for an echo and sends a message to the other players of its game.
+ */
+struct SimulatedPlayer {
+	asio::ip::tcp::socket socket;
+	frame_queue recvQueue;
+	plr_t plr = PLR_BROADCAST;
+	buffer_t roundFrames;
+	std::chrono::steady_clock::time_point sentAt;
+
+	explicit SimulatedPlayer(asio::io_context &ioc)
+	    : socket(ioc)
+	{
+	}
+};
+
+/** @brief Full games on a relay, with all players connected over loopback. */
+class LoadTest {
+public:
+	LoadTest(size_t numGames, size_t numThreads)
+	    : relay_(MakeOptions(numGames, numThreads))
+	{
+		relay_.Start();
+		for (const unsigned short port : relay_.Ports()) {
+			const asio::ip::tcp::endpoint endpoint(asio::ip::make_address("127.0.0.1"), port);
+			for (int i = 0; i < MAX_PLRS; ++i) {
+				players_.push_back(std::make_unique<SimulatedPlayer>(ioc_));
+				if (!Join(*players_.back(), endpoint))
+					return;
+			}
+		}
+		for (const std::unique_ptr<SimulatedPlayer> &player : players_)
+			StartReceive(*player);
+	}
+
+	~LoadTest()
+	{
+		relay_.Stop();
+	}
+
+	[[nodiscard]] const char *error() const
+	{
+		return error_;
+	}
+
+	[[nodiscard]] size_t NumPlayers() const
+	{
+		return players_.size();
+	}
+
+	/** @brief Every player sends its round and waits until it got its echo and the messages of all other players. */
+	bool PlayRound()
+	{
+		pending_ = players_.size() * MAX_PLRS;
+		for (const std::unique_ptr<SimulatedPlayer> &player : players_) {
+			player->sentAt = std::chrono::steady_clock::now();
+			asio::async_write(player->socket, asio::buffer(player->roundFrames), [this](const asio::error_code &ec, size_t /*bytesSent*/) {
+				if (ec)
+					error_ = "Failed to send";
+			});
+		}
+		while (pending_ > 0 && error_ == nullptr)
+			ioc_.run_one();
+		return error_ == nullptr;
+	}
+
+	/** @brief Echo round-trip times in microseconds, in the order they arrived. */
+	std::vector<int64_t> &latencies()
+	{
+		return latencies_;
+	}
+
+private:
+	static RelayOptions MakeOptions(size_t numGames, size_t numThreads)
+	{
+		RelayOptions options;
+		options.bindAddress = "127.0.0.1";
+		options.firstPort = 0;
+		options.numGames = numGames;
+		options.numThreads = numThreads;
+		options.gameSettings = DefaultRelayGameSettings(/*spawn=*/false);
+		return options;
+	}
+
+	bool Join(SimulatedPlayer &player, const asio::ip::tcp::endpoint &endpoint)
+	{
+		player.socket.connect(endpoint);
+		player.socket.set_option(asio::ip::tcp::no_delay(true));
+		std::expected<std::unique_ptr<packet>, PacketError> pkt
+		    = pktfty_.make_packet<PT_JOIN_REQUEST>(PLR_BROADCAST, PLR_MASTER, packet_out::GenerateCookie(), buffer_t());
+		const buffer_t frame = *frame_queue::MakeFrame((*pkt)->Data());
+		asio::write(player.socket, asio::buffer(frame));
+		while (player.plr == PLR_BROADCAST && error_ == nullptr) {
+			const std::span<unsigned char> recvSpan = player.recvQueue.WriteSpan();
+			player.recvQueue.CommitWrite(player.socket.read_some(asio::buffer(recvSpan.data(), recvSpan.size())));
+			HandleReceived(player, [this, &player](packet &received) {
+				if (received.Type() != PT_JOIN_ACCEPT)
+					return;
+				std::expected<const buffer_t *, PacketError> info = received.Info();
+				if (!info.has_value() || (*info)->size() != sizeof(GameData)) {
+					error_ = "The relay sent invalid game settings";
+					return;
+				}
+				player.plr = *received.NewPlayer();
+			});
+		}
+		if (error_ != nullptr)
+			return false;
+
+		AppendFrame(player.roundFrames, **pktfty_.make_packet<PT_ECHO_REQUEST>(player.plr, PLR_MASTER, timestamp_t { 0 }));
+		const buffer_t message(MessageSize);
+		AppendFrame(player.roundFrames, **pktfty_.make_packet<PT_MESSAGE>(player.plr, PLR_BROADCAST, std::span<const unsigned char>(message)));
+		return true;
+	}
+
+	static void AppendFrame(buffer_t &frames, packet &pkt)
+	{
+		const buffer_t frame = *frame_queue::MakeFrame(pkt.Data());
+		frames.insert(frames.end(), frame.begin(), frame.end());
+	}
+
+	void StartReceive(SimulatedPlayer &player)
+	{
+		const std::span<unsigned char> recvSpan = player.recvQueue.WriteSpan();
+		player.socket.async_receive(asio::buffer(recvSpan.data(), recvSpan.size()), [this, &player](const asio::error_code &ec, size_t bytesRead) {
+			if (ec) {
+				error_ = "Failed to receive";
+				return;
+			}
+			player.recvQueue.CommitWrite(bytesRead);
+			HandleReceived(player, [this, &player](packet &received) {
+				if (received.Type() == PT_ECHO_REPLY) {
+					const auto latency = std::chrono::steady_clock::now() - player.sentAt;
+					latencies_.push_back(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+					--pending_;
+				} else if (received.Type() == PT_MESSAGE) {
+					--pending_;
+				}
+			});
+			StartReceive(player);
+		});
+	}
+
+	/** @brief Hands all complete packets that arrived for the player to `handle`. */
+	void HandleReceived(SimulatedPlayer &player, const std::function<void(packet &)> &handle)
+	{
+		while (true) {
+			std::expected<bool, PacketError> ready = player.recvQueue.PacketReady();
+			if (!ready.has_value()) {
+				error_ = "Invalid frame received";
+				return;
+			}
+			if (!*ready)
+				return;
+			std::expected<std::unique_ptr<packet>, PacketError> pkt
+			    = player.recvQueue.ReadPacket()
+			          .and_then([this](std::span<const unsigned char> pktData) { return pktfty_.make_packet(pktData); });
+			if (!pkt.has_value()) {
+				error_ = "Invalid packet received";
+				return;
+			}
+			handle(**pkt);
+		}
+	}
+
+	RelayServer relay_;
+	asio::io_context ioc_;
+	packet_factory pktfty_;
+	std::vector<std::unique_ptr<SimulatedPlayer>> players_;
+	std::vector<int64_t> latencies_;
+	size_t pending_ = 0;
+	const char *error_ = nullptr;
+};
+
+int64_t Percentile(const std::vector<int64_t> &sorted, int percent)
+{
+	if (sorted.empty())
+		return 0;
+	return sorted[(sorted.size() - 1) * percent / 100];
+}
+
+/**
+ * @brief Rounds of full games that a relay gets through, state.range(0) is the number of games and state.range(1) the number of threads.
+ *
+ * Reports the echo round-trip time percentiles of the players, which include the time their messages spent queued in the relay.
+ */
+void BM_RelayLoad(benchmark::State &state)
+{
+	LoadTest loadTest(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+	if (loadTest.error() != nullptr) {
+		state.SkipWithError(loadTest.error());
+		return;
+	}
+	for (auto _ : state) {
+		if (!loadTest.PlayRound()) {
+			state.SkipWithError(loadTest.error());
+			return;
+		}
+	}
+	// Each message is delivered to all other players of its game.
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(loadTest.NumPlayers() * (MAX_PLRS - 1)));
+
+	std::vector<int64_t> &latencies = loadTest.latencies();
+	std::sort(latencies.begin(), latencies.end());
+	state.counters["p50_us"] = static_cast<double>(Percentile(latencies, 50));
+	state.counters["p95_us"] = static_cast<double>(Percentile(latencies, 95));
+	state.counters["p99_us"] = static_cast<double>(Percentile(latencies, 99));
+	state.SetLabel(StrCat(loadTest.NumPlayers(), " players"));
+}
+
+BENCHMARK(BM_RelayLoad)
+    ->ArgNames({ "games", "threads" })
+    ->Args({ 1, 1 })
+    ->Args({ 16, 1 })
+    ->Args({ 16, 4 })
+    ->Args({ 64, 4 })
+    ->UseRealTime();
+
+} // namespace
+} // namespace net
+} // namespace devilution
@@ -0,0 +1,115 @@
+#include <chrono>
+#include <expected>
+#include <memory>
+#include <span>
+#include <thread>
+
+#include <asio/write.hpp>
+#include <gtest/gtest.h>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "dvlnet/frame_queue.h"
+#include "dvlnet/packet.h"
+#include "dvlnet/relay_server.hpp"
+
+namespace devilution {
+namespace net {
+namespace {
+
+RelayOptions MakeOptions()
+{
+	RelayOptions options;
+	options.bindAddress = "127.0.0.1";
+	options.firstPort = 0;
+	options.numGames = 1;
+	options.numThreads = 1;
+	options.gameSettings = DefaultRelayGameSettings(/*spawn=*/false);
+	return options;
+}
+
+/** @brief Sends a join request and waits up to `timeout` for the relay to accept it. */
+bool Join(asio::io_context &ioc, asio::ip::tcp::socket &socket, std::chrono::milliseconds timeout)
+{
+	packet_factory pktfty;
+	std::expected<std::unique_ptr<packet>, PacketError> pkt
+	    = pktfty.make_packet<PT_JOIN_REQUEST>(PLR_BROADCAST, PLR_MASTER, packet_out::GenerateCookie(), buffer_t());
+	const buffer_t frame = *frame_queue::MakeFrame((*pkt)->Data());
+	asio::write(socket, asio::buffer(frame));
+
+	frame_queue recvQueue;
+	bool joined = false;
+	bool failed = false;
+	const auto startReceive = [&](const auto &self) -> void {
+		const std::span<unsigned char> recvSpan = recvQueue.WriteSpan();
+		socket.async_receive(asio::buffer(recvSpan.data(), recvSpan.size()), [&](const asio::error_code &ec, size_t bytesRead) {
+			if (ec) {
+				failed = true;
+				return;
+			}
+			recvQueue.CommitWrite(bytesRead);
+			while (recvQueue.PacketReady().value_or(false)) {
+				std::expected<std::unique_ptr<packet>, PacketError> received
+				    = recvQueue.ReadPacket()
+				          .and_then([&pktfty](std::span<const unsigned char> pktData) { return pktfty.make_packet(pktData); });
+				if (received.has_value() && (*received)->Type() == PT_JOIN_ACCEPT)
+					joined = true;
+			}
+			if (!joined)
+				self(self);
+		});
+	};
+	startReceive(startReceive);
+	ioc.restart();
+	ioc.run_for(timeout);
+	return joined && !failed;
+}
+
+TEST(RelayServerTest, PlayersCanJoin)
+{
+	RelayServer relay(MakeOptions());
+	relay.Start();
+
+	asio::io_context ioc;
+	asio::ip::tcp::socket socket(ioc);
+	socket.connect(asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), relay.Ports()[0]));
+	EXPECT_TRUE(Join(ioc, socket, std::chrono::seconds(5)));
+}
+
+#ifdef __unix__
+TEST(RelayServerTest, KeepsAcceptingAfterAcceptError)
+{
+	RelayServer relay(MakeOptions());
+	relay.Start();
+
+	asio::io_context ioc;
+	asio::ip::tcp::socket socket(ioc);
+	socket.open(asio::ip::tcp::v4());
+
+	// Makes every new file descriptor fail with EMFILE, so the relay fails to accept the connection.
+	rlimit limit;
+	ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &limit), 0);
+	const int nextFd = dup(socket.native_handle());
+	ASSERT_GE(nextFd, 0);
+	close(nextFd);
+	rlimit lowered = limit;
+	lowered.rlim_cur = static_cast<rlim_t>(nextFd);
+	ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &lowered), 0);
+
+	// The connection completes in the kernel's backlog, only the relay's accept fails.
+	asio::error_code ec;
+	socket.connect(asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), relay.Ports()[0]), ec);
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
+	ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &limit), 0);
+	ASSERT_FALSE(ec) << ec.message();
+
+	EXPECT_TRUE(Join(ioc, socket, std::chrono::seconds(5))) << "The relay must accept players again once the error is gone";
+}
+#endif
+
+} // namespace
+} // namespace net
+} // namespace devilution
@@ -0,0 +1,289 @@
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <magic_enum/magic_enum.hpp>
+
+#include "engine/assets.hpp"
+#include "game_mode.hpp"
+#include "headless_mode.hpp"
+#include "items.h"
+#include "loadsave.h"
+#include "menu.h"
+#include "pfile.h"
+#include "player.h"
+#include "qol/stash.h"
+#include "save_profile.hpp"
+#include "save_queue.hpp"
+#include "tables/itemdat.h"
+#include "tables/misdat.h"
+#include "tables/monstdat.h"
+#include "tables/objdat.h"
+#include "tables/playerdat.hpp"
+#include "tables/spelldat.h"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace {
+
+/**
+ * The saves that are measured, each one is written to its own directory during setup.
+ *
+ * They are all derived from the timedemo fixture, so that the benchmark only needs the assets the tests use.
+ */
+enum class SaveCorpus : uint8_t {
+	/** A single player Diablo game. */
+	Vanilla,
+	/** A single player Hellfire game, only available with hellfire.mpq and diabdat.mpq. */
+	Hellfire,
+	/** A multiplayer hero, multiplayer saves have no game data. */
+	Multiplayer,
+	/** A stash with every page full of items. */
+	Stash,
+};
+
+constexpr uint32_t SaveNumber = 0;
+/** The stash has 100 pages of 10×10 cells. */
+constexpr unsigned NumStashPages = 100;
+constexpr size_t NumStashItems = NumStashPages * 100;
+
+bool IsSpawnData;
+bool HaveHellfireCorpus;
+
+std::string CorpusPath(SaveCorpus corpus)
+{
+	return StrCat(paths::BasePath(), "save_benchmark/", magic_enum::enum_name(corpus), "/");
+}
+
+/** @brief Sets up the game mode and save directory for the corpus. */
+void UseCorpus(SaveCorpus corpus)
+{
+	paths::SetPrefPath(CorpusPath(corpus));
+	gbIsSpawn = IsSpawnData;
+	gbIsHellfire = corpus == SaveCorpus::Hellfire;
+	gbIsHellfireSaveGame = gbIsHellfire;
+	gbIsMultiplayer = corpus == SaveCorpus::Multiplayer;
+	giNumberOfLevels = gbIsHellfire ? 25 : 17;
+}
+
+void FillStash()
+{
+	Stash = {};
+	Item potion {};
+	InitializeItem(potion, IDI_HEAL);
+	for (unsigned page = 0; page < NumStashPages; page++) {
+		Stash.SetPage(page);
+		for (size_t i = 0; i < NumStashItems / NumStashPages; i++)
+			AutoPlaceItemInStash(potion, true);
+	}
+	Stash.SetPage(0);
+	Stash.gold = 10000;
+	Stash.dirty = true;
+}
+
+/** @brief Returns the memory used by the items of the stash. */
+size_t GetStashItemMemory()
+{
+	size_t size = Stash.stashList.capacity() * sizeof(Item);
+	for (const auto &[_, packedPage] : Stash.packedPages)
+		size += sizeof(packedPage) + packedPage.items.capacity();
+	return size;
+}
+
+void InitOnce()
+{
+	[[maybe_unused]] static const bool GlobalInitDone = []() {
+		LoadCoreArchives();
+		LoadGameArchives();
+		if (!HaveMainData()) {
+			LogError("This benchmark needs spawn.mpq or diabdat.mpq");
+			exit(1);
+		}
+		IsSpawnData = gbIsSpawn;
+		HaveHellfireCorpus = HaveHellfire() && !IsSpawnData;
+		if (HaveHellfireCorpus)
+			LoadHellfireArchives();
+		HeadlessMode = true;
+
+		LoadSpellData();
+		LoadPlayerDataFiles();
+		LoadMissileData();
+		LoadMonsterData();
+		LoadItemData();
+		LoadObjectData();
+
+		// Load the fixture, it is a spawn save that can be read with either of the main data files.
+		paths::SetPrefPath(paths::BasePath() + "test/fixtures/timedemo/WarriorLevel1to2/");
+		gbIsSpawn = true;
+		gbIsHellfire = false;
+		gbIsMultiplayer = false;
+		Players.resize(1);
+		MyPlayerId = 0;
+		MyPlayer = &Players[MyPlayerId];
+		gSaveNumber = SaveNumber;
+		pfile_read_player_from_save(SaveNumber, *MyPlayer);
+		if (!LoadGame(true).has_value()) {
+			LogError("Unable to load the fixture save");
+			exit(1);
+		}
+
+		// Write the corpus. Rewriting it on every run keeps it in sync with the current save format.
+		for (const SaveCorpus corpus : magic_enum::enum_values<SaveCorpus>()) {
+			if (corpus == SaveCorpus::Hellfire && !HaveHellfireCorpus)
+				continue;
+			const std::string path = CorpusPath(corpus);
+			RecursivelyCreateDir(path.c_str());
+			UseCorpus(corpus);
+			switch (corpus) {
+			case SaveCorpus::Vanilla:
+			case SaveCorpus::Hellfire:
+				pfile_write_hero(/*writeGameData=*/true);
+				break;
+			case SaveCorpus::Multiplayer:
+				pfile_write_hero();
+				break;
+			case SaveCorpus::Stash:
+				pfile_write_hero();
+				FillStash();
+				sfile_write_stash();
+				break;
+			}
+		}
+		WaitForPendingSaves();
+
+		SetSaveProfilingEnabled(true);
+		return true;
+	}();
+}
+
+/**
+ * @brief Selects the corpus given by state.range(0).
+ * @return false if the corpus is not available with the data files that were found.
+ */
+bool SetUpCorpus(benchmark::State &state)
+{
+	InitOnce();
+	const auto corpus = static_cast<SaveCorpus>(state.range(0));
+	state.SetLabel(std::string(magic_enum::enum_name(corpus)));
+	if (corpus == SaveCorpus::Hellfire && !HaveHellfireCorpus) {
+		state.SkipWithMessage("Needs diabdat.mpq and hellfire.mpq");
+		return false;
+	}
+	UseCorpus(corpus);
+	pfile_read_player_from_save(SaveNumber, *MyPlayer);
+	ResetSaveProfile();
+	return true;
+}
+
+/** @brief Reports the time recorded for each section, per iteration and in microseconds. */
+void ReportSaveProfile(benchmark::State &state)
+{
+	for (const SaveProfileSection section : magic_enum::enum_values<SaveProfileSection>()) {
+		const int64_t timeNs = GetSaveProfileTimeNs(section);
+		if (timeNs == 0)
+			continue;
+		state.counters[StrCat(SaveProfileSectionName(section), "_us")] = benchmark::Counter(static_cast<double>(timeNs) / 1000, benchmark::Counter::kAvgIterations);
+	}
+}
+
+void BM_Load(benchmark::State &state)
+{
+	if (!SetUpCorpus(state))
+		return;
+	const auto corpus = static_cast<SaveCorpus>(state.range(0));
+	Player player;
+	for (auto _ : state) {
+		switch (corpus) {
+		case SaveCorpus::Vanilla:
+		case SaveCorpus::Hellfire:
+			if (!LoadGame(true).has_value()) {
+				state.SkipWithError("Unable to load the game");
+				return;
+			}
+			break;
+		case SaveCorpus::Multiplayer:
+			pfile_read_player_from_save(SaveNumber, player);
+			benchmark::DoNotOptimize(player);
+			break;
+		case SaveCorpus::Stash:
+			LoadStash();
+			if (Stash.ItemCount() != NumStashItems) {
+				state.SkipWithError(StrCat("Loaded ", Stash.ItemCount(), " stash items instead of ", NumStashItems).c_str());
+				return;
+			}
+			break;
+		}
+	}
+	ReportSaveProfile(state);
+}
+
+/**
+ * @brief Loads the full stash, state.range(0) is whether all pages are shown afterwards.
+ *
+ * Only the page that is shown first is read when loading, the other pages are read when they are shown.
+ */
+void BM_LoadStash(benchmark::State &state)
+{
+	InitOnce();
+	UseCorpus(SaveCorpus::Stash);
+	const bool showAllPages = state.range(0) != 0;
+	for (auto _ : state) {
+		LoadStash();
+		if (showAllPages) {
+			for (unsigned page = 0; page < NumStashPages; page++)
+				Stash.SetPage(page);
+		}
+	}
+	if (Stash.ItemCount() != NumStashItems)
+		state.SkipWithError(StrCat("Loaded ", Stash.ItemCount(), " stash items instead of ", NumStashItems).c_str());
+	state.counters["item_bytes"] = static_cast<double>(GetStashItemMemory());
+	state.SetLabel(showAllPages ? "all pages shown" : "first page shown");
+}
+
+void BM_Save(benchmark::State &state)
+{
+	if (!SetUpCorpus(state))
+		return;
+	const auto corpus = static_cast<SaveCorpus>(state.range(0));
+	if (corpus == SaveCorpus::Vanilla || corpus == SaveCorpus::Hellfire) {
+		// Saving writes the current level, so it has to be the one from the save.
+		if (!LoadGame(true).has_value()) {
+			state.SkipWithError("Unable to load the game");
+			return;
+		}
+	} else if (corpus == SaveCorpus::Stash) {
+		LoadStash();
+	}
+	ResetSaveProfile();
+	for (auto _ : state) {
+		switch (corpus) {
+		case SaveCorpus::Vanilla:
+		case SaveCorpus::Hellfire:
+			pfile_write_hero(/*writeGameData=*/true);
+			break;
+		case SaveCorpus::Multiplayer:
+			pfile_write_hero();
+			break;
+		case SaveCorpus::Stash:
+			Stash.dirty = true;
+			sfile_write_stash();
+			break;
+		}
+		// Encoding and writing happen on a background thread, include them in the time.
+		WaitForPendingSaves();
+	}
+	ReportSaveProfile(state);
+}
+
+constexpr int64_t LastCorpus = magic_enum::enum_count<SaveCorpus>() - 1;
+
+BENCHMARK(BM_Load)->DenseRange(0, LastCorpus)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Save)->DenseRange(0, LastCorpus)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LoadStash)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,114 @@
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "codec.h"
+#include "game_mode.hpp"
+#include "multi.h"
+#include "pfile.h"
+#include "save_container.hpp"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace {
+
+constexpr const char *FileNames[] = { "hero", "game", "perml00", "templ01", "templ02" };
+
+std::vector<std::vector<std::byte>> Files;
+
+void InitOnce()
+{
+	[[maybe_unused]] static const bool GlobalInitDone = []() {
+		paths::SetPrefPath(paths::BasePath() + "test/fixtures/timedemo/WarriorLevel1to2/");
+		gbIsSpawn = true;
+		gbIsMultiplayer = false;
+		std::optional<SaveReader> archive = OpenSaveArchive(0);
+		if (!archive) {
+			LogError("Unable to open the fixture save");
+			exit(1);
+		}
+		for (const char *name : FileNames) {
+			size_t size;
+			const std::unique_ptr<std::byte[]> data = ReadArchive(*archive, name, &size);
+			if (data == nullptr) {
+				LogError("Unable to read {} from the fixture save", name);
+				exit(1);
+			}
+			Files.emplace_back(data.get(), data.get() + size);
+		}
+		return true;
+	}();
+}
+
+/** @brief Prepares a file the way `SaveWriter` stores it, compressed if `pack` is set. */
+std::unique_ptr<std::byte[]> WriteFile(std::span<const std::byte> file, bool pack, size_t &encodedLen)
+{
+	size_t size = file.size();
+	std::unique_ptr<std::byte[]> data = pack ? PackSaveFile(file, GetSaveCompression(), size) : nullptr;
+	if (data == nullptr) {
+		size = file.size();
+		data = std::unique_ptr<std::byte[]> { new std::byte[codec_get_encoded_len(size)] };
+		memcpy(data.get(), file.data(), size);
+	}
+	encodedLen = codec_get_encoded_len(size);
+	codec_encode(data.get(), size, encodedLen, pfile_get_password());
+	return data;
+}
+
+const std::vector<std::byte> &SetUp(benchmark::State &state)
+{
+	InitOnce();
+	const bool pack = state.range(1) != 0;
+	if (pack && GetSaveCompression() == SaveCompression::None)
+		state.SkipWithError("Built without save compression");
+	state.SetLabel(StrCat(FileNames[state.range(0)], pack ? " packed" : " legacy"));
+	return Files[state.range(0)];
+}
+
+void BM_WriteSaveFile(benchmark::State &state)
+{
+	const std::vector<std::byte> &file = SetUp(state);
+	size_t encodedLen = 0;
+	for (auto _ : state) {
+		std::unique_ptr<std::byte[]> data = WriteFile(file, state.range(1) != 0, encodedLen);
+		benchmark::DoNotOptimize(data);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file.size()));
+	state.counters["bytes_written"] = static_cast<double>(encodedLen);
+	state.counters["ratio"] = static_cast<double>(encodedLen) / static_cast<double>(file.size());
+}
+
+void BM_ReadSaveFile(benchmark::State &state)
+{
+	const std::vector<std::byte> &file = SetUp(state);
+	size_t encodedLen;
+	const std::unique_ptr<std::byte[]> encoded = WriteFile(file, state.range(1) != 0, encodedLen);
+	const std::unique_ptr<std::byte[]> data { new std::byte[encodedLen] };
+	for (auto _ : state) {
+		state.PauseTiming();
+		memcpy(data.get(), encoded.get(), encodedLen);
+		state.ResumeTiming();
+		size_t size = codec_decode(data.get(), encodedLen, pfile_get_password());
+		if (IsPackedSaveFile({ data.get(), size })) {
+			std::unique_ptr<std::byte[]> unpacked = UnpackSaveFile({ data.get(), size }, size);
+			benchmark::DoNotOptimize(unpacked);
+		}
+		if (size != file.size())
+			state.SkipWithError("Failed to read the file back");
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file.size()));
+}
+
+BENCHMARK(BM_WriteSaveFile)->ArgsProduct({ { 0, 1, 2, 3, 4 }, { 0, 1 } });
+BENCHMARK(BM_ReadSaveFile)->ArgsProduct({ { 0, 1, 2, 3, 4 }, { 0, 1 } });
+
+} // namespace
+} // namespace devilution
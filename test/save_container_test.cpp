@@ -0,0 +1,88 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "save_container.hpp"
+
+using namespace devilution;
+
+namespace {
+
+std::vector<std::byte> MakeFile(size_t size, bool compressible)
+{
+	std::vector<std::byte> result(size);
+	uint32_t state = 1;
+	for (size_t i = 0; i < size; ++i) {
+		state = state * 1103515245 + 12345;
+		result[i] = compressible && (i / 256) % 2 == 0 ? std::byte { 0 } : static_cast<std::byte>(state >> 16);
+	}
+	return result;
+}
+
+// Saves written by a build with either compression must load in every build.
+constexpr SaveCompression Compressions[] = { SaveCompression::LZ4, SaveCompression::Zstd };
+
+} // namespace
+
+TEST(SaveContainer, Roundtrip)
+{
+	const std::vector<std::byte> file = MakeFile(20000, /*compressible=*/true);
+	for (const SaveCompression compression : Compressions) {
+		size_t packedSize;
+		const std::unique_ptr<std::byte[]> packed = PackSaveFile(file, compression, packedSize);
+		ASSERT_NE(packed, nullptr) << "Compression " << static_cast<int>(compression);
+		EXPECT_LT(packedSize, file.size());
+		ASSERT_TRUE(IsPackedSaveFile({ packed.get(), packedSize }));
+
+		size_t size;
+		const std::unique_ptr<std::byte[]> unpacked = UnpackSaveFile({ packed.get(), packedSize }, size);
+		ASSERT_NE(unpacked, nullptr) << "Compression " << static_cast<int>(compression);
+		EXPECT_EQ(std::vector<std::byte>(unpacked.get(), unpacked.get() + size), file);
+	}
+}
+
+TEST(SaveContainer, NoCompressionStaysLegacy)
+{
+	const std::vector<std::byte> file = MakeFile(20000, /*compressible=*/true);
+	size_t packedSize;
+	EXPECT_EQ(PackSaveFile(file, SaveCompression::None, packedSize), nullptr);
+}
+
+TEST(SaveContainer, IncompressibleFilesStayLegacy)
+{
+	const std::vector<std::byte> file = MakeFile(20000, /*compressible=*/false);
+	for (const SaveCompression compression : Compressions) {
+		size_t packedSize;
+		EXPECT_EQ(PackSaveFile(file, compression, packedSize), nullptr) << "Compression " << static_cast<int>(compression);
+	}
+	EXPECT_FALSE(IsPackedSaveFile(file));
+}
+
+TEST(SaveContainer, RejectsSizeAboveCompressionRatio)
+{
+	const std::vector<std::byte> file = MakeFile(20000, /*compressible=*/true);
+	for (const SaveCompression compression : Compressions) {
+		size_t packedSize;
+		const std::unique_ptr<std::byte[]> packed = PackSaveFile(file, compression, packedSize);
+		ASSERT_NE(packed, nullptr);
+
+		// A corrupt header must not make `UnpackSaveFile` allocate gigabytes.
+		for (const uint8_t byte : { 8, 9, 10, 11 })
+			packed[byte] = std::byte { 0xFF };
+		size_t size;
+		EXPECT_EQ(UnpackSaveFile({ packed.get(), packedSize }, size), nullptr) << "Compression " << static_cast<int>(compression);
+	}
+}
+
+TEST(SaveContainer, RejectsUnknownCompression)
+{
+	std::vector<std::byte> file = { std::byte { 'D' }, std::byte { 'X' }, std::byte { 'S' }, std::byte { 'C' }, std::byte { 1 }, std::byte { 0xFF },
+		std::byte { 0 }, std::byte { 0 }, std::byte { 4 }, std::byte { 0 }, std::byte { 0 }, std::byte { 0 } };
+	file.resize(32);
+	ASSERT_TRUE(IsPackedSaveFile(file));
+	size_t size;
+	EXPECT_EQ(UnpackSaveFile(file, size), nullptr);
+}
@@ -0,0 +1,159 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "codec.h"
+#include "game_mode.hpp"
+#include "multi.h"
+#include "pfile.h"
+#include "save_delta.hpp"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace {
+
+/** Level files of the fixture save, the town and the first two dungeon levels. */
+constexpr const char *LevelNames[] = { "perml00", "templ01", "templ02" };
+
+/** Size of an item in a Hellfire save. */
+constexpr size_t ItemSaveSize = 372;
+
+enum class Change : uint8_t {
+	/** The level was only looked at. */
+	None,
+	/** An item was picked up, which also shifts everything that is saved after the items. */
+	ItemPickedUp,
+	/** A fight: monsters and items moved around, one monster and two items are gone. */
+	Fight,
+};
+
+constexpr const char *ChangeNames[] = { "None", "ItemPickedUp", "Fight" };
+
+struct FixtureLevel {
+	std::vector<std::byte> data;
+	uint64_t hash;
+};
+
+std::vector<FixtureLevel> Levels;
+
+void InitOnce()
+{
+	[[maybe_unused]] static const bool GlobalInitDone = []() {
+		paths::SetPrefPath(paths::BasePath() + "test/fixtures/timedemo/WarriorLevel1to2/");
+		gbIsSpawn = true;
+		gbIsMultiplayer = false;
+		std::optional<SaveReader> archive = OpenSaveArchive(0);
+		if (!archive) {
+			LogError("Unable to open the fixture save");
+			exit(1);
+		}
+		for (const char *name : LevelNames) {
+			size_t size;
+			const std::unique_ptr<std::byte[]> data = ReadArchive(*archive, name, &size);
+			if (data == nullptr) {
+				LogError("Unable to read {} from the fixture save", name);
+				exit(1);
+			}
+			FixtureLevel &level = Levels.emplace_back();
+			level.data.assign(data.get(), data.get() + size);
+			level.hash = GetSaveDeltaBaseHash(level.data);
+		}
+		return true;
+	}();
+}
+
+/** @brief Simulates the level being saved again after the given change. */
+std::vector<std::byte> ChangeLevel(std::vector<std::byte> level, Change change)
+{
+	switch (change) {
+	case Change::None:
+		break;
+	case Change::ItemPickedUp:
+		level.erase(level.begin() + level.size() / 3, level.begin() + level.size() / 3 + ItemSaveSize);
+		level[10] ^= std::byte { 1 };
+		level[level.size() - level.size() / 8] ^= std::byte { 1 };
+		break;
+	case Change::Fight:
+		level.erase(level.begin() + level.size() / 5, level.begin() + level.size() / 5 + 300);
+		level.erase(level.begin() + level.size() / 3, level.begin() + level.size() / 3 + 2 * ItemSaveSize);
+		for (size_t i = 0; i < 64; ++i) {
+			level[(i * 104729 + 7) % level.size()] ^= std::byte { 0x11 };
+		}
+		break;
+	}
+	return level;
+}
+
+/** @brief Encodes a file the way `SaveWriter::WriteFile` does, returns the number of bytes written. */
+size_t EncodeFile(std::span<const std::byte> data)
+{
+	const size_t encodedLen = codec_get_encoded_len(data.size());
+	const std::unique_ptr<std::byte[]> buffer { new std::byte[encodedLen] };
+	memcpy(buffer.get(), data.data(), data.size());
+	codec_encode(buffer.get(), data.size(), encodedLen, pfile_get_password());
+	benchmark::DoNotOptimize(buffer.get());
+	return encodedLen;
+}
+
+void SetUp(benchmark::State &state, const FixtureLevel *&level, std::vector<std::byte> &changed)
+{
+	InitOnce();
+	level = &Levels[state.range(0)];
+	changed = ChangeLevel(level->data, static_cast<Change>(state.range(1)));
+	state.SetLabel(StrCat(LevelNames[state.range(0)], " ", ChangeNames[state.range(1)]));
+}
+
+void BM_SaveLevelFull(benchmark::State &state)
+{
+	const FixtureLevel *level;
+	std::vector<std::byte> changed;
+	SetUp(state, level, changed);
+	size_t bytesWritten = 0;
+	for (auto _ : state) {
+		bytesWritten = EncodeFile(changed);
+	}
+	state.counters["bytes_written"] = static_cast<double>(bytesWritten);
+}
+
+void BM_SaveLevelDelta(benchmark::State &state)
+{
+	const FixtureLevel *level;
+	std::vector<std::byte> changed;
+	SetUp(state, level, changed);
+	size_t bytesWritten = 0;
+	for (auto _ : state) {
+		const std::vector<std::byte> delta = CreateSaveDelta(level->data, level->hash, changed, 1);
+		bytesWritten = EncodeFile(delta);
+	}
+	state.counters["bytes_written"] = static_cast<double>(bytesWritten);
+}
+
+void BM_LoadLevelDelta(benchmark::State &state)
+{
+	const FixtureLevel *level;
+	std::vector<std::byte> changed;
+	SetUp(state, level, changed);
+	const std::vector<std::byte> delta = CreateSaveDelta(level->data, level->hash, changed, 1);
+	for (auto _ : state) {
+		size_t size;
+		std::unique_ptr<std::byte[]> result = ApplySaveDelta(level->data, delta, size);
+		benchmark::DoNotOptimize(result);
+	}
+}
+
+BENCHMARK(BM_SaveLevelFull)->ArgsProduct({ { 0, 1, 2 }, { 0, 1, 2 } });
+BENCHMARK(BM_SaveLevelDelta)->ArgsProduct({ { 0, 1, 2 }, { 0, 1, 2 } });
+BENCHMARK(BM_LoadLevelDelta)->ArgsProduct({ { 0, 1, 2 }, { 0, 1, 2 } });
+
+} // namespace
+} // namespace devilution
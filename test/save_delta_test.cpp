@@ -0,0 +1,105 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "save_delta.hpp"
+
+using namespace devilution;
+
+namespace {
+
+std::vector<std::byte> MakeLevel(size_t size)
+{
+	std::vector<std::byte> result(size);
+	uint32_t state = 1;
+	for (size_t i = 0; i < size; ++i) {
+		// Runs of zeros like the dungeon grids, mixed with noise like the monsters and items.
+		state = state * 1103515245 + 12345;
+		result[i] = (i / 512) % 2 == 0 ? std::byte { 0 } : static_cast<std::byte>(state >> 16);
+	}
+	return result;
+}
+
+std::vector<std::byte> Apply(const std::vector<std::byte> &base, const std::vector<std::byte> &delta)
+{
+	size_t size = 0;
+	const std::unique_ptr<std::byte[]> result = ApplySaveDelta(base, delta, size);
+	if (result == nullptr)
+		return {};
+	return { result.get(), result.get() + size };
+}
+
+std::vector<std::byte> Roundtrip(const std::vector<std::byte> &base, const std::vector<std::byte> &target, size_t *deltaSize = nullptr)
+{
+	const std::vector<std::byte> delta = CreateSaveDelta(base, GetSaveDeltaBaseHash(base), target, 1);
+	if (deltaSize != nullptr)
+		*deltaSize = delta.size();
+	return Apply(base, delta);
+}
+
+} // namespace
+
+TEST(SaveDelta, Unchanged)
+{
+	const std::vector<std::byte> base = MakeLevel(20000);
+	size_t deltaSize;
+	EXPECT_EQ(Roundtrip(base, base, &deltaSize), base);
+	EXPECT_LT(deltaSize, 64);
+}
+
+TEST(SaveDelta, ChangedInPlace)
+{
+	const std::vector<std::byte> base = MakeLevel(20000);
+	std::vector<std::byte> target = base;
+	target[0] ^= std::byte { 1 };
+	target[7000] ^= std::byte { 1 };
+	target[19999] ^= std::byte { 1 };
+	size_t deltaSize;
+	EXPECT_EQ(Roundtrip(base, target, &deltaSize), target);
+	EXPECT_LT(deltaSize, 128);
+}
+
+TEST(SaveDelta, RemovedAndInserted)
+{
+	const std::vector<std::byte> base = MakeLevel(20000);
+	std::vector<std::byte> target = base;
+	target.erase(target.begin() + 1000, target.begin() + 1372);
+	const std::vector<std::byte> inserted(100, std::byte { 0xAB });
+	target.insert(target.begin() + 9000, inserted.begin(), inserted.end());
+	size_t deltaSize;
+	EXPECT_EQ(Roundtrip(base, target, &deltaSize), target);
+	EXPECT_LT(deltaSize, 256);
+}
+
+TEST(SaveDelta, SmallFiles)
+{
+	const std::vector<std::byte> base = MakeLevel(10);
+	const std::vector<std::byte> target = MakeLevel(20);
+	EXPECT_EQ(Roundtrip(base, target), target);
+	EXPECT_EQ(Roundtrip(target, base), base);
+	EXPECT_EQ(Roundtrip({}, target), target);
+	EXPECT_EQ(Roundtrip(target, {}), std::vector<std::byte> {});
+}
+
+TEST(SaveDelta, Generation)
+{
+	const std::vector<std::byte> base = MakeLevel(1000);
+	EXPECT_EQ(GetSaveDeltaGeneration(CreateSaveDelta(base, GetSaveDeltaBaseHash(base), base, 3)), 3);
+	EXPECT_EQ(GetSaveDeltaGeneration(base), 0);
+}
+
+TEST(SaveDelta, RejectsDifferentBase)
+{
+	const std::vector<std::byte> base = MakeLevel(1000);
+	std::vector<std::byte> target = base;
+	target[500] ^= std::byte { 1 };
+	const std::vector<std::byte> delta = CreateSaveDelta(base, GetSaveDeltaBaseHash(base), target, 1);
+
+	size_t size;
+	EXPECT_EQ(ApplySaveDelta(target, delta, size), nullptr);
+	const std::vector<std::byte> truncated(delta.begin(), delta.end() - 1);
+	EXPECT_EQ(ApplySaveDelta(base, truncated, size), nullptr);
+}
@@ -0,0 +1,51 @@
+/**
+ * @file sim_game.hpp
+ *
+ * Helpers for tests that play over a simulated network.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dvlnet/abstract_net.h"
+#include "dvlnet/protocol_sim.h"
+#include "multi.h"
+
+namespace devilution::net {
+
+inline buffer_t MakeSimGameInfo()
+{
+	GameData gameData {};
+	gameData.size = sizeof(GameData);
+	gameData.swapLE();
+	const auto *bytes = reinterpret_cast<const unsigned char *>(&gameData);
+	return buffer_t(bytes, bytes + sizeof(GameData));
+}
+
+/** @brief Lets the peers finish their handshakes. */
+inline void SettleSimGame(const std::vector<abstract_net *> &peers)
+{
+	for (int i = 0; i < 4; ++i) {
+		for (abstract_net *peer : peers)
+			peer->process_network_packets();
+	}
+}
+
+/** @brief The first peer creates a game that the others join, over links without any delay. */
+inline std::vector<abstract_net *> StartSimGame(sim_network &network, size_t numPlayers)
+{
+	std::vector<abstract_net *> peers;
+	for (size_t i = 0; i < numPlayers; ++i)
+		peers.push_back(&network.AddPeer());
+	peers[0]->setup_gameinfo(MakeSimGameInfo());
+	EXPECT_EQ(peers[0]->create("sim"), 0);
+	for (size_t i = 1; i < numPlayers; ++i)
+		EXPECT_EQ(peers[i]->join("sim"), static_cast<int>(i));
+	SettleSimGame(peers);
+	return peers;
+}
+
+} // namespace devilution::net
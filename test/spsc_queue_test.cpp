@@ -0,0 +1,100 @@
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/sdl_thread.h"
+#include "utils/spsc_queue.hpp"
+
+using namespace devilution;
+
+namespace {
+
+TEST(SpscQueueTest, KeepsTheOrder)
+{
+	SpscQueue<int, 4> queue;
+	EXPECT_EQ(queue.Front(), nullptr);
+	for (int i = 0; i < 3; i++) {
+		int *slot = queue.BackSlot();
+		ASSERT_NE(slot, nullptr);
+		*slot = i;
+		queue.Push();
+	}
+	for (int i = 0; i < 3; i++) {
+		ASSERT_NE(queue.Front(), nullptr);
+		EXPECT_EQ(*queue.Front(), i);
+		queue.Pop();
+	}
+	EXPECT_TRUE(queue.Empty());
+}
+
+TEST(SpscQueueTest, FullQueueHasNoSlot)
+{
+	SpscQueue<int, 2> queue;
+	for (int i = 0; i < 2; i++) {
+		*queue.BackSlot() = i;
+		queue.Push();
+	}
+	EXPECT_EQ(queue.BackSlot(), nullptr);
+	queue.Pop();
+	EXPECT_NE(queue.BackSlot(), nullptr);
+}
+
+TEST(SpscQueueTest, SlotsKeepTheirStorage)
+{
+	SpscQueue<std::vector<uint8_t>, 2> queue;
+	queue.BackSlot()->assign(100, 1);
+	queue.Push();
+	queue.Front()->clear();
+	queue.Pop();
+	ASSERT_NE(queue.BackSlot(), nullptr);
+	queue.Push();
+	queue.Pop();
+	// Back at the first slot.
+	EXPECT_GE(queue.BackSlot()->capacity(), 100U);
+}
+
+struct CrossThreadTest {
+	static constexpr uint32_t NumItems = 10000;
+	SpscQueue<uint32_t, 64> queue;
+
+	static int SDLCALL Produce(void *data)
+	{
+		auto &test = *static_cast<CrossThreadTest *>(data);
+		for (uint32_t i = 0; i < NumItems;) {
+			uint32_t *slot = test.queue.BackSlot();
+			if (slot == nullptr) {
+				std::this_thread::yield();
+				continue;
+			}
+			*slot = i++;
+			test.queue.Push();
+		}
+		return 0;
+	}
+};
+
+TEST(SpscQueueTest, HandsItemsToAnotherThread)
+{
+	CrossThreadTest test;
+	SdlThread producer(CrossThreadTest::Produce, &test);
+	uint32_t expected = 0;
+	bool inOrder = true;
+	while (expected < CrossThreadTest::NumItems) {
+		const uint32_t *item = test.queue.Front();
+		if (item == nullptr) {
+			std::this_thread::yield();
+			continue;
+		}
+		inOrder = inOrder && *item == expected;
+		expected++;
+		test.queue.Pop();
+	}
+	producer.join();
+	EXPECT_TRUE(inOrder);
+	EXPECT_TRUE(test.queue.Empty());
+}
+
+} // namespace
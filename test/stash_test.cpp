@@ -18,8 +18,13 @@
 
 #include "inv.h"
 #include "items.h"
+#include "loadsave.h"
+#include "pfile.h"
 #include "player.h"
 #include "qol/stash.h"
+#include "save_queue.hpp"
+#include "utils/file_util.h"
+#include "utils/paths.h"
 
 namespace devilution {
 namespace {
@@ -59,6 +64,14 @@ protected:
 		return item;
 	}
 
+	/** @brief Create a buckler, an item that is also valid in Diablo saves. */
+	static Item MakeShield()
+	{
+		Item item {};
+		InitializeItem(item, IDI_WARRSHLD);
+		return item;
+	}
+
 	/** @brief Create a gold item with the given value. */
 	static Item MakeGold(int value)
 	{
@@ -82,6 +95,23 @@ protected:
 		return count;
 	}
 
+	/** @brief Writes the stash to a save in the test directory and loads it again. */
+	static void SaveAndLoadStash()
+	{
+		const std::string prefPath = paths::PrefPath();
+		const std::string testPath = paths::BasePath() + "stash_test/";
+		RecursivelyCreateDir(testPath.c_str());
+		paths::SetPrefPath(testPath);
+		gbIsHellfireSaveGame = gbIsHellfire;
+
+		Stash.dirty = true;
+		sfile_write_stash();
+		WaitForPendingSaves();
+		LoadStash();
+
+		paths::SetPrefPath(prefPath);
+	}
+
 	/** @brief Fill a stash page completely with 1×1 items. */
 	void FillStashPage(unsigned page)
 	{
@@ -694,5 +724,68 @@ TEST_F(StashTest, GoldStorageIndependentOfItems)
 	EXPECT_EQ(Stash.stashList.size(), 1u) << "Only the non-gold item should be in stashList";
 }
 
+// ---------------------------------------------------------------------------
+// Saving and loading
+// ---------------------------------------------------------------------------
+
+TEST_F(StashTest, Load_OnlyUnpacksCurrentPage)
+{
+	Stash.SetPage(3);
+	ASSERT_TRUE(AutoPlaceItemInStash(MakeShield(), true));
+	ASSERT_TRUE(AutoPlaceItemInStash(MakeSmallItem(), true));
+	Stash.SetPage(0);
+	ASSERT_TRUE(AutoPlaceItemInStash(MakeSmallItem(), true));
+
+	SaveAndLoadStash();
+
+	EXPECT_EQ(Stash.GetPage(), 0u);
+	EXPECT_EQ(Stash.stashList.size(), 1u);
+	EXPECT_EQ(Stash.packedPages.count(3), 1u);
+	EXPECT_EQ(Stash.ItemCount(), 3u);
+
+	Stash.SetPage(3);
+	EXPECT_TRUE(Stash.packedPages.empty());
+	ASSERT_EQ(Stash.stashList.size(), 3u);
+	const Size shieldSize = GetInventorySize(MakeShield());
+	EXPECT_EQ(CountOccupiedCells(Stash.stashGrids[3]), shieldSize.width * shieldSize.height + 1);
+	EXPECT_EQ(Stash.stashList[Stash.GetItemIdAtPosition({ 0, 0 })].IDidx, IDI_WARRSHLD);
+}
+
+TEST_F(StashTest, Load_PackedPagesAreSavedAgain)
+{
+	Stash.SetPage(5);
+	ASSERT_TRUE(AutoPlaceItemInStash(MakeShield(), true));
+	Stash.SetPage(0);
+	ASSERT_TRUE(AutoPlaceItemInStash(MakeSmallItem(), true));
+
+	SaveAndLoadStash();
+	ASSERT_EQ(Stash.packedPages.count(5), 1u);
+	// Save the packed page without unpacking it.
+	SaveAndLoadStash();
+
+	EXPECT_EQ(Stash.ItemCount(), 2u);
+	Stash.SetPage(5);
+	ASSERT_EQ(Stash.stashList.size(), 2u);
+	EXPECT_EQ(Stash.stashList[Stash.GetItemIdAtPosition({ 0, 0 })].IDidx, IDI_WARRSHLD);
+}
+
+TEST_F(StashTest, PlaceItem_FindsSpaceOnPackedPage)
+{
+	FillStashPage(0);
+	Stash.SetPage(1);
+	ASSERT_TRUE(AutoPlaceItemInStash(MakeSmallItem(), true));
+	Stash.SetPage(0);
+
+	SaveAndLoadStash();
+	ASSERT_EQ(Stash.packedPages.count(1), 1u);
+
+	ASSERT_TRUE(AutoPlaceItemInStash(MakeSmallItem(), false));
+	EXPECT_EQ(Stash.packedPages.count(1), 1u) << "A dry run should not unpack the page";
+	ASSERT_TRUE(AutoPlaceItemInStash(MakeSmallItem(), true));
+	EXPECT_TRUE(Stash.packedPages.empty());
+	EXPECT_EQ(CountOccupiedCells(Stash.stashGrids[1]), 2);
+	EXPECT_EQ(Stash.stashList.size(), 102u);
+}
+
 } // namespace
 } // namespace devilution
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <random>
+#include <span>
+#include <thread>
+
+#include <asio/connect.hpp>
+#include <asio/executor_work_guard.hpp>
+#include <asio/write.hpp>
+#include <benchmark/benchmark.h>
+
+#include "dvlnet/frame_queue.h"
+#include "dvlnet/packet.h"
+#include "dvlnet/tcp_server.h"
+#include "utils/sdl_thread.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+namespace net {
+namespace {
+
+/** Packets a client sends before waiting for them to arrive at the other client. */
+constexpr int PacketsPerBatch = 64;
+
+/** @brief A client that speaks the frame protocol directly, without the game's `tcp_client` around it. */
+struct LoopbackClient {
+	asio::ip::tcp::socket socket;
+	frame_queue recvQueue;
+	plr_t plr = PLR_BROADCAST;
+
+	explicit LoopbackClient(asio::io_context &ioc)
+	    : socket(ioc)
+	{
+	}
+};
+
+/** @brief Who runs the `io_context` of the server. */
+enum class ServerRunner : uint8_t {
+	/** The benchmark thread, whenever a client waits for packets. */
+	Inline,
+	/** A simulated game thread that polls it after each frame, like the host did before the server had a thread of its own. */
+	GameFrames,
+	/** A thread of its own, like the one of the host's `tcp_client`. */
+	OwnThread,
+};
+
+/** @brief Two clients connected to a `tcp_server` over loopback, the first one sends to the second one. */
+class LoopbackGame {
+public:
+	/** @param frameMs How long each frame of the simulated game thread takes, for `ServerRunner::GameFrames`. */
+	explicit LoopbackGame(ServerRunner runner = ServerRunner::Inline, int frameMs = 0)
+	    : runner_(runner)
+	    , frameMs_(frameMs)
+	    , server_(ioc_, "127.0.0.1", 0, serverPktfty_)
+	    , sender_(clientIoc_)
+	    , receiver_(clientIoc_)
+	{
+		if (runner_ == ServerRunner::GameFrames)
+			serverThread_ = SdlThread(RunGameFrames, this);
+		else if (runner_ == ServerRunner::OwnThread)
+			serverThread_ = SdlThread(RunOwnThread, this);
+
+		const asio::ip::tcp::endpoint endpoint(asio::ip::make_address("127.0.0.1"), server_.Port());
+		for (LoopbackClient *client : { &sender_, &receiver_ }) {
+			client->socket.connect(endpoint);
+			client->socket.set_option(asio::ip::tcp::no_delay(true));
+			std::expected<std::unique_ptr<packet>, PacketError> pkt
+			    = pktfty_.make_packet<PT_JOIN_REQUEST>(PLR_BROADCAST, PLR_MASTER, packet_out::GenerateCookie(), buffer_t(1));
+			Send(*client, (*pkt)->Data());
+			while (client->plr == PLR_BROADCAST)
+				Receive(*client, [client](packet &pkt) {
+					if (pkt.Type() == PT_JOIN_ACCEPT)
+						client->plr = *pkt.NewPlayer();
+				});
+		}
+	}
+
+	~LoopbackGame()
+	{
+		stop_ = true;
+		work_.reset();
+		ioc_.stop();
+		serverThread_.join();
+	}
+
+	/** @brief Sends a batch of messages and waits until all of them arrived. */
+	bool SendBatch(std::span<const unsigned char> frames, int numPackets = PacketsPerBatch)
+	{
+		asio::write(sender_.socket, asio::buffer(frames.data(), frames.size()));
+		int received = 0;
+		while (received < numPackets) {
+			if (!Receive(receiver_, [&received](packet &pkt) {
+				    if (pkt.Type() == PT_MESSAGE)
+					    ++received;
+			    }))
+				return false;
+		}
+		return true;
+	}
+
+	/** @brief Returns the frames of a batch of messages from the sender to everyone else. */
+	buffer_t MakeBatch(size_t messageSize, int numPackets = PacketsPerBatch)
+	{
+		buffer_t frames;
+		const buffer_t message(messageSize);
+		for (int i = 0; i < numPackets; ++i) {
+			std::expected<std::unique_ptr<packet>, PacketError> pkt
+			    = pktfty_.make_packet<PT_MESSAGE>(sender_.plr, PLR_BROADCAST, std::span<const unsigned char>(message));
+			const buffer_t frame = *frame_queue::MakeFrame((*pkt)->Data());
+			frames.insert(frames.end(), frame.begin(), frame.end());
+		}
+		return frames;
+	}
+
+private:
+	static int SDLCALL RunGameFrames(void *data)
+	{
+		auto &game = *static_cast<LoopbackGame *>(data);
+		while (!game.stop_) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(game.frameMs_));
+			game.ioc_.poll();
+		}
+		return 0;
+	}
+
+	static int SDLCALL RunOwnThread(void *data)
+	{
+		static_cast<LoopbackGame *>(data)->ioc_.run();
+		return 0;
+	}
+
+	void Send(LoopbackClient &client, std::span<const unsigned char> pktData)
+	{
+		const buffer_t frame = *frame_queue::MakeFrame(pktData);
+		asio::write(client.socket, asio::buffer(frame));
+	}
+
+	/**
+	 * @brief Hands all complete packets that arrived at the client to `handle`.
+	 *
+	 * Lets the server run first if it has no thread, otherwise waits for data from it.
+	 */
+	template <typename Handler>
+	bool Receive(LoopbackClient &client, Handler handle)
+	{
+		if (runner_ == ServerRunner::Inline) {
+			ioc_.poll();
+			if (client.socket.available() == 0)
+				return true;
+		}
+		const std::span<unsigned char> recvSpan = client.recvQueue.WriteSpan();
+		client.recvQueue.CommitWrite(client.socket.read_some(asio::buffer(recvSpan.data(), recvSpan.size())));
+		while (true) {
+			std::expected<bool, PacketError> ready = client.recvQueue.PacketReady();
+			if (!ready.has_value())
+				return false;
+			if (!*ready)
+				return true;
+			std::expected<std::unique_ptr<packet>, PacketError> pkt
+			    = client.recvQueue.ReadPacket()
+			          .and_then([this](std::span<const unsigned char> pktData) { return pktfty_.make_packet(pktData); });
+			if (!pkt.has_value())
+				return false;
+			handle(**pkt);
+		}
+	}
+
+	ServerRunner runner_;
+	int frameMs_;
+	std::atomic<bool> stop_ = false;
+	asio::io_context ioc_;
+	asio::executor_work_guard<asio::io_context::executor_type> work_ = asio::make_work_guard(ioc_);
+	/** The server may run on another thread, so it can't share the packet factory of the clients. */
+	packet_factory serverPktfty_;
+	tcp_server server_;
+	asio::io_context clientIoc_;
+	packet_factory pktfty_;
+	LoopbackClient sender_;
+	LoopbackClient receiver_;
+	SdlThread serverThread_;
+};
+
+/** @brief Packets per second that a client sends through the server to another client, state.range(0) is the message size. */
+void BM_RelayMessages(benchmark::State &state)
+{
+	LoopbackGame game;
+	const buffer_t frames = game.MakeBatch(static_cast<size_t>(state.range(0)));
+	for (auto _ : state) {
+		if (!game.SendBatch(frames)) {
+			state.SkipWithError("Invalid packet received");
+			break;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * PacketsPerBatch);
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frames.size()));
+	state.SetLabel(StrCat(state.range(0), " byte messages"));
+}
+
+BENCHMARK(BM_RelayMessages)->Arg(16)->Arg(512)->Arg(4096);
+
+/**
+ * @brief Time for a message to get from one client through the server to another client, while the
+ * game of the host takes state.range(0) ms for each frame.
+ *
+ * Demonstrates that the players of a game no longer wait for the frames of the host.
+ */
+template <ServerRunner Runner>
+void BM_RelayLatency(benchmark::State &state)
+{
+	const int frameMs = static_cast<int>(state.range(0));
+	LoopbackGame game(Runner, frameMs);
+	const buffer_t frame = game.MakeBatch(16, 1);
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<int> pauseMs(1, frameMs);
+	for (auto _ : state) {
+		// Like in a game, the messages come at any time during a frame of the host.
+		std::this_thread::sleep_for(std::chrono::milliseconds(pauseMs(rng)));
+		const auto start = std::chrono::steady_clock::now();
+		if (!game.SendBatch(frame, 1)) {
+			state.SkipWithError("Invalid packet received");
+			break;
+		}
+		state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
+	state.SetLabel(StrCat(frameMs, " ms host frames"));
+}
+
+BENCHMARK(BM_RelayLatency<ServerRunner::GameFrames>)->Name("BM_RelayLatency/game_frames")->Arg(1)->Arg(16)->Arg(50)->Iterations(100)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RelayLatency<ServerRunner::OwnThread>)->Name("BM_RelayLatency/own_thread")->Arg(1)->Arg(16)->Arg(50)->Iterations(100)->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace net
+} // namespace devilution
@@ -0,0 +1,192 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dvlnet/abstract_net.h"
+#include "dvlnet/protocol_sim.h"
+#include "dvlnet/turn_delay.hpp"
+#include "player.h"
+#include "sim_game.hpp"
+
+namespace devilution {
+namespace net {
+namespace {
+
+constexpr uint32_t TickMs = 50;
+constexpr uint32_t TicksPerTurn = 4;
+constexpr uint32_t TurnPeriodMs = TickMs * TicksPerTurn;
+
+TEST(TurnDelayControllerTest, FastLinkUsesOneTurn)
+{
+	TurnDelayController controller;
+	controller.Reset(2);
+	for (uint32_t i = 0; i < TurnDelayController::CalmTurnsBeforeLowering; ++i) {
+		controller.AddRoundTripSample(2);
+		controller.Update(TurnPeriodMs);
+	}
+	EXPECT_EQ(controller.DesiredTurns(), 1U);
+}
+
+TEST(TurnDelayControllerTest, SlowLinkRaisesTurnsRightAway)
+{
+	TurnDelayController controller;
+	controller.Reset(2);
+	controller.AddRoundTripSample(1000);
+	controller.Update(TurnPeriodMs);
+	// 500 ms to the other player and as much jitter until more samples arrive.
+	EXPECT_GE(controller.DesiredTurns(), 4U);
+}
+
+TEST(TurnDelayControllerTest, TurnsAreLoweredOnlyAfterACalmPeriod)
+{
+	TurnDelayController controller;
+	controller.Reset(2);
+	controller.AddStall();
+	EXPECT_EQ(controller.DesiredTurns(), 3U);
+	controller.AddRoundTripSample(0);
+	for (uint32_t i = 1; i < TurnDelayController::CalmTurnsBeforeLowering; ++i)
+		controller.Update(TurnPeriodMs);
+	EXPECT_EQ(controller.DesiredTurns(), 3U);
+	controller.Update(TurnPeriodMs);
+	EXPECT_EQ(controller.DesiredTurns(), 2U);
+}
+
+TEST(TurnDelayControllerTest, PlayersAgreeOnTheHighestWish)
+{
+	TurnDelayController controller;
+	controller.Reset(2);
+	controller.SetPlayerTurns(1, 5);
+	controller.SetPlayerTurns(2, 3);
+	EXPECT_EQ(controller.AgreedTurns(), 5U);
+	controller.SetPlayerTurns(1, 0);
+	EXPECT_EQ(controller.AgreedTurns(), 3U);
+	controller.SetPlayerTurns(3, 1000);
+	EXPECT_EQ(controller.AgreedTurns(), TurnDelayController::MaxTurns);
+}
+
+struct LockstepResult {
+	/** Ticks in which a player couldn't advance because turns were missing. */
+	uint32_t stallTicks = 0;
+	std::array<uint32_t, 2> turnsInTransit {};
+};
+
+/**
+ * @brief Plays a two player game over a simulated link the way nthread does.
+ *
+ * With `adaptive` the players adapt their turns in transit and tell each other the number they want,
+ * otherwise they keep the default of the TCP and ZeroTier providers.
+ */
+LockstepResult PlayLockstep(const LinkConditions &conditions, bool adaptive, uint32_t numTicks)
+{
+	struct PlayerState {
+		TurnDelayController controller;
+		uint32_t turnsInTransit = 2;
+		uint32_t announcedTurns = 2;
+		uint32_t ticksUntilTurn = 0;
+		bool waitingForTurns = false;
+	};
+
+	sim_network network(1);
+	const std::vector<abstract_net *> peers = StartSimGame(network, 2);
+	network.SetConditions(conditions);
+	std::array<PlayerState, 2> players;
+	for (PlayerState &player : players)
+		player.controller.Reset(player.turnsInTransit);
+
+	LockstepResult result;
+	for (uint32_t tick = 0; tick < numTicks; ++tick) {
+		for (uint8_t i = 0; i < 2; ++i) {
+			abstract_net &peer = *peers[i];
+			PlayerState &player = players[i];
+			const uint8_t other = 1 - i;
+
+			uint8_t sender;
+			void *data;
+			size_t size;
+			while (peer.SNetReceiveMessage(&sender, &data, &size)) {
+				uint32_t turns;
+				EXPECT_EQ(size, sizeof(turns));
+				if (size != sizeof(turns))
+					continue;
+				std::memcpy(&turns, data, sizeof(turns));
+				player.controller.SetPlayerTurns(sender, turns);
+			}
+
+			uint32_t turnsInTransit;
+			peer.SNetGetTurnsInTransit(&turnsInTransit);
+			for (; turnsInTransit < player.turnsInTransit; ++turnsInTransit) {
+				int32_t turn = 0;
+				peer.SNetSendTurn(reinterpret_cast<char *>(&turn), sizeof(turn));
+			}
+
+			if (player.ticksUntilTurn > 0) {
+				player.ticksUntilTurn--;
+				continue;
+			}
+			std::array<char *, MAX_PLRS> turnData {};
+			std::array<size_t, MAX_PLRS> turnSize {};
+			std::array<uint32_t, MAX_PLRS> status {};
+			if (!peer.SNetReceiveTurns(turnData.data(), turnSize.data(), status.data())) {
+				result.stallTicks++;
+				if (!player.waitingForTurns) {
+					player.waitingForTurns = true;
+					player.controller.AddStall();
+				}
+				continue;
+			}
+			player.waitingForTurns = false;
+			player.ticksUntilTurn = TicksPerTurn - 1;
+			if (!adaptive)
+				continue;
+
+			const std::optional<int> roundTrip = peer.get_latencies(other).providerLatency;
+			if (roundTrip.has_value())
+				player.controller.AddRoundTripSample(static_cast<uint32_t>(*roundTrip));
+			player.controller.Update(TurnPeriodMs);
+			uint32_t desiredTurns = player.controller.DesiredTurns();
+			if (desiredTurns != player.announcedTurns) {
+				peer.SNetSendMessage(other, &desiredTurns, sizeof(desiredTurns));
+				player.announcedTurns = desiredTurns;
+			}
+			player.turnsInTransit = player.controller.AgreedTurns();
+		}
+		network.Advance(TickMs);
+	}
+	for (size_t i = 0; i < players.size(); ++i)
+		result.turnsInTransit[i] = players[i].turnsInTransit;
+	return result;
+}
+
+class TurnDelaySimTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		Players.resize(MAX_PLRS);
+	}
+};
+
+TEST_F(TurnDelaySimTest, SlowLinkStallsLessWithAdaptiveTurns)
+{
+	const LinkConditions conditions { .latencyMs = 500 };
+	const LockstepResult fixed = PlayLockstep(conditions, /*adaptive=*/false, 400);
+	const LockstepResult adaptive = PlayLockstep(conditions, /*adaptive=*/true, 400);
+	EXPECT_LT(adaptive.stallTicks * 2, fixed.stallTicks);
+	EXPECT_GT(adaptive.turnsInTransit[0], 2U);
+	EXPECT_GT(adaptive.turnsInTransit[1], 2U);
+}
+
+TEST_F(TurnDelaySimTest, FastLinkAgreesOnFewerTurns)
+{
+	const LinkConditions conditions { .latencyMs = 1 };
+	// The first turns stall while the players join, lowering back to one turn takes two calm periods.
+	const LockstepResult adaptive = PlayLockstep(conditions, /*adaptive=*/true, 1000);
+	EXPECT_EQ(adaptive.turnsInTransit, (std::array<uint32_t, 2> { 1, 1 }));
+}
+
+} // namespace
+} // namespace net
+} // namespace devilution
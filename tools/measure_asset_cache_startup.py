@@ -0,0 +1,51 @@
+#!/usr/bin/env python
+
+"""Measures the wall time of a timedemo run with a cold and a warm asset cache (`--asset-cache-dir`)."""
+
+import argparse
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+from typing import List
+
+
+def measure(binary: str, cache_dir: str) -> float:
+	start = time.perf_counter()
+	result: subprocess.CompletedProcess = subprocess.run(
+		[binary, '--diablo', '--spawn', '--lang', 'en', '--demo', '0', '--timedemo', '--asset-cache-dir', cache_dir],
+		capture_output=True)
+	elapsed = time.perf_counter() - start
+	if result.returncode != 0:
+		raise Exception(f"Run failed with exit code {result.returncode}:\n{result.stderr}")
+	return elapsed
+
+
+def format_stats(label: str, times: List[float]) -> str:
+	mean = statistics.mean(times)
+	stdev = statistics.stdev(times, mean) if len(times) > 1 else 0
+	return f"{label}: {mean:.3f} ± {stdev:.3f} seconds"
+
+
+def main():
+	parser = argparse.ArgumentParser()
+	parser.add_argument('--binary', help='Path to the devilutionx binary', required=True)
+	parser.add_argument('-n', '--num-runs', type=int, default=8, metavar='N')
+	args = parser.parse_args()
+
+	num_runs = args.num_runs
+	cold = []
+	warm = []
+	for i in range(1, num_runs + 1):
+		with tempfile.TemporaryDirectory(prefix='devilutionx-asset-cache-') as cache_dir:
+			print(f"Run {i:>2} of {num_runs}: ", end='', file=sys.stderr, flush=True)
+			cold.append(measure(args.binary, cache_dir))
+			warm.append(measure(args.binary, cache_dir))
+			print(f"\tcold {cold[-1]:>6.3f} seconds\twarm {warm[-1]:>6.3f} seconds", file=sys.stderr, flush=True)
+
+	print(format_stats('Cold', cold))
+	print(format_stats('Warm', warm))
+
+
+main()
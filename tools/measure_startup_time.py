@@ -0,0 +1,77 @@
+#!/usr/bin/env python
+
+"""Measures the time to the main menu and the duration of each startup phase (`--startup-trace`)."""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+from typing import Dict, List
+
+# The last table loaded while the main menu is idle, see `Source/tables/deferred_tables.cpp`.
+LAST_DEFERRED_PHASE = 'LoadQuestData'
+
+
+def read_trace(path: str):
+	try:
+		with open(path, 'r') as f:
+			return json.load(f)
+	except (FileNotFoundError, json.JSONDecodeError):
+		return None
+
+
+def measure(binary: str, trace_path: str, timeout: float):
+	process = subprocess.Popen(
+		[binary, '--diablo', '--spawn', '--lang', 'en', '-n', '--startup-trace', trace_path],
+		stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+	deadline = time.monotonic() + timeout
+	try:
+		while time.monotonic() < deadline:
+			if process.poll() is not None:
+				raise Exception(f"Exited with code {process.returncode} before reaching the main menu:\n{process.stderr.read()}")
+			trace = read_trace(trace_path)
+			if trace is not None and any(event['name'] == LAST_DEFERRED_PHASE for event in trace['traceEvents']):
+				return trace
+			time.sleep(0.01)
+		raise Exception(f"Did not reach the main menu within {timeout} seconds")
+	finally:
+		process.kill()
+		process.wait()
+
+
+def format_stats(label: str, times: List[float]) -> str:
+	mean = statistics.mean(times)
+	stdev = statistics.stdev(times, mean) if len(times) > 1 else 0
+	return f"{label:<24} {mean:>8.2f} ± {stdev:>6.2f} ms"
+
+
+def main():
+	parser = argparse.ArgumentParser()
+	parser.add_argument('--binary', help='Path to the devilutionx binary', required=True)
+	parser.add_argument('-n', '--num-runs', type=int, default=8, metavar='N')
+	parser.add_argument('--timeout', type=float, default=60, help='Per-run timeout in seconds')
+	args = parser.parse_args()
+
+	num_runs = args.num_runs
+	time_to_menu: List[float] = []
+	phases: Dict[str, List[float]] = {}
+	with tempfile.TemporaryDirectory(prefix='devilutionx-startup-trace-') as trace_dir:
+		for i in range(1, num_runs + 1):
+			trace_path = os.path.join(trace_dir, f'{i}.json')
+			print(f"Run {i:>2} of {num_runs}: ", end='', file=sys.stderr, flush=True)
+			trace = measure(args.binary, trace_path, args.timeout)
+			time_to_menu.append(trace['otherData']['timeToMenuUs'] / 1000)
+			for event in trace['traceEvents']:
+				phases.setdefault(event['name'], []).append(event['dur'] / 1000)
+			print(f"\t{time_to_menu[-1]:>8.2f} ms", file=sys.stderr, flush=True)
+
+	print(format_stats('Time to menu', time_to_menu))
+	for name, times in phases.items():
+		print(format_stats(name, times))
+
+
+main()